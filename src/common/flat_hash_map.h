@@ -0,0 +1,257 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Hash map using open addressing with linear probing. Elements are stored inline in a single
+ * array, so lookups touch one or two cache lines instead of walking bucket lists.
+ *
+ * Erasing an element moves the following elements of its probe sequence back, which invalidates
+ * every iterator except the one returned by erase. Erasing while iterating with
+ * "it = map.erase(it)" still visits every element, but an element may be visited twice when a
+ * probe sequence wraps around the end of the table.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using size_type = std::size_t;
+
+    template <bool IS_CONST>
+    class Iterator {
+        friend FlatHashMap;
+        friend Iterator<!IS_CONST>;
+
+        using Map = std::conditional_t<IS_CONST, const FlatHashMap, FlatHashMap>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = FlatHashMap::value_type;
+        using pointer = std::conditional_t<IS_CONST, const value_type*, value_type*>;
+        using reference = std::conditional_t<IS_CONST, const value_type&, value_type&>;
+
+        constexpr Iterator() = default;
+
+        operator Iterator<true>() const noexcept requires(!IS_CONST) {
+            return Iterator<true>{map, index};
+        }
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return *map->slots[index];
+        }
+
+        [[nodiscard]] pointer operator->() const noexcept {
+            return &*map->slots[index];
+        }
+
+        Iterator& operator++() noexcept {
+            index = map->NextOccupied(index + 1);
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            const Iterator copy{*this};
+            ++*this;
+            return copy;
+        }
+
+        [[nodiscard]] bool operator==(const Iterator& other) const noexcept {
+            return index == other.index;
+        }
+
+    private:
+        Iterator(Map* map_, size_t index_) noexcept : map{map_}, index{index_} {}
+
+        Map* map = nullptr;
+        size_t index = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+
+    [[nodiscard]] iterator begin() noexcept {
+        return iterator{this, NextOccupied(0)};
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator{this, NextOccupied(0)};
+    }
+
+    [[nodiscard]] iterator end() noexcept {
+        return iterator{this, slots.size()};
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator{this, slots.size()};
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return num_elements;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return num_elements == 0;
+    }
+
+    [[nodiscard]] iterator find(const Key& key) {
+        return iterator{this, FindIndex(key)};
+    }
+
+    [[nodiscard]] const_iterator find(const Key& key) const {
+        return const_iterator{this, FindIndex(key)};
+    }
+
+    [[nodiscard]] bool contains(const Key& key) const {
+        return FindIndex(key) != slots.size();
+    }
+
+    /// Inserts an element constructed from args if key is not in the map
+    /// @returns Iterator to the element with the given key and true if it was inserted
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        if (const size_t index = FindIndex(key); index != slots.size()) {
+            return {iterator{this, index}, false};
+        }
+        if ((num_elements + 1) * MAX_LOAD_DENOMINATOR > slots.size() * MAX_LOAD_NUMERATOR) {
+            Rehash(std::max(slots.size() * 2, MIN_CAPACITY));
+        }
+        size_t index = HomeIndex(key);
+        while (slots[index]) {
+            index = (index + 1) & Mask();
+        }
+        slots[index].emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        ++num_elements;
+        return {iterator{this, index}, true};
+    }
+
+    Value& operator[](const Key& key) {
+        return try_emplace(key).first->second;
+    }
+
+    /// Erases the element pointed by it
+    /// @returns Iterator to the next element to visit
+    iterator erase(const_iterator it) {
+        const size_t index = it.index;
+        EraseIndex(index);
+        return iterator{this, slots[index] ? index : NextOccupied(index + 1)};
+    }
+
+    /// Erases the element with the given key
+    /// @returns Number of erased elements
+    size_t erase(const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index == slots.size()) {
+            return 0;
+        }
+        EraseIndex(index);
+        return 1;
+    }
+
+    void clear() {
+        slots.clear();
+        num_elements = 0;
+    }
+
+    /// Makes room for at least count elements without rehashing
+    void reserve(size_t count) {
+        const size_t capacity =
+            std::bit_ceil(count * MAX_LOAD_DENOMINATOR / MAX_LOAD_NUMERATOR + 1);
+        if (capacity > slots.size()) {
+            Rehash(std::max(capacity, MIN_CAPACITY));
+        }
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 16;
+    static constexpr size_t MAX_LOAD_NUMERATOR = 3;
+    static constexpr size_t MAX_LOAD_DENOMINATOR = 4;
+
+    [[nodiscard]] size_t Mask() const noexcept {
+        return slots.size() - 1;
+    }
+
+    /// Returns the first slot of the probe sequence of key
+    [[nodiscard]] size_t HomeIndex(const Key& key) const {
+        // Mix the hash, std::hash is the identity for integers on common implementations and
+        // aligned addresses would collide on their low bits
+        const u64 hash = static_cast<u64>(Hash{}(key)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(hash >> (64 - std::countr_zero(slots.size())));
+    }
+
+    [[nodiscard]] size_t FindIndex(const Key& key) const {
+        if (num_elements == 0) {
+            return slots.size();
+        }
+        for (size_t index = HomeIndex(key); slots[index]; index = (index + 1) & Mask()) {
+            if (KeyEqual{}(slots[index]->first, key)) {
+                return index;
+            }
+        }
+        return slots.size();
+    }
+
+    [[nodiscard]] size_t NextOccupied(size_t index) const noexcept {
+        while (index < slots.size() && !slots[index]) {
+            ++index;
+        }
+        return index;
+    }
+
+    void EraseIndex(size_t hole) {
+        slots[hole].reset();
+        --num_elements;
+
+        // Move back the elements of the probe sequence that can no longer be reached
+        for (size_t index = (hole + 1) & Mask(); slots[index]; index = (index + 1) & Mask()) {
+            const size_t home = HomeIndex(slots[index]->first);
+            if (((index - home) & Mask()) >= ((index - hole) & Mask())) {
+                slots[hole] = std::move(slots[index]);
+                slots[index].reset();
+                hole = index;
+            }
+        }
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<std::optional<value_type>> old_slots(capacity);
+        old_slots.swap(slots);
+        for (std::optional<value_type>& slot : old_slots) {
+            if (!slot) {
+                continue;
+            }
+            size_t index = HomeIndex(slot->first);
+            while (slots[index]) {
+                index = (index + 1) & Mask();
+            }
+            slots[index] = std::move(slot);
+        }
+    }
+
+    std::vector<std::optional<value_type>> slots;
+    size_t num_elements = 0;
+};
+
+} // namespace Common
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+
 #include "common/fs/file.h"
 #include "common/fs/fs.h"
 #include "common/fs/path_util.h"
@@ -10,7 +12,9 @@
 #ifdef _WIN32
 #include <io.h>
 #include <share.h>
+#include <windows.h>
 #else
+#include <cerrno>
 #include <unistd.h>
 #endif
 
@@ -298,6 +302,77 @@ size_t IOFile::WriteString(std::span<const char> string) const {
     return WriteSpan(string);
 }
 
+size_t IOFile::ReadAt(std::span<u8> data, u64 offset) const {
+    if (!IsOpen()) {
+        return 0;
+    }
+
+    size_t total_read = 0;
+    while (total_read < data.size()) {
+        const u64 position = offset + total_read;
+#ifdef _WIN32
+        const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file)));
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+        const auto request =
+            static_cast<DWORD>(std::min<size_t>(data.size() - total_read, 0x80000000));
+        DWORD num_read = 0;
+        if (!ReadFile(handle, data.data() + total_read, request, &num_read, &overlapped) ||
+            num_read == 0) {
+            break;
+        }
+#else
+        const ssize_t num_read = pread(fileno(file), data.data() + total_read,
+                                       data.size() - total_read, static_cast<off_t>(position));
+        if (num_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (num_read <= 0) {
+            break;
+        }
+#endif
+        total_read += static_cast<size_t>(num_read);
+    }
+    return total_read;
+}
+
+size_t IOFile::WriteAt(std::span<const u8> data, u64 offset) const {
+    if (!IsOpen()) {
+        return 0;
+    }
+
+    size_t total_written = 0;
+    while (total_written < data.size()) {
+        const u64 position = offset + total_written;
+#ifdef _WIN32
+        const auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file)));
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+        const auto request =
+            static_cast<DWORD>(std::min<size_t>(data.size() - total_written, 0x80000000));
+        DWORD num_written = 0;
+        if (!WriteFile(handle, data.data() + total_written, request, &num_written, &overlapped) ||
+            num_written == 0) {
+            break;
+        }
+#else
+        const ssize_t num_written =
+            pwrite(fileno(file), data.data() + total_written, data.size() - total_written,
+                   static_cast<off_t>(position));
+        if (num_written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (num_written <= 0) {
+            break;
+        }
+#endif
+        total_written += static_cast<size_t>(num_written);
+    }
+    return total_written;
+}
+
 bool IOFile::Flush() const {
     if (!IsOpen()) {
         return false;
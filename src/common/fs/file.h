@@ -395,6 +395,38 @@ public:
      */
     [[nodiscard]] size_t WriteString(std::span<const char> string) const;
 
+    /**
+     * Reads bytes from a file at the given offset, without using nor moving the file pointer.
+     * Unlike Seek followed by ReadSpan, concurrent positional reads and writes on the same file do
+     * not have to be serialized. Positional accesses bypass the stream buffer and must not be
+     * mixed with sequential accesses on the same file.
+     *
+     * Failures occur when:
+     * - The file is not open
+     * - The opened file lacks read permissions
+     *
+     * @param data Span of bytes to read into
+     * @param offset Offset from the start of the file
+     *
+     * @returns Count of bytes successfully read.
+     */
+    [[nodiscard]] size_t ReadAt(std::span<u8> data, u64 offset) const;
+
+    /**
+     * Writes bytes to a file at the given offset, without using nor moving the file pointer.
+     * See ReadAt for more details.
+     *
+     * Failures occur when:
+     * - The file is not open
+     * - The opened file lacks write permissions
+     *
+     * @param data Span of bytes to write
+     * @param offset Offset from the start of the file
+     *
+     * @returns Count of bytes successfully written.
+     */
+    [[nodiscard]] size_t WriteAt(std::span<const u8> data, u64 offset) const;
+
     /**
      * Attempts to flush any unwritten buffered data into the file and flush the file into the disk.
      *
@@ -25,3 +25,4 @@
 // yuzu-specific files
 
 #define LOG_FILE "yuzu_log.txt"
+#define TRACE_FILE "yuzu_log.trace"
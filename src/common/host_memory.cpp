@@ -11,12 +11,16 @@
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE
 #endif
+#include <csignal>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
 #endif // ^^^ Linux ^^^
 
+#include <array>
+#include <atomic>
+#include <bit>
 #include <mutex>
 
 #include "common/alignment.h"
@@ -30,6 +34,197 @@ namespace Common {
 constexpr size_t PageAlignment = 0x1000;
 constexpr size_t HugePageSize = 0x200000;
 
+constexpr size_t PageBits = 12;
+static_assert(PageAlignment == size_t{1} << PageBits);
+
+/// Maximum number of HostMemory instances tracking writes at the same time.
+constexpr size_t MaxWriteTrackers = 8;
+
+/// Trackers the fault handler looks up faulting addresses in.
+std::array<std::atomic<HostMemory::WriteTracker*>, MaxWriteTrackers> write_trackers{};
+
+/**
+ * Page bitmaps used to track writes, shared with the fault handler.
+ * A page is owned when a write fault on it is caused by write tracking, it is tracked while it has
+ * to be write protected again after its writes are collected. Written pages are recorded in three
+ * levels, each bit of an upper level covering a word of the level below, so collecting them only
+ * scans the words that changed.
+ */
+class HostMemory::WriteTracker {
+public:
+    explicit WriteTracker(u8* base_, size_t size_)
+        : base{base_}, num_pages{size_ >> PageBits}, owned{WordCount(num_pages)},
+          tracked{WordCount(num_pages)}, written{WordCount(num_pages)},
+          written_words{WordCount(written.size())}, written_groups{
+                                                        WordCount(written_words.size())} {
+        for (auto& slot : write_trackers) {
+            WriteTracker* expected = nullptr;
+            if (slot.compare_exchange_strong(expected, this, std::memory_order_acq_rel)) {
+                registered = true;
+                break;
+            }
+        }
+    }
+
+    ~WriteTracker() {
+        for (auto& slot : write_trackers) {
+            WriteTracker* expected = this;
+            if (slot.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+                break;
+            }
+        }
+    }
+
+    WriteTracker(const WriteTracker&) = delete;
+    WriteTracker& operator=(const WriteTracker&) = delete;
+
+    /// Returns false when too many trackers exist for the fault handler to find this one.
+    [[nodiscard]] bool IsRegistered() const noexcept {
+        return registered;
+    }
+
+    /// Called from the fault handler, returns true when the fault at address was a write to a page
+    /// owned by write tracking, which is then writable.
+    bool HandleFault(const void* address) {
+        const auto* const pointer = static_cast<const u8*>(address);
+        if (pointer < base || pointer >= base + (num_pages << PageBits)) {
+            return false;
+        }
+        const size_t page = static_cast<size_t>(pointer - base) >> PageBits;
+        if (!TestBit(owned, page)) {
+            return false;
+        }
+        if (!UnprotectPage(base + (page << PageBits))) {
+            return false;
+        }
+        // Lower levels are marked first so a collector that sees an upper bit finds the page
+        SetBit(written, page);
+        SetBit(written_words, page / 64);
+        SetBit(written_groups, page / (64 * 64));
+        return true;
+    }
+
+    void Track(size_t first_page, size_t count) {
+        SetBits(owned, first_page, count);
+        SetBits(tracked, first_page, count);
+    }
+
+    void Untrack(size_t first_page, size_t count) {
+        ClearBits(tracked, first_page, count);
+    }
+
+    void Disown(size_t first_page, size_t count) {
+        ClearBits(tracked, first_page, count);
+        ClearBits(owned, first_page, count);
+    }
+
+    [[nodiscard]] bool IsTracked(size_t page) const {
+        return TestBit(tracked, page);
+    }
+
+    /// Calls func(page) for each page written since the last call, in ascending order.
+    template <typename Func>
+    void PopWrittenPages(Func&& func) {
+        for (size_t group_word = 0; group_word < written_groups.size(); ++group_word) {
+            u64 groups = Exchange(written_groups, group_word);
+            for (; groups != 0; groups &= groups - 1) {
+                const size_t group = group_word * 64 + std::countr_zero(groups);
+                u64 words = Exchange(written_words, group);
+                for (; words != 0; words &= words - 1) {
+                    const size_t word = group * 64 + std::countr_zero(words);
+                    u64 pages = Exchange(written, word);
+                    for (; pages != 0; pages &= pages - 1) {
+                        func(word * 64 + std::countr_zero(pages));
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] u8* Base() const noexcept {
+        return base;
+    }
+
+private:
+    using Bitmap = VirtualBuffer<u64>;
+
+    static constexpr size_t WordCount(size_t bits) {
+        return (bits + 63) / 64;
+    }
+
+    static bool TestBit(const Bitmap& bitmap, size_t bit) {
+        u64& word = const_cast<Bitmap&>(bitmap)[bit / 64];
+        return (std::atomic_ref{word}.load(std::memory_order_acquire) >> (bit % 64)) & 1;
+    }
+
+    static void SetBit(Bitmap& bitmap, size_t bit) {
+        std::atomic_ref{bitmap[bit / 64]}.fetch_or(u64{1} << (bit % 64),
+                                                   std::memory_order_release);
+    }
+
+    static u64 Exchange(Bitmap& bitmap, size_t word) {
+        // Loading first keeps untouched words on the shared zero page
+        std::atomic_ref atomic_word{bitmap[word]};
+        if (atomic_word.load(std::memory_order_relaxed) == 0) {
+            return 0;
+        }
+        return atomic_word.exchange(0, std::memory_order_acq_rel);
+    }
+
+    template <typename Op>
+    static void ForEachWordMask(size_t first, size_t count, Op&& op) {
+        const size_t end = first + count;
+        while (first < end) {
+            const size_t bit = first % 64;
+            const size_t bits = std::min<size_t>(64 - bit, end - first);
+            const u64 mask = (bits == 64 ? ~u64{0} : ((u64{1} << bits) - 1)) << bit;
+            op(first / 64, mask);
+            first += bits;
+        }
+    }
+
+    static void SetBits(Bitmap& bitmap, size_t first, size_t count) {
+        ForEachWordMask(first, count, [&bitmap](size_t word, u64 mask) {
+            std::atomic_ref{bitmap[word]}.fetch_or(mask, std::memory_order_release);
+        });
+    }
+
+    static void ClearBits(Bitmap& bitmap, size_t first, size_t count) {
+        ForEachWordMask(first, count, [&bitmap](size_t word, u64 mask) {
+            std::atomic_ref atomic_word{bitmap[word]};
+            if ((atomic_word.load(std::memory_order_relaxed) & mask) != 0) {
+                atomic_word.fetch_and(~mask, std::memory_order_release);
+            }
+        });
+    }
+
+    static bool UnprotectPage(u8* page);
+
+    u8* const base;
+    const size_t num_pages;
+    Bitmap owned;
+    Bitmap tracked;
+    Bitmap written;
+    Bitmap written_words;
+    Bitmap written_groups;
+    bool registered = false;
+};
+
+namespace {
+/// Returns true when a fault at address was handled by write tracking.
+bool HandleWriteFault(const void* address) {
+    for (const auto& slot : write_trackers) {
+        HostMemory::WriteTracker* const tracker = slot.load(std::memory_order_acquire);
+        if (tracker != nullptr && tracker->HandleFault(address)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void InstallWriteFaultHandler();
+} // Anonymous namespace
+
 #ifdef _WIN32
 
 // Manually imported for MinGW compatibility
@@ -343,6 +538,36 @@ private:
     std::unordered_map<size_t, size_t> placeholder_host_pointers; ///< Placeholder backing offset
 };
 
+bool HostMemory::WriteTracker::UnprotectPage(u8* page) {
+    DWORD old_flags{};
+    return VirtualProtect(page, PageAlignment, PAGE_READWRITE, &old_flags) != 0;
+}
+
+namespace {
+LONG WINAPI WriteFaultHandler(EXCEPTION_POINTERS* info) {
+    const EXCEPTION_RECORD& record = *info->ExceptionRecord;
+    // The first parameter of an access violation is 1 for writes, the second is the address
+    if (record.ExceptionCode != EXCEPTION_ACCESS_VIOLATION || record.NumberParameters < 2 ||
+        record.ExceptionInformation[0] != 1) {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+    if (!HandleWriteFault(reinterpret_cast<const void*>(record.ExceptionInformation[1]))) {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+    return EXCEPTION_CONTINUE_EXECUTION;
+}
+
+void InstallWriteFaultHandler() {
+    static std::once_flag flag;
+    std::call_once(flag, [] {
+        // Handle faults before any other handler, writes to tracked pages are expected
+        if (AddVectoredExceptionHandler(1, WriteFaultHandler) == nullptr) {
+            LOG_CRITICAL(HW_Memory, "Failed to install the write tracking exception handler");
+        }
+    });
+}
+} // Anonymous namespace
+
 #elif defined(__linux__) // ^^^ Windows ^^^ vvv Linux vvv
 
 class HostMemory::Impl {
@@ -449,6 +674,53 @@ private:
     int fd{-1}; // memfd file descriptor, -1 is the error value of memfd_create
 };
 
+bool HostMemory::WriteTracker::UnprotectPage(u8* page) {
+    return mprotect(page, PageAlignment, PROT_READ | PROT_WRITE) == 0;
+}
+
+namespace {
+struct sigaction previous_segv_action;
+
+void WriteFaultHandler(int sig, siginfo_t* info, void* raw_context) {
+    if (HandleWriteFault(info->si_addr)) {
+        return;
+    }
+    // Not ours, forward the fault to the handler installed before
+    if ((previous_segv_action.sa_flags & SA_SIGINFO) != 0) {
+        previous_segv_action.sa_sigaction(sig, info, raw_context);
+        return;
+    }
+    if (previous_segv_action.sa_handler == SIG_DFL || previous_segv_action.sa_handler == SIG_IGN) {
+        // Returning retries the faulting access, which now crashes with the default action
+        signal(sig, SIG_DFL);
+        return;
+    }
+    previous_segv_action.sa_handler(sig);
+}
+
+void InstallWriteFaultHandler() {
+    // Checked on every use rather than installed once on startup. The handler must run before the
+    // one of the JIT, which expects every fault in the fastmem arena to come from an unmapped page,
+    // and other handlers may have been installed on top of it since.
+    static std::mutex install_mutex;
+    std::scoped_lock lock{install_mutex};
+    struct sigaction current_action {};
+    if (sigaction(SIGSEGV, nullptr, &current_action) == 0 &&
+        (current_action.sa_flags & SA_SIGINFO) != 0 &&
+        current_action.sa_sigaction == WriteFaultHandler) {
+        return;
+    }
+    struct sigaction action {};
+    action.sa_sigaction = WriteFaultHandler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGSEGV, &action, &previous_segv_action) != 0) {
+        LOG_CRITICAL(HW_Memory, "Failed to install the write tracking signal handler: {}",
+                     strerror(errno));
+    }
+}
+} // Anonymous namespace
+
 #else // ^^^ Linux ^^^ vvv Generic vvv
 
 class HostMemory::Impl {
@@ -469,6 +741,14 @@ public:
     u8* virtual_base{nullptr};
 };
 
+bool HostMemory::WriteTracker::UnprotectPage(u8* page) {
+    return false;
+}
+
+namespace {
+void InstallWriteFaultHandler() {}
+} // Anonymous namespace
+
 #endif // ^^^ Generic ^^^
 
 HostMemory::HostMemory(size_t backing_size_, size_t virtual_size_)
@@ -486,6 +766,13 @@ HostMemory::HostMemory(size_t backing_size_, size_t virtual_size_)
             virtual_base += 2 * HugePageSize - 1;
             virtual_base -= reinterpret_cast<size_t>(virtual_base) & (HugePageSize - 1);
             virtual_base_offset = virtual_base - impl->virtual_base;
+
+            write_tracker =
+                std::make_unique<WriteTracker>(virtual_base, AlignUp(virtual_size, PageAlignment));
+            if (!write_tracker->IsRegistered()) {
+                LOG_WARNING(HW_Memory, "Too many instances to track writes");
+                write_tracker.reset();
+            }
         }
 
     } catch (const std::bad_alloc&) {
@@ -512,6 +799,10 @@ void HostMemory::Map(size_t virtual_offset, size_t host_offset, size_t length) {
     if (length == 0 || !virtual_base || !impl) {
         return;
     }
+    if (write_tracker) {
+        // The new protection replaces the one of write tracking
+        write_tracker->Disown(virtual_offset >> PageBits, length >> PageBits);
+    }
     impl->Map(virtual_offset + virtual_base_offset, host_offset, length);
 }
 
@@ -522,6 +813,10 @@ void HostMemory::Unmap(size_t virtual_offset, size_t length) {
     if (length == 0 || !virtual_base || !impl) {
         return;
     }
+    if (write_tracker) {
+        // The new protection replaces the one of write tracking
+        write_tracker->Disown(virtual_offset >> PageBits, length >> PageBits);
+    }
     impl->Unmap(virtual_offset + virtual_base_offset, length);
 }
 
@@ -532,7 +827,69 @@ void HostMemory::Protect(size_t virtual_offset, size_t length, bool read, bool w
     if (length == 0 || !virtual_base || !impl) {
         return;
     }
+    if (write_tracker) {
+        // The new protection replaces the one of write tracking
+        write_tracker->Disown(virtual_offset >> PageBits, length >> PageBits);
+    }
     impl->Protect(virtual_offset + virtual_base_offset, length, read, write);
 }
 
+void HostMemory::TrackWrites(size_t virtual_offset, size_t length) {
+    ASSERT(virtual_offset % PageAlignment == 0);
+    ASSERT(length % PageAlignment == 0);
+    ASSERT(virtual_offset + length <= virtual_size);
+    if (length == 0 || !write_tracker) {
+        return;
+    }
+    InstallWriteFaultHandler();
+    // Owned before protected, so a write right after protecting is not mistaken for a crash
+    write_tracker->Track(virtual_offset >> PageBits, length >> PageBits);
+    impl->Protect(virtual_offset + virtual_base_offset, length, true, false);
+}
+
+void HostMemory::UntrackWrites(size_t virtual_offset, size_t length) {
+    ASSERT(virtual_offset % PageAlignment == 0);
+    ASSERT(length % PageAlignment == 0);
+    ASSERT(virtual_offset + length <= virtual_size);
+    if (length == 0 || !write_tracker) {
+        return;
+    }
+    // Pages stay owned, a write that faulted before they were made writable is still handled
+    impl->Protect(virtual_offset + virtual_base_offset, length, true, true);
+    write_tracker->Untrack(virtual_offset >> PageBits, length >> PageBits);
+}
+
+std::vector<std::pair<size_t, size_t>> HostMemory::PopWrittenRanges() {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    if (!write_tracker) {
+        return ranges;
+    }
+    size_t protect_begin = 0;
+    size_t protect_end = 0;
+    const auto protect = [&] {
+        if (protect_begin != protect_end) {
+            impl->Protect(protect_begin + virtual_base_offset, protect_end - protect_begin, true,
+                          false);
+        }
+    };
+    write_tracker->PopWrittenPages([&](size_t page) {
+        const size_t offset = page << PageBits;
+        if (!ranges.empty() && ranges.back().first + ranges.back().second == offset) {
+            ranges.back().second += PageAlignment;
+        } else {
+            ranges.emplace_back(offset, PageAlignment);
+        }
+        if (!write_tracker->IsTracked(page)) {
+            return;
+        }
+        if (protect_end != offset) {
+            protect();
+            protect_begin = offset;
+        }
+        protect_end = offset + PageAlignment;
+    });
+    protect();
+    return ranges;
+}
+
 } // namespace Common
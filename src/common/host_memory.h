@@ -5,6 +5,8 @@
 #pragma once
 
 #include <memory>
+#include <utility>
+#include <vector>
 #include "common/common_types.h"
 #include "common/virtual_buffer.h"
 
@@ -38,6 +40,28 @@ public:
 
     void Protect(size_t virtual_offset, size_t length, bool read, bool write);
 
+    /**
+     * Write protects a range and records the pages written to it.
+     * The first write to a page faults, the fault handler marks the page as written and makes it
+     * writable again, so tracking costs one fault per page until the written pages are collected.
+     * Reads are not affected. Does nothing when fastmem is not available.
+     */
+    void TrackWrites(size_t virtual_offset, size_t length);
+
+    /// Stops tracking writes to a range and makes it writable again.
+    void UntrackWrites(size_t virtual_offset, size_t length);
+
+    /**
+     * Returns the ranges written since the last call as {virtual_offset, length} pairs, in
+     * ascending order. Written pages that are still tracked are write protected again.
+     */
+    [[nodiscard]] std::vector<std::pair<size_t, size_t>> PopWrittenRanges();
+
+    /// Returns whether writes to this memory can be tracked.
+    [[nodiscard]] bool IsWriteTrackingSupported() const noexcept {
+        return write_tracker != nullptr;
+    }
+
     [[nodiscard]] u8* BackingBasePointer() noexcept {
         return backing_base;
     }
@@ -52,6 +76,9 @@ public:
         return virtual_base;
     }
 
+    // Page state of write tracking, shared with the fault handler
+    class WriteTracker;
+
 private:
     size_t backing_size{};
     size_t virtual_size{};
@@ -65,6 +92,8 @@ private:
 
     // Fallback if fastmem is not supported on this platform
     std::unique_ptr<Common::VirtualBuffer<u8>> fallback_buffer;
+
+    std::unique_ptr<WriteTracker> write_tracker;
 };
 
 } // namespace Common
@@ -5,10 +5,10 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <climits>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <thread>
 #include <vector>
 
@@ -16,6 +16,7 @@
 #include <windows.h> // For OutputDebugStringW
 #endif
 
+#include "common/alignment.h"
 #include "common/assert.h"
 #include "common/fs/file.h"
 #include "common/fs/fs.h"
@@ -24,11 +25,209 @@
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
 #include "common/logging/text_formatter.h"
+#include "common/logging/trace.h"
+#include "common/logging/trace_file.h"
 #include "common/settings.h"
 #include "common/string_util.h"
 #include "common/threadsafe_queue.h"
 
 namespace Common::Log {
+namespace {
+using namespace Common::Literals;
+
+/// Header of a message in a LogRing, followed by its packed arguments. Trace events are queued as
+/// messages without formatter, format is the name of the event then.
+struct PackedMessage {
+    u32 size; ///< Size of the message and its arguments, 0 pads the end of the ring.
+    Class log_class;
+    Level log_level;
+    unsigned int line_num;
+    u32 thread_id;
+    const char* filename;
+    const char* function;
+    const char* format;
+    detail::PackedFormatter formatter;
+    std::chrono::steady_clock::time_point time;
+};
+
+/**
+ * Single producer, single consumer ring of packed messages. Each thread logging messages owns one,
+ * which is drained by the logging thread.
+ */
+class LogRing {
+public:
+    static constexpr std::size_t CAPACITY = 64_KiB;
+
+    /// Messages larger than this are formatted by the caller instead.
+    static constexpr std::size_t MAX_MESSAGE_SIZE = CAPACITY / 4;
+
+    u8* Reserve(std::size_t args_size) {
+        const std::size_t size = Common::AlignUp(sizeof(PackedMessage) + args_size, 8);
+        if (size > MAX_MESSAGE_SIZE) {
+            return nullptr;
+        }
+
+        u64 write = write_pos.load(std::memory_order_relaxed);
+        const std::size_t offset = static_cast<std::size_t>(write % CAPACITY);
+        const std::size_t padding = offset + size > CAPACITY ? CAPACITY - offset : 0;
+        if (write + padding + size - read_pos.load(std::memory_order_acquire) > CAPACITY) {
+            return nullptr;
+        }
+        if (padding != 0) {
+            // The message does not fit before the end of the ring, skip to its start
+            const u32 padding_marker = 0;
+            std::memcpy(buffer.data() + offset, &padding_marker, sizeof(padding_marker));
+            write += padding;
+        }
+
+        pending_pos = write;
+        pending_size = size;
+        return buffer.data() + write % CAPACITY + sizeof(PackedMessage);
+    }
+
+    void Commit(const PackedMessage& message) {
+        PackedMessage header = message;
+        header.size = static_cast<u32>(pending_size);
+        std::memcpy(buffer.data() + pending_pos % CAPACITY, &header, sizeof(header));
+        // Sequentially consistent so the logging thread either sees the message or is seen idle
+        write_pos.store(pending_pos + pending_size, std::memory_order_seq_cst);
+    }
+
+    bool HasMessages() const {
+        return read_pos.load(std::memory_order_relaxed) !=
+               write_pos.load(std::memory_order_seq_cst);
+    }
+
+    /// Calls func with each queued message and its arguments, then frees them.
+    template <typename Func>
+    void Drain(Func&& func) {
+        u64 read = read_pos.load(std::memory_order_relaxed);
+        const u64 end = write_pos.load(std::memory_order_acquire);
+        while (read < end) {
+            const std::size_t offset = static_cast<std::size_t>(read % CAPACITY);
+            PackedMessage message;
+            std::memcpy(&message.size, buffer.data() + offset, sizeof(message.size));
+            if (message.size == 0) {
+                read += CAPACITY - offset;
+                continue;
+            }
+            std::memcpy(&message, buffer.data() + offset, sizeof(message));
+            func(message, buffer.data() + offset + sizeof(PackedMessage));
+            read += message.size;
+        }
+        read_pos.store(read, std::memory_order_release);
+    }
+
+    /// Marks the ring as no longer used by its thread, it is dropped once drained.
+    void Close() {
+        closed.store(true, std::memory_order_release);
+    }
+
+    bool IsClosed() const {
+        return closed.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(8) std::array<u8, CAPACITY> buffer;
+    std::atomic<u64> write_pos{};
+    std::atomic<u64> read_pos{};
+    std::atomic_bool closed{};
+
+    // Only used by the owning thread
+    u64 pending_pos{};
+    std::size_t pending_size{};
+};
+
+/// Returns the id of the calling thread in log entries, threads are numbered as they first log.
+u32 GetThreadId() {
+    static std::atomic<u32> next_id{1};
+    thread_local const u32 id = next_id.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+/// String arguments of trace events are truncated to this size.
+constexpr std::size_t MAX_EVENT_STRING_SIZE = 0x100;
+
+std::string_view TruncateEventString(std::string_view string) {
+    return string.substr(0, MAX_EVENT_STRING_SIZE);
+}
+
+/// Returns the size of the duration, type and arguments of an event packed in a LogRing.
+std::size_t PackedEventSize(std::span<const Trace::Arg> args) {
+    std::size_t size = sizeof(s64) + sizeof(Trace::EventType) + sizeof(u8);
+    for (const Trace::Arg& arg : args) {
+        size += sizeof(const void*) + sizeof(Trace::ArgType);
+        if (arg.type == Trace::ArgType::String) {
+            size += detail::PackedSize(TruncateEventString(arg.string_value));
+        } else {
+            size += sizeof(u64);
+        }
+    }
+    return size;
+}
+
+void PackEvent(u8* out, Trace::EventType type, std::chrono::nanoseconds duration,
+               std::span<const Trace::Arg> args) {
+    detail::Pack(out, s64{duration.count()});
+    detail::Pack(out, type);
+    detail::Pack(out, static_cast<u8>(args.size()));
+    for (const Trace::Arg& arg : args) {
+        // Names are literals, only their address is copied
+        detail::Pack(out, static_cast<const void*>(arg.name));
+        detail::Pack(out, arg.type);
+        if (arg.type == Trace::ArgType::String) {
+            detail::Pack(out, TruncateEventString(arg.string_value));
+        } else {
+            // Copies the bits of the value whatever its type
+            detail::Pack(out, arg.unsigned_value);
+        }
+    }
+}
+
+Trace::Event UnpackEvent(const PackedMessage& message, const u8* in,
+                         std::chrono::steady_clock::time_point time_origin) {
+    Trace::Event event{
+        .timestamp = message.time - time_origin,
+        .duration = std::chrono::nanoseconds{detail::Unpack<s64>(in)},
+        .thread_id = message.thread_id,
+        .type = detail::Unpack<Trace::EventType>(in),
+        .category = message.log_class,
+        .name = message.format,
+        .args = {},
+    };
+    const u8 num_args = detail::Unpack<u8>(in);
+    event.args.reserve(num_args);
+    for (u8 i = 0; i < num_args; ++i) {
+        const char* const name = static_cast<const char*>(detail::Unpack<const void*>(in));
+        switch (detail::Unpack<Trace::ArgType>(in)) {
+        case Trace::ArgType::Signed:
+            event.args.push_back({name, detail::Unpack<s64>(in)});
+            break;
+        case Trace::ArgType::Unsigned:
+            event.args.push_back({name, detail::Unpack<u64>(in)});
+            break;
+        case Trace::ArgType::Float:
+            event.args.push_back({name, detail::Unpack<double>(in)});
+            break;
+        case Trace::ArgType::String:
+            event.args.push_back({name, std::string{detail::Unpack<std::string_view>(in)}});
+            break;
+        }
+    }
+    return event;
+}
+
+/// Closes the ring of a thread when the thread exits.
+struct LogRingOwner {
+    ~LogRingOwner() {
+        if (ring) {
+            ring->Close();
+        }
+    }
+
+    std::shared_ptr<LogRing> ring;
+};
+} // Anonymous namespace
 
 /**
  * Static state as a singleton.
@@ -48,8 +247,45 @@ public:
 
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, std::string message) {
-        message_queue.Push(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+        message_queue.Push(CreateEntry(log_class, log_level, filename, line_num, function,
+                                       std::move(message), std::chrono::steady_clock::now(),
+                                       GetThreadId()));
+        WakeBackend();
+    }
+
+    u8* ReservePackedMessage(std::size_t size) {
+        return GetThreadRing().Reserve(size);
+    }
+
+    void CommitPackedMessage(const PackedMessage& message) {
+        GetThreadRing().Commit(message);
+        WakeBackend();
+    }
+
+    bool RecordEvent(Trace::EventType type, Class category, const char* name,
+                     std::chrono::steady_clock::time_point time, std::chrono::nanoseconds duration,
+                     std::span<const Trace::Arg> args) {
+        args = args.first(std::min(args.size(), Trace::MAX_EVENT_ARGS));
+        LogRing& ring = GetThreadRing();
+        u8* const data = ring.Reserve(PackedEventSize(args));
+        if (data == nullptr) {
+            return false;
+        }
+        PackEvent(data, type, duration, args);
+        ring.Commit(PackedMessage{
+            .size = 0,
+            .log_class = category,
+            .log_level = Level::Trace,
+            .line_num = 0,
+            .thread_id = GetThreadId(),
+            .filename = nullptr,
+            .function = nullptr,
+            .format = name,
+            .formatter = nullptr,
+            .time = time,
+        });
+        WakeBackend();
+        return true;
     }
 
     void AddBackend(std::unique_ptr<Backend> backend) {
@@ -84,54 +320,144 @@ public:
 
 private:
     Impl() {
-        backend_thread = std::thread([&] {
-            Entry entry;
-            auto write_logs = [&](Entry& e) {
-                std::lock_guard lock{writing_mutex};
-                for (const auto& backend : backends) {
-                    backend->Write(e);
-                }
-            };
-            while (true) {
-                entry = message_queue.PopWait();
-                if (entry.final_entry) {
-                    break;
+        backend_thread = std::thread([this] {
+            std::vector<Entry> entries;
+            std::vector<Trace::Event> events;
+            while (!stop_backend) {
+                CollectEntries(entries, events);
+                if (entries.empty() && events.empty()) {
+                    WaitForEntries();
+                    continue;
                 }
-                write_logs(entry);
+                WriteEntries(entries, events);
             }
 
-            // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a
-            // case where a system is repeatedly spamming logs even on close.
-            const int MAX_LOGS_TO_WRITE = filter.IsDebug() ? INT_MAX : 100;
-            int logs_written = 0;
-            while (logs_written++ < MAX_LOGS_TO_WRITE && message_queue.Pop(entry)) {
-                write_logs(entry);
-            }
+            // Drain what was logged before shutting down, anything logged while draining is lost
+            CollectEntries(entries, events);
+            WriteEntries(entries, events);
         });
     }
 
     ~Impl() {
-        Entry entry;
-        entry.final_entry = true;
-        message_queue.Push(entry);
+        stop_backend = true;
+        {
+            std::scoped_lock lock{wake_mutex};
+        }
+        wake_condition.notify_one();
         backend_thread.join();
     }
 
-    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
-                      const char* function, std::string message) const {
-        using std::chrono::duration_cast;
-        using std::chrono::microseconds;
-        using std::chrono::steady_clock;
+    LogRing& GetThreadRing() {
+        thread_local LogRingOwner owner;
+        if (!owner.ring) {
+            owner.ring = std::make_shared<LogRing>();
+            std::scoped_lock lock{rings_mutex};
+            rings.push_back(owner.ring);
+        }
+        return *owner.ring;
+    }
+
+    void WakeBackend() {
+        if (!backend_idle.load(std::memory_order_seq_cst)) {
+            return;
+        }
+        {
+            std::scoped_lock lock{wake_mutex};
+        }
+        wake_condition.notify_one();
+    }
+
+    bool HasPendingEntries() {
+        if (!message_queue.Empty()) {
+            return true;
+        }
+        std::scoped_lock lock{rings_mutex};
+        return std::any_of(rings.begin(), rings.end(),
+                           [](const auto& ring) { return ring->HasMessages(); });
+    }
+
+    void WaitForEntries() {
+        backend_idle.store(true, std::memory_order_seq_cst);
+        {
+            // The timeout covers a wake up racing with the idle flag
+            std::unique_lock lock{wake_mutex};
+            wake_condition.wait_for(lock, std::chrono::milliseconds{100},
+                                    [this] { return stop_backend || HasPendingEntries(); });
+        }
+        backend_idle.store(false, std::memory_order_relaxed);
+    }
+
+    /// Moves every queued message to entries, in the order they were logged, and every queued
+    /// trace event to events.
+    void CollectEntries(std::vector<Entry>& entries, std::vector<Trace::Event>& events) {
+        entries.clear();
+        events.clear();
+        Entry entry;
+        while (message_queue.Pop(entry)) {
+            entries.push_back(std::move(entry));
+        }
+
+        {
+            std::scoped_lock lock{rings_mutex};
+            std::erase_if(rings, [&](const std::shared_ptr<LogRing>& ring) {
+                // A closed ring gets no more messages, it can be dropped once drained
+                const bool closed = ring->IsClosed();
+                ring->Drain([&](const PackedMessage& message, const u8* args) {
+                    if (message.formatter == nullptr) {
+                        events.push_back(UnpackEvent(message, args, time_origin));
+                        return;
+                    }
+                    entries.push_back(CreateEntry(message.log_class, message.log_level,
+                                                  message.filename, message.line_num,
+                                                  message.function, FormatPacked(message, args),
+                                                  message.time, message.thread_id));
+                });
+                return closed;
+            });
+        }
+
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+            return lhs.timestamp < rhs.timestamp;
+        });
+    }
+
+    void WriteEntries(const std::vector<Entry>& entries,
+                      const std::vector<Trace::Event>& events) {
+        std::lock_guard lock{writing_mutex};
+        for (const Entry& entry : entries) {
+            for (const auto& backend : backends) {
+                backend->Write(entry);
+            }
+        }
+        for (const Trace::Event& event : events) {
+            for (const auto& backend : backends) {
+                backend->WriteEvent(event);
+            }
+        }
+    }
+
+    static std::string FormatPacked(const PackedMessage& message, const u8* args) {
+        fmt::memory_buffer buffer;
+        try {
+            message.formatter(buffer, message.format, args);
+        } catch (const fmt::format_error& error) {
+            return fmt::format("Failed to format \"{}\": {}", message.format, error.what());
+        }
+        return fmt::to_string(buffer);
+    }
 
+    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
+                      const char* function, std::string message,
+                      std::chrono::steady_clock::time_point time, u32 thread_id) const {
         return {
-            .timestamp = duration_cast<microseconds>(steady_clock::now() - time_origin),
+            .timestamp = time - time_origin,
+            .thread_id = thread_id,
             .log_class = log_class,
             .log_level = log_level,
             .filename = filename,
             .line_num = line_nr,
             .function = function,
             .message = std::move(message),
-            .final_entry = false,
         };
     }
 
@@ -141,6 +467,14 @@ private:
     MPSCQueue<Entry> message_queue;
     Filter filter;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
+
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<LogRing>> rings;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake_condition;
+    std::atomic_bool backend_idle{};
+    std::atomic_bool stop_backend{};
 };
 
 ConsoleBackend::~ConsoleBackend() = default;
@@ -193,6 +527,27 @@ void FileBackend::Write(const Entry& entry) {
     }
 }
 
+TraceBackend::TraceBackend(const std::filesystem::path& filename) {
+    using namespace Common::Literals;
+    // Keeps about a million entries of typical length
+    constexpr std::size_t RING_SIZE = 256_MiB;
+
+    writer = std::make_unique<Trace::TraceWriter>(filename, RING_SIZE);
+    Trace::SetEnabled(writer->IsOpen());
+}
+
+TraceBackend::~TraceBackend() {
+    Trace::SetEnabled(false);
+}
+
+void TraceBackend::Write(const Entry& entry) {
+    writer->Write(entry);
+}
+
+void TraceBackend::WriteEvent(const Trace::Event& event) {
+    writer->WriteEvent(event);
+}
+
 DebuggerBackend::~DebuggerBackend() = default;
 
 void DebuggerBackend::Write(const Entry& entry) {
@@ -217,6 +572,49 @@ Backend* GetBackend(std::string_view backend_name) {
     return Impl::Instance().GetBackend(backend_name);
 }
 
+namespace detail {
+bool IsEnabled(Class log_class, Level log_level) {
+    return Impl::Instance().GetGlobalFilter().CheckMessage(log_class, log_level);
+}
+
+u8* ReservePackedMessage(std::size_t size) {
+    return Impl::Instance().ReservePackedMessage(size);
+}
+
+void CommitPackedMessage(Class log_class, Level log_level, const char* filename,
+                         unsigned int line_num, const char* function, const char* format,
+                         PackedFormatter formatter) {
+    Impl::Instance().CommitPackedMessage(PackedMessage{
+        .size = 0,
+        .log_class = log_class,
+        .log_level = log_level,
+        .line_num = line_num,
+        .thread_id = GetThreadId(),
+        .filename = filename,
+        .function = function,
+        .format = format,
+        .formatter = formatter,
+        .time = std::chrono::steady_clock::now(),
+    });
+}
+} // namespace detail
+
+namespace Trace {
+namespace detail {
+std::atomic_bool events_enabled{};
+
+bool RecordEvent(EventType type, Class category, const char* name,
+                 std::chrono::steady_clock::time_point time, std::chrono::nanoseconds duration,
+                 std::span<const Arg> args) {
+    return Impl::Instance().RecordEvent(type, category, name, time, duration, args);
+}
+} // namespace detail
+
+void SetEnabled(bool enabled) {
+    detail::events_enabled.store(enabled, std::memory_order_relaxed);
+}
+} // namespace Trace
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
@@ -10,6 +10,7 @@
 #include <string_view>
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
+#include "common/logging/trace.h"
 
 namespace Common::FS {
 class IOFile;
@@ -33,6 +34,9 @@ public:
     virtual const char* GetName() const = 0;
     virtual void Write(const Entry& entry) = 0;
 
+    /// Writes a trace event, they are only recorded by backends overriding this.
+    virtual void WriteEvent([[maybe_unused]] const Trace::Event& event) {}
+
 private:
     Filter filter;
 };
@@ -93,6 +97,35 @@ private:
     std::size_t bytes_written = 0;
 };
 
+namespace Trace {
+class TraceWriter;
+}
+
+/**
+ * Backend that records entries in binary form to a trace file passed into the constructor. The file
+ * is a ring keeping the most recent entries, it can be converted with yuzu-trace-converter. Trace
+ * events are recorded while the backend exists.
+ */
+class TraceBackend : public Backend {
+public:
+    explicit TraceBackend(const std::filesystem::path& filename);
+    ~TraceBackend() override;
+
+    static const char* Name() {
+        return "trace";
+    }
+
+    const char* GetName() const override {
+        return Name();
+    }
+
+    void Write(const Entry& entry) override;
+    void WriteEvent(const Trace::Event& event) override;
+
+private:
+    std::unique_ptr<Trace::TraceWriter> writer;
+};
+
 /**
  * Backend that writes to Visual Studio's output window
  */
@@ -4,11 +4,58 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 #include <fmt/format.h>
 #include "common/logging/types.h"
 
+// Lowest level compiled in, messages below it are removed at compile time along with the
+// evaluation of their arguments. Set through the YUZU_LOG_MIN_LEVEL CMake option.
+#ifndef YUZU_LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define YUZU_LOG_MIN_LEVEL Trace
+#else
+#define YUZU_LOG_MIN_LEVEL Debug
+#endif
+#endif
+
+// Per class overrides of YUZU_LOG_MIN_LEVEL, as a list of {Class::X,Level::Y}, entries. Set through
+// the YUZU_LOG_CLASS_MIN_LEVELS CMake option.
+#ifndef YUZU_LOG_CLASS_MIN_LEVELS
+#define YUZU_LOG_CLASS_MIN_LEVELS
+#endif
+
 namespace Common::Log {
 
+/// Lowest level compiled in for each class.
+inline constexpr auto COMPILED_MIN_LEVELS = [] {
+    std::array<Level, static_cast<std::size_t>(Class::Count)> levels{};
+    levels.fill(Level::YUZU_LOG_MIN_LEVEL);
+
+    constexpr std::pair<Class, Level> overrides[]{
+        YUZU_LOG_CLASS_MIN_LEVELS{Class::Count, Level::Count},
+    };
+    for (const auto& [log_class, log_level] : overrides) {
+        if (log_class != Class::Count) {
+            levels[static_cast<std::size_t>(log_class)] = log_level;
+        }
+    }
+    return levels;
+}();
+
+/// Returns whether messages of a class and level are compiled in.
+constexpr bool IsLevelCompiledIn(Class log_class, Level log_level) {
+    return log_level >= COMPILED_MIN_LEVELS[static_cast<std::size_t>(log_class)];
+}
+
 // trims up to and including the last of ../, ..\, src/, src\ in a string
 constexpr const char* TrimSourcePath(std::string_view source) {
     const auto rfind = [source](const std::string_view match) {
@@ -23,41 +70,137 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
 
+namespace detail {
+
+// Messages whose arguments are all strings or plain values are not formatted by the caller. The
+// arguments are copied into a per thread ring along with the format string, and formatted by the
+// logging thread.
+
+/// Formats the arguments packed after a message, out is the formatted message.
+using PackedFormatter = void (*)(fmt::memory_buffer& out, const char* format, const u8* args);
+
+template <typename T>
+constexpr bool IsPackedString =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+template <typename T>
+constexpr bool IsPackedValue = std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+                               std::is_same_v<T, const void*> || std::is_same_v<T, void*>;
+
+template <typename T>
+constexpr bool IsPackable = IsPackedString<std::decay_t<T>> || IsPackedValue<std::decay_t<T>>;
+
+template <typename T>
+std::string_view ToStringView(const T& value) {
+    if constexpr (std::is_pointer_v<std::decay_t<T>>) {
+        return value != nullptr ? std::string_view{value} : std::string_view{};
+    } else {
+        return std::string_view{value};
+    }
+}
+
+template <typename T>
+std::size_t PackedSize(const T& value) {
+    if constexpr (IsPackedString<std::decay_t<T>>) {
+        return sizeof(u32) + ToStringView(value).size();
+    } else {
+        return sizeof(T);
+    }
+}
+
+template <typename T>
+void Pack(u8*& out, const T& value) {
+    if constexpr (IsPackedString<std::decay_t<T>>) {
+        const std::string_view string = ToStringView(value);
+        const u32 size = static_cast<u32>(string.size());
+        std::memcpy(out, &size, sizeof(size));
+        std::memcpy(out + sizeof(size), string.data(), size);
+        out += sizeof(size) + size;
+    } else {
+        std::memcpy(out, &value, sizeof(T));
+        out += sizeof(T);
+    }
+}
+
+template <typename T>
+auto Unpack(const u8*& in) {
+    if constexpr (IsPackedString<T>) {
+        u32 size;
+        std::memcpy(&size, in, sizeof(size));
+        const std::string_view string{reinterpret_cast<const char*>(in + sizeof(size)), size};
+        in += sizeof(size) + size;
+        return string;
+    } else {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        return value;
+    }
+}
+
+template <typename... Args>
+void FormatPacked(fmt::memory_buffer& out, const char* format, const u8* args) {
+    // Braced initialization unpacks the arguments in order
+    const std::tuple<decltype(Unpack<Args>(args))...> values{Unpack<Args>(args)...};
+    std::apply(
+        [&out, format](const auto&... unpacked) {
+            fmt::vformat_to(std::back_inserter(out), fmt::string_view{format},
+                            fmt::make_format_args(unpacked...));
+        },
+        values);
+}
+
+/// Returns whether the global filter lets messages of a class and level through.
+bool IsEnabled(Class log_class, Level log_level);
+
+/// Reserves size bytes in the ring of the calling thread for the arguments of a message.
+/// Returns nullptr when the ring has no room, the message has to be formatted by the caller then.
+u8* ReservePackedMessage(std::size_t size);
+
+/// Queues the message reserved last by the calling thread, once its arguments are packed.
+void CommitPackedMessage(Class log_class, Level log_level, const char* filename,
+                         unsigned int line_num, const char* function, const char* format,
+                         PackedFormatter formatter);
+
+} // namespace detail
+
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, const char* format, const Args&... args) {
+    if constexpr ((detail::IsPackable<Args> && ...)) {
+        if (!detail::IsEnabled(log_class, log_level)) {
+            return;
+        }
+        const std::size_t size = (std::size_t{0} + ... + detail::PackedSize(args));
+        if (u8* data = detail::ReservePackedMessage(size)) {
+            (detail::Pack(data, args), ...);
+            detail::CommitPackedMessage(log_class, log_level, filename, line_num, function, format,
+                                        &detail::FormatPacked<std::decay_t<Args>...>);
+            return;
+        }
+    }
     FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
                       fmt::make_format_args(args...));
 }
 
 } // namespace Common::Log
 
-#ifdef _DEBUG
-#define LOG_TRACE(log_class, ...)                                                                  \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Trace,           \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#else
-#define LOG_TRACE(log_class, fmt, ...) (void(0))
-#endif
+// The format string must be a literal, as it may be read by the logging thread after the call.
+#define LOG_GENERIC(log_class, log_level, ...)                                                     \
+    do {                                                                                           \
+        if constexpr (Common::Log::IsLevelCompiledIn(Common::Log::Class::log_class,               \
+                                                     Common::Log::Level::log_level)) {             \
+            constexpr const char* log_source_path = Common::Log::TrimSourcePath(__FILE__);        \
+            Common::Log::FmtLogMessage(Common::Log::Class::log_class,                              \
+                                       Common::Log::Level::log_level, log_source_path, __LINE__,  \
+                                       __func__, "" __VA_ARGS__);                                  \
+        }                                                                                          \
+    } while (0)
 
-#define LOG_DEBUG(log_class, ...)                                                                  \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Debug,           \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#define LOG_INFO(log_class, ...)                                                                   \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Info,            \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#define LOG_WARNING(log_class, ...)                                                                \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Warning,         \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#define LOG_ERROR(log_class, ...)                                                                  \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Error,           \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#define LOG_CRITICAL(log_class, ...)                                                               \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Critical,        \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
+#define LOG_TRACE(log_class, ...) LOG_GENERIC(log_class, Trace, __VA_ARGS__)
+#define LOG_DEBUG(log_class, ...) LOG_GENERIC(log_class, Debug, __VA_ARGS__)
+#define LOG_INFO(log_class, ...) LOG_GENERIC(log_class, Info, __VA_ARGS__)
+#define LOG_WARNING(log_class, ...) LOG_GENERIC(log_class, Warning, __VA_ARGS__)
+#define LOG_ERROR(log_class, ...) LOG_GENERIC(log_class, Error, __VA_ARGS__)
+#define LOG_CRITICAL(log_class, ...) LOG_GENERIC(log_class, Critical, __VA_ARGS__)
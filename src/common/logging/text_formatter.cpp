@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <chrono>
 #include <cstdio>
 
 #ifdef _WIN32
@@ -19,8 +20,9 @@
 namespace Common::Log {
 
 std::string FormatLogMessage(const Entry& entry) {
-    unsigned int time_seconds = static_cast<unsigned int>(entry.timestamp.count() / 1000000);
-    unsigned int time_fractional = static_cast<unsigned int>(entry.timestamp.count() % 1000000);
+    const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(entry.timestamp);
+    unsigned int time_seconds = static_cast<unsigned int>(timestamp.count() / 1000000);
+    unsigned int time_fractional = static_cast<unsigned int>(timestamp.count() % 1000000);
 
     const char* class_name = GetLogClassName(entry.log_class);
     const char* level_name = GetLevelName(entry.log_level);
@@ -0,0 +1,171 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/logging/types.h"
+
+namespace Common::Log::Trace {
+
+// Trace events time spans of the emulator, such as SVCs, IPC commands or GPU methods, with a few
+// typed arguments. Unlike log messages they are not removed by YUZU_LOG_MIN_LEVEL nor filtered,
+// they are recorded whenever a trace backend is open and go only to it.
+
+/// Maximum number of arguments of an event, the ones after it are dropped.
+constexpr std::size_t MAX_EVENT_ARGS = 4;
+
+enum class EventType : u8 {
+    Complete, ///< Span of time, recorded once it ends.
+    Instant,
+};
+
+/// Type of an argument value, matches the index of its alternative in ArgValue.
+enum class ArgType : u8 {
+    Signed,
+    Unsigned,
+    Float,
+    String,
+};
+
+using ArgValue = std::variant<s64, u64, double, std::string>;
+
+/// Named argument of an event. The name must be a literal, string values are copied when the
+/// event is recorded.
+struct Arg {
+    Arg() = default;
+
+    template <typename T>
+    requires std::is_integral_v<T> || std::is_enum_v<T> Arg(const char* name_, T value)
+        : name{name_} {
+        using Value = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
+                                                  std::type_identity<T>>::type;
+        if constexpr (std::is_signed_v<Value>) {
+            type = ArgType::Signed;
+            signed_value = static_cast<s64>(value);
+        } else {
+            type = ArgType::Unsigned;
+            unsigned_value = static_cast<u64>(value);
+        }
+    }
+
+    Arg(const char* name_, double value) : name{name_}, type{ArgType::Float}, float_value{value} {}
+
+    Arg(const char* name_, std::string_view value)
+        : name{name_}, type{ArgType::String}, string_value{value} {}
+
+    const char* name = nullptr;
+    ArgType type = ArgType::Unsigned;
+    union {
+        s64 signed_value;
+        u64 unsigned_value = 0;
+        double float_value;
+    };
+    std::string_view string_value;
+};
+
+/// Argument of an event handed to the backends.
+struct EventArg {
+    const char* name;
+    ArgValue value;
+};
+
+/// Event handed to the backends by the logging thread.
+struct Event {
+    std::chrono::nanoseconds timestamp; ///< Start of the event since the start of the log.
+    std::chrono::nanoseconds duration;
+    u32 thread_id;
+    EventType type;
+    Class category;
+    const char* name;
+    std::vector<EventArg> args;
+};
+
+namespace detail {
+extern std::atomic_bool events_enabled;
+
+/// Queues an event in the ring of the calling thread, returns false if it had no room.
+bool RecordEvent(EventType type, Class category, const char* name,
+                 std::chrono::steady_clock::time_point time, std::chrono::nanoseconds duration,
+                 std::span<const Arg> args);
+} // namespace detail
+
+/// Returns whether events are being recorded.
+inline bool IsEnabled() {
+    return detail::events_enabled.load(std::memory_order_relaxed);
+}
+
+/// Enables recording events, done by the trace backend while its file is open.
+void SetEnabled(bool enabled);
+
+/// Records an instant event, string arguments are copied.
+inline void RecordInstant(Class category, const char* name, std::initializer_list<Arg> args) {
+    if (IsEnabled()) {
+        detail::RecordEvent(EventType::Instant, category, name, std::chrono::steady_clock::now(),
+                            {}, args);
+    }
+}
+
+/**
+ * Records the lifetime of the object as a complete event. A single event is recorded when the
+ * scope ends, so fibers switching inside the scope can not mismatch its begin and end. String
+ * arguments are referenced until then and must outlive the object.
+ */
+class ScopedEvent {
+public:
+    ScopedEvent(Class category_, const char* name_, std::initializer_list<Arg> args_)
+        : enabled{IsEnabled()} {
+        if (!enabled) {
+            return;
+        }
+        category = category_;
+        name = name_;
+        num_args = std::min(args_.size(), MAX_EVENT_ARGS);
+        std::copy_n(args_.begin(), num_args, args.begin());
+        begin = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedEvent() {
+        if (enabled) {
+            const auto end = std::chrono::steady_clock::now();
+            detail::RecordEvent(EventType::Complete, category, name, begin, end - begin,
+                                std::span{args.data(), num_args});
+        }
+    }
+
+    ScopedEvent(const ScopedEvent&) = delete;
+    ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+private:
+    bool enabled;
+    Class category{};
+    const char* name = nullptr;
+    std::size_t num_args = 0;
+    std::array<Arg, MAX_EVENT_ARGS> args;
+    std::chrono::steady_clock::time_point begin;
+};
+
+} // namespace Common::Log::Trace
+
+// Event names must point to string literals, arguments are given as {"name", value} pairs after
+// them.
+#define TRACE_SCOPE(log_class, name, ...)                                                          \
+    const Common::Log::Trace::ScopedEvent CONCAT2(trace_scope_, __LINE__)(                         \
+        Common::Log::Class::log_class, name, {__VA_ARGS__})
+
+#define TRACE_INSTANT(log_class, name, ...)                                                        \
+    Common::Log::Trace::RecordInstant(Common::Log::Class::log_class, name, {__VA_ARGS__})
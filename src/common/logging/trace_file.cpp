@@ -0,0 +1,402 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "common/alignment.h"
+#include "common/fs/file.h"
+#include "common/logging/trace_file.h"
+
+namespace Common::Log::Trace {
+namespace {
+/// Space reserved for the file header, the string table starts after it.
+constexpr u64 HEADER_SIZE = 0x1000;
+
+/// Messages are truncated to keep records well under the chunk size.
+constexpr std::size_t MAX_MESSAGE_SIZE = 0x2000;
+
+/// Reads the duration and arguments of an event record, returns std::nullopt if they are corrupt.
+template <typename GetString>
+std::optional<TraceEntry> ReadEvent(const RecordHeader& record, const u8* message,
+                                    const GetString& get_string) {
+    const u8* const end = message + record.message_size;
+    const auto read = [&message, end](auto& value) {
+        if (static_cast<std::size_t>(end - message) < sizeof(value)) {
+            return false;
+        }
+        std::memcpy(&value, message, sizeof(value));
+        message += sizeof(value);
+        return true;
+    };
+
+    TraceEntry entry{
+        .type = record.type,
+        .timestamp = std::chrono::nanoseconds{record.timestamp},
+        .thread_id = record.thread_id,
+        .log_class = record.log_class,
+        .log_level = record.log_level,
+        .filename = {},
+        .function = get_string(record.function_id),
+        .line_num = 0,
+        .message = {},
+        .duration = {},
+        .args = {},
+    };
+    s64 duration;
+    if (!read(duration)) {
+        return std::nullopt;
+    }
+    entry.duration = std::chrono::nanoseconds{duration};
+
+    for (u8 i = 0; i < record.num_args; ++i) {
+        u32 name_id;
+        ArgType type;
+        if (!read(name_id) || !read(type)) {
+            return std::nullopt;
+        }
+        TraceArg& arg = entry.args.emplace_back(TraceArg{.name = get_string(name_id), .value = {}});
+        switch (type) {
+        case ArgType::Signed:
+        case ArgType::Unsigned:
+        case ArgType::Float: {
+            u64 bits;
+            if (!read(bits)) {
+                return std::nullopt;
+            }
+            if (type == ArgType::Signed) {
+                arg.value = static_cast<s64>(bits);
+            } else if (type == ArgType::Unsigned) {
+                arg.value = bits;
+            } else {
+                double value;
+                std::memcpy(&value, &bits, sizeof(value));
+                arg.value = value;
+            }
+            break;
+        }
+        case ArgType::String: {
+            u32 size;
+            if (!read(size) || static_cast<std::size_t>(end - message) < size) {
+                return std::nullopt;
+            }
+            arg.value = std::string(reinterpret_cast<const char*>(message), size);
+            message += size;
+            break;
+        }
+        default:
+            return std::nullopt;
+        }
+    }
+    return entry;
+}
+} // Anonymous namespace
+
+TraceWriter::TraceWriter(const std::filesystem::path& path, u64 ring_size) {
+    ring_size = std::max(Common::AlignUp(ring_size, CHUNK_SIZE), CHUNK_SIZE * 2);
+    const u64 ring_offset = HEADER_SIZE + STRING_TABLE_SIZE;
+    file_size = ring_offset + ring_size;
+
+    // The file is mapped rather than written so entries reach it even if the process crashes
+#ifdef _WIN32
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                                    nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    file_handle = file;
+    mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(file_size >> 32),
+                                        static_cast<DWORD>(file_size), nullptr);
+    if (mapping_handle == nullptr) {
+        return;
+    }
+    base = static_cast<u8*>(MapViewOfFile(mapping_handle, FILE_MAP_WRITE, 0, 0, 0));
+#else
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        return;
+    }
+    if (ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+        return;
+    }
+    void* const map = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        return;
+    }
+    base = static_cast<u8*>(map);
+#endif
+    if (base == nullptr) {
+        return;
+    }
+
+    header = reinterpret_cast<FileHeader*>(base);
+    *header = FileHeader{
+        .magic = TRACE_MAGIC,
+        .version = TRACE_VERSION,
+        .string_table_offset = HEADER_SIZE,
+        .string_table_size = STRING_TABLE_SIZE,
+        .ring_offset = ring_offset,
+        .ring_size = ring_size,
+        .chunk_size = CHUNK_SIZE,
+        .start_time = 0,
+        .strings_used = 0,
+        .ring_head = 0,
+    };
+}
+
+TraceWriter::~TraceWriter() {
+#ifdef _WIN32
+    if (base != nullptr) {
+        FlushViewOfFile(base, 0);
+        UnmapViewOfFile(base);
+    }
+    if (mapping_handle != nullptr) {
+        CloseHandle(mapping_handle);
+    }
+    if (file_handle != nullptr) {
+        CloseHandle(file_handle);
+    }
+#else
+    if (base != nullptr) {
+        munmap(base, file_size);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+#endif
+}
+
+void TraceWriter::Write(const Entry& entry) {
+    if (!IsOpen()) {
+        return;
+    }
+    const std::size_t message_size = std::min(entry.message.size(), MAX_MESSAGE_SIZE);
+    WriteRecord(
+        RecordHeader{
+            .size = 0,
+            .thread_id = entry.thread_id,
+            .timestamp = entry.timestamp.count(),
+            .filename_id = GetLiteralId(entry.filename),
+            .function_id = GetStringId(entry.function),
+            .line_num = entry.line_num,
+            .message_size = static_cast<u32>(message_size),
+            .log_class = entry.log_class,
+            .log_level = entry.log_level,
+            .type = RecordType::Message,
+            .num_args = 0,
+            .padding = 0,
+        },
+        reinterpret_cast<const u8*>(entry.message.data()), message_size);
+}
+
+void TraceWriter::WriteEvent(const Event& event) {
+    if (!IsOpen()) {
+        return;
+    }
+    const auto append = [this](const auto& value) {
+        const auto* const bytes = reinterpret_cast<const u8*>(&value);
+        event_buffer.insert(event_buffer.end(), bytes, bytes + sizeof(value));
+    };
+    event_buffer.clear();
+    append(s64{event.duration.count()});
+    for (const EventArg& arg : event.args) {
+        append(GetLiteralId(arg.name));
+        append(static_cast<ArgType>(arg.value.index()));
+        std::visit(
+            [&](const auto& value) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(value)>, std::string>) {
+                    append(static_cast<u32>(value.size()));
+                    event_buffer.insert(event_buffer.end(), value.begin(), value.end());
+                } else {
+                    append(value);
+                }
+            },
+            arg.value);
+    }
+
+    WriteRecord(
+        RecordHeader{
+            .size = 0,
+            .thread_id = event.thread_id,
+            .timestamp = event.timestamp.count(),
+            .filename_id = INVALID_STRING_ID,
+            .function_id = GetLiteralId(event.name),
+            .line_num = 0,
+            .message_size = static_cast<u32>(event_buffer.size()),
+            .log_class = event.category,
+            .log_level = Level::Trace,
+            .type = event.type == EventType::Complete ? RecordType::CompleteEvent
+                                                      : RecordType::InstantEvent,
+            .num_args = static_cast<u8>(event.args.size()),
+            .padding = 0,
+        },
+        event_buffer.data(), event_buffer.size());
+}
+
+void TraceWriter::WriteRecord(RecordHeader record, const u8* message, std::size_t message_size) {
+    if (header->start_time == 0) {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        header->start_time =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - record.timestamp;
+    }
+
+    const u64 size = Common::AlignUp(sizeof(RecordHeader) + message_size, 8);
+    record.size = static_cast<u32>(size);
+
+    u64 head = header->ring_head;
+    const u64 chunk_offset = head % CHUNK_SIZE;
+    if (chunk_offset + size > CHUNK_SIZE) {
+        // End the chunk, the record starts the next one
+        if (chunk_offset + sizeof(u32) <= CHUNK_SIZE) {
+            const u32 end_marker = 0;
+            std::memcpy(base + header->ring_offset + head % header->ring_size, &end_marker,
+                        sizeof(end_marker));
+        }
+        head += CHUNK_SIZE - chunk_offset;
+    }
+
+    u8* const out = base + header->ring_offset + head % header->ring_size;
+    std::memcpy(out, &record, sizeof(record));
+    std::memcpy(out + sizeof(record), message, message_size);
+
+    // Publish the record once it is complete
+    header->ring_head = head + size;
+}
+
+u32 TraceWriter::GetLiteralId(const char* string) {
+    // A string that did not fit keeps INVALID_STRING_ID, it is not interned again
+    const auto [it, inserted] = literal_ids.try_emplace(string, INVALID_STRING_ID);
+    if (inserted) {
+        it->second = InternString(string != nullptr ? string : "");
+    }
+    return it->second;
+}
+
+u32 TraceWriter::GetStringId(const std::string& string) {
+    const auto [it, inserted] = string_ids.try_emplace(string, INVALID_STRING_ID);
+    if (inserted) {
+        it->second = InternString(string);
+    }
+    return it->second;
+}
+
+u32 TraceWriter::InternString(std::string_view string) {
+    const u64 size = sizeof(u32) + string.size();
+    if (header->strings_used + size > header->string_table_size) {
+        return INVALID_STRING_ID;
+    }
+    u8* const out = base + header->string_table_offset + header->strings_used;
+    const u32 length = static_cast<u32>(string.size());
+    std::memcpy(out, &length, sizeof(length));
+    std::memcpy(out + sizeof(length), string.data(), string.size());
+
+    const u32 id = static_cast<u32>(header->strings_used);
+    header->strings_used += size;
+    return id;
+}
+
+std::optional<TraceFile> ReadTraceFile(const std::filesystem::path& path) {
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                            Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return std::nullopt;
+    }
+
+    FileHeader header{};
+    if (!file.ReadObject(header) || header.magic != TRACE_MAGIC ||
+        header.version != TRACE_VERSION) {
+        return std::nullopt;
+    }
+    const u64 file_size = file.GetSize();
+    if (header.chunk_size < sizeof(RecordHeader) || header.ring_size % header.chunk_size != 0 ||
+        header.strings_used > header.string_table_size ||
+        header.string_table_offset + header.string_table_size > file_size ||
+        header.ring_offset + header.ring_size > file_size) {
+        return std::nullopt;
+    }
+
+    std::vector<u8> strings(static_cast<std::size_t>(header.strings_used));
+    std::vector<u8> ring(static_cast<std::size_t>(header.ring_size));
+    if (!file.Seek(static_cast<s64>(header.string_table_offset)) ||
+        file.ReadSpan<u8>(strings) != strings.size() ||
+        !file.Seek(static_cast<s64>(header.ring_offset)) ||
+        file.ReadSpan<u8>(ring) != ring.size()) {
+        return std::nullopt;
+    }
+
+    const auto get_string = [&strings](u32 id) -> std::string {
+        u32 length;
+        if (id == INVALID_STRING_ID || u64{id} + sizeof(length) > strings.size()) {
+            return "?";
+        }
+        std::memcpy(&length, strings.data() + id, sizeof(length));
+        if (u64{id} + sizeof(length) + length > strings.size()) {
+            return "?";
+        }
+        return std::string(reinterpret_cast<const char*>(strings.data() + id + sizeof(length)),
+                           length);
+    };
+
+    // The chunk being written replaced the oldest one, skip what is left of the latter
+    const u64 head = header.ring_head;
+    u64 position = head > header.ring_size
+                       ? Common::AlignUp(head - header.ring_size, header.chunk_size)
+                       : 0;
+
+    TraceFile trace{.start_time = header.start_time, .entries = {}};
+    while (position < head) {
+        const u64 chunk_offset = position % header.chunk_size;
+        const u64 chunk_end = position - chunk_offset + header.chunk_size;
+
+        RecordHeader record{};
+        if (chunk_offset + sizeof(record) <= header.chunk_size) {
+            std::memcpy(&record, ring.data() + position % header.ring_size, sizeof(record));
+        }
+        if (record.size == 0) {
+            position = chunk_end;
+            continue;
+        }
+        if (record.size < sizeof(record) + record.message_size || position + record.size > head ||
+            chunk_offset + record.size > header.chunk_size || record.log_class >= Class::Count ||
+            record.log_level >= Level::Count || record.type >= RecordType::Count) {
+            // Corrupt record, nothing else in the chunk can be trusted
+            position = chunk_end;
+            continue;
+        }
+
+        const u8* const message = ring.data() + position % header.ring_size + sizeof(record);
+        position += record.size;
+        if (record.type != RecordType::Message) {
+            if (auto event = ReadEvent(record, message, get_string)) {
+                trace.entries.push_back(std::move(*event));
+            }
+            continue;
+        }
+        trace.entries.push_back(TraceEntry{
+            .type = RecordType::Message,
+            .timestamp = std::chrono::nanoseconds{record.timestamp},
+            .thread_id = record.thread_id,
+            .log_class = record.log_class,
+            .log_level = record.log_level,
+            .filename = get_string(record.filename_id),
+            .function = get_string(record.function_id),
+            .line_num = record.line_num,
+            .message = std::string(reinterpret_cast<const char*>(message), record.message_size),
+            .duration = {},
+            .args = {},
+        });
+    }
+    return trace;
+}
+
+} // namespace Common::Log::Trace
@@ -0,0 +1,165 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "common/logging/trace.h"
+#include "common/logging/types.h"
+
+namespace Common::Log::Trace {
+
+// A trace file holds the most recent log entries in binary form, so entries can be recorded at a
+// high rate without formatting them as text. The file is mapped in memory while recording and is
+// laid out as a header, a table of the interned file and function names and a ring of chunks:
+//
+//   [FileHeader][string table][chunk 0][chunk 1]...[chunk N-1]
+//
+// Each chunk holds whole records. A record that does not fit in the rest of a chunk starts the
+// next one, the ring wraps around by overwriting its oldest chunk. Entries can be read back with
+// ReadTraceFile, even from the file of a process that crashed while recording.
+//
+// Trace events are records too. Their function is the name of the event, their message holds the
+// duration of the event in nanoseconds followed by the arguments, each one as the id of its name,
+// its ArgType and its value: 8 bytes, or the 4 bytes size of a string followed by the string.
+
+constexpr u32 TRACE_MAGIC = Common::MakeMagic('Y', 'L', 'O', 'G');
+constexpr u32 TRACE_VERSION = 2;
+
+constexpr u32 INVALID_STRING_ID = 0xFFFFFFFF;
+
+struct FileHeader {
+    u32 magic;
+    u32 version;
+    u64 string_table_offset;
+    u64 string_table_size;
+    u64 ring_offset;
+    u64 ring_size;
+    u64 chunk_size;
+    /// Wall clock time of the start of the log in nanoseconds since the Unix epoch, estimated
+    /// when the first entry is recorded.
+    s64 start_time;
+    /// Bytes used in the string table.
+    u64 strings_used;
+    /// Bytes ever written to the ring, records are complete up to this position.
+    u64 ring_head;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+enum class RecordType : u8 {
+    Message,
+    CompleteEvent,
+    InstantEvent,
+    Count,
+};
+
+/// Header of a record in a chunk, followed by its message. A size of 0 ends the chunk.
+struct RecordHeader {
+    u32 size; ///< Size of the record and its message, aligned to 8 bytes.
+    u32 thread_id;
+    s64 timestamp; ///< Nanoseconds since the start of the log.
+    u32 filename_id;
+    u32 function_id;
+    u32 line_num;
+    u32 message_size;
+    Class log_class;
+    Level log_level;
+    RecordType type;
+    u8 num_args; ///< Number of arguments of an event.
+    u32 padding;
+};
+static_assert(sizeof(RecordHeader) == 40);
+static_assert(std::is_trivially_copyable_v<RecordHeader>);
+
+/**
+ * Records log entries to a trace file. Not thread safe, it is written by the logging thread.
+ */
+class TraceWriter {
+public:
+    static constexpr u64 STRING_TABLE_SIZE = 1ULL << 20;
+    static constexpr u64 CHUNK_SIZE = 64ULL << 10;
+
+    /// Creates the file at path, replacing any previous one, with a ring of ring_size bytes.
+    explicit TraceWriter(const std::filesystem::path& path, u64 ring_size);
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    /// Returns whether the file is mapped and entries can be recorded.
+    [[nodiscard]] bool IsOpen() const {
+        return base != nullptr;
+    }
+
+    void Write(const Entry& entry);
+    void WriteEvent(const Event& event);
+
+private:
+    /// Appends a record followed by its message to the ring.
+    void WriteRecord(RecordHeader record, const u8* message, std::size_t message_size);
+
+    /// Returns the id of a literal string, interning it the first time.
+    u32 GetLiteralId(const char* string);
+
+    /// Returns the id of a string, interning it the first time.
+    u32 GetStringId(const std::string& string);
+
+    u32 InternString(std::string_view string);
+
+    u8* base = nullptr;
+    u64 file_size = 0;
+    FileHeader* header = nullptr;
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    std::unordered_map<const char*, u32> literal_ids;
+    std::unordered_map<std::string, u32> string_ids;
+    std::vector<u8> event_buffer;
+};
+
+/// Argument of a trace event read back from a trace file.
+struct TraceArg {
+    std::string name;
+    ArgValue value;
+};
+
+/// Log entry or trace event read back from a trace file.
+struct TraceEntry {
+    RecordType type;
+    std::chrono::nanoseconds timestamp;
+    u32 thread_id;
+    Class log_class;
+    Level log_level;
+    std::string filename;
+    std::string function;
+    u32 line_num;
+    std::string message;
+    std::chrono::nanoseconds duration; ///< Duration of a complete event.
+    std::vector<TraceArg> args;        ///< Arguments of an event.
+};
+
+struct TraceFile {
+    /// Wall clock time of the start of the log, in nanoseconds since the Unix epoch.
+    s64 start_time;
+    /// Entries and events still in the ring, from the oldest to the most recent.
+    std::vector<TraceEntry> entries;
+};
+
+/// Reads the entries of a trace file, returns std::nullopt if the file is not a valid trace.
+std::optional<TraceFile> ReadTraceFile(const std::filesystem::path& path);
+
+} // namespace Common::Log::Trace
@@ -131,14 +131,14 @@ enum class Class : u8 {
  * formatting on different frontends, as well as facilitating filtering and aggregation.
  */
 struct Entry {
-    std::chrono::microseconds timestamp;
+    std::chrono::nanoseconds timestamp;
+    u32 thread_id{}; ///< Sequential id of the thread that logged the message, starting at 1.
     Class log_class{};
     Level log_level{};
     const char* filename = nullptr;
     unsigned int line_num = 0;
     std::string function;
     std::string message;
-    bool final_entry = false;
 };
 
 } // namespace Common::Log
@@ -72,4 +72,12 @@ std::vector<u8> DecompressDataLZ4(std::span<const u8> compressed, std::size_t un
     return uncompressed;
 }
 
+bool DecompressDataLZ4(std::span<const u8> compressed, std::span<u8> uncompressed) {
+    const int size_check = LZ4_decompress_safe(reinterpret_cast<const char*>(compressed.data()),
+                                               reinterpret_cast<char*>(uncompressed.data()),
+                                               static_cast<int>(compressed.size()),
+                                               static_cast<int>(uncompressed.size()));
+    return static_cast<int>(uncompressed.size()) == size_check;
+}
+
 } // namespace Common::Compression
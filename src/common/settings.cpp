@@ -60,6 +60,13 @@ void LogSettings() {
     log_setting("Renderer_UseAssemblyShaders", values.use_assembly_shaders.GetValue());
     log_setting("Renderer_UseAsynchronousShaders", values.use_asynchronous_shaders.GetValue());
     log_setting("Renderer_UseGarbageCollection", values.use_caches_gc.GetValue());
+    log_setting("Renderer_UseWriteTracking", values.use_write_tracking.GetValue());
+    log_setting("Renderer_UseDiskTextureCache", values.use_disk_texture_cache.GetValue());
+    log_setting("Renderer_DiskTextureCacheSize", values.disk_texture_cache_size.GetValue());
+    log_setting("Renderer_UseMultithreadedRecording",
+                values.use_multithreaded_recording.GetValue());
+    log_setting("Renderer_TextureCacheBudget", values.texture_cache_budget.GetValue());
+    log_setting("Renderer_BufferCacheBudget", values.buffer_cache_budget.GetValue());
     log_setting("Renderer_AnisotropicFilteringLevel", values.max_anisotropy.GetValue());
     log_setting("Audio_OutputEngine", values.sink_id);
     log_setting("Audio_EnableAudioStretching", values.enable_audio_stretching.GetValue());
@@ -99,6 +106,14 @@ bool IsFastmemEnabled() {
     return true;
 }
 
+bool IsWriteTrackingEnabled() {
+    // Cached pages the GPU has written to are still marked through the page types, so CPU reads
+    // of them are flushed at every accuracy level. Extreme GPU accuracy also waits for the GPU
+    // thread on reads of pages whose GPU writes have not been recorded yet, which needs every
+    // cached page to be intercepted
+    return values.use_write_tracking.GetValue() && IsFastmemEnabled() && !IsGPULevelExtreme();
+}
+
 float Volume() {
     if (values.audio_muted) {
         return 0.0f;
@@ -144,6 +159,12 @@ void RestoreGlobalState(bool is_powered_on) {
     values.use_asynchronous_shaders.SetGlobal(true);
     values.use_fast_gpu_time.SetGlobal(true);
     values.use_caches_gc.SetGlobal(true);
+    values.use_write_tracking.SetGlobal(true);
+    values.use_disk_texture_cache.SetGlobal(true);
+    values.disk_texture_cache_size.SetGlobal(true);
+    values.use_multithreaded_recording.SetGlobal(true);
+    values.texture_cache_budget.SetGlobal(true);
+    values.buffer_cache_budget.SetGlobal(true);
     values.bg_red.SetGlobal(true);
     values.bg_green.SetGlobal(true);
     values.bg_blue.SetGlobal(true);
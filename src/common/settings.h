@@ -155,6 +155,12 @@ struct Values {
     Setting<bool> use_asynchronous_shaders;
     Setting<bool> use_fast_gpu_time;
     Setting<bool> use_caches_gc;
+    Setting<bool> use_write_tracking;
+    Setting<bool> use_disk_texture_cache;
+    Setting<u32> disk_texture_cache_size;
+    Setting<bool> use_multithreaded_recording;
+    Setting<u32> texture_cache_budget;
+    Setting<u32> buffer_cache_budget;
 
     Setting<float> bg_red;
     Setting<float> bg_green;
@@ -214,6 +220,7 @@ struct Values {
     bool gamecard_inserted;
     bool gamecard_current_game;
     std::string gamecard_path;
+    bool verify_nca_integrity;
 
     // Debugging
     bool record_frame_times;
@@ -227,6 +234,7 @@ struct Values {
     bool quest_flag;
     bool disable_macro_jit;
     bool extended_logging;
+    bool trace_logging;
     bool use_debug_asserts;
     bool use_auto_stub;
 
@@ -257,6 +265,7 @@ bool IsGPULevelExtreme();
 bool IsGPULevelHigh();
 
 bool IsFastmemEnabled();
+bool IsWriteTrackingEnabled();
 
 float Volume();
 
@@ -149,7 +149,7 @@ public:
     template <typename Arg>
     void Push(Arg&& t) {
         std::lock_guard lock{write_lock};
-        spsc_queue.Push(t);
+        spsc_queue.Push(std::forward<Arg>(t));
     }
 
     void Pop() {
@@ -307,6 +307,7 @@ struct System::Impl {
 
         services.reset();
         service_manager.reset();
+        fs_controller.ShutdownReadahead();
         cheat_engine.reset();
         telemetry_session.reset();
         cpu_manager.Shutdown();
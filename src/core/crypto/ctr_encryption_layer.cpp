@@ -4,31 +4,34 @@
 
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 #include "common/assert.h"
+#include "common/scope_exit.h"
 #include "core/crypto/ctr_encryption_layer.h"
 
 namespace Core::Crypto {
 
 CTREncryptionLayer::CTREncryptionLayer(FileSys::VirtualFile base_, Key128 key_,
                                        std::size_t base_offset_)
-    : EncryptionLayer(std::move(base_)), base_offset(base_offset_), cipher(key_, Mode::CTR) {}
+    : EncryptionLayer(std::move(base_)), base_offset(base_offset_), key(key_) {}
 
 std::size_t CTREncryptionLayer::Read(u8* data, std::size_t length, std::size_t offset) const {
     if (length == 0)
         return 0;
 
+    auto cipher = AcquireCipher();
+    SCOPE_EXIT({ ReleaseCipher(std::move(cipher)); });
+
     const auto sector_offset = offset & 0xF;
     if (sector_offset == 0) {
-        UpdateIV(base_offset + offset);
         std::vector<u8> raw = base->ReadBytes(length, offset);
-        cipher.Transcode(raw.data(), raw.size(), data, Op::Decrypt);
+        Decrypt(*cipher, raw.data(), raw.size(), data, offset);
         return length;
     }
 
     // offset does not fall on block boundary (0x10)
     std::vector<u8> block = base->ReadBytes(0x10, offset - sector_offset);
-    UpdateIV(base_offset + offset - sector_offset);
-    cipher.Transcode(block.data(), block.size(), block.data(), Op::Decrypt);
+    Decrypt(*cipher, block.data(), block.size(), block.data(), offset - sector_offset);
     std::size_t read = 0x10 - sector_offset;
 
     if (length + sector_offset < 0x10) {
@@ -43,12 +46,32 @@ void CTREncryptionLayer::SetIV(const IVData& iv_) {
     iv = iv_;
 }
 
-void CTREncryptionLayer::UpdateIV(std::size_t offset) const {
-    offset >>= 4;
+std::unique_ptr<CTREncryptionLayer::Cipher> CTREncryptionLayer::AcquireCipher() const {
+    {
+        std::scoped_lock lock{cipher_mutex};
+        if (!idle_ciphers.empty()) {
+            auto cipher = std::move(idle_ciphers.back());
+            idle_ciphers.pop_back();
+            return cipher;
+        }
+    }
+    return std::make_unique<Cipher>(key, Mode::CTR);
+}
+
+void CTREncryptionLayer::ReleaseCipher(std::unique_ptr<Cipher> cipher) const {
+    std::scoped_lock lock{cipher_mutex};
+    idle_ciphers.push_back(std::move(cipher));
+}
+
+void CTREncryptionLayer::Decrypt(Cipher& cipher, const u8* src, std::size_t size, u8* dest,
+                                 std::size_t offset) const {
+    IVData block_iv = iv;
+    std::size_t counter = (base_offset + offset) >> 4;
     for (std::size_t i = 0; i < 8; ++i) {
-        iv[16 - i - 1] = offset & 0xFF;
-        offset >>= 8;
+        block_iv[16 - i - 1] = counter & 0xFF;
+        counter >>= 8;
     }
-    cipher.SetIV(iv);
+    cipher.SetIV(block_iv);
+    cipher.Transcode(src, size, dest, Op::Decrypt);
 }
 } // namespace Core::Crypto
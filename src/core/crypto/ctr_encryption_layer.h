@@ -5,6 +5,9 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "core/crypto/aes_util.h"
 #include "core/crypto/encryption_layer.h"
@@ -24,13 +27,21 @@ public:
     void SetIV(const IVData& iv);
 
 private:
-    std::size_t base_offset;
-
-    // Must be mutable as operations modify cipher contexts.
-    mutable AESCipher<Key128> cipher;
-    mutable IVData iv{};
+    using Cipher = AESCipher<Key128>;
 
-    void UpdateIV(std::size_t offset) const;
+    std::size_t base_offset;
+    Key128 key;
+    IVData iv{};
+
+    // Cipher contexts not in use. The layer may be read from several threads, each read takes a
+    // context of its own so decryption runs in parallel.
+    mutable std::vector<std::unique_ptr<Cipher>> idle_ciphers;
+    mutable std::mutex cipher_mutex;
+
+    std::unique_ptr<Cipher> AcquireCipher() const;
+    void ReleaseCipher(std::unique_ptr<Cipher> cipher) const;
+    void Decrypt(Cipher& cipher, const u8* src, std::size_t size, u8* dest,
+                 std::size_t offset) const;
 };
 
 } // namespace Core::Crypto
@@ -6,17 +6,22 @@
 #include <array>
 #include <bitset>
 #include <cctype>
-#include <fstream>
+#include <chrono>
+#include <cstring>
 #include <locale>
 #include <map>
-#include <sstream>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 #include <mbedtls/bignum.h>
 #include <mbedtls/cipher.h>
 #include <mbedtls/cmac.h>
 #include <mbedtls/sha256.h>
+#include "common/cityhash.h"
 #include "common/common_funcs.h"
 #include "common/fs/file.h"
 #include "common/fs/fs.h"
@@ -25,6 +30,7 @@
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "common/string_util.h"
+#include "common/swap.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 #include "core/crypto/partition_data_manager.h"
@@ -129,6 +135,108 @@ template <std::size_t Size>
 bool IsAllZeroArray(const std::array<u8, Size>& array) {
     return std::all_of(array.begin(), array.end(), [](const auto& elem) { return elem == 0; });
 }
+
+// The keys loaded from the key files are cached in binary form, together with what was derived
+// from them, so they are only parsed again when a key file changes.
+constexpr u32 KEYSET_CACHE_MAGIC = Common::MakeMagic('Y', 'K', 'E', 'Y');
+constexpr u32 TICKET_CACHE_MAGIC = Common::MakeMagic('Y', 'T', 'I', 'K');
+constexpr u32 KEY_CACHE_VERSION = 1;
+
+constexpr std::string_view KEYSET_CACHE_FILE = "keyset.cache";
+constexpr std::string_view TICKET_CACHE_FILE = "tickets.cache";
+
+struct KeyCacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le key;
+    u64_le num_entries_0; ///< 128-bit keys in the keyset cache, tickets in the ticket cache
+    u64_le num_entries_1; ///< 256-bit keys in the keyset cache, unused in the ticket cache
+};
+static_assert(sizeof(KeyCacheHeader) == 0x20, "KeyCacheHeader has incorrect size.");
+
+template <typename Key>
+struct KeyRecord {
+    u64_le type;
+    u64_le field1;
+    u64_le field2;
+    Key key;
+};
+static_assert(sizeof(KeyRecord<Key128>) == 0x28, "KeyRecord has incorrect size.");
+static_assert(sizeof(KeyRecord<Key256>) == 0x38, "KeyRecord has incorrect size.");
+
+/// Header of a cached ticket, followed by the ticket as the variant alternative at index.
+struct TicketRecord {
+    u64_le rights_id_low;
+    u64_le rights_id_high;
+    Key128 title_key;
+    u32_le common;
+    u32_le index;
+};
+static_assert(sizeof(TicketRecord) == 0x28, "TicketRecord has incorrect size.");
+
+u64 HashBytes(const void* data, std::size_t size, u64 hash) {
+    return Common::CityHash64WithSeed(static_cast<const char*>(data), size, hash);
+}
+
+template <typename T>
+void Append(std::vector<u8>& out, const T& object) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* const data = reinterpret_cast<const u8*>(&object);
+    out.insert(out.end(), data, data + sizeof(T));
+}
+
+template <typename T>
+bool ReadNext(std::span<const u8> data, std::size_t& position, T& object) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (data.size() - position < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&object, data.data() + position, sizeof(T));
+    position += sizeof(T);
+    return true;
+}
+
+/// Reads a cache file and checks its header, returns the contents after the header.
+std::optional<std::vector<u8>> ReadKeyCache(const std::filesystem::path& path, u32 magic, u64 key,
+                                            KeyCacheHeader& header) {
+    const Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || !file.ReadObject(header) || header.magic != magic ||
+        header.version != KEY_CACHE_VERSION || header.key != key) {
+        return std::nullopt;
+    }
+    std::vector<u8> data(file.GetSize() - sizeof(header));
+    if (file.ReadSpan(std::span<u8>{data}) != data.size()) {
+        return std::nullopt;
+    }
+    return data;
+}
+
+void WriteKeyCache(const std::filesystem::path& path, std::span<const u8> data) {
+    const Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || file.WriteSpan(data) != data.size()) {
+        LOG_WARNING(Crypto, "Failed to write the key cache to {}",
+                    Common::FS::PathToUTF8String(path));
+    }
+}
+
+/// Hashes the size and modification time of a file, tickets are read from saves too large to hash
+/// on every boot.
+u64 HashFileStamp(const std::filesystem::path& path, u64 hash) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return HashBytes("", 0, hash);
+    }
+    const auto modification_time = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return HashBytes("", 0, hash);
+    }
+    const std::array<s64, 2> stamp{static_cast<s64>(size),
+                                   static_cast<s64>(modification_time.time_since_epoch().count())};
+    return HashBytes(stamp.data(), sizeof(stamp), hash);
+}
 } // Anonymous namespace
 
 u64 GetSignatureTypeDataSize(SignatureType type) {
@@ -582,20 +690,43 @@ KeyManager::KeyManager() {
         LOG_ERROR(Core, "Failed to create the keys directory.");
     }
 
-    if (Settings::values.use_dev_keys) {
-        dev_mode = true;
-        LoadFromFile(yuzu_keys_dir / "dev.keys", false);
-        LoadFromFile(yuzu_keys_dir / "dev.keys_autogenerated", false);
-    } else {
-        dev_mode = false;
-        LoadFromFile(yuzu_keys_dir / "prod.keys", false);
-        LoadFromFile(yuzu_keys_dir / "prod.keys_autogenerated", false);
-    }
-
-    LoadFromFile(yuzu_keys_dir / "title.keys", true);
-    LoadFromFile(yuzu_keys_dir / "title.keys_autogenerated", true);
-    LoadFromFile(yuzu_keys_dir / "console.keys", false);
-    LoadFromFile(yuzu_keys_dir / "console.keys_autogenerated", false);
+    dev_mode = Settings::values.use_dev_keys;
+    const std::string_view keys_name = dev_mode ? "dev.keys" : "prod.keys";
+    const std::array<std::pair<std::filesystem::path, bool>, 6> key_files{{
+        {yuzu_keys_dir / keys_name, false},
+        {yuzu_keys_dir / fmt::format("{}_autogenerated", keys_name), false},
+        {yuzu_keys_dir / "title.keys", true},
+        {yuzu_keys_dir / "title.keys_autogenerated", true},
+        {yuzu_keys_dir / "console.keys", false},
+        {yuzu_keys_dir / "console.keys_autogenerated", false},
+    }};
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    // The files are read in full anyway, hashing them costs little next to parsing them
+    std::array<std::string, key_files.size()> contents;
+    u64 cache_key = HashBytes(&dev_mode, sizeof(dev_mode), KEY_CACHE_VERSION);
+    for (std::size_t i = 0; i < key_files.size(); ++i) {
+        contents[i] = Common::FS::ReadStringFromFile(key_files[i].first,
+                                                     Common::FS::FileType::TextFile);
+        const u64 size = contents[i].size();
+        cache_key = HashBytes(&size, sizeof(size), cache_key);
+        cache_key = HashBytes(contents[i].data(), contents[i].size(), cache_key);
+    }
+
+    const auto cache_path = yuzu_keys_dir / KEYSET_CACHE_FILE;
+    const bool cached = LoadKeysetCache(cache_path, cache_key);
+    if (!cached) {
+        for (std::size_t i = 0; i < key_files.size(); ++i) {
+            ParseKeys(contents[i], key_files[i].second);
+        }
+        StoreKeysetCache(cache_path, cache_key);
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start_time;
+    LOG_INFO(Crypto, "Loaded {} keys from the {} in {} us", s128_keys.size() + s256_keys.size(),
+             cached ? "keyset cache" : "key files",
+             std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
 }
 
 static bool ValidCryptoRevisionString(std::string_view base, size_t begin, size_t length) {
@@ -606,30 +737,19 @@ static bool ValidCryptoRevisionString(std::string_view base, size_t begin, size_
                        [](u8 c) { return std::isxdigit(c); });
 }
 
-void KeyManager::LoadFromFile(const std::filesystem::path& file_path, bool is_title_keys) {
-    if (!Common::FS::Exists(file_path)) {
-        return;
-    }
-
-    std::ifstream file;
-    Common::FS::OpenFileStream(file, file_path, std::ios_base::in);
+void KeyManager::ParseKeys(std::string_view contents, bool is_title_keys) {
+    while (!contents.empty()) {
+        const std::size_t line_end = std::min(contents.find('\n'), contents.size());
+        const std::string_view line = contents.substr(0, line_end);
+        contents.remove_prefix(std::min(line_end + 1, contents.size()));
 
-    if (!file.is_open()) {
-        return;
-    }
-
-    std::string line;
-    while (std::getline(file, line)) {
-        std::vector<std::string> out;
-        std::stringstream stream(line);
-        std::string item;
-        while (std::getline(stream, item, '=')) {
-            out.push_back(std::move(item));
-        }
-
-        if (out.size() != 2) {
+        const std::size_t separator = line.find('=');
+        if (separator == std::string_view::npos || separator + 1 == line.size() ||
+            line.find('=', separator + 1) != std::string_view::npos) {
             continue;
         }
+        std::array<std::string, 2> out{std::string(line.substr(0, separator)),
+                                       std::string(line.substr(separator + 1))};
 
         out[0].erase(std::remove(out[0].begin(), out[0].end(), ' '), out[0].end());
         out[1].erase(std::remove(out[1].begin(), out[1].end(), ' '), out[1].end());
@@ -708,6 +828,153 @@ void KeyManager::LoadFromFile(const std::filesystem::path& file_path, bool is_ti
     }
 }
 
+bool KeyManager::LoadKeysetCache(const std::filesystem::path& path, u64 cache_key) {
+    KeyCacheHeader header{};
+    const auto data = ReadKeyCache(path, KEYSET_CACHE_MAGIC, cache_key, header);
+    if (!data) {
+        return false;
+    }
+
+    std::map<KeyIndex<S128KeyType>, Key128> cached_s128_keys;
+    std::map<KeyIndex<S256KeyType>, Key256> cached_s256_keys;
+    std::size_t position = 0;
+    for (u64 i = 0; i < header.num_entries_0; ++i) {
+        KeyRecord<Key128> record{};
+        if (!ReadNext<KeyRecord<Key128>>(*data, position, record)) {
+            return false;
+        }
+        const KeyIndex<S128KeyType> index{static_cast<S128KeyType>(u64{record.type}),
+                                          record.field1, record.field2};
+        cached_s128_keys.emplace_hint(cached_s128_keys.end(), index, record.key);
+    }
+    for (u64 i = 0; i < header.num_entries_1; ++i) {
+        KeyRecord<Key256> record{};
+        if (!ReadNext<KeyRecord<Key256>>(*data, position, record)) {
+            return false;
+        }
+        const KeyIndex<S256KeyType> index{static_cast<S256KeyType>(u64{record.type}),
+                                          record.field1, record.field2};
+        cached_s256_keys.emplace_hint(cached_s256_keys.end(), index, record.key);
+    }
+
+    auto cached_encrypted_keyblobs = encrypted_keyblobs;
+    auto cached_keyblobs = keyblobs;
+    auto cached_eticket_extended_kek = eticket_extended_kek;
+    if (!ReadNext(*data, position, cached_encrypted_keyblobs) ||
+        !ReadNext(*data, position, cached_keyblobs) ||
+        !ReadNext(*data, position, cached_eticket_extended_kek) || position != data->size()) {
+        return false;
+    }
+
+    s128_keys = std::move(cached_s128_keys);
+    s256_keys = std::move(cached_s256_keys);
+    encrypted_keyblobs = cached_encrypted_keyblobs;
+    keyblobs = cached_keyblobs;
+    eticket_extended_kek = cached_eticket_extended_kek;
+    return true;
+}
+
+void KeyManager::StoreKeysetCache(const std::filesystem::path& path, u64 cache_key) const {
+    std::vector<u8> out;
+    out.reserve(sizeof(KeyCacheHeader) + s128_keys.size() * sizeof(KeyRecord<Key128>) +
+                s256_keys.size() * sizeof(KeyRecord<Key256>) + sizeof(encrypted_keyblobs) +
+                sizeof(keyblobs) + sizeof(eticket_extended_kek));
+    Append(out, KeyCacheHeader{
+                    .magic = KEYSET_CACHE_MAGIC,
+                    .version = KEY_CACHE_VERSION,
+                    .key = cache_key,
+                    .num_entries_0 = s128_keys.size(),
+                    .num_entries_1 = s256_keys.size(),
+                });
+    for (const auto& [index, key] : s128_keys) {
+        Append(out, KeyRecord<Key128>{
+                        .type = static_cast<u64>(index.type),
+                        .field1 = index.field1,
+                        .field2 = index.field2,
+                        .key = key,
+                    });
+    }
+    for (const auto& [index, key] : s256_keys) {
+        Append(out, KeyRecord<Key256>{
+                        .type = static_cast<u64>(index.type),
+                        .field1 = index.field1,
+                        .field2 = index.field2,
+                        .key = key,
+                    });
+    }
+    Append(out, encrypted_keyblobs);
+    Append(out, keyblobs);
+    Append(out, eticket_extended_kek);
+    WriteKeyCache(path, out);
+}
+
+bool KeyManager::LoadTicketCache(const std::filesystem::path& path, u64 cache_key,
+                                 std::vector<CachedTicket>& tickets) const {
+    KeyCacheHeader header{};
+    const auto data = ReadKeyCache(path, TICKET_CACHE_MAGIC, cache_key, header);
+    if (!data) {
+        return false;
+    }
+
+    std::vector<CachedTicket> cached_tickets;
+    std::size_t position = 0;
+    for (u64 i = 0; i < header.num_entries_0; ++i) {
+        TicketRecord record{};
+        if (!ReadNext(*data, position, record)) {
+            return false;
+        }
+        CachedTicket& cached = cached_tickets.emplace_back();
+        cached.rights_id = {record.rights_id_low, record.rights_id_high};
+        cached.title_key = record.title_key;
+        cached.common = record.common != 0;
+
+        bool read = false;
+        switch (record.index) {
+        case 0:
+            read = ReadNext(*data, position, cached.ticket.data.emplace<RSA4096Ticket>());
+            break;
+        case 1:
+            read = ReadNext(*data, position, cached.ticket.data.emplace<RSA2048Ticket>());
+            break;
+        case 2:
+            read = ReadNext(*data, position, cached.ticket.data.emplace<ECDSATicket>());
+            break;
+        }
+        if (!read) {
+            return false;
+        }
+    }
+    if (position != data->size()) {
+        return false;
+    }
+
+    tickets = std::move(cached_tickets);
+    return true;
+}
+
+void KeyManager::StoreTicketCache(const std::filesystem::path& path, u64 cache_key,
+                                  const std::vector<CachedTicket>& tickets) const {
+    std::vector<u8> out;
+    Append(out, KeyCacheHeader{
+                    .magic = TICKET_CACHE_MAGIC,
+                    .version = KEY_CACHE_VERSION,
+                    .key = cache_key,
+                    .num_entries_0 = tickets.size(),
+                    .num_entries_1 = 0,
+                });
+    for (const auto& cached : tickets) {
+        Append(out, TicketRecord{
+                        .rights_id_low = cached.rights_id[0],
+                        .rights_id_high = cached.rights_id[1],
+                        .title_key = cached.title_key,
+                        .common = cached.common ? 1U : 0U,
+                        .index = static_cast<u32>(cached.ticket.data.index()),
+                    });
+        std::visit([&out](const auto& ticket) { Append(out, ticket); }, cached.ticket.data);
+    }
+    WriteKeyCache(path, out);
+}
+
 bool KeyManager::BaseDeriveNecessary() const {
     const auto check_key_existence = [this](auto key_type, u64 index1 = 0, u64 index2 = 0) {
         return !HasKey(key_type, index1, index2);
@@ -732,36 +999,43 @@ bool KeyManager::BaseDeriveNecessary() const {
 }
 
 bool KeyManager::HasKey(S128KeyType id, u64 field1, u64 field2) const {
+    std::shared_lock lock{keys_mutex};
     return s128_keys.find({id, field1, field2}) != s128_keys.end();
 }
 
 bool KeyManager::HasKey(S256KeyType id, u64 field1, u64 field2) const {
+    std::shared_lock lock{keys_mutex};
     return s256_keys.find({id, field1, field2}) != s256_keys.end();
 }
 
 Key128 KeyManager::GetKey(S128KeyType id, u64 field1, u64 field2) const {
-    if (!HasKey(id, field1, field2)) {
+    std::shared_lock lock{keys_mutex};
+    const auto iter = s128_keys.find({id, field1, field2});
+    if (iter == s128_keys.end()) {
         return {};
     }
-    return s128_keys.at({id, field1, field2});
+    return iter->second;
 }
 
 Key256 KeyManager::GetKey(S256KeyType id, u64 field1, u64 field2) const {
-    if (!HasKey(id, field1, field2)) {
+    std::shared_lock lock{keys_mutex};
+    const auto iter = s256_keys.find({id, field1, field2});
+    if (iter == s256_keys.end()) {
         return {};
     }
-    return s256_keys.at({id, field1, field2});
+    return iter->second;
 }
 
 Key256 KeyManager::GetBISKey(u8 partition_id) const {
+    std::shared_lock lock{keys_mutex};
     Key256 out{};
 
     for (const auto& bis_type : {BISKeyType::Crypto, BISKeyType::Tweak}) {
-        if (HasKey(S128KeyType::BIS, partition_id, static_cast<u64>(bis_type))) {
-            std::memcpy(
-                out.data() + sizeof(Key128) * static_cast<u64>(bis_type),
-                s128_keys.at({S128KeyType::BIS, partition_id, static_cast<u64>(bis_type)}).data(),
-                sizeof(Key128));
+        const auto iter =
+            s128_keys.find({S128KeyType::BIS, partition_id, static_cast<u64>(bis_type)});
+        if (iter != s128_keys.end()) {
+            std::memcpy(out.data() + sizeof(Key128) * static_cast<u64>(bis_type),
+                        iter->second.data(), sizeof(Key128));
         }
     }
 
@@ -799,10 +1073,10 @@ void KeyManager::WriteKeyToFile(KeyCategory category, std::string_view keyname,
     }
 
     void(file.WriteString(fmt::format("\n{} = {}", keyname, Common::HexToString(key))));
-    LoadFromFile(path, category == KeyCategory::Title);
 }
 
 void KeyManager::SetKey(S128KeyType id, Key128 key, u64 field1, u64 field2) {
+    std::unique_lock lock{keys_mutex};
     if (s128_keys.find({id, field1, field2}) != s128_keys.end() || key == Key128{}) {
         return;
     }
@@ -856,6 +1130,7 @@ void KeyManager::SetKey(S128KeyType id, Key128 key, u64 field1, u64 field2) {
 }
 
 void KeyManager::SetKey(S256KeyType id, Key256 key, u64 field1, u64 field2) {
+    std::unique_lock lock{keys_mutex};
     if (s256_keys.find({id, field1, field2}) != s256_keys.end() || key == Key256{}) {
         return;
     }
@@ -1124,40 +1399,57 @@ void KeyManager::PopulateTickets() {
 
     const auto system_save_e1_path =
         Common::FS::GetYuzuPath(Common::FS::YuzuPath::NANDDir) / "system/save/80000000000000e1";
-
-    const Common::FS::IOFile save_e1{system_save_e1_path, Common::FS::FileAccessMode::Read,
-                                     Common::FS::FileType::BinaryFile};
-
     const auto system_save_e2_path =
         Common::FS::GetYuzuPath(Common::FS::YuzuPath::NANDDir) / "system/save/80000000000000e2";
 
-    const Common::FS::IOFile save_e2{system_save_e2_path, Common::FS::FileAccessMode::Read,
-                                     Common::FS::FileType::BinaryFile};
-
-    const auto blob2 = GetTicketblob(save_e2);
-    auto res = GetTicketblob(save_e1);
-
-    const auto idx = res.size();
-    res.insert(res.end(), blob2.begin(), blob2.end());
+    // Personalized tickets need an RSA decryption each, the results are cached until the saves or
+    // the key change
+    const auto cache_path =
+        Common::FS::GetYuzuPath(Common::FS::YuzuPath::KeysDir) / TICKET_CACHE_FILE;
+    u64 cache_key = HashBytes(&rsa_key, sizeof(rsa_key), KEY_CACHE_VERSION);
+    cache_key = HashFileStamp(system_save_e1_path, cache_key);
+    cache_key = HashFileStamp(system_save_e2_path, cache_key);
+
+    std::vector<CachedTicket> tickets;
+    if (!LoadTicketCache(cache_path, cache_key, tickets)) {
+        const Common::FS::IOFile save_e1{system_save_e1_path, Common::FS::FileAccessMode::Read,
+                                         Common::FS::FileType::BinaryFile};
+        const Common::FS::IOFile save_e2{system_save_e2_path, Common::FS::FileAccessMode::Read,
+                                         Common::FS::FileType::BinaryFile};
+
+        const auto blob2 = GetTicketblob(save_e2);
+        auto res = GetTicketblob(save_e1);
+
+        const auto idx = res.size();
+        res.insert(res.end(), blob2.begin(), blob2.end());
+
+        for (std::size_t i = 0; i < res.size(); ++i) {
+            const auto pair = ParseTicket(res[i], rsa_key);
+            if (!pair) {
+                continue;
+            }
 
-    for (std::size_t i = 0; i < res.size(); ++i) {
-        const auto common = i < idx;
-        const auto pair = ParseTicket(res[i], rsa_key);
-        if (!pair) {
-            continue;
+            const auto& [rid, key] = *pair;
+            u128 rights_id;
+            std::memcpy(rights_id.data(), rid.data(), rid.size());
+            tickets.push_back(CachedTicket{
+                .ticket = res[i],
+                .rights_id = rights_id,
+                .title_key = key,
+                .common = i < idx,
+            });
         }
+        StoreTicketCache(cache_path, cache_key, tickets);
+    }
 
-        const auto& [rid, key] = *pair;
-        u128 rights_id;
-        std::memcpy(rights_id.data(), rid.data(), rid.size());
-
-        if (common) {
-            common_tickets[rights_id] = res[i];
+    for (const auto& cached : tickets) {
+        if (cached.common) {
+            common_tickets[cached.rights_id] = cached.ticket;
         } else {
-            personal_tickets[rights_id] = res[i];
+            personal_tickets[cached.rights_id] = cached.ticket;
         }
 
-        SetKey(S128KeyType::Titlekey, key, rights_id[1], rights_id[0]);
+        SetKey(S128KeyType::Titlekey, cached.title_key, cached.rights_id[1], cached.rights_id[0]);
     }
 }
 
@@ -8,9 +8,12 @@
 #include <filesystem>
 #include <map>
 #include <optional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 
 #include <variant>
+#include <vector>
 #include <fmt/format.h>
 #include "common/common_funcs.h"
 #include "common/common_types.h"
@@ -274,6 +277,9 @@ private:
 
     std::map<KeyIndex<S128KeyType>, Key128> s128_keys;
     std::map<KeyIndex<S256KeyType>, Key256> s256_keys;
+    // Guards the key maps for HasKey, GetKey and SetKey, which are used while parsing content from
+    // several threads.
+    mutable std::shared_mutex keys_mutex;
 
     // Map from rights ID to ticket
     std::map<u128, Ticket> common_tickets;
@@ -284,7 +290,25 @@ private:
     std::array<u8, 576> eticket_extended_kek{};
 
     bool dev_mode;
-    void LoadFromFile(const std::filesystem::path& file_path, bool is_title_keys);
+
+    // A ticket read from the ticket saves, with the title key it holds.
+    struct CachedTicket {
+        Ticket ticket;
+        u128 rights_id;
+        Key128 title_key;
+        bool common;
+    };
+
+    void ParseKeys(std::string_view contents, bool is_title_keys);
+
+    // The keyset cache holds the keys and keyblobs parsed from the key files, keyed on their
+    // contents. The ticket cache holds the tickets parsed from the ticket saves.
+    bool LoadKeysetCache(const std::filesystem::path& path, u64 cache_key);
+    void StoreKeysetCache(const std::filesystem::path& path, u64 cache_key) const;
+    bool LoadTicketCache(const std::filesystem::path& path, u64 cache_key,
+                         std::vector<CachedTicket>& tickets) const;
+    void StoreTicketCache(const std::filesystem::path& path, u64 cache_key,
+                          const std::vector<CachedTicket>& tickets) const;
 
     template <size_t Size>
     void WriteKeyToFile(KeyCategory category, std::string_view keyname,
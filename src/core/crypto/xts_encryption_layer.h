@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "core/crypto/aes_util.h"
 #include "core/crypto/encryption_layer.h"
 #include "core/crypto/key_manager.h"
@@ -20,6 +22,8 @@ public:
 private:
     // Must be mutable as operations modify cipher contexts.
     mutable AESCipher<Key256> cipher;
+    // Serializes the use of the cipher context, the layer may be read from several threads.
+    mutable std::mutex cipher_mutex;
 };
 
 } // namespace Core::Crypto
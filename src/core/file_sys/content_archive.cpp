@@ -8,13 +8,18 @@
 #include <ranges>
 #include <utility>
 
+#include <mbedtls/sha256.h>
+
+#include "common/div_ceil.h"
 #include "common/logging/log.h"
+#include "common/settings.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/ctr_encryption_layer.h"
 #include "core/crypto/key_manager.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/nca_patch.h"
 #include "core/file_sys/partition_filesystem.h"
+#include "core/file_sys/vfs_hash_tree.h"
 #include "core/file_sys/vfs_offset.h"
 #include "core/loader/loader.h"
 
@@ -44,9 +49,11 @@ static_assert(sizeof(IVFCLevel) == 0x18, "IVFCLevel has incorrect size.");
 struct IVFCHeader {
     u32_le magic;
     u32_le magic_number;
-    INSERT_PADDING_BYTES_NOINIT(8);
+    u32_le master_hash_size;
+    u32_le num_levels;
     std::array<IVFCLevel, 6> levels;
-    INSERT_PADDING_BYTES_NOINIT(64);
+    INSERT_PADDING_BYTES_NOINIT(32);
+    Core::Crypto::SHA256Hash master_hash;
 };
 static_assert(sizeof(IVFCHeader) == 0xE0, "IVFCHeader has incorrect size.");
 
@@ -114,6 +121,53 @@ union NCASectionHeader {
 };
 static_assert(sizeof(NCASectionHeader) == 0x200, "NCASectionHeader has incorrect size.");
 
+// Returns the layout of the hash tree protecting a section, relative to the start of the section.
+static std::optional<HashTreeLayout> GetHashTreeLayout(const NCASectionHeader& section) {
+    if (section.raw.header.filesystem_type == NCASectionFilesystemType::PFS0) {
+        // HierarchicalSha256: a single hash table, itself hashed by the master hash
+        const PFS0Superblock& pfs0 = section.pfs0;
+        const u64 num_blocks =
+            pfs0.size == 0 ? 0 : Common::DivCeil(u64{pfs0.pfs0_size}, u64{pfs0.size});
+        if (num_blocks == 0 ||
+            pfs0.hash_table_size < num_blocks * sizeof(Core::Crypto::SHA256Hash)) {
+            return std::nullopt;
+        }
+        return HashTreeLayout{
+            .master_hashes = {pfs0.hash},
+            .levels =
+                {
+                    {pfs0.hash_table_offset, pfs0.hash_table_size, pfs0.hash_table_size},
+                    {pfs0.pfs0_header_offset, pfs0.pfs0_size, pfs0.size},
+                },
+            .pad_blocks = false,
+        };
+    }
+
+    if (section.raw.header.filesystem_type == NCASectionFilesystemType::ROMFS) {
+        const IVFCHeader& ivfc = section.romfs.ivfc;
+        if (ivfc.magic != Common::MakeMagic('I', 'V', 'F', 'C') ||
+            ivfc.num_levels != IVFC_MAX_LEVEL + 1 ||
+            ivfc.master_hash_size != sizeof(Core::Crypto::SHA256Hash)) {
+            return std::nullopt;
+        }
+        HashTreeLayout layout{
+            .master_hashes = {ivfc.master_hash},
+            .levels = {},
+            .pad_blocks = true,
+        };
+        for (const IVFCLevel& level : ivfc.levels) {
+            // Block sizes are stored as powers of two
+            if (level.block_size < 4 || level.block_size >= 32) {
+                return std::nullopt;
+            }
+            layout.levels.push_back({level.offset, level.size, u64{1} << level.block_size});
+        }
+        return layout;
+    }
+
+    return std::nullopt;
+}
+
 static bool IsValidNCA(const NCAHeader& header) {
     // TODO(DarkLordZach): Add NCA2/NCA0 support.
     return header.magic == Common::MakeMagic('N', 'C', 'A', '3');
@@ -354,10 +408,15 @@ bool NCA::ReadRomFSSection(const NCASectionHeader& section, const NCASectionTabl
             section.raw.section_ctr);
 
         // BKTR applies to entire IVFC, so make an offset version to level 6
-        files.push_back(std::make_shared<OffsetVfsFile>(
-            bktr, romfs_size, section.romfs.ivfc.levels[IVFC_MAX_LEVEL - 1].offset));
+        files.push_back(AddHashTree(section, bktr,
+                                    std::make_shared<OffsetVfsFile>(
+                                        bktr, romfs_size,
+                                        section.romfs.ivfc.levels[IVFC_MAX_LEVEL - 1].offset)));
     } else {
-        files.push_back(std::move(dec));
+        const u64 size = MEDIA_OFFSET_MULTIPLIER * (entry.media_end_offset - entry.media_offset);
+        auto section_file =
+            Decrypt(section, std::make_shared<OffsetVfsFile>(file, size, base_offset), base_offset);
+        files.push_back(AddHashTree(section, std::move(section_file), std::move(dec)));
     }
 
     romfs = files.back();
@@ -371,6 +430,11 @@ bool NCA::ReadPFS0Section(const NCASectionHeader& section, const NCASectionTable
 
     auto dec = Decrypt(section, std::make_shared<OffsetVfsFile>(file, size, offset), offset);
     if (dec != nullptr) {
+        const u64 base_offset = static_cast<u64>(entry.media_offset) * MEDIA_OFFSET_MULTIPLIER;
+        auto section_file =
+            Decrypt(section, std::make_shared<OffsetVfsFile>(file, size, base_offset), base_offset);
+        dec = AddHashTree(section, std::move(section_file), std::move(dec));
+
         auto npfs = std::make_shared<PartitionFilesystem>(std::move(dec));
 
         if (npfs->GetStatus() == Loader::ResultStatus::Success) {
@@ -516,6 +580,22 @@ VirtualFile NCA::Decrypt(const NCASectionHeader& s_header, VirtualFile in, u64 s
     }
 }
 
+VirtualFile NCA::AddHashTree(const NCASectionHeader& section, VirtualFile section_file,
+                             VirtualFile data) {
+    const auto layout = GetHashTreeLayout(section);
+    if (section_file == nullptr || !layout) {
+        LOG_DEBUG(Loader, "A section of NCA {} has no hash tree that can be checked", GetName());
+        return data;
+    }
+
+    auto hash_tree = std::make_shared<HashTreeVfsFile>(std::move(section_file), *layout, GetName());
+    hash_trees.push_back(hash_tree);
+    if (!Settings::values.verify_nca_integrity) {
+        return data;
+    }
+    return hash_tree;
+}
+
 Loader::ResultStatus NCA::GetStatus() const {
     return status;
 }
@@ -584,4 +664,31 @@ VirtualDir NCA::GetLogoPartition() const {
     return logo;
 }
 
+bool NCA::VerifyIntegrity(std::size_t num_threads) const {
+    if (status != Loader::ResultStatus::Success) {
+        return false;
+    }
+
+    bool success = true;
+    const std::vector<NCASectionHeader> sections = ReadSectionHeaders();
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        Core::Crypto::SHA256Hash hash;
+        mbedtls_sha256_ret(reinterpret_cast<const u8*>(&sections[i]), sizeof(NCASectionHeader),
+                           hash.data(), 0);
+        if (hash != header.hash_tables[i]) {
+            LOG_ERROR(Loader, "Header of section {} in NCA {} is corrupt", i, GetName());
+            success = false;
+        }
+    }
+
+    if (hash_trees.size() < sections.size()) {
+        LOG_WARNING(Loader, "{} sections of NCA {} have no hash tree and were not checked",
+                    sections.size() - hash_trees.size(), GetName());
+    }
+    for (const auto& hash_tree : hash_trees) {
+        success &= hash_tree->VerifyAll(num_threads);
+    }
+    return success;
+}
+
 } // namespace FileSys
@@ -22,6 +22,7 @@ enum class ResultStatus : u16;
 
 namespace FileSys {
 
+class HashTreeVfsFile;
 union NCASectionHeader;
 
 /// Describes the type of content within an NCA archive.
@@ -125,6 +126,10 @@ public:
 
     VirtualDir GetLogoPartition() const;
 
+    // Checks the section headers and every block of every section against their hashes, spreading
+    // the work over num_threads threads. Returns false if anything is corrupt.
+    bool VerifyIntegrity(std::size_t num_threads) const;
+
 private:
     bool CheckSupportedNCA(const NCAHeader& header);
     bool HandlePotentialHeaderDecryption();
@@ -139,9 +144,12 @@ private:
     std::optional<Core::Crypto::Key128> GetKeyAreaKey(NCASectionCryptoType type) const;
     std::optional<Core::Crypto::Key128> GetTitlekey();
     VirtualFile Decrypt(const NCASectionHeader& header, VirtualFile in, u64 starting_offset);
+    VirtualFile AddHashTree(const NCASectionHeader& section, VirtualFile section_file,
+                            VirtualFile data);
 
     std::vector<VirtualDir> dirs;
     std::vector<VirtualFile> files;
+    std::vector<std::shared_ptr<HashTreeVfsFile>> hash_trees;
 
     VirtualFile romfs = nullptr;
     VirtualDir exefs = nullptr;
@@ -22,10 +22,13 @@
  * Refer to the license.txt file included.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <string_view>
+#include <thread>
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "common/div_ceil.h"
 #include "core/file_sys/fsmitm_romfsbuild.h"
 #include "core/file_sys/ips_layer.h"
 #include "core/file_sys/vfs.h"
@@ -38,6 +41,9 @@ constexpr u64 FS_MAX_PATH = 0x301;
 constexpr u32 ROMFS_ENTRY_EMPTY = 0xFFFFFFFF;
 constexpr u32 ROMFS_FILEPARTITION_OFS = 0x200;
 
+// Minimum number of files resolved by each thread when building an image.
+constexpr std::size_t MIN_FILES_PER_THREAD = 256;
+
 // Types for building a RomFS.
 struct RomFSHeader {
     u64 header_size;
@@ -96,6 +102,7 @@ struct RomFSBuildFileContext {
     std::shared_ptr<RomFSBuildDirectoryContext> parent;
     std::shared_ptr<RomFSBuildFileContext> sibling;
     VirtualFile source;
+    bool patched = false;
 };
 
 static u32 romfs_calc_path_hash(u32 parent, std::string_view path, u32 start,
@@ -126,78 +133,101 @@ static u64 romfs_get_hash_table_count(u64 num_entries) {
     return count;
 }
 
-void RomFSBuildContext::VisitDirectory(VirtualDir root_romfs, VirtualDir ext_dir,
+void RomFSBuildContext::VisitDirectory(VirtualDir dir, VirtualDir ext_dir,
                                        std::shared_ptr<RomFSBuildDirectoryContext> parent) {
-    std::vector<std::shared_ptr<RomFSBuildDirectoryContext>> child_dirs;
+    std::vector<std::pair<std::shared_ptr<RomFSBuildDirectoryContext>, VirtualDir>> child_dirs;
+
+    for (auto& subdir : dir->GetSubdirectories()) {
+        const auto name = subdir->GetName();
+        const auto child = std::make_shared<RomFSBuildDirectoryContext>();
+        // Set child's path.
+        child->cur_path_ofs = parent->path_len + 1;
+        child->path_len = child->cur_path_ofs + static_cast<u32>(name.size());
+        child->path = parent->path + "/" + name;
+
+        if (ext_dir != nullptr && ext_dir->GetFileRelative(child->path + ".stub") != nullptr) {
+            continue;
+        }
 
-    VirtualDir dir;
+        // Sanity check on path_len
+        ASSERT(child->path_len < FS_MAX_PATH);
 
-    if (parent->path_len == 0) {
-        dir = root_romfs;
-    } else {
-        dir = root_romfs->GetDirectoryRelative(parent->path);
+        if (AddDirectory(parent, child)) {
+            child_dirs.emplace_back(child, std::move(subdir));
+        }
     }
 
-    const auto entries = dir->GetEntries();
-
-    for (const auto& kv : entries) {
-        if (kv.second == VfsEntryType::Directory) {
-            const auto child = std::make_shared<RomFSBuildDirectoryContext>();
-            // Set child's path.
-            child->cur_path_ofs = parent->path_len + 1;
-            child->path_len = child->cur_path_ofs + static_cast<u32>(kv.first.size());
-            child->path = parent->path + "/" + kv.first;
+    for (auto& file : dir->GetFiles()) {
+        const auto name = file->GetName();
+        const auto child = std::make_shared<RomFSBuildFileContext>();
+        // Set child's path.
+        child->cur_path_ofs = parent->path_len + 1;
+        child->path_len = child->cur_path_ofs + static_cast<u32>(name.size());
+        child->path = parent->path + "/" + name;
+
+        // A directory takes precedence over a file of the same name.
+        if (directory_paths.contains(child->path)) {
+            continue;
+        }
 
-            if (ext_dir != nullptr && ext_dir->GetFileRelative(child->path + ".stub") != nullptr) {
-                continue;
-            }
+        if (ext_dir != nullptr && ext_dir->GetFileRelative(child->path + ".stub") != nullptr) {
+            continue;
+        }
 
-            // Sanity check on path_len
-            ASSERT(child->path_len < FS_MAX_PATH);
+        // Sanity check on path_len
+        ASSERT(child->path_len < FS_MAX_PATH);
 
-            if (AddDirectory(parent, child)) {
-                child_dirs.push_back(child);
-            }
-        } else {
-            const auto child = std::make_shared<RomFSBuildFileContext>();
-            // Set child's path.
-            child->cur_path_ofs = parent->path_len + 1;
-            child->path_len = child->cur_path_ofs + static_cast<u32>(kv.first.size());
-            child->path = parent->path + "/" + kv.first;
-
-            if (ext_dir != nullptr && ext_dir->GetFileRelative(child->path + ".stub") != nullptr) {
-                continue;
-            }
+        // IPS patches and sizes are resolved once every file is known, see ResolveFileSources.
+        child->source = std::move(file);
 
-            // Sanity check on path_len
-            ASSERT(child->path_len < FS_MAX_PATH);
+        AddFile(parent, child);
+    }
 
-            child->source = root_romfs->GetFileRelative(child->path);
+    for (auto& [child, subdir] : child_dirs) {
+        this->VisitDirectory(std::move(subdir), ext_dir, child);
+    }
+}
 
-            if (ext_dir != nullptr) {
-                if (const auto ips = ext_dir->GetFileRelative(child->path + ".ips")) {
-                    if (auto patched = PatchIPS(child->source, ips)) {
-                        child->source = std::move(patched);
+void RomFSBuildContext::ResolveFileSources() {
+    const auto resolve = [this](std::size_t begin, std::size_t end) {
+        for (std::size_t index = begin; index < end; ++index) {
+            RomFSBuildFileContext& file = *files[index];
+            if (ext != nullptr) {
+                if (const auto ips = ext->GetFileRelative(file.path + ".ips")) {
+                    if (auto patched = PatchIPS(file.source, ips)) {
+                        file.source = std::move(patched);
+                        file.patched = true;
                     }
                 }
             }
-
-            child->size = child->source->GetSize();
-
-            AddFile(parent, child);
+            file.size = file.source->GetSize();
         }
+    };
+
+    const std::size_t max_threads = std::max(1U, std::thread::hardware_concurrency());
+    const std::size_t num_threads =
+        std::clamp<std::size_t>(files.size() / MIN_FILES_PER_THREAD, 1, max_threads);
+    if (num_threads == 1) {
+        resolve(0, files.size());
+        return;
     }
 
-    for (auto& child : child_dirs) {
-        this->VisitDirectory(root_romfs, ext_dir, child);
+    const std::size_t files_per_thread = Common::DivCeil(files.size(), num_threads);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (std::size_t begin = files_per_thread; begin < files.size(); begin += files_per_thread) {
+        threads.emplace_back(resolve, begin, std::min(begin + files_per_thread, files.size()));
+    }
+    resolve(0, std::min(files_per_thread, files.size()));
+    for (auto& thread : threads) {
+        thread.join();
     }
 }
 
 bool RomFSBuildContext::AddDirectory(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
                                      std::shared_ptr<RomFSBuildDirectoryContext> dir_ctx) {
     // Check whether it's already in the known directories.
-    const auto existing = directories.find(dir_ctx->path);
-    if (existing != directories.end())
+    if (!directory_paths.insert(dir_ctx->path).second)
         return false;
 
     // Add a new directory.
@@ -205,7 +235,7 @@ bool RomFSBuildContext::AddDirectory(std::shared_ptr<RomFSBuildDirectoryContext>
     dir_table_size +=
         sizeof(RomFSDirectoryEntry) + Common::AlignUp(dir_ctx->path_len - dir_ctx->cur_path_ofs, 4);
     dir_ctx->parent = parent_dir_ctx;
-    directories.emplace(dir_ctx->path, dir_ctx);
+    directories.push_back(std::move(dir_ctx));
 
     return true;
 }
@@ -213,8 +243,7 @@ bool RomFSBuildContext::AddDirectory(std::shared_ptr<RomFSBuildDirectoryContext>
 bool RomFSBuildContext::AddFile(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
                                 std::shared_ptr<RomFSBuildFileContext> file_ctx) {
     // Check whether it's already in the known files.
-    const auto existing = files.find(file_ctx->path);
-    if (existing != files.end()) {
+    if (!file_paths.insert(file_ctx->path).second) {
         return false;
     }
 
@@ -223,7 +252,7 @@ bool RomFSBuildContext::AddFile(std::shared_ptr<RomFSBuildDirectoryContext> pare
     file_table_size +=
         sizeof(RomFSFileEntry) + Common::AlignUp(file_ctx->path_len - file_ctx->cur_path_ofs, 4);
     file_ctx->parent = parent_dir_ctx;
-    files.emplace(file_ctx->path, file_ctx);
+    files.push_back(std::move(file_ctx));
 
     return true;
 }
@@ -232,11 +261,13 @@ RomFSBuildContext::RomFSBuildContext(VirtualDir base_, VirtualDir ext_)
     : base(std::move(base_)), ext(std::move(ext_)) {
     root = std::make_shared<RomFSBuildDirectoryContext>();
     root->path = "\0";
-    directories.emplace(root->path, root);
+    directory_paths.insert(root->path);
+    directories.push_back(root);
     num_dirs = 1;
     dir_table_size = 0x18;
 
     VisitDirectory(base, ext, root);
+    ResolveFileSources();
 }
 
 RomFSBuildContext::~RomFSBuildContext() = default;
@@ -247,6 +278,11 @@ std::multimap<u64, VirtualFile> RomFSBuildContext::Build() {
     dir_hash_table_size = 4 * dir_hash_table_entry_count;
     file_hash_table_size = 4 * file_hash_table_entry_count;
 
+    // Lay out the entries in path order, which keeps the root directory first.
+    const auto path_order = [](const auto& lhs, const auto& rhs) { return lhs->path < rhs->path; };
+    std::sort(files.begin(), files.end(), path_order);
+    std::sort(directories.begin(), directories.end(), path_order);
+
     // Assign metadata pointers
     RomFSHeader header{};
 
@@ -262,7 +298,7 @@ std::multimap<u64, VirtualFile> RomFSBuildContext::Build() {
     u32 entry_offset = 0;
     std::shared_ptr<RomFSBuildFileContext> prev_file = nullptr;
     for (const auto& it : files) {
-        cur_file = it.second;
+        cur_file = it;
         file_partition_size = Common::AlignUp(file_partition_size, 16);
         cur_file->offset = file_partition_size;
         file_partition_size += cur_file->size;
@@ -274,7 +310,7 @@ std::multimap<u64, VirtualFile> RomFSBuildContext::Build() {
     }
     // Assign deferred parent/sibling ownership.
     for (auto it = files.rbegin(); it != files.rend(); ++it) {
-        cur_file = it->second;
+        cur_file = *it;
         cur_file->sibling = cur_file->parent->file;
         cur_file->parent->file = cur_file;
     }
@@ -284,15 +320,15 @@ std::multimap<u64, VirtualFile> RomFSBuildContext::Build() {
     // Determine directory offsets.
     entry_offset = 0;
     for (const auto& it : directories) {
-        cur_dir = it.second;
+        cur_dir = it;
         cur_dir->entry_offset = entry_offset;
         entry_offset +=
             static_cast<u32>(sizeof(RomFSDirectoryEntry) +
                              Common::AlignUp(cur_dir->path_len - cur_dir->cur_path_ofs, 4));
     }
     // Assign deferred parent/sibling ownership.
-    for (auto it = directories.rbegin(); it->second != root; ++it) {
-        cur_dir = it->second;
+    for (auto it = directories.rbegin(); *it != root; ++it) {
+        cur_dir = *it;
         cur_dir->sibling = cur_dir->parent->child;
         cur_dir->parent->child = cur_dir;
     }
@@ -301,7 +337,7 @@ std::multimap<u64, VirtualFile> RomFSBuildContext::Build() {
 
     // Populate file tables.
     for (const auto& it : files) {
-        cur_file = it.second;
+        cur_file = it;
         RomFSFileEntry cur_entry{};
 
         cur_entry.parent = cur_file->parent->entry_offset;
@@ -328,7 +364,7 @@ std::multimap<u64, VirtualFile> RomFSBuildContext::Build() {
 
     // Populate dir tables.
     for (const auto& it : directories) {
-        cur_dir = it.second;
+        cur_dir = it;
         RomFSDirectoryEntry cur_entry{};
 
         cur_entry.parent = cur_dir == root ? 0 : cur_dir->parent->entry_offset;
@@ -386,4 +422,19 @@ std::multimap<u64, VirtualFile> RomFSBuildContext::Build() {
     return out;
 }
 
+std::vector<RomFSBuildContext::FileLayout> RomFSBuildContext::GetFileLayout() const {
+    std::vector<FileLayout> out;
+    out.reserve(files.size());
+    for (const auto& file : files) {
+        out.push_back({
+            .path = file->path,
+            .offset = file->offset + ROMFS_FILEPARTITION_OFS,
+            .size = file->size,
+            .source = file->source,
+            .patched = file->patched,
+        });
+    }
+    return out;
+}
+
 } // namespace FileSys
@@ -27,6 +27,9 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
 #include "common/common_types.h"
 #include "core/file_sys/vfs.h"
 
@@ -39,18 +42,33 @@ struct RomFSFileEntry;
 
 class RomFSBuildContext {
 public:
+    // Location of a file in the built image.
+    struct FileLayout {
+        std::string_view path;
+        u64 offset;
+        u64 size;
+        VirtualFile source;
+        bool patched; // Whether the source is the result of an IPS patch.
+    };
+
     explicit RomFSBuildContext(VirtualDir base, VirtualDir ext = nullptr);
     ~RomFSBuildContext();
 
     // This finalizes the context.
     std::multimap<u64, VirtualFile> Build();
 
+    // Returns where every file was placed in the image, only valid once Build was called.
+    std::vector<FileLayout> GetFileLayout() const;
+
 private:
     VirtualDir base;
     VirtualDir ext;
     std::shared_ptr<RomFSBuildDirectoryContext> root;
-    std::map<std::string, std::shared_ptr<RomFSBuildDirectoryContext>, std::less<>> directories;
-    std::map<std::string, std::shared_ptr<RomFSBuildFileContext>, std::less<>> files;
+    std::vector<std::shared_ptr<RomFSBuildDirectoryContext>> directories;
+    std::vector<std::shared_ptr<RomFSBuildFileContext>> files;
+    // Views of the paths owned by the contexts above, used to reject duplicates.
+    std::unordered_set<std::string_view> directory_paths;
+    std::unordered_set<std::string_view> file_paths;
     u64 num_dirs = 0;
     u64 num_files = 0;
     u64 dir_table_size = 0;
@@ -59,9 +77,12 @@ private:
     u64 file_hash_table_size = 0;
     u64 file_partition_size = 0;
 
-    void VisitDirectory(VirtualDir filesys, VirtualDir ext_dir,
+    void VisitDirectory(VirtualDir dir, VirtualDir ext_dir,
                         std::shared_ptr<RomFSBuildDirectoryContext> parent);
 
+    // Applies the IPS patches and determines the size of every file, in parallel.
+    void ResolveFileSources();
+
     bool AddDirectory(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
                       std::shared_ptr<RomFSBuildDirectoryContext> dir_ctx);
     bool AddFile(std::shared_ptr<RomFSBuildDirectoryContext> parent_dir_ctx,
@@ -2,7 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 #include "common/string_util.h"
 #include "core/file_sys/kernel_executable.h"
@@ -57,12 +60,13 @@ bool DecompressBLZ(std::vector<u8>& data) {
 
                 out_index -= segment_size;
 
+                if (out_index + segment_size + segment_offset + start_offset > data.size()) {
+                    return false;
+                }
+                // The source may overlap the destination, copy byte by byte
+                u8* const out = data.data() + out_index + start_offset;
                 for (size_t j = 0; j < segment_size; ++j) {
-                    if (out_index + j + segment_offset + start_offset >= data.size()) {
-                        return false;
-                    }
-                    data[out_index + j + start_offset] =
-                        data[out_index + j + segment_offset + start_offset];
+                    out[j] = out[j + segment_offset];
                 }
             } else {
                 if (out_index < 1) {
@@ -98,21 +102,42 @@ KIP::KIP(const VirtualFile& file) : status(Loader::ResultStatus::Success) {
         return;
     }
 
+    // Sections are decompressed in place, the compressed ones in parallel
+    std::vector<std::size_t> compressed_sections;
     u64 offset = sizeof(KIPHeader);
     for (std::size_t i = 0; i < header.sections.size(); ++i) {
-        auto compressed = file->ReadBytes(header.sections[i].compressed_size, offset);
-        offset += header.sections[i].compressed_size;
-
-        if (header.sections[i].compressed_size == 0 && header.sections[i].decompressed_size != 0) {
-            decompressed_sections[i] = std::vector<u8>(header.sections[i].decompressed_size);
-        } else if (header.sections[i].compressed_size == header.sections[i].decompressed_size) {
-            decompressed_sections[i] = std::move(compressed);
-        } else {
-            decompressed_sections[i] = compressed;
-            if (!DecompressBLZ(decompressed_sections[i])) {
-                status = Loader::ResultStatus::ErrorBLZDecompressionFailed;
-                return;
-            }
+        const auto& section = header.sections[i];
+        if (section.compressed_size == 0 && section.decompressed_size != 0) {
+            decompressed_sections[i] = std::vector<u8>(section.decompressed_size);
+            continue;
+        }
+
+        decompressed_sections[i] = file->ReadBytes(section.compressed_size, offset);
+        offset += section.compressed_size;
+        if (section.compressed_size != section.decompressed_size) {
+            compressed_sections.push_back(i);
+        }
+    }
+
+    std::array<bool, 6> success{};
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < compressed_sections.size(); ++i) {
+        threads.emplace_back([this, &success, index = compressed_sections[i]] {
+            success[index] = DecompressBLZ(decompressed_sections[index]);
+        });
+    }
+    if (!compressed_sections.empty()) {
+        const std::size_t index = compressed_sections[0];
+        success[index] = DecompressBLZ(decompressed_sections[index]);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const std::size_t index : compressed_sections) {
+        if (!success[index]) {
+            status = Loader::ResultStatus::ErrorBLZDecompressionFailed;
+            return;
         }
     }
 }
@@ -0,0 +1,189 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "core/file_sys/nso_patch_cache.h"
+#include "core/file_sys/vfs.h"
+
+namespace FileSys {
+namespace {
+constexpr u32 CACHE_MAGIC = Common::MakeMagic('Y', 'N', 'P', 'C');
+constexpr u32 CACHE_VERSION = 1;
+
+// Images are compared in blocks, only blocks that differ are compared byte by byte.
+constexpr std::size_t COMPARE_BLOCK_SIZE = 0x1000;
+
+// Changed ranges closer than this are stored as a single range.
+constexpr std::size_t MERGE_DISTANCE = 0x20;
+
+struct CacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le key;
+    u64_le image_size;
+    u64_le num_ranges;
+};
+static_assert(sizeof(CacheHeader) == 0x20, "CacheHeader has incorrect size.");
+
+struct RangeRecord {
+    u64_le offset;
+    u64_le size;
+};
+static_assert(sizeof(RangeRecord) == 0x10, "RangeRecord has incorrect size.");
+
+u64 HashBytes(std::span<const u8> data, u64 hash) {
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(data.data()), data.size(),
+                                      hash);
+}
+
+u64 HashString(std::string_view string, u64 hash) {
+    return HashBytes(std::span{reinterpret_cast<const u8*>(string.data()), string.size()}, hash);
+}
+
+template <typename T>
+void Append(std::vector<u8>& out, const T& object) {
+    const auto* const data = reinterpret_cast<const u8*>(&object);
+    out.insert(out.end(), data, data + sizeof(T));
+}
+
+// Returns the [begin, end) ranges where original and patched differ.
+std::vector<std::pair<std::size_t, std::size_t>> FindChangedRanges(std::span<const u8> original,
+                                                                   std::span<const u8> patched) {
+    std::vector<std::pair<std::size_t, std::size_t>> ranges;
+    const std::size_t size = std::min(original.size(), patched.size());
+    for (std::size_t block = 0; block < size; block += COMPARE_BLOCK_SIZE) {
+        const std::size_t block_end = std::min(block + COMPARE_BLOCK_SIZE, size);
+        if (std::memcmp(original.data() + block, patched.data() + block, block_end - block) == 0) {
+            continue;
+        }
+        for (std::size_t offset = block; offset < block_end; ++offset) {
+            if (original[offset] == patched[offset]) {
+                continue;
+            }
+            if (!ranges.empty() && offset - ranges.back().second <= MERGE_DISTANCE) {
+                ranges.back().second = offset + 1;
+            } else {
+                ranges.emplace_back(offset, offset + 1);
+            }
+        }
+    }
+    return ranges;
+}
+} // Anonymous namespace
+
+NSOPatchCache::NSOPatchCache(std::filesystem::path path_, const BuildID& build_id,
+                             std::size_t image_size_, const std::vector<VirtualFile>& patches)
+    : path{std::move(path_)}, image_size{image_size_} {
+    u64 hash = HashBytes(build_id, CACHE_VERSION);
+    for (const auto& patch : patches) {
+        const auto mod_dir = patch->GetContainingDirectory();
+        if (mod_dir != nullptr && mod_dir->GetParentDirectory() != nullptr) {
+            hash = HashString(mod_dir->GetParentDirectory()->GetName() + '/', hash);
+        }
+        hash = HashString(patch->GetName(), hash);
+        hash = HashBytes(patch->ReadAllBytes(), hash);
+    }
+    key = hash;
+}
+
+NSOPatchCache::~NSOPatchCache() = default;
+
+bool NSOPatchCache::Load(std::span<u8> image) const {
+    if (image.size() != image_size) {
+        return false;
+    }
+
+    const Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return false;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadSpan(std::span<u8>{data}) != data.size()) {
+        return false;
+    }
+
+    CacheHeader header{};
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key ||
+        header.image_size != image_size) {
+        return false;
+    }
+
+    // Validate every range before changing the image
+    std::size_t position = sizeof(header);
+    for (u64 index = 0; index < header.num_ranges; ++index) {
+        RangeRecord record{};
+        if (data.size() - position < sizeof(record)) {
+            return false;
+        }
+        std::memcpy(&record, data.data() + position, sizeof(record));
+        position += sizeof(record);
+        if (record.offset > image.size() || image.size() - record.offset < record.size ||
+            data.size() - position < record.size) {
+            return false;
+        }
+        position += record.size;
+    }
+
+    position = sizeof(header);
+    for (u64 index = 0; index < header.num_ranges; ++index) {
+        RangeRecord record{};
+        std::memcpy(&record, data.data() + position, sizeof(record));
+        position += sizeof(record);
+        std::memcpy(image.data() + record.offset, data.data() + position, record.size);
+        position += record.size;
+    }
+    return true;
+}
+
+void NSOPatchCache::Store(std::span<const u8> original, std::span<const u8> patched) const {
+    if (original.size() != image_size) {
+        return;
+    }
+
+    const auto ranges = FindChangedRanges(original, patched);
+
+    std::vector<u8> out;
+    Append(out, CacheHeader{
+                    .magic = CACHE_MAGIC,
+                    .version = CACHE_VERSION,
+                    .key = key,
+                    .image_size = image_size,
+                    .num_ranges = ranges.size(),
+                });
+    for (const auto& [begin, end] : ranges) {
+        Append(out, RangeRecord{
+                        .offset = begin,
+                        .size = end - begin,
+                    });
+        out.insert(out.end(), patched.begin() + begin, patched.begin() + end);
+    }
+
+    if (!Common::FS::CreateParentDirs(path)) {
+        LOG_WARNING(Loader, "Failed to create the NSO patch cache directory");
+        return;
+    }
+    const Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || file.WriteSpan(std::span<const u8>{out}) != out.size()) {
+        LOG_WARNING(Loader, "Failed to write the NSO patch cache to {}",
+                    Common::FS::PathToUTF8String(path));
+    }
+}
+
+} // namespace FileSys
@@ -0,0 +1,45 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <span>
+#include <vector>
+#include "common/common_types.h"
+#include "core/file_sys/vfs_types.h"
+
+namespace FileSys {
+
+// Persists the changes IPS and IPSwitch patches make to the program image of an NSO, so a module
+// whose patches did not change since the last boot is patched without running them again.
+//
+// An entry is keyed on the build ID of the module, the size of its image and the names and
+// contents of the patches applied to it. Only the ranges of the image the patches changed are
+// stored.
+class NSOPatchCache {
+public:
+    using BuildID = std::array<u8, 0x20>;
+
+    // path is the file the entry is stored in, patches are the patch files applied to the image in
+    // the order they are applied.
+    NSOPatchCache(std::filesystem::path path_, const BuildID& build_id, std::size_t image_size,
+                  const std::vector<VirtualFile>& patches);
+    ~NSOPatchCache();
+
+    // Applies the cached changes to image. Returns false, leaving image untouched, when there is
+    // no valid entry for the current inputs.
+    [[nodiscard]] bool Load(std::span<u8> image) const;
+
+    // Stores the changes between the image before and after applying the patches.
+    void Store(std::span<const u8> original, std::span<const u8> patched) const;
+
+private:
+    std::filesystem::path path;
+    std::size_t image_size;
+    u64 key;
+};
+
+} // namespace FileSys
@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <cstring>
 
+#include "common/fs/path_util.h"
 #include "common/hex_util.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
@@ -15,10 +16,14 @@
 #include "core/file_sys/common_funcs.h"
 #include "core/file_sys/content_archive.h"
 #include "core/file_sys/control_metadata.h"
+#include "core/file_sys/fsmitm_romfsbuild.h"
 #include "core/file_sys/ips_layer.h"
+#include "core/file_sys/nso_patch_cache.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/romfs.h"
+#include "core/file_sys/romfs_build_cache.h"
+#include "core/file_sys/vfs_concat.h"
 #include "core/file_sys/vfs_layered.h"
 #include "core/file_sys/vfs_vector.h"
 #include "core/hle/service/filesystem/filesystem.h"
@@ -288,6 +293,47 @@ std::vector<u8> PatchManager::PatchNSO(const std::vector<u8>& nso, const std::st
     return out;
 }
 
+void PatchManager::PatchNSOImage(std::span<u8> image, const Loader::NSOHeader& header,
+                                 const std::string& name) const {
+    const auto build_id_raw = Common::HexToString(header.build_id);
+    const auto build_id = build_id_raw.substr(0, build_id_raw.find_last_not_of('0') + 1);
+
+    std::vector<VirtualFile> patches;
+    if (const auto load_dir = fs_controller.GetModificationLoadRoot(title_id)) {
+        auto patch_dirs = load_dir->GetSubdirectories();
+        std::sort(patch_dirs.begin(), patch_dirs.end(),
+                  [](const VirtualDir& l, const VirtualDir& r) {
+                      return l->GetName() < r->GetName();
+                  });
+        patches = CollectPatches(patch_dirs, build_id);
+    }
+    if (patches.empty() && !Settings::values.dump_nso) {
+        return;
+    }
+
+    const auto cache_path = Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) /
+                            "nso_patches" / fmt::format("{:016X}_{}.bin", title_id, build_id);
+    const NSOPatchCache cache{cache_path, header.build_id, image.size(), patches};
+
+    // Dumping needs the unpatched image, which the cache skips
+    if (!patches.empty() && !Settings::values.dump_nso && cache.Load(image)) {
+        LOG_INFO(Loader, "Patched NSO for name={}, build_id={} from cache", name, build_id);
+        return;
+    }
+
+    std::vector<u8> nso(sizeof(header) + image.size());
+    std::memcpy(nso.data(), &header, sizeof(header));
+    std::memcpy(nso.data() + sizeof(header), image.data(), image.size());
+
+    const auto patched = PatchNSO(nso, name);
+    const auto patched_image = std::span{patched}.subspan(
+        sizeof(header), std::min(patched.size() - sizeof(header), image.size()));
+    if (!patches.empty()) {
+        cache.Store(image, patched_image);
+    }
+    std::copy(patched_image.begin(), patched_image.end(), image.begin());
+}
+
 bool PatchManager::HasNSOPatch(const BuildID& build_id_) const {
     const auto build_id_raw = Common::HexToString(build_id_);
     const auto build_id = build_id_raw.substr(0, build_id_raw.find_last_not_of('0') + 1);
@@ -388,6 +434,10 @@ static void ApplyLayeredFS(VirtualFile& romfs, u64 title_id, ContentRecordType t
         return;
     }
 
+    const auto cache_path = Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) / "layeredfs" /
+                            fmt::format("{:016X}_{:02X}.bin", title_id, static_cast<u8>(type));
+    const RomFSBuildCache cache{cache_path, romfs, layers, layers_ext};
+
     layers.push_back(std::move(extracted));
 
     auto layered = LayeredVfsDirectory::MakeLayeredDirectory(std::move(layers));
@@ -397,7 +447,17 @@ static void ApplyLayeredFS(VirtualFile& romfs, u64 title_id, ContentRecordType t
 
     auto layered_ext = LayeredVfsDirectory::MakeLayeredDirectory(std::move(layers_ext));
 
-    auto packed = CreateRomFS(std::move(layered), std::move(layered_ext));
+    if (auto cached = cache.Load(layered, layered_ext)) {
+        LOG_INFO(Loader, "    RomFS: LayeredFS patches applied from cache");
+        romfs = std::move(cached);
+        return;
+    }
+
+    RomFSBuildContext context{layered, layered_ext};
+    auto image = context.Build();
+    cache.Store(context, image);
+
+    auto packed = ConcatenatedVfsFile::MakeConcatenatedFile(0, std::move(image), layered->GetName());
     if (packed == nullptr) {
         return;
     }
@@ -454,7 +514,7 @@ VirtualFile PatchManager::PatchRomFS(VirtualFile romfs, u64 ivfc_offset, Content
     return romfs;
 }
 
-PatchManager::PatchVersionNames PatchManager::GetPatchVersionNames(VirtualFile update_raw) const {
+PatchManager::PatchVersionNames PatchManager::GetPatchVersionNames(bool has_packed_update) const {
     if (title_id == 0) {
         return {};
     }
@@ -482,7 +542,7 @@ PatchManager::PatchVersionNames PatchManager::GetPatchVersionNames(VirtualFile u
             } else {
                 out.insert_or_assign(update_label, FormatTitleVersion(*meta_ver));
             }
-        } else if (update_raw != nullptr) {
+        } else if (has_packed_update) {
             out.insert_or_assign(update_label, "PACKED");
         }
     }
@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include "common/common_types.h"
 #include "core/file_sys/nca_metadata.h"
@@ -17,6 +18,10 @@ namespace Core {
 class System;
 }
 
+namespace Loader {
+struct NSOHeader;
+}
+
 namespace Service::FileSystem {
 class FileSystemController;
 }
@@ -51,6 +56,12 @@ public:
     [[nodiscard]] std::vector<u8> PatchNSO(const std::vector<u8>& nso,
                                            const std::string& name) const;
 
+    // Applies the NSO patches to the program image of an NSO in place. The changes made by the
+    // patches are cached on disk, later loads of the same module with the same patches apply them
+    // without running the patches.
+    void PatchNSOImage(std::span<u8> image, const Loader::NSOHeader& header,
+                       const std::string& name) const;
+
     // Checks to see if PatchNSO() will have any effect given the NSO's build ID.
     // Used to prevent expensive copies in NSO loader.
     [[nodiscard]] bool HasNSOPatch(const BuildID& build_id) const;
@@ -69,7 +80,8 @@ public:
 
     // Returns a vector of pairs between patch names and patch versions.
     // i.e. Update 3.2.2 will return {"Update", "3.2.2"}
-    [[nodiscard]] PatchVersionNames GetPatchVersionNames(VirtualFile update_raw = nullptr) const;
+    // has_packed_update is whether the file of the title also holds its update.
+    [[nodiscard]] PatchVersionNames GetPatchVersionNames(bool has_packed_update = false) const;
 
     // If the game update exists, returns the u32 version field in its Meta-type NCA. If that fails,
     // it will fallback to the Meta-type NCA of the base game. If that fails, the result will be
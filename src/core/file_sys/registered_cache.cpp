@@ -204,7 +204,7 @@ bool PlaceholderCache::Register(RegisteredCache* cache, const NcaID& placeholder
     if (file == nullptr)
         return false;
 
-    const auto res = cache->RawInstallNCA(NCA{file}, &VfsRawCopy, false, install);
+    const auto res = cache->RawInstallNCA(NCA{file}, {}, false, install);
 
     if (res != InstallResult::Success)
         return false;
@@ -556,12 +556,12 @@ static std::shared_ptr<NCA> GetNCAFromNSPForID(const NSP& nsp, const NcaID& id)
 }
 
 InstallResult RegisteredCache::InstallEntry(const XCI& xci, bool overwrite_if_exists,
-                                            const VfsCopyFunction& copy) {
-    return InstallEntry(*xci.GetSecurePartitionNSP(), overwrite_if_exists, copy);
+                                            const CopyProgressCallback& progress) {
+    return InstallEntry(*xci.GetSecurePartitionNSP(), overwrite_if_exists, progress);
 }
 
 InstallResult RegisteredCache::InstallEntry(const NSP& nsp, bool overwrite_if_exists,
-                                            const VfsCopyFunction& copy) {
+                                            const CopyProgressCallback& progress) {
     const auto ncas = nsp.GetNCAsCollapsed();
     const auto meta_iter = std::find_if(ncas.begin(), ncas.end(), [](const auto& nca) {
         return nca->GetType() == NCAContentType::Meta;
@@ -605,7 +605,7 @@ InstallResult RegisteredCache::InstallEntry(const NSP& nsp, bool overwrite_if_ex
     const auto result = RemoveExistingEntry(title_id);
 
     // Install Metadata File
-    const auto res = RawInstallNCA(**meta_iter, copy, overwrite_if_exists, meta_id_data);
+    const auto res = RawInstallNCA(**meta_iter, progress, overwrite_if_exists, meta_id_data);
     if (res != InstallResult::Success) {
         return res;
     }
@@ -620,7 +620,8 @@ InstallResult RegisteredCache::InstallEntry(const NSP& nsp, bool overwrite_if_ex
         if (nca == nullptr) {
             return InstallResult::ErrorCopyFailed;
         }
-        const auto res2 = RawInstallNCA(*nca, copy, overwrite_if_exists, record.nca_id);
+        const auto res2 =
+            RawInstallNCA(*nca, progress, overwrite_if_exists, record.nca_id, record.hash);
         if (res2 != InstallResult::Success) {
             return res2;
         }
@@ -634,7 +635,8 @@ InstallResult RegisteredCache::InstallEntry(const NSP& nsp, bool overwrite_if_ex
 }
 
 InstallResult RegisteredCache::InstallEntry(const NCA& nca, TitleType type,
-                                            bool overwrite_if_exists, const VfsCopyFunction& copy) {
+                                            bool overwrite_if_exists,
+                                            const CopyProgressCallback& progress) {
     const CNMTHeader header{
         .title_id = nca.GetTitleId(),
         .title_version = 0,
@@ -658,7 +660,7 @@ InstallResult RegisteredCache::InstallEntry(const NCA& nca, TitleType type,
     if (!RawInstallYuzuMeta(new_cnmt)) {
         return InstallResult::ErrorMetaFailed;
     }
-    return RawInstallNCA(nca, copy, overwrite_if_exists, c_rec.nca_id);
+    return RawInstallNCA(nca, progress, overwrite_if_exists, c_rec.nca_id);
 }
 
 bool RegisteredCache::RemoveExistingEntry(u64 title_id) const {
@@ -712,9 +714,10 @@ bool RegisteredCache::RemoveExistingEntry(u64 title_id) const {
     return false;
 }
 
-InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFunction& copy,
+InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const CopyProgressCallback& progress,
                                              bool overwrite_if_exists,
-                                             std::optional<NcaID> override_id) {
+                                             std::optional<NcaID> override_id,
+                                             std::optional<Core::Crypto::SHA256Hash> expected_hash) {
     const auto in = nca.GetBaseFile();
     Core::Crypto::SHA256Hash hash{};
 
@@ -749,8 +752,28 @@ InstallResult RegisteredCache::RawInstallNCA(const NCA& nca, const VfsCopyFuncti
     if (out == nullptr) {
         return InstallResult::ErrorCopyFailed;
     }
-    return copy(in, out, VFS_RC_LARGE_COPY_BLOCK) ? InstallResult::Success
-                                                  : InstallResult::ErrorCopyFailed;
+
+    // Don't leave a partial or corrupt NCA behind
+    const auto remove_output = [&] {
+        const auto c_dir = out->GetContainingDirectory();
+        out.reset();
+        c_dir->DeleteFile(Common::FS::GetFilename(path));
+    };
+
+    // The hash of the NCA is computed while it is copied, so verifying it costs no extra pass
+    Core::Crypto::SHA256Hash copied_hash{};
+    if (!PipelinedCopy(in, out, VFS_RC_LARGE_COPY_BLOCK, progress,
+                       expected_hash ? &copied_hash : nullptr)) {
+        remove_output();
+        return InstallResult::ErrorCopyFailed;
+    }
+    if (expected_hash && copied_hash != *expected_hash) {
+        LOG_ERROR(Loader, "NCA {} does not match the hash in its metadata, the file is corrupt.",
+                  Common::HexToString(id, false));
+        remove_output();
+        return InstallResult::ErrorVerificationFailed;
+    }
+    return InstallResult::Success;
 }
 
 bool RegisteredCache::RawInstallYuzuMeta(const CNMT& cnmt) {
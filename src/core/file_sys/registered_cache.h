@@ -13,6 +13,7 @@
 #include "common/common_types.h"
 #include "core/crypto/key_manager.h"
 #include "core/file_sys/vfs.h"
+#include "core/file_sys/vfs_copy.h"
 
 namespace FileSys {
 class CNMT;
@@ -30,7 +31,6 @@ class RegisteredCache;
 
 using NcaID = std::array<u8, 0x10>;
 using ContentProviderParsingFunction = std::function<VirtualFile(const VirtualFile&, const NcaID&)>;
-using VfsCopyFunction = std::function<bool(const VirtualFile&, const VirtualFile&, size_t)>;
 
 enum class InstallResult {
     Success,
@@ -39,6 +39,7 @@ enum class InstallResult {
     ErrorCopyFailed,
     ErrorMetaFailed,
     ErrorBaseInstall,
+    ErrorVerificationFailed,
 };
 
 struct ContentProviderEntry {
@@ -157,18 +158,19 @@ public:
         std::optional<u64> title_id = {}) const override;
 
     // Raw copies all the ncas from the xci/nsp to the csache. Does some quick checks to make sure
-    // there is a meta NCA and all of them are accessible.
+    // there is a meta NCA and all of them are accessible. Every content NCA is checked against the
+    // hash in the CNMT while it is copied.
     InstallResult InstallEntry(const XCI& xci, bool overwrite_if_exists = false,
-                               const VfsCopyFunction& copy = &VfsRawCopy);
+                               const CopyProgressCallback& progress = {});
     InstallResult InstallEntry(const NSP& nsp, bool overwrite_if_exists = false,
-                               const VfsCopyFunction& copy = &VfsRawCopy);
+                               const CopyProgressCallback& progress = {});
 
     // Due to the fact that we must use Meta-type NCAs to determine the existance of files, this
     // poses quite a challenge. Instead of creating a new meta NCA for this file, yuzu will create a
     // dir inside the NAND called 'yuzu_meta' and store the raw CNMT there.
     // TODO(DarkLordZach): Author real meta-type NCAs and install those.
     InstallResult InstallEntry(const NCA& nca, TitleType type, bool overwrite_if_exists = false,
-                               const VfsCopyFunction& copy = &VfsRawCopy);
+                               const CopyProgressCallback& progress = {});
 
     // Removes an existing entry based on title id
     bool RemoveExistingEntry(u64 title_id) const;
@@ -184,8 +186,9 @@ private:
     std::optional<NcaID> GetNcaIDFromMetadata(u64 title_id, ContentRecordType type) const;
     VirtualFile GetFileAtID(NcaID id) const;
     VirtualFile OpenFileOrDirectoryConcat(const VirtualDir& open_dir, std::string_view path) const;
-    InstallResult RawInstallNCA(const NCA& nca, const VfsCopyFunction& copy,
-                                bool overwrite_if_exists, std::optional<NcaID> override_id = {});
+    InstallResult RawInstallNCA(const NCA& nca, const CopyProgressCallback& progress,
+                                bool overwrite_if_exists, std::optional<NcaID> override_id = {},
+                                std::optional<Core::Crypto::SHA256Hash> expected_hash = {});
     bool RawInstallYuzuMeta(const CNMT& cnmt);
 
     VirtualDir dir;
@@ -2,8 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
 
+#include "common/assert.h"
 #include "common/common_types.h"
 #include "common/string_util.h"
 #include "common/swap.h"
@@ -12,7 +18,6 @@
 #include "core/file_sys/vfs.h"
 #include "core/file_sys/vfs_concat.h"
 #include "core/file_sys/vfs_offset.h"
-#include "core/file_sys/vfs_vector.h"
 
 namespace FileSys {
 namespace {
@@ -35,13 +40,14 @@ struct RomFSHeader {
 static_assert(sizeof(RomFSHeader) == 0x50, "RomFSHeader has incorrect size.");
 
 struct DirectoryEntry {
+    u32_le parent;
     u32_le sibling;
     u32_le child_dir;
     u32_le child_file;
     u32_le hash;
     u32_le name_length;
 };
-static_assert(sizeof(DirectoryEntry) == 0x14, "DirectoryEntry has incorrect size.");
+static_assert(sizeof(DirectoryEntry) == 0x18, "DirectoryEntry has incorrect size.");
 
 struct FileEntry {
     u32_le parent;
@@ -54,56 +60,201 @@ struct FileEntry {
 static_assert(sizeof(FileEntry) == 0x20, "FileEntry has incorrect size.");
 
 template <typename Entry>
-std::pair<Entry, std::string> GetEntry(const VirtualFile& file, std::size_t offset) {
-    Entry entry{};
-    if (file->ReadObject(&entry, offset) != sizeof(Entry))
-        return {};
-    std::string string(entry.name_length, '\0');
-    if (file->ReadArray(&string[0], string.size(), offset + sizeof(Entry)) != string.size())
-        return {};
-    return {entry, string};
-}
-
-void ProcessFile(VirtualFile file, std::size_t file_offset, std::size_t data_offset,
-                 u32 this_file_offset, std::shared_ptr<VectorVfsDirectory> parent) {
-    while (true) {
-        auto entry = GetEntry<FileEntry>(file, file_offset + this_file_offset);
+struct EntryView {
+    Entry entry;
+    std::string_view name;
+};
 
-        parent->AddFile(std::make_shared<OffsetVfsFile>(
-            file, entry.first.size, entry.first.offset + data_offset, entry.second));
+// Reads the entry at the given offset of a metadata table, returns std::nullopt when the entry
+// does not fit in the table.
+template <typename Entry>
+std::optional<EntryView<Entry>> GetEntry(const std::vector<u8>& table, u32 offset) {
+    if (offset > table.size() || table.size() - offset < sizeof(Entry)) {
+        return std::nullopt;
+    }
+    EntryView<Entry> view{};
+    std::memcpy(&view.entry, table.data() + offset, sizeof(Entry));
 
-        if (entry.first.sibling == ROMFS_ENTRY_EMPTY)
-            break;
+    const std::size_t name_offset = offset + sizeof(Entry);
+    if (table.size() - name_offset < view.entry.name_length) {
+        return std::nullopt;
+    }
+    view.name = std::string_view{reinterpret_cast<const char*>(table.data() + name_offset),
+                                 view.entry.name_length};
+    return view;
+}
 
-        this_file_offset = entry.first.sibling;
+// Hashes a name the way the RomFS hash tables are keyed. Names are hashed byte by byte, images
+// built by Nintendo hash bytes as unsigned while the ones built by RomFSBuildContext on hosts with
+// a signed char sign-extend them, which only makes a difference for non-ASCII names.
+template <typename Byte>
+u32 CalcPathHash(u32 parent, std::string_view name) {
+    u32 hash = parent ^ 123456789;
+    for (const char c : name) {
+        hash = (hash >> 5) | (hash << 27);
+        hash ^= static_cast<u32>(static_cast<Byte>(c));
     }
+    return hash;
 }
 
-void ProcessDirectory(VirtualFile file, std::size_t dir_offset, std::size_t file_offset,
-                      std::size_t data_offset, u32 this_dir_offset,
-                      std::shared_ptr<VectorVfsDirectory> parent) {
-    while (true) {
-        auto entry = GetEntry<DirectoryEntry>(file, dir_offset + this_dir_offset);
-        auto current = std::make_shared<VectorVfsDirectory>(
-            std::vector<VirtualFile>{}, std::vector<VirtualDir>{}, entry.second);
+bool HasNonAsciiCharacters(std::string_view name) {
+    return std::any_of(name.begin(), name.end(),
+                       [](char c) { return (static_cast<u8>(c) & 0x80) != 0; });
+}
 
-        if (entry.first.child_file != ROMFS_ENTRY_EMPTY) {
-            ProcessFile(file, file_offset, data_offset, entry.first.child_file, current);
+// Walks the hash bucket of the given name and returns the offset of the matching entry, or
+// ROMFS_ENTRY_EMPTY when there is none.
+template <typename Entry>
+u32 FindInBucket(const std::vector<u32_le>& hash_table, const std::vector<u8>& table, u32 parent,
+                 std::string_view name, u32 hash) {
+    if (hash_table.empty()) {
+        return ROMFS_ENTRY_EMPTY;
+    }
+    // Bound the walk by the number of entries that fit in the table to survive cyclic chains
+    std::size_t remaining = table.size() / sizeof(Entry) + 1;
+    u32 offset = hash_table[hash % hash_table.size()];
+    while (offset != ROMFS_ENTRY_EMPTY && remaining-- > 0) {
+        const auto view = GetEntry<Entry>(table, offset);
+        if (!view) {
+            break;
         }
-
-        if (entry.first.child_dir != ROMFS_ENTRY_EMPTY) {
-            ProcessDirectory(file, dir_offset, file_offset, data_offset, entry.first.child_dir,
-                             current);
+        if (view->entry.parent == parent && view->name == name) {
+            return offset;
         }
+        offset = view->entry.hash;
+    }
+    return ROMFS_ENTRY_EMPTY;
+}
 
-        parent->AddDirectory(current);
-        if (entry.first.sibling == ROMFS_ENTRY_EMPTY)
+template <typename Entry>
+u32 FindEntry(const std::vector<u32_le>& hash_table, const std::vector<u8>& table, u32 parent,
+              std::string_view name) {
+    const u32 offset =
+        FindInBucket<Entry>(hash_table, table, parent, name, CalcPathHash<u8>(parent, name));
+    if (offset != ROMFS_ENTRY_EMPTY || !HasNonAsciiCharacters(name)) {
+        return offset;
+    }
+    return FindInBucket<Entry>(hash_table, table, parent, name,
+                               CalcPathHash<s8>(parent, name));
+}
+
+// Calls func with every entry of a sibling chain, stops early when func returns false
+template <typename Entry, typename Func>
+void ForEachSibling(const std::vector<u8>& table, u32 offset, Func&& func) {
+    std::size_t remaining = table.size() / sizeof(Entry) + 1;
+    while (offset != ROMFS_ENTRY_EMPTY && remaining-- > 0) {
+        const auto view = GetEntry<Entry>(table, offset);
+        if (!view || !func(offset, *view)) {
             break;
-        this_dir_offset = entry.first.sibling;
+        }
+        offset = view->entry.sibling;
     }
 }
+
+template <typename T>
+bool ReadTable(const VirtualFile& file, const TableLocation& location, std::vector<T>& out) {
+    const std::size_t file_size = file->GetSize();
+    if (location.offset > file_size || file_size - location.offset < location.size) {
+        return false;
+    }
+    out.resize(location.size / sizeof(T));
+    const std::size_t size = out.size() * sizeof(T);
+    return file->ReadBytes(out.data(), size, location.offset) == size;
+}
 } // Anonymous namespace
 
+struct RomFSMetadata {
+    VirtualFile file;
+    u64 data_offset;
+    std::vector<u32_le> directory_hash;
+    std::vector<u8> directory_meta;
+    std::vector<u32_le> file_hash;
+    std::vector<u8> file_meta;
+};
+
+RomFSVfsDirectory::RomFSVfsDirectory(std::shared_ptr<const RomFSMetadata> metadata_,
+                                     u32 entry_offset_)
+    : metadata{std::move(metadata_)}, entry_offset{entry_offset_} {
+    const auto view = GetEntry<DirectoryEntry>(metadata->directory_meta, entry_offset);
+    ASSERT(view);
+    child_dir = view->entry.child_dir;
+    child_file = view->entry.child_file;
+    name = std::string{view->name};
+}
+
+RomFSVfsDirectory::~RomFSVfsDirectory() = default;
+
+std::vector<VirtualFile> RomFSVfsDirectory::GetFiles() const {
+    std::vector<VirtualFile> files;
+    ForEachSibling<FileEntry>(metadata->file_meta, child_file,
+                              [&](u32, const EntryView<FileEntry>& view) {
+                                  files.push_back(std::make_shared<OffsetVfsFile>(
+                                      metadata->file, view.entry.size,
+                                      view.entry.offset + metadata->data_offset,
+                                      std::string{view.name}));
+                                  return true;
+                              });
+    return files;
+}
+
+VirtualFile RomFSVfsDirectory::GetFile(std::string_view file_name) const {
+    const u32 offset =
+        FindEntry<FileEntry>(metadata->file_hash, metadata->file_meta, entry_offset, file_name);
+    if (offset == ROMFS_ENTRY_EMPTY) {
+        return nullptr;
+    }
+    const auto view = GetEntry<FileEntry>(metadata->file_meta, offset);
+    return std::make_shared<OffsetVfsFile>(metadata->file, view->entry.size,
+                                           view->entry.offset + metadata->data_offset,
+                                           std::string{view->name});
+}
+
+std::vector<VirtualDir> RomFSVfsDirectory::GetSubdirectories() const {
+    std::vector<VirtualDir> subdirectories;
+    ForEachSibling<DirectoryEntry>(metadata->directory_meta, child_dir,
+                                   [&](u32 offset, const EntryView<DirectoryEntry>&) {
+                                       subdirectories.push_back(
+                                           std::make_shared<RomFSVfsDirectory>(metadata, offset));
+                                       return true;
+                                   });
+    return subdirectories;
+}
+
+VirtualDir RomFSVfsDirectory::GetSubdirectory(std::string_view subdirectory_name) const {
+    const u32 offset = FindEntry<DirectoryEntry>(metadata->directory_hash,
+                                                 metadata->directory_meta, entry_offset,
+                                                 subdirectory_name);
+    if (offset == ROMFS_ENTRY_EMPTY) {
+        return nullptr;
+    }
+    return std::make_shared<RomFSVfsDirectory>(metadata, offset);
+}
+
+std::string RomFSVfsDirectory::GetName() const {
+    return name;
+}
+
+VirtualDir RomFSVfsDirectory::GetParentDirectory() const {
+    // Like the extracted trees this replaces, every directory is treated as a root so absolute
+    // paths resolve relative to the directory returned by ExtractRomFS.
+    return nullptr;
+}
+
+std::map<std::string, VfsEntryType, std::less<>> RomFSVfsDirectory::GetEntries() const {
+    std::map<std::string, VfsEntryType, std::less<>> out;
+    ForEachSibling<DirectoryEntry>(metadata->directory_meta, child_dir,
+                                   [&](u32, const EntryView<DirectoryEntry>& view) {
+                                       out.emplace(view.name, VfsEntryType::Directory);
+                                       return true;
+                                   });
+    ForEachSibling<FileEntry>(metadata->file_meta, child_file,
+                              [&](u32, const EntryView<FileEntry>& view) {
+                                  out.emplace(view.name, VfsEntryType::File);
+                                  return true;
+                              });
+    return out;
+}
+
 VirtualDir ExtractRomFS(VirtualFile file, RomFSExtractionType type) {
     RomFSHeader header{};
     if (file->ReadObject(&header) != sizeof(RomFSHeader))
@@ -112,28 +263,43 @@ VirtualDir ExtractRomFS(VirtualFile file, RomFSExtractionType type) {
     if (header.header_size != sizeof(RomFSHeader))
         return nullptr;
 
-    const u64 file_offset = header.file_meta.offset;
-    const u64 dir_offset = header.directory_meta.offset + 4;
+    auto metadata = std::make_shared<RomFSMetadata>();
+    metadata->file = file;
+    metadata->data_offset = header.data_offset;
+    if (!ReadTable(file, header.directory_hash, metadata->directory_hash) ||
+        !ReadTable(file, header.directory_meta, metadata->directory_meta) ||
+        !ReadTable(file, header.file_hash, metadata->file_hash) ||
+        !ReadTable(file, header.file_meta, metadata->file_meta)) {
+        return nullptr;
+    }
 
-    auto root =
-        std::make_shared<VectorVfsDirectory>(std::vector<VirtualFile>{}, std::vector<VirtualDir>{},
-                                             file->GetName(), file->GetContainingDirectory());
+    const auto& directories = metadata->directory_meta;
+    if (!GetEntry<DirectoryEntry>(directories, 0))
+        return nullptr;
 
-    ProcessDirectory(file, dir_offset, file_offset, header.data_offset, 0, root);
+    // The root directory is always at the start of the directory table
+    u32 out = 0;
 
-    VirtualDir out = std::move(root);
+    if (type != RomFSExtractionType::SingleDiscard) {
+        // Descend while the directory only holds a single subdirectory
+        while (true) {
+            const auto entry = GetEntry<DirectoryEntry>(directories, out);
+            if (entry->entry.child_file != ROMFS_ENTRY_EMPTY ||
+                entry->entry.child_dir == ROMFS_ENTRY_EMPTY)
+                break;
 
-    if (type == RomFSExtractionType::SingleDiscard)
-        return out->GetSubdirectories().front();
+            const auto child = GetEntry<DirectoryEntry>(directories, entry->entry.child_dir);
+            if (!child || child->entry.sibling != ROMFS_ENTRY_EMPTY)
+                break;
 
-    while (out->GetSubdirectories().size() == 1 && out->GetFiles().empty()) {
-        if (Common::ToLower(out->GetSubdirectories().front()->GetName()) == "data" &&
-            type == RomFSExtractionType::Truncated)
-            break;
-        out = out->GetSubdirectories().front();
+            if (Common::ToLower(std::string{child->name}) == "data" &&
+                type == RomFSExtractionType::Truncated)
+                break;
+            out = entry->entry.child_dir;
+        }
     }
 
-    return out;
+    return std::make_shared<RomFSVfsDirectory>(std::move(metadata), out);
 }
 
 VirtualFile CreateRomFS(VirtualDir dir, VirtualDir ext) {
@@ -8,12 +8,38 @@
 
 namespace FileSys {
 
+struct RomFSMetadata;
+
 enum class RomFSExtractionType {
     Full,          // Includes data directory
     Truncated,     // Traverses into data directory
     SingleDiscard, // Traverses into the first subdirectory of root
 };
 
+// A read-only directory backed by the metadata tables of a RomFS image. The tables are kept in
+// their raw form and shared by every directory of the image, names are looked up through the hash
+// tables stored in the image and file objects are only created when requested.
+class RomFSVfsDirectory : public ReadOnlyVfsDirectory {
+public:
+    RomFSVfsDirectory(std::shared_ptr<const RomFSMetadata> metadata_, u32 entry_offset_);
+    ~RomFSVfsDirectory() override;
+
+    std::vector<VirtualFile> GetFiles() const override;
+    VirtualFile GetFile(std::string_view name) const override;
+    std::vector<VirtualDir> GetSubdirectories() const override;
+    VirtualDir GetSubdirectory(std::string_view name) const override;
+    std::string GetName() const override;
+    VirtualDir GetParentDirectory() const override;
+    std::map<std::string, VfsEntryType, std::less<>> GetEntries() const override;
+
+private:
+    std::shared_ptr<const RomFSMetadata> metadata;
+    u32 entry_offset;
+    u32 child_dir;
+    u32 child_file;
+    std::string name;
+};
+
 // Converts a RomFS binary blob to VFS Filesystem
 // Returns nullptr on failure
 VirtualDir ExtractRomFS(VirtualFile file,
@@ -0,0 +1,324 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "core/file_sys/fsmitm_romfsbuild.h"
+#include "core/file_sys/ips_layer.h"
+#include "core/file_sys/romfs_build_cache.h"
+#include "core/file_sys/vfs_concat.h"
+#include "core/file_sys/vfs_layered.h"
+#include "core/file_sys/vfs_offset.h"
+#include "core/file_sys/vfs_vector.h"
+
+namespace FileSys {
+namespace {
+constexpr u32 CACHE_MAGIC = Common::MakeMagic('Y', 'R', 'F', 'C');
+constexpr u32 CACHE_VERSION = 1;
+
+// Marks files that are not read straight from the base RomFS.
+constexpr u64 NOT_IN_BASE = ~u64{0};
+
+struct CacheHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le key;
+    u64_le romfs_header_size;
+    u64_le metadata_offset;
+    u64_le metadata_size;
+    u64_le num_files;
+};
+static_assert(sizeof(CacheHeader) == 0x30, "CacheHeader has incorrect size.");
+
+struct FileRecord {
+    u64_le offset;
+    u64_le size;
+    u64_le base_offset;
+    u32_le path_length;
+    INSERT_PADDING_BYTES(4);
+};
+static_assert(sizeof(FileRecord) == 0x20, "FileRecord has incorrect size.");
+
+struct TableLocation {
+    u64_le offset;
+    u64_le size;
+};
+
+struct RomFSHeader {
+    u64_le header_size;
+    TableLocation directory_hash;
+    TableLocation directory_meta;
+    TableLocation file_hash;
+    TableLocation file_meta;
+    u64_le data_offset;
+};
+static_assert(sizeof(RomFSHeader) == 0x50, "RomFSHeader has incorrect size.");
+
+u64 HashBytes(std::span<const u8> data, u64 hash) {
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(data.data()), data.size(), hash);
+}
+
+template <typename T>
+u64 HashObject(const T& object, u64 hash) {
+    return HashBytes(std::span{reinterpret_cast<const u8*>(&object), sizeof(T)}, hash);
+}
+
+u64 HashString(std::string_view string, u64 hash) {
+    return HashBytes(std::span{reinterpret_cast<const u8*>(string.data()), string.size()}, hash);
+}
+
+// Hashes the header and the metadata tables of a RomFS, which identify its layout.
+std::optional<u64> HashRomFSMetadata(const VirtualFile& romfs) {
+    RomFSHeader header{};
+    if (romfs->ReadObject(&header) != sizeof(RomFSHeader) ||
+        header.header_size != sizeof(RomFSHeader)) {
+        return std::nullopt;
+    }
+
+    u64 hash = HashObject(header, CACHE_VERSION);
+    for (const TableLocation& table : {header.directory_hash, header.directory_meta,
+                                       header.file_hash, header.file_meta}) {
+        const auto data = romfs->ReadBytes(table.size, table.offset);
+        if (data.size() != table.size) {
+            return std::nullopt;
+        }
+        hash = HashBytes(data, hash);
+    }
+    return hash;
+}
+
+// Hashes the names and sizes of every entry under dir, in name order.
+u64 HashDirectoryListing(const VirtualDir& dir, u64 hash) {
+    const auto by_name = [](const auto& lhs, const auto& rhs) {
+        return lhs->GetName() < rhs->GetName();
+    };
+
+    auto files = dir->GetFiles();
+    std::sort(files.begin(), files.end(), by_name);
+    for (const auto& file : files) {
+        hash = HashString(file->GetName(), hash);
+        hash = HashObject(static_cast<u64>(file->GetSize()), hash);
+    }
+
+    auto subdirs = dir->GetSubdirectories();
+    std::sort(subdirs.begin(), subdirs.end(), by_name);
+    for (const auto& subdir : subdirs) {
+        hash = HashString(subdir->GetName() + '/', hash);
+        hash = HashDirectoryListing(subdir, hash);
+    }
+    return hash;
+}
+
+template <typename T>
+void Append(std::vector<u8>& out, const T& object) {
+    const auto* const data = reinterpret_cast<const u8*>(&object);
+    out.insert(out.end(), data, data + sizeof(T));
+}
+
+void AppendBytes(std::vector<u8>& out, std::span<const u8> data) {
+    out.insert(out.end(), data.begin(), data.end());
+}
+
+// Bounds checked reads from a cache entry.
+class CacheReader {
+public:
+    explicit CacheReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    bool Read(T& object) {
+        if (data.size() - position < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&object, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    std::span<const u8> ReadBytes(std::size_t size, bool& ok) {
+        if (data.size() - position < size) {
+            ok = false;
+            return {};
+        }
+        const auto bytes = data.subspan(position, size);
+        position += size;
+        return bytes;
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t position{};
+};
+} // Anonymous namespace
+
+RomFSBuildCache::RomFSBuildCache(std::filesystem::path path_, VirtualFile base_romfs_,
+                                 std::vector<VirtualDir> layers,
+                                 const std::vector<VirtualDir>& layers_ext)
+    : path{std::move(path_)}, base_romfs{std::move(base_romfs_)} {
+    auto hash = HashRomFSMetadata(base_romfs);
+    if (!hash) {
+        return;
+    }
+    for (const auto& layer : layers) {
+        *hash = HashDirectoryListing(layer, HashString("romfs", *hash));
+    }
+    for (const auto& layer : layers_ext) {
+        *hash = HashDirectoryListing(layer, HashString("romfs_ext", *hash));
+    }
+    key = hash;
+    mods = LayeredVfsDirectory::MakeLayeredDirectory(std::move(layers));
+}
+
+RomFSBuildCache::~RomFSBuildCache() = default;
+
+VirtualFile RomFSBuildCache::Load(const VirtualDir& layered, const VirtualDir& layered_ext) const {
+    if (!key) {
+        return nullptr;
+    }
+
+    const Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return nullptr;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadSpan(std::span<u8>{data}) != data.size()) {
+        return nullptr;
+    }
+
+    CacheReader reader{data};
+    CacheHeader header{};
+    if (!reader.Read(header) || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+        header.key != *key) {
+        return nullptr;
+    }
+
+    bool ok = true;
+    const auto romfs_header = reader.ReadBytes(header.romfs_header_size, ok);
+    const auto metadata = reader.ReadBytes(header.metadata_size, ok);
+    if (!ok) {
+        return nullptr;
+    }
+
+    std::multimap<u64, VirtualFile> image;
+    image.emplace(0, std::make_shared<VectorVfsFile>(
+                         std::vector<u8>(romfs_header.begin(), romfs_header.end())));
+    image.emplace(header.metadata_offset,
+                  std::make_shared<VectorVfsFile>(std::vector<u8>(metadata.begin(), metadata.end())));
+
+    const std::size_t base_size = base_romfs->GetSize();
+    for (u64 index = 0; index < header.num_files; ++index) {
+        FileRecord record{};
+        if (!reader.Read(record)) {
+            return nullptr;
+        }
+        const auto path_bytes = reader.ReadBytes(record.path_length, ok);
+        if (!ok) {
+            return nullptr;
+        }
+        const std::string_view file_path{reinterpret_cast<const char*>(path_bytes.data()),
+                                         path_bytes.size()};
+        const auto file_name = std::string{file_path.substr(file_path.rfind('/') + 1)};
+
+        VirtualFile source;
+        if (record.base_offset != NOT_IN_BASE) {
+            if (record.base_offset > base_size || base_size - record.base_offset < record.size) {
+                return nullptr;
+            }
+            source = std::make_shared<OffsetVfsFile>(base_romfs, record.size, record.base_offset,
+                                                     file_name);
+        } else {
+            // Resolve the file the same way RomFSBuildContext does
+            source = layered->GetFileRelative(file_path);
+            if (source == nullptr) {
+                return nullptr;
+            }
+            if (layered_ext != nullptr) {
+                const auto ips = layered_ext->GetFileRelative(std::string{file_path} + ".ips");
+                if (ips != nullptr) {
+                    if (auto patched = PatchIPS(source, ips)) {
+                        source = std::move(patched);
+                    }
+                }
+            }
+            // A mod file that changed size would invalidate the layout
+            if (source->GetSize() != record.size) {
+                return nullptr;
+            }
+        }
+        image.emplace(record.offset, std::move(source));
+    }
+
+    return ConcatenatedVfsFile::MakeConcatenatedFile(0, std::move(image), layered->GetName());
+}
+
+void RomFSBuildCache::Store(const RomFSBuildContext& context,
+                            const std::multimap<u64, VirtualFile>& image) const {
+    if (!key || image.size() < 2) {
+        return;
+    }
+
+    // Build places the image header at the start and the metadata tables after the file data
+    const auto romfs_header = image.begin()->second->ReadAllBytes();
+    const auto& [metadata_offset, metadata_file] = *std::prev(image.end());
+    const auto metadata = metadata_file->ReadAllBytes();
+    const auto layout = context.GetFileLayout();
+
+    std::vector<u8> out;
+    Append(out, CacheHeader{
+                    .magic = CACHE_MAGIC,
+                    .version = CACHE_VERSION,
+                    .key = *key,
+                    .romfs_header_size = romfs_header.size(),
+                    .metadata_offset = metadata_offset,
+                    .metadata_size = metadata.size(),
+                    .num_files = layout.size(),
+                });
+    AppendBytes(out, romfs_header);
+    AppendBytes(out, metadata);
+
+    for (const auto& file : layout) {
+        // Files of the base RomFS that no mod replaces or patches are located by their offset in
+        // it, everything else is resolved by path when loading.
+        u64 base_offset = NOT_IN_BASE;
+        if (!file.patched && (mods == nullptr || mods->GetFileRelative(file.path) == nullptr)) {
+            if (const auto* offset_file = dynamic_cast<const OffsetVfsFile*>(file.source.get())) {
+                base_offset = offset_file->GetOffset();
+            }
+        }
+
+        FileRecord record{};
+        record.offset = file.offset;
+        record.size = file.size;
+        record.base_offset = base_offset;
+        record.path_length = static_cast<u32>(file.path.size());
+        Append(out, record);
+        AppendBytes(out, std::span{reinterpret_cast<const u8*>(file.path.data()), file.path.size()});
+    }
+
+    if (!Common::FS::CreateParentDirs(path)) {
+        LOG_WARNING(Loader, "Failed to create the LayeredFS cache directory");
+        return;
+    }
+    const Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || file.WriteSpan(std::span<const u8>{out}) != out.size()) {
+        LOG_WARNING(Loader, "Failed to write the LayeredFS cache to {}",
+                    Common::FS::PathToUTF8String(path));
+    }
+}
+
+} // namespace FileSys
@@ -0,0 +1,48 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <vector>
+#include "common/common_types.h"
+#include "core/file_sys/vfs.h"
+
+namespace FileSys {
+
+class RomFSBuildContext;
+
+// Persists the layout of RomFS images built for LayeredFS, so a title whose base RomFS and mods did
+// not change since the last boot is mounted without walking and rebuilding the whole image.
+//
+// An entry is keyed on the metadata of the base RomFS and on the names and sizes of every file in
+// the mod directories. Only the image metadata and where each file lives are stored, file data is
+// always read from its source, so editing a mod file in place keeps the entry valid as long as its
+// size is unchanged.
+class RomFSBuildCache {
+public:
+    // path is the file the entry is stored in, layers and layers_ext are the mod directories laid
+    // on top of base_romfs and the directories holding their IPS patches and stubs, highest
+    // priority first.
+    RomFSBuildCache(std::filesystem::path path_, VirtualFile base_romfs_,
+                    std::vector<VirtualDir> layers, const std::vector<VirtualDir>& layers_ext);
+    ~RomFSBuildCache();
+
+    // Remounts the cached image. layered and layered_ext must be the directories the image was
+    // built from. Returns nullptr when there is no valid entry for the current inputs.
+    [[nodiscard]] VirtualFile Load(const VirtualDir& layered, const VirtualDir& layered_ext) const;
+
+    // Stores the image built by context, image being the result of context.Build().
+    void Store(const RomFSBuildContext& context, const std::multimap<u64, VirtualFile>& image) const;
+
+private:
+    std::filesystem::path path;
+    VirtualFile base_romfs;
+    VirtualDir mods;
+    std::optional<u64> key;
+};
+
+} // namespace FileSys
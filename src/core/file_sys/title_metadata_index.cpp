@@ -0,0 +1,534 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/fs_util.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "common/swap.h"
+#include "core/core.h"
+#include "core/file_sys/card_image.h"
+#include "core/file_sys/content_archive.h"
+#include "core/file_sys/control_metadata.h"
+#include "core/file_sys/mode.h"
+#include "core/file_sys/nca_metadata.h"
+#include "core/file_sys/registered_cache.h"
+#include "core/file_sys/submission_package.h"
+#include "core/file_sys/title_metadata_index.h"
+#include "core/file_sys/vfs.h"
+#include "core/file_sys/vfs_offset.h"
+
+namespace FileSys {
+namespace {
+constexpr u32 INDEX_MAGIC = Common::MakeMagic('Y', 'T', 'M', 'I');
+constexpr u32 INDEX_VERSION = 1;
+
+struct IndexHeader {
+    u32_le magic;
+    u32_le version;
+    u64_le files_key;
+    u64_le num_entries;
+};
+static_assert(sizeof(IndexHeader) == 0x18, "IndexHeader has incorrect size.");
+
+enum EntryFlags : u32 {
+    HasProgramId = 1 << 0,
+    RomFSUpdatable = 1 << 1,
+    HasPackedUpdate = 1 << 2,
+    ContentsIndexed = 1 << 3,
+    HasAddOns = 1 << 4,
+};
+
+// Followed by the path, name, developer, version and icon of the entry, then its contents and
+// add-ons.
+struct EntryRecord {
+    u64_le size;
+    s64_le modification_time;
+    u64_le program_id;
+    u64_le add_ons_key;
+    u32_le file_type;
+    u32_le flags;
+    u32_le num_contents;
+    u32_le num_add_ons;
+};
+static_assert(sizeof(EntryRecord) == 0x30, "EntryRecord has incorrect size.");
+
+// Followed by the name of the content.
+struct ContentRecord {
+    u64_le title_id;
+    u64_le offset;
+    u64_le size;
+    u8 title_type;
+    u8 record_type;
+    INSERT_PADDING_BYTES(6);
+};
+static_assert(sizeof(ContentRecord) == 0x20, "ContentRecord has incorrect size.");
+
+u64 HashString(std::string_view string, u64 hash) {
+    return Common::CityHash64WithSeed(string.data(), string.size(), hash);
+}
+
+template <typename T>
+u64 HashObject(const T& object, u64 hash) {
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(&object), sizeof(T), hash);
+}
+
+template <typename T>
+void Append(std::vector<u8>& out, const T& object) {
+    const auto* const data = reinterpret_cast<const u8*>(&object);
+    out.insert(out.end(), data, data + sizeof(T));
+}
+
+void AppendBytes(std::vector<u8>& out, std::span<const u8> data) {
+    Append(out, u32_le{static_cast<u32>(data.size())});
+    out.insert(out.end(), data.begin(), data.end());
+}
+
+void AppendString(std::vector<u8>& out, std::string_view string) {
+    AppendBytes(out, std::span{reinterpret_cast<const u8*>(string.data()), string.size()});
+}
+
+// Bounds checked reads from the index file.
+class IndexReader {
+public:
+    explicit IndexReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    bool Read(T& object) {
+        if (data.size() - position < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&object, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    bool ReadBytes(std::vector<u8>& out) {
+        u32_le size{};
+        if (!Read(size) || data.size() - position < size) {
+            return false;
+        }
+        out.assign(data.begin() + position, data.begin() + position + size);
+        position += size;
+        return true;
+    }
+
+    bool ReadString(std::string& out) {
+        u32_le size{};
+        if (!Read(size) || data.size() - position < size) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(data.data()) + position, size);
+        position += size;
+        return true;
+    }
+
+    bool AtEnd() const {
+        return position == data.size();
+    }
+
+private:
+    std::span<const u8> data;
+    std::size_t position{};
+};
+
+struct FileStamp {
+    u64 size;
+    s64 modification_time;
+};
+
+std::optional<FileStamp> GetFileStamp(const std::string& file_path) {
+    const std::filesystem::path fs_path{Common::FS::ToU8String(file_path)};
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(fs_path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const auto modification_time = std::filesystem::last_write_time(fs_path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    return FileStamp{
+        .size = static_cast<u64>(size),
+        .modification_time = static_cast<s64>(modification_time.time_since_epoch().count()),
+    };
+}
+
+// Returns the offset of a window of container, which may be nested in other windows.
+std::optional<u64> GetOffsetInContainer(VirtualFile file, const VirtualFile& container) {
+    u64 offset = 0;
+    while (file != container) {
+        const auto* const window = dynamic_cast<const OffsetVfsFile*>(file.get());
+        if (window == nullptr) {
+            return std::nullopt;
+        }
+        offset += window->GetOffset();
+        file = window->GetBaseFile();
+    }
+    return offset;
+}
+
+// Lists the contents the game list registers for a NCA, NSP or XCI.
+void IndexContents(TitleMetadata& entry, const VirtualFile& file) {
+    if (entry.file_type == Loader::FileType::NCA) {
+        entry.contents.push_back({
+            .title_type = TitleType::Application,
+            .record_type = GetCRTypeFromNCAType(NCA{file}.GetType()),
+            .title_id = *entry.program_id,
+            .offset = 0,
+            .size = file->GetSize(),
+            .name = file->GetName(),
+        });
+        entry.contents_indexed = true;
+        return;
+    }
+
+    if (entry.file_type != Loader::FileType::NSP && entry.file_type != Loader::FileType::XCI) {
+        entry.contents_indexed = true;
+        return;
+    }
+
+    const auto nsp = entry.file_type == Loader::FileType::NSP ? std::make_shared<NSP>(file)
+                                                              : XCI{file}.GetSecurePartitionNSP();
+    for (const auto& [title_id, title_contents] : nsp->GetNCAs()) {
+        for (const auto& [type, nca] : title_contents) {
+            const auto content_file = nca->GetBaseFile();
+            const auto offset = GetOffsetInContainer(content_file, file);
+            if (!offset) {
+                entry.contents.clear();
+                return;
+            }
+            entry.contents.push_back({
+                .title_type = type.first,
+                .record_type = type.second,
+                .title_id = title_id,
+                .offset = *offset,
+                .size = content_file->GetSize(),
+                .name = content_file->GetName(),
+            });
+        }
+    }
+    entry.contents_indexed = true;
+}
+
+TitleMetadata ParseFile(Core::System& system, const VirtualFilesystem& vfs,
+                        const std::string& file_path, const FileStamp& stamp) {
+    TitleMetadata entry{
+        .size = stamp.size,
+        .modification_time = stamp.modification_time,
+    };
+
+    const auto file = vfs->OpenFile(file_path, Mode::Read);
+    if (file == nullptr) {
+        return entry;
+    }
+    const auto loader = Loader::GetLoader(system, file);
+    if (loader == nullptr) {
+        return entry;
+    }
+    const auto file_type = loader->GetFileType();
+    if (file_type == Loader::FileType::Unknown || file_type == Loader::FileType::Error) {
+        return entry;
+    }
+    entry.file_type = file_type;
+
+    u64 program_id = 0;
+    if (loader->ReadProgramId(program_id) == Loader::ResultStatus::Success) {
+        entry.program_id = program_id;
+    }
+    [[maybe_unused]] const auto icon_result = loader->ReadIcon(entry.icon);
+    [[maybe_unused]] const auto title_result = loader->ReadTitle(entry.name);
+
+    NACP nacp;
+    if (loader->ReadControlData(nacp) == Loader::ResultStatus::Success) {
+        entry.developer = nacp.GetDeveloperName();
+        entry.version = nacp.GetVersionString();
+    }
+
+    entry.romfs_updatable = loader->IsRomFSUpdatable();
+    VirtualFile update_raw;
+    loader->ReadUpdateRaw(update_raw);
+    entry.has_packed_update = update_raw != nullptr;
+
+    if (entry.program_id) {
+        IndexContents(entry, file);
+    }
+    return entry;
+}
+
+void WriteEntry(std::vector<u8>& out, const std::string& file_path, const TitleMetadata& entry) {
+    u32 flags = 0;
+    flags |= entry.program_id ? HasProgramId : 0;
+    flags |= entry.romfs_updatable ? RomFSUpdatable : 0;
+    flags |= entry.has_packed_update ? HasPackedUpdate : 0;
+    flags |= entry.contents_indexed ? ContentsIndexed : 0;
+    flags |= entry.add_ons ? HasAddOns : 0;
+
+    Append(out, EntryRecord{
+                    .size = entry.size,
+                    .modification_time = entry.modification_time,
+                    .program_id = entry.program_id.value_or(0),
+                    .add_ons_key = entry.add_ons_key,
+                    .file_type = static_cast<u32>(entry.file_type),
+                    .flags = flags,
+                    .num_contents = static_cast<u32>(entry.contents.size()),
+                    .num_add_ons = entry.add_ons ? static_cast<u32>(entry.add_ons->size()) : 0,
+                });
+    AppendString(out, file_path);
+    AppendString(out, entry.name);
+    AppendString(out, entry.developer);
+    AppendString(out, entry.version);
+    AppendBytes(out, entry.icon);
+
+    for (const auto& content : entry.contents) {
+        ContentRecord record{};
+        record.title_id = content.title_id;
+        record.offset = content.offset;
+        record.size = content.size;
+        record.title_type = static_cast<u8>(content.title_type);
+        record.record_type = static_cast<u8>(content.record_type);
+        Append(out, record);
+        AppendString(out, content.name);
+    }
+    if (entry.add_ons) {
+        for (const auto& [add_on, version] : *entry.add_ons) {
+            AppendString(out, add_on);
+            AppendString(out, version);
+        }
+    }
+}
+
+bool ReadEntry(IndexReader& reader, std::string& file_path, TitleMetadata& entry) {
+    EntryRecord record{};
+    if (!reader.Read(record)) {
+        return false;
+    }
+    const u32 file_type = record.file_type;
+    if (file_type > static_cast<u32>(Loader::FileType::DeconstructedRomDirectory)) {
+        return false;
+    }
+    entry.size = record.size;
+    entry.modification_time = record.modification_time;
+    entry.file_type = static_cast<Loader::FileType>(file_type);
+    if ((record.flags & HasProgramId) != 0) {
+        entry.program_id = record.program_id;
+    }
+    entry.romfs_updatable = (record.flags & RomFSUpdatable) != 0;
+    entry.has_packed_update = (record.flags & HasPackedUpdate) != 0;
+    entry.contents_indexed = (record.flags & ContentsIndexed) != 0;
+    entry.add_ons_key = record.add_ons_key;
+
+    if (!reader.ReadString(file_path) || !reader.ReadString(entry.name) ||
+        !reader.ReadString(entry.developer) || !reader.ReadString(entry.version) ||
+        !reader.ReadBytes(entry.icon)) {
+        return false;
+    }
+
+    for (u32 index = 0; index < record.num_contents; ++index) {
+        ContentRecord content{};
+        std::string name;
+        if (!reader.Read(content) || !reader.ReadString(name)) {
+            return false;
+        }
+        entry.contents.push_back({
+            .title_type = static_cast<TitleType>(content.title_type),
+            .record_type = static_cast<ContentRecordType>(content.record_type),
+            .title_id = content.title_id,
+            .offset = content.offset,
+            .size = content.size,
+            .name = std::move(name),
+        });
+    }
+
+    if ((record.flags & HasAddOns) != 0) {
+        auto& add_ons = entry.add_ons.emplace();
+        for (u32 index = 0; index < record.num_add_ons; ++index) {
+            std::string add_on;
+            std::string version;
+            if (!reader.ReadString(add_on) || !reader.ReadString(version)) {
+                return false;
+            }
+            add_ons.insert_or_assign(std::move(add_on), std::move(version));
+        }
+    }
+    return true;
+}
+} // Anonymous namespace
+
+TitleMetadataIndex::TitleMetadataIndex(std::filesystem::path path_) : path{std::move(path_)} {}
+
+TitleMetadataIndex::~TitleMetadataIndex() = default;
+
+bool TitleMetadataIndex::Load() {
+    entries.clear();
+    files_key = 0;
+
+    const Common::FS::IOFile file{path, Common::FS::FileAccessMode::Read,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen()) {
+        return false;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadSpan(std::span<u8>{data}) != data.size()) {
+        return false;
+    }
+
+    IndexReader reader{data};
+    IndexHeader header{};
+    if (!reader.Read(header) || header.magic != INDEX_MAGIC || header.version != INDEX_VERSION) {
+        return false;
+    }
+
+    std::unordered_map<std::string, TitleMetadata> loaded;
+    for (u64 index = 0; index < header.num_entries; ++index) {
+        std::string file_path;
+        TitleMetadata entry;
+        if (!ReadEntry(reader, file_path, entry)) {
+            LOG_WARNING(Loader, "Title metadata index {} is corrupt",
+                        Common::FS::PathToUTF8String(path));
+            return false;
+        }
+        loaded.insert_or_assign(std::move(file_path), std::move(entry));
+    }
+    if (!reader.AtEnd()) {
+        return false;
+    }
+
+    entries = std::move(loaded);
+    files_key = header.files_key;
+    return true;
+}
+
+bool TitleMetadataIndex::Save() const {
+    std::vector<u8> out;
+    Append(out, IndexHeader{
+                    .magic = INDEX_MAGIC,
+                    .version = INDEX_VERSION,
+                    .files_key = files_key,
+                    .num_entries = entries.size(),
+                });
+    for (const auto& [file_path, entry] : entries) {
+        WriteEntry(out, file_path, entry);
+    }
+
+    if (!Common::FS::CreateParentDirs(path)) {
+        LOG_WARNING(Loader, "Failed to create the title metadata index directory");
+        return false;
+    }
+    const Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                                  Common::FS::FileType::BinaryFile};
+    if (!file.IsOpen() || file.WriteSpan(std::span<const u8>{out}) != out.size()) {
+        LOG_WARNING(Loader, "Failed to write the title metadata index to {}",
+                    Common::FS::PathToUTF8String(path));
+        return false;
+    }
+    return true;
+}
+
+bool TitleMetadataIndex::Refresh(Core::System& system, const VirtualFilesystem& vfs,
+                                 const std::vector<std::string>& files, std::size_t num_threads,
+                                 const std::atomic_bool& stop) {
+    // Workers only read the existing entries, results are merged once they are done
+    std::vector<std::optional<FileStamp>> stamps(files.size());
+    std::vector<std::optional<TitleMetadata>> parsed(files.size());
+    std::atomic<std::size_t> next_file{0};
+    const auto worker = [&] {
+        for (std::size_t index = next_file++; index < files.size() && !stop;
+             index = next_file++) {
+            stamps[index] = GetFileStamp(files[index]);
+            if (!stamps[index]) {
+                continue;
+            }
+            const auto iter = entries.find(files[index]);
+            if (iter != entries.end() && iter->second.size == stamps[index]->size &&
+                iter->second.modification_time == stamps[index]->modification_time) {
+                continue;
+            }
+            parsed[index] = ParseFile(system, vfs, files[index], *stamps[index]);
+        }
+    };
+
+    num_threads = std::clamp<std::size_t>(num_threads, 1, std::max<std::size_t>(files.size(), 1));
+    std::vector<std::thread> threads;
+    for (std::size_t thread = 1; thread < num_threads; ++thread) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (stop) {
+        for (std::size_t index = 0; index < files.size(); ++index) {
+            if (parsed[index]) {
+                entries.insert_or_assign(files[index], std::move(*parsed[index]));
+            }
+        }
+        return false;
+    }
+
+    std::unordered_map<std::string, TitleMetadata> refreshed;
+    u64 new_files_key = INDEX_VERSION;
+    for (std::size_t index = 0; index < files.size(); ++index) {
+        if (!stamps[index]) {
+            continue;
+        }
+        new_files_key = HashString(files[index], new_files_key);
+        new_files_key = HashObject(stamps[index]->size, new_files_key);
+        new_files_key = HashObject(stamps[index]->modification_time, new_files_key);
+
+        if (parsed[index]) {
+            refreshed.insert_or_assign(files[index], std::move(*parsed[index]));
+        } else if (const auto iter = entries.find(files[index]); iter != entries.end()) {
+            refreshed.insert_or_assign(files[index], std::move(iter->second));
+        }
+    }
+
+    const auto num_parsed = std::count_if(parsed.begin(), parsed.end(),
+                                          [](const auto& entry) { return entry.has_value(); });
+    LOG_DEBUG(Loader, "Indexed {} files, {} of them parsed", refreshed.size(), num_parsed);
+
+    entries = std::move(refreshed);
+    files_key = new_files_key;
+    return true;
+}
+
+const TitleMetadata* TitleMetadataIndex::Find(const std::string& file_path) const {
+    const auto iter = entries.find(file_path);
+    return iter != entries.end() ? &iter->second : nullptr;
+}
+
+const PatchManager::PatchVersionNames& TitleMetadataIndex::GetAddOns(
+    const std::string& file_path, const PatchManager& patch_manager) {
+    TitleMetadata& entry = entries.at(file_path);
+
+    // Add-ons come from the other files of the game list and are labeled according to the disabled
+    // add-ons of the title. Installing or removing content clears the whole game list cache.
+    u64 key = files_key;
+    const auto disabled = Settings::values.disabled_addons.find(patch_manager.GetTitleID());
+    if (disabled != Settings::values.disabled_addons.end()) {
+        for (const auto& add_on : disabled->second) {
+            key = HashString(add_on, key);
+        }
+    }
+
+    if (!entry.add_ons || entry.add_ons_key != key) {
+        entry.add_ons = patch_manager.GetPatchVersionNames(entry.has_packed_update);
+        entry.add_ons_key = key;
+    }
+    return *entry.add_ons;
+}
+
+} // namespace FileSys
@@ -0,0 +1,100 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "core/file_sys/nca_metadata.h"
+#include "core/file_sys/patch_manager.h"
+#include "core/file_sys/vfs_types.h"
+#include "core/loader/loader.h"
+
+namespace Core {
+class System;
+}
+
+namespace FileSys {
+
+// Everything the loader reports about a game file, as shown in a game list.
+struct TitleMetadata {
+    // A content stored in a NSP or XCI, located by its window in the container file.
+    struct Content {
+        TitleType title_type;
+        ContentRecordType record_type;
+        u64 title_id;
+        u64 offset;
+        u64 size;
+        std::string name;
+    };
+
+    // Size and modification time of the file when it was parsed.
+    u64 size{};
+    s64 modification_time{};
+
+    // Unknown when the file could not be loaded, such files are not parsed again until they change.
+    Loader::FileType file_type{Loader::FileType::Unknown};
+    std::optional<u64> program_id;
+    std::string name{" "};
+    std::string developer;
+    std::string version;
+    std::vector<u8> icon;
+    bool romfs_updatable{true};
+    bool has_packed_update{};
+
+    // Whether contents lists every content of the file. When false the file has to be parsed to
+    // get its contents.
+    bool contents_indexed{};
+    std::vector<Content> contents;
+
+    // The add-ons of the title as returned by PatchManager::GetPatchVersionNames, computed on
+    // demand as they depend on the other files and on the disabled add-ons.
+    std::optional<PatchManager::PatchVersionNames> add_ons;
+    u64 add_ons_key{};
+};
+
+// Index of the metadata of every game file found by a game list scan, keyed by path.
+//
+// An entry is reused as long as the size and modification time of its file are unchanged, so a
+// scan of an unchanged library does not parse any file. The index is stored as a single file.
+class TitleMetadataIndex {
+public:
+    explicit TitleMetadataIndex(std::filesystem::path path_);
+    ~TitleMetadataIndex();
+
+    // Replaces the entries with the ones stored on disk. Returns false if there is no valid index.
+    bool Load();
+
+    // Writes the entries to disk. Returns false on failure.
+    bool Save() const;
+
+    // Updates the index to describe exactly files, parsing only the files that are new or that
+    // changed since they were indexed, on up to num_threads threads. Returns false if stop was set
+    // before every file was checked, the entries of the unchecked files are kept as they were then.
+    bool Refresh(Core::System& system, const VirtualFilesystem& vfs,
+                 const std::vector<std::string>& files, std::size_t num_threads,
+                 const std::atomic_bool& stop);
+
+    // Returns the entry of a file, or nullptr if it is not indexed.
+    [[nodiscard]] const TitleMetadata* Find(const std::string& file_path) const;
+
+    // Returns the add-ons of an indexed file, computing them with patch_manager if the indexed
+    // files or the disabled add-ons of the title changed since they were last computed.
+    const PatchManager::PatchVersionNames& GetAddOns(const std::string& file_path,
+                                                     const PatchManager& patch_manager);
+
+private:
+    std::filesystem::path path;
+    std::unordered_map<std::string, TitleMetadata> entries;
+
+    // Identifies the set of indexed files, a change invalidates the add-ons of every entry.
+    u64 files_key{};
+};
+
+} // namespace FileSys
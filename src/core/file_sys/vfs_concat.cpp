@@ -3,14 +3,19 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <utility>
 
 #include "common/assert.h"
 #include "core/file_sys/vfs_concat.h"
+#include "core/file_sys/vfs_offset.h"
 #include "core/file_sys/vfs_static.h"
 
 namespace FileSys {
 
+// Largest static fill read over from the underlying file to merge the windows around it
+constexpr u64 MAX_MERGED_FILL_SIZE = 0x1000;
+
 static bool VerifyConcatenationMapContinuity(const std::multimap<u64, VirtualFile>& map) {
     const auto last_valid = --map.end();
     for (auto iter = map.begin(); iter != last_valid;) {
@@ -25,16 +30,84 @@ static bool VerifyConcatenationMapContinuity(const std::multimap<u64, VirtualFil
 
 ConcatenatedVfsFile::ConcatenatedVfsFile(std::vector<VirtualFile> files_, std::string name_)
     : name(std::move(name_)) {
+    fragments.reserve(files_.size());
     std::size_t next_offset = 0;
     for (const auto& file : files_) {
-        files.emplace(next_offset, file);
+        AddFragment(next_offset, file);
         next_offset += file->GetSize();
     }
+    if (!files_.empty()) {
+        first_file = std::move(files_.front());
+    }
 }
 
 ConcatenatedVfsFile::ConcatenatedVfsFile(std::multimap<u64, VirtualFile> files_, std::string name_)
-    : files(std::move(files_)), name(std::move(name_)) {
-    ASSERT(VerifyConcatenationMapContinuity(files));
+    : name(std::move(name_)) {
+    ASSERT(VerifyConcatenationMapContinuity(files_));
+    fragments.reserve(files_.size());
+    for (const auto& [offset, file] : files_) {
+        AddFragment(offset, file);
+    }
+    if (!files_.empty()) {
+        first_file = files_.begin()->second;
+    }
+}
+
+void ConcatenatedVfsFile::AddFragment(u64 offset, const VirtualFile& file) {
+    const u64 size = file->GetSize();
+    if (size == 0) {
+        return;
+    }
+
+    // Read windows straight from the file they are taken from, as long as the fragment does not
+    // extend past the end of the window.
+    VirtualFile base = file;
+    u64 base_offset = 0;
+    while (const auto* const window = dynamic_cast<const OffsetVfsFile*>(base.get())) {
+        if (base_offset + size > window->GetSize()) {
+            break;
+        }
+        base_offset += window->GetOffset();
+        base = window->GetBaseFile();
+    }
+
+    // Look past the short static fills at the end, the previous window can be extended over them
+    // when the data between the windows in the base file has the same size
+    std::size_t first_fill = fragments.size();
+    u64 fill_size = 0;
+    while (first_fill > 0) {
+        const Fragment& fill = fragments[first_fill - 1];
+        if (dynamic_cast<const StaticVfsFile*>(fill.file.get()) == nullptr ||
+            fill_size + fill.size > MAX_MERGED_FILL_SIZE) {
+            break;
+        }
+        fill_size += fill.size;
+        --first_fill;
+    }
+    if (first_fill > 0) {
+        Fragment& last = fragments[first_fill - 1];
+        if (last.file == base && last.file_offset + last.size + fill_size == base_offset) {
+            // Contiguous in both files apart from the fills, extend the previous fragment instead
+            for (std::size_t index = first_fill; index < fragments.size(); ++index) {
+                const Fragment& fill = fragments[index];
+                last.fills.push_back({
+                    .offset = fill.offset - last.offset,
+                    .size = fill.size,
+                    .value = static_cast<const StaticVfsFile&>(*fill.file).GetValue(),
+                });
+            }
+            last.size += fill_size + size;
+            fragments.resize(first_fill);
+            return;
+        }
+    }
+    fragments.push_back({
+        .offset = offset,
+        .size = size,
+        .file_offset = base_offset,
+        .file = std::move(base),
+        .fills = {},
+    });
 }
 
 ConcatenatedVfsFile::~ConcatenatedVfsFile() = default;
@@ -75,20 +148,20 @@ VirtualFile ConcatenatedVfsFile::MakeConcatenatedFile(u8 filler_byte,
 }
 
 std::string ConcatenatedVfsFile::GetName() const {
-    if (files.empty()) {
+    if (first_file == nullptr) {
         return "";
     }
     if (!name.empty()) {
         return name;
     }
-    return files.begin()->second->GetName();
+    return first_file->GetName();
 }
 
 std::size_t ConcatenatedVfsFile::GetSize() const {
-    if (files.empty()) {
+    if (fragments.empty()) {
         return 0;
     }
-    return files.rbegin()->first + files.rbegin()->second->GetSize();
+    return fragments.back().offset + fragments.back().size;
 }
 
 bool ConcatenatedVfsFile::Resize(std::size_t new_size) {
@@ -96,10 +169,10 @@ bool ConcatenatedVfsFile::Resize(std::size_t new_size) {
 }
 
 VirtualDir ConcatenatedVfsFile::GetContainingDirectory() const {
-    if (files.empty()) {
+    if (first_file == nullptr) {
         return nullptr;
     }
-    return files.begin()->second->GetContainingDirectory();
+    return first_file->GetContainingDirectory();
 }
 
 bool ConcatenatedVfsFile::IsWritable() const {
@@ -111,25 +184,36 @@ bool ConcatenatedVfsFile::IsReadable() const {
 }
 
 std::size_t ConcatenatedVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
-    auto entry = --files.end();
-    for (auto iter = files.begin(); iter != files.end(); ++iter) {
-        if (iter->first > offset) {
-            entry = --iter;
+    // Find the first fragment ending past the offset
+    auto fragment = std::upper_bound(
+        fragments.begin(), fragments.end(), offset,
+        [](u64 value, const Fragment& entry) { return value < entry.offset + entry.size; });
+
+    std::size_t read = 0;
+    while (read < length && fragment != fragments.end()) {
+        const u64 fragment_offset = offset + read - fragment->offset;
+        const u64 to_read = std::min<u64>(fragment->size - fragment_offset, length - read);
+        const std::size_t fragment_read =
+            fragment->file->Read(data + read, to_read, fragment->file_offset + fragment_offset);
+
+        // Write the fills over what was read in their place
+        const u64 read_end = fragment_offset + fragment_read;
+        auto fill = std::upper_bound(
+            fragment->fills.begin(), fragment->fills.end(), fragment_offset,
+            [](u64 value, const Fill& entry) { return value < entry.offset + entry.size; });
+        for (; fill != fragment->fills.end() && fill->offset < read_end; ++fill) {
+            const u64 fill_begin = std::max(fill->offset, fragment_offset);
+            const u64 fill_end = std::min(fill->offset + fill->size, read_end);
+            std::memset(data + read + (fill_begin - fragment_offset), fill->value,
+                        fill_end - fill_begin);
+        }
+        read += fragment_read;
+        if (fragment_read != to_read) {
             break;
         }
+        ++fragment;
     }
-
-    if (entry->first + entry->second->GetSize() <= offset)
-        return 0;
-
-    const auto read_in =
-        std::min<u64>(entry->first + entry->second->GetSize() - offset, entry->second->GetSize());
-    if (length > read_in) {
-        return entry->second->Read(data, read_in, offset - entry->first) +
-               Read(data + read_in, length - read_in, offset + read_in);
-    }
-
-    return entry->second->Read(data, std::min<u64>(read_in, length), offset - entry->first);
+    return read;
 }
 
 std::size_t ConcatenatedVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
@@ -7,12 +7,17 @@
 #include <map>
 #include <memory>
 #include <string_view>
+#include <vector>
 #include "core/file_sys/vfs.h"
 
 namespace FileSys {
 
 // Class that wraps multiple vfs files and concatenates them, making reads seamless. Currently
 // read-only.
+// Fragments are kept in a table sorted by offset. Fragments that are windows of the same file are
+// read from that file directly, and adjacent windows are merged so a read spanning many of them is
+// forwarded as a single read. Windows separated only by short static fills, such as the alignment
+// padding of a RomFS image, are merged as well and the fills are written over the data read.
 class ConcatenatedVfsFile : public VfsFile {
     explicit ConcatenatedVfsFile(std::vector<VirtualFile> files, std::string name_);
     explicit ConcatenatedVfsFile(std::multimap<u64, VirtualFile> files, std::string name_);
@@ -39,8 +44,26 @@ public:
     bool Rename(std::string_view new_name) override;
 
 private:
-    // Maps starting offset to file -- more efficient.
-    std::multimap<u64, VirtualFile> files;
+    struct Fill {
+        u64 offset; // Offset of the fill relative to its fragment.
+        u64 size;
+        u8 value;
+    };
+
+    struct Fragment {
+        u64 offset;      // Offset of the fragment in the concatenated file.
+        u64 size;        // Size of the fragment.
+        u64 file_offset; // Offset of the fragment data in file.
+        VirtualFile file;
+        std::vector<Fill> fills; // Ranges written over the data read from file, sorted by offset.
+    };
+
+    // Appends a file at the given offset, which must be the end of the last fragment.
+    void AddFragment(u64 offset, const VirtualFile& file);
+
+    // Fragments sorted by offset, with no gaps between them.
+    std::vector<Fragment> fragments;
+    VirtualFile first_file;
     std::string name;
 };
 
@@ -0,0 +1,312 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <mbedtls/sha256.h>
+
+#include "common/scope_exit.h"
+#include "common/thread.h"
+#include "core/file_sys/vfs.h"
+#include "core/file_sys/vfs_copy.h"
+#include "core/file_sys/vfs_offset.h"
+#include "core/file_sys/vfs_real.h"
+
+namespace FileSys {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// Number of blocks in flight between the reader, the hasher and the writer.
+constexpr std::size_t NUM_BUFFERS = 3;
+
+// Tracks the throughput of a copy and forwards it to the progress callback.
+class ProgressReporter {
+public:
+    explicit ProgressReporter(const CopyProgressCallback& callback_, u64 total_bytes_)
+        : callback{callback_}, total_bytes{total_bytes_}, start_time{Clock::now()} {}
+
+    bool Report(u64 delta_bytes) {
+        copied_bytes += delta_bytes;
+        if (!callback) {
+            return true;
+        }
+        const auto elapsed = std::chrono::duration<double>(Clock::now() - start_time).count();
+        const u64 bytes_per_second =
+            elapsed > 0.0 ? static_cast<u64>(static_cast<double>(copied_bytes) / elapsed) : 0;
+        return callback(CopyProgress{
+            .copied_bytes = copied_bytes,
+            .delta_bytes = delta_bytes,
+            .total_bytes = total_bytes,
+            .bytes_per_second = bytes_per_second,
+        });
+    }
+
+private:
+    const CopyProgressCallback& callback;
+    const u64 total_bytes;
+    const Clock::time_point start_time;
+    u64 copied_bytes{};
+};
+
+// Returns the host file backing a window of a file along with the window's offset in it.
+std::optional<std::pair<const RealVfsFile*, u64>> GetHostFile(const VirtualFile& file) {
+    VirtualFile base = file;
+    u64 offset = 0;
+    while (const auto* const window = dynamic_cast<const OffsetVfsFile*>(base.get())) {
+        offset += window->GetOffset();
+        base = window->GetBaseFile();
+    }
+    const auto* const real_file = dynamic_cast<const RealVfsFile*>(base.get());
+    if (real_file == nullptr) {
+        return std::nullopt;
+    }
+    return std::make_pair(real_file, offset);
+}
+
+// Copies between two host files without going through user space. Returns std::nullopt when the
+// copy could not be started and has to be done by hand.
+std::optional<bool> KernelCopy(const VirtualFile& src, const VirtualFile& dest,
+                               std::size_t block_size, ProgressReporter& reporter) {
+#ifdef __linux__
+    const auto src_host = GetHostFile(src);
+    const auto dest_host = GetHostFile(dest);
+    if (!src_host || !dest_host) {
+        return std::nullopt;
+    }
+
+    const int src_fd = open(src_host->first->GetFullPath().c_str(), O_RDONLY | O_CLOEXEC);
+    if (src_fd < 0) {
+        return std::nullopt;
+    }
+    SCOPE_EXIT({ close(src_fd); });
+    const int dest_fd = open(dest_host->first->GetFullPath().c_str(), O_WRONLY | O_CLOEXEC);
+    if (dest_fd < 0) {
+        return std::nullopt;
+    }
+    SCOPE_EXIT({ close(dest_fd); });
+
+    const u64 size = src->GetSize();
+    loff_t src_offset = static_cast<loff_t>(src_host->second);
+    loff_t dest_offset = static_cast<loff_t>(dest_host->second);
+    u64 copied = 0;
+    while (copied < size) {
+        const std::size_t chunk = static_cast<std::size_t>(std::min<u64>(block_size, size - copied));
+        const ssize_t result =
+            copy_file_range(src_fd, &src_offset, dest_fd, &dest_offset, chunk, 0);
+        if (result <= 0) {
+            // Unsupported between these files, let the caller copy by hand
+            return copied == 0 ? std::nullopt : std::optional<bool>{false};
+        }
+        copied += static_cast<u64>(result);
+        if (!reporter.Report(static_cast<u64>(result))) {
+            return false;
+        }
+    }
+    return true;
+#else
+    return std::nullopt;
+#endif
+}
+
+class CopyPipeline {
+public:
+    explicit CopyPipeline(const VirtualFile& src_, const VirtualFile& dest_,
+                          std::size_t block_size_, Core::Crypto::SHA256Hash* hash_)
+        : src{src_}, dest{dest_}, size{src->GetSize()}, block_size{block_size_}, hash{hash_} {
+        for (auto& buffer : buffers) {
+            buffer.data.resize(static_cast<std::size_t>(std::min<u64>(block_size, size)));
+        }
+        for (std::size_t index = 0; index < NUM_BUFFERS; ++index) {
+            free_buffers.push(index);
+        }
+    }
+
+    bool Run(ProgressReporter& reporter) {
+        std::jthread writer{[this] { WriterLoop(); }};
+        std::optional<std::jthread> hasher;
+        if (hash) {
+            hasher.emplace([this] { HasherLoop(); });
+        }
+
+        bool success = ReaderLoop(reporter);
+        {
+            std::scoped_lock lock{mutex};
+            end_of_data = true;
+            failed |= !success;
+        }
+        condition.notify_all();
+        writer.join();
+        if (hasher) {
+            hasher->join();
+        }
+
+        // Report the blocks written after the reader finished
+        success &= !failed;
+        const u64 remaining = written_bytes - reported_bytes;
+        if (success && remaining > 0) {
+            success = reporter.Report(remaining);
+        }
+        return success;
+    }
+
+private:
+    struct Buffer {
+        std::vector<u8> data;
+        std::size_t size{};
+        u64 offset{};
+        u32 pending_stages{};
+    };
+
+    bool ReaderLoop(ProgressReporter& reporter) {
+        for (u64 offset = 0; offset < size;) {
+            std::size_t index;
+            {
+                std::unique_lock lock{mutex};
+                condition.wait(lock, [this] { return failed || !free_buffers.empty(); });
+                if (failed) {
+                    return false;
+                }
+                index = free_buffers.front();
+                free_buffers.pop();
+            }
+
+            Buffer& buffer = buffers[index];
+            buffer.offset = offset;
+            buffer.size = static_cast<std::size_t>(std::min<u64>(block_size, size - offset));
+            if (src->Read(buffer.data.data(), buffer.size, offset) != buffer.size) {
+                return false;
+            }
+            offset += buffer.size;
+
+            u64 delta_bytes;
+            {
+                std::scoped_lock lock{mutex};
+                buffer.pending_stages = hash ? 2 : 1;
+                write_queue.push(index);
+                if (hash) {
+                    hash_queue.push(index);
+                }
+                delta_bytes = written_bytes - reported_bytes;
+                reported_bytes = written_bytes;
+            }
+            condition.notify_all();
+
+            if (delta_bytes > 0 && !reporter.Report(delta_bytes)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Pops the next block of a stage, returns std::nullopt once the stage has nothing left to do
+    std::optional<std::size_t> NextBuffer(std::queue<std::size_t>& queue) {
+        std::unique_lock lock{mutex};
+        condition.wait(lock, [&] { return failed || end_of_data || !queue.empty(); });
+        if (failed || queue.empty()) {
+            return std::nullopt;
+        }
+        const std::size_t index = queue.front();
+        queue.pop();
+        return index;
+    }
+
+    // Marks a stage as done with a block, the block is recycled when every stage is done with it
+    void ReleaseBuffer(std::size_t index, u64 written) {
+        {
+            std::scoped_lock lock{mutex};
+            written_bytes += written;
+            if (--buffers[index].pending_stages == 0) {
+                free_buffers.push(index);
+            }
+        }
+        condition.notify_all();
+    }
+
+    void Fail() {
+        {
+            std::scoped_lock lock{mutex};
+            failed = true;
+        }
+        condition.notify_all();
+    }
+
+    void WriterLoop() {
+        Common::SetCurrentThreadName("yuzu:CopyWriter");
+        while (const auto index = NextBuffer(write_queue)) {
+            const Buffer& buffer = buffers[*index];
+            if (dest->Write(buffer.data.data(), buffer.size, buffer.offset) != buffer.size) {
+                Fail();
+                return;
+            }
+            ReleaseBuffer(*index, buffer.size);
+        }
+    }
+
+    void HasherLoop() {
+        Common::SetCurrentThreadName("yuzu:CopyHasher");
+        mbedtls_sha256_context context;
+        mbedtls_sha256_init(&context);
+        SCOPE_EXIT({ mbedtls_sha256_free(&context); });
+        mbedtls_sha256_starts_ret(&context, 0);
+
+        // Blocks are queued in order, so they are hashed in order
+        while (const auto index = NextBuffer(hash_queue)) {
+            const Buffer& buffer = buffers[*index];
+            mbedtls_sha256_update_ret(&context, buffer.data.data(), buffer.size);
+            ReleaseBuffer(*index, 0);
+        }
+        mbedtls_sha256_finish_ret(&context, hash->data());
+    }
+
+    const VirtualFile& src;
+    const VirtualFile& dest;
+    const u64 size;
+    const std::size_t block_size;
+    Core::Crypto::SHA256Hash* const hash;
+
+    std::array<Buffer, NUM_BUFFERS> buffers;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::queue<std::size_t> free_buffers;
+    std::queue<std::size_t> write_queue;
+    std::queue<std::size_t> hash_queue;
+    u64 written_bytes{};
+    u64 reported_bytes{};
+    bool end_of_data{};
+    bool failed{};
+};
+} // Anonymous namespace
+
+bool PipelinedCopy(const VirtualFile& src, const VirtualFile& dest, std::size_t block_size,
+                   const CopyProgressCallback& progress, Core::Crypto::SHA256Hash* hash) {
+    if (src == nullptr || dest == nullptr || !src->IsReadable() || !dest->IsWritable())
+        return false;
+    if (!dest->Resize(src->GetSize()))
+        return false;
+
+    ProgressReporter reporter{progress, src->GetSize()};
+    if (hash == nullptr) {
+        if (const auto result = KernelCopy(src, dest, block_size, reporter)) {
+            return *result;
+        }
+    }
+
+    CopyPipeline pipeline{src, dest, block_size, hash};
+    return pipeline.Run(reporter);
+}
+
+} // namespace FileSys
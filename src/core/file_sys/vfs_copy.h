@@ -0,0 +1,37 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include "common/common_types.h"
+#include "core/crypto/key_manager.h"
+#include "core/file_sys/vfs_types.h"
+
+namespace FileSys {
+
+// Progress of a copy, reported after every block written to the destination.
+struct CopyProgress {
+    u64 copied_bytes;     // Bytes written to the destination so far.
+    u64 delta_bytes;      // Bytes written since the previous report.
+    u64 total_bytes;      // Size of the source.
+    u64 bytes_per_second; // Average throughput since the start of the copy.
+};
+
+// Called with the progress of a copy, returning false cancels it.
+using CopyProgressCallback = std::function<bool(const CopyProgress&)>;
+
+// Copies src into dest, resizing dest to the size of src.
+//
+// Reading, hashing and writing are done on separate threads and overlap through a ring of
+// block_size buffers. When hash is not null, the SHA-256 of the whole source is computed while
+// copying and stored there. When no hash is requested and both files are host files, the copy is
+// done by the kernel where supported.
+//
+// Returns false if the copy failed or was cancelled, the contents of dest are undefined then.
+bool PipelinedCopy(const VirtualFile& src, const VirtualFile& dest, std::size_t block_size,
+                   const CopyProgressCallback& progress = {},
+                   Core::Crypto::SHA256Hash* hash = nullptr);
+
+} // namespace FileSys
@@ -0,0 +1,284 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include <mbedtls/sha256.h>
+
+#include "common/assert.h"
+#include "common/div_ceil.h"
+#include "common/logging/log.h"
+#include "core/file_sys/vfs_hash_tree.h"
+
+namespace FileSys {
+namespace {
+// Amount of data read at once when verifying a whole level.
+constexpr u64 VERIFY_CHUNK_SIZE = 0x100000;
+
+constexpr u64 HASH_SIZE = sizeof(Core::Crypto::SHA256Hash);
+} // Anonymous namespace
+
+HashTreeVfsFile::HashTreeVfsFile(VirtualFile base_, HashTreeLayout layout_, std::string name_)
+    : base{std::move(base_)}, layout{std::move(layout_)}, name{std::move(name_)} {
+    ASSERT(!layout.levels.empty());
+}
+
+HashTreeVfsFile::~HashTreeVfsFile() = default;
+
+std::string HashTreeVfsFile::GetName() const {
+    return name;
+}
+
+std::size_t HashTreeVfsFile::GetSize() const {
+    return layout.levels.back().size;
+}
+
+bool HashTreeVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+VirtualDir HashTreeVfsFile::GetContainingDirectory() const {
+    return base->GetContainingDirectory();
+}
+
+bool HashTreeVfsFile::IsWritable() const {
+    return false;
+}
+
+bool HashTreeVfsFile::IsReadable() const {
+    return true;
+}
+
+std::size_t HashTreeVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    const std::size_t data_level = layout.levels.size() - 1;
+    const HashTreeLevel& level = layout.levels[data_level];
+    if (offset >= level.size) {
+        return 0;
+    }
+    length = std::min<std::size_t>(length, level.size - offset);
+    const u64 end = offset + length;
+
+    std::vector<u8> scratch;
+    std::size_t copied = 0;
+    while (copied < length) {
+        const u64 position = offset + copied;
+        const u64 block = position / level.block_size;
+        const u64 block_offset = position % level.block_size;
+
+        if (IsVerified(data_level, block)) {
+            // Read a run of verified blocks straight from the base file
+            u64 run_end_block = block + 1;
+            while (run_end_block * level.block_size < end &&
+                   IsVerified(data_level, run_end_block)) {
+                ++run_end_block;
+            }
+            const u64 run_size = std::min(run_end_block * level.block_size, end) - position;
+            const std::size_t read =
+                base->Read(data + copied, static_cast<std::size_t>(run_size), level.offset + position);
+            copied += read;
+            if (read != run_size) {
+                break;
+            }
+            continue;
+        }
+
+        const std::size_t block_size = ReadVerifiedBlock(data_level, block, scratch);
+        if (block_size <= block_offset) {
+            break;
+        }
+        const std::size_t copy_size =
+            std::min<std::size_t>(block_size - block_offset, length - copied);
+        std::memcpy(data + copied, scratch.data() + block_offset, copy_size);
+        copied += copy_size;
+    }
+    return copied;
+}
+
+std::size_t HashTreeVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+bool HashTreeVfsFile::Rename(std::string_view new_name) {
+    return false;
+}
+
+bool HashTreeVfsFile::VerifyAll(std::size_t num_threads) const {
+    num_threads = std::max<std::size_t>(num_threads, 1);
+
+    // Levels are checked top down, so the hashes of a level are trusted once the previous one is
+    for (std::size_t level = 0; level < layout.levels.size(); ++level) {
+        const u64 num_blocks = NumBlocks(level);
+        const u64 blocks_per_thread = Common::DivCeil(num_blocks, static_cast<u64>(num_threads));
+        if (blocks_per_thread == 0) {
+            continue;
+        }
+
+        std::atomic_bool success{true};
+        const auto verify = [&](u64 begin, u64 end) {
+            if (!VerifyBlocks(level, begin, end)) {
+                success = false;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (u64 begin = blocks_per_thread; begin < num_blocks; begin += blocks_per_thread) {
+            threads.emplace_back(verify, begin, std::min(begin + blocks_per_thread, num_blocks));
+        }
+        verify(0, std::min(blocks_per_thread, num_blocks));
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (!success) {
+            return false;
+        }
+    }
+    return true;
+}
+
+u64 HashTreeVfsFile::NumBlocks(std::size_t level) const {
+    return Common::DivCeil(layout.levels[level].size, layout.levels[level].block_size);
+}
+
+bool HashTreeVfsFile::IsVerified(std::size_t level, u64 block) const {
+    std::call_once(bitmaps_flag, [this] {
+        verified.reserve(layout.levels.size());
+        for (std::size_t index = 0; index < layout.levels.size(); ++index) {
+            verified.push_back(
+                std::make_unique<std::atomic<u64>[]>(Common::DivCeil(NumBlocks(index), u64{64})));
+        }
+    });
+    return (verified[level][block / 64].load(std::memory_order_acquire) >> (block % 64)) & 1;
+}
+
+void HashTreeVfsFile::MarkVerified(std::size_t level, u64 block) const {
+    verified[level][block / 64].fetch_or(u64{1} << (block % 64), std::memory_order_release);
+}
+
+std::size_t HashTreeVfsFile::ReadVerifiedBlock(std::size_t level, u64 block,
+                                               std::vector<u8>& scratch) const {
+    const HashTreeLevel& tree_level = layout.levels[level];
+    const u64 block_offset = block * tree_level.block_size;
+    const std::size_t size =
+        static_cast<std::size_t>(std::min(tree_level.block_size, tree_level.size - block_offset));
+
+    scratch.resize(static_cast<std::size_t>(tree_level.block_size));
+    if (base->Read(scratch.data(), size, tree_level.offset + block_offset) != size) {
+        return 0;
+    }
+    if (IsVerified(level, block)) {
+        return size;
+    }
+
+    Core::Crypto::SHA256Hash expected;
+    if (!GetExpectedHash(level, block, expected) ||
+        !CheckBlock(level, block, scratch, size, expected)) {
+        return 0;
+    }
+    return size;
+}
+
+bool HashTreeVfsFile::GetExpectedHash(std::size_t level, u64 block,
+                                      Core::Crypto::SHA256Hash& hash) const {
+    if (level == 0) {
+        if (block >= layout.master_hashes.size()) {
+            return false;
+        }
+        hash = layout.master_hashes[block];
+        return true;
+    }
+
+    const HashTreeLevel& parent = layout.levels[level - 1];
+    const u64 hash_offset = block * HASH_SIZE;
+    if (hash_offset + HASH_SIZE > parent.size) {
+        return false;
+    }
+
+    const u64 parent_block = hash_offset / parent.block_size;
+    if (IsVerified(level - 1, parent_block)) {
+        return base->ReadObject(&hash, parent.offset + hash_offset) == HASH_SIZE;
+    }
+
+    std::vector<u8> parent_data;
+    const std::size_t parent_size = ReadVerifiedBlock(level - 1, parent_block, parent_data);
+    const u64 offset_in_block = hash_offset % parent.block_size;
+    if (offset_in_block + HASH_SIZE > parent_size) {
+        return false;
+    }
+    std::memcpy(hash.data(), parent_data.data() + offset_in_block, HASH_SIZE);
+    return true;
+}
+
+bool HashTreeVfsFile::CheckBlock(std::size_t level, u64 block, std::span<u8> data,
+                                 std::size_t size, const Core::Crypto::SHA256Hash& expected) const {
+    std::size_t hashed_size = size;
+    if (layout.pad_blocks && size < layout.levels[level].block_size) {
+        hashed_size = static_cast<std::size_t>(layout.levels[level].block_size);
+        std::fill(data.begin() + size, data.begin() + hashed_size, u8{0});
+    }
+
+    Core::Crypto::SHA256Hash hash;
+    mbedtls_sha256_ret(data.data(), hashed_size, hash.data(), 0);
+    if (hash != expected) {
+        LOG_ERROR(Loader, "Block {} of hash tree level {} in {} is corrupt", block, level, name);
+        return false;
+    }
+    MarkVerified(level, block);
+    return true;
+}
+
+bool HashTreeVfsFile::VerifyBlocks(std::size_t level, u64 begin, u64 end) const {
+    const HashTreeLevel& tree_level = layout.levels[level];
+    const u64 blocks_per_chunk = std::max<u64>(VERIFY_CHUNK_SIZE / tree_level.block_size, 1);
+
+    std::vector<u8> buffer(static_cast<std::size_t>(blocks_per_chunk * tree_level.block_size));
+    std::vector<Core::Crypto::SHA256Hash> hashes;
+    for (u64 chunk = begin; chunk < end; chunk += blocks_per_chunk) {
+        const u64 chunk_end = std::min(chunk + blocks_per_chunk, end);
+
+        // The previous level is verified, read the hashes of the whole chunk at once
+        hashes.resize(static_cast<std::size_t>(chunk_end - chunk));
+        if (level == 0) {
+            if (chunk_end > layout.master_hashes.size()) {
+                return false;
+            }
+            std::copy_n(layout.master_hashes.begin() + chunk, hashes.size(), hashes.begin());
+        } else {
+            const HashTreeLevel& parent = layout.levels[level - 1];
+            const std::size_t hashes_size = hashes.size() * HASH_SIZE;
+            if (chunk_end * HASH_SIZE > parent.size ||
+                base->Read(reinterpret_cast<u8*>(hashes.data()), hashes_size,
+                           parent.offset + chunk * HASH_SIZE) != hashes_size) {
+                return false;
+            }
+        }
+
+        const u64 chunk_offset = chunk * tree_level.block_size;
+        const std::size_t chunk_size = static_cast<std::size_t>(
+            std::min((chunk_end - chunk) * tree_level.block_size, tree_level.size - chunk_offset));
+        if (base->Read(buffer.data(), chunk_size, tree_level.offset + chunk_offset) != chunk_size) {
+            return false;
+        }
+
+        bool success = true;
+        for (u64 block = chunk; block < chunk_end; ++block) {
+            if (IsVerified(level, block)) {
+                continue;
+            }
+            const std::size_t offset = static_cast<std::size_t>((block - chunk) * tree_level.block_size);
+            const std::size_t size =
+                std::min(static_cast<std::size_t>(tree_level.block_size), chunk_size - offset);
+            const std::span<u8> block_data{buffer.data() + offset, buffer.size() - offset};
+            success &= CheckBlock(level, block, block_data, size, hashes[block - chunk]);
+        }
+        if (!success) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace FileSys
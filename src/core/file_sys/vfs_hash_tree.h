@@ -0,0 +1,81 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/crypto/key_manager.h"
+#include "core/file_sys/vfs.h"
+
+namespace FileSys {
+
+// A region of the base file that is hashed in blocks of block_size bytes.
+struct HashTreeLevel {
+    u64 offset;
+    u64 size;
+    u64 block_size;
+};
+
+// Describes the hash tree protecting a NCA section, either an IVFC or a HierarchicalSha256 one.
+struct HashTreeLayout {
+    // SHA-256 of each block of the first level.
+    std::vector<Core::Crypto::SHA256Hash> master_hashes;
+    // The SHA-256 of each block of a level is stored in the previous level, the last level holds
+    // the data.
+    std::vector<HashTreeLevel> levels;
+    // Whether a partial last block is hashed as if it was padded with zeroes to the block size.
+    bool pad_blocks;
+};
+
+// An implementation of VfsFile exposing the data level of a hash tree, which checks every block
+// against the tree the first time it is read. A read stops at the first block that does not match.
+class HashTreeVfsFile : public VfsFile {
+public:
+    HashTreeVfsFile(VirtualFile base, HashTreeLayout layout, std::string name);
+    ~HashTreeVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    VirtualDir GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view name) override;
+
+    // Checks every block of every level not verified yet, spreading the work over num_threads
+    // threads. Returns false if any block does not match the tree.
+    bool VerifyAll(std::size_t num_threads) const;
+
+private:
+    u64 NumBlocks(std::size_t level) const;
+    bool IsVerified(std::size_t level, u64 block) const;
+    void MarkVerified(std::size_t level, u64 block) const;
+
+    // Reads a block into scratch and checks it, verifying the blocks holding its hash first.
+    // Returns the size of the block, or 0 if it is corrupt.
+    std::size_t ReadVerifiedBlock(std::size_t level, u64 block, std::vector<u8>& scratch) const;
+    bool GetExpectedHash(std::size_t level, u64 block, Core::Crypto::SHA256Hash& hash) const;
+    bool CheckBlock(std::size_t level, u64 block, std::span<u8> data, std::size_t size,
+                    const Core::Crypto::SHA256Hash& expected) const;
+    bool VerifyBlocks(std::size_t level, u64 begin, u64 end) const;
+
+    VirtualFile base;
+    HashTreeLayout layout;
+    std::string name;
+
+    // One bit per block of each level, allocated on first use as most files are never read.
+    mutable std::once_flag bitmaps_flag;
+    mutable std::vector<std::unique_ptr<std::atomic<u64>[]>> verified;
+};
+
+} // namespace FileSys
@@ -2,7 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <algorithm>
+#include <unordered_set>
 #include <utility>
 #include "core/file_sys/vfs_layered.h"
 
@@ -59,12 +59,11 @@ std::string LayeredVfsDirectory::GetFullPath() const {
 
 std::vector<VirtualFile> LayeredVfsDirectory::GetFiles() const {
     std::vector<VirtualFile> out;
+    std::unordered_set<std::string> names;
     for (const auto& layer : dirs) {
-        for (const auto& file : layer->GetFiles()) {
-            if (std::find_if(out.begin(), out.end(), [&file](const VirtualFile& comp) {
-                    return comp->GetName() == file->GetName();
-                }) == out.end()) {
-                out.push_back(file);
+        for (auto& file : layer->GetFiles()) {
+            if (names.insert(file->GetName()).second) {
+                out.push_back(std::move(file));
             }
         }
     }
@@ -74,10 +73,12 @@ std::vector<VirtualFile> LayeredVfsDirectory::GetFiles() const {
 
 std::vector<VirtualDir> LayeredVfsDirectory::GetSubdirectories() const {
     std::vector<std::string> names;
+    std::unordered_set<std::string> known_names;
     for (const auto& layer : dirs) {
         for (const auto& sd : layer->GetSubdirectories()) {
-            if (std::find(names.begin(), names.end(), sd->GetName()) == names.end())
-                names.push_back(sd->GetName());
+            auto subdir_name = sd->GetName();
+            if (known_names.insert(subdir_name).second)
+                names.push_back(std::move(subdir_name));
         }
     }
 
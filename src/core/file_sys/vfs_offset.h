@@ -38,6 +38,7 @@ public:
     bool Rename(std::string_view new_name) override;
 
     std::size_t GetOffset() const;
+    VirtualFile GetBaseFile() const;
 
 private:
     std::size_t TrimToFit(std::size_t r_size, std::size_t r_offset) const;
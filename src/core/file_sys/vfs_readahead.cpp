@@ -0,0 +1,212 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "common/alignment.h"
+#include "common/thread_worker.h"
+#include "core/file_sys/vfs_readahead.h"
+
+namespace FileSys {
+
+namespace {
+/// Size of the blocks read ahead of the guest
+constexpr std::size_t BlockSize = 0x40000;
+
+/// Number of blocks cached per file, this bounds how far ahead of the guest data is read
+constexpr std::size_t NumBlocks = 8;
+
+/// Number of consecutive sequential reads required before reading ahead
+constexpr u32 SequentialThreshold = 2;
+} // Anonymous namespace
+
+struct ReadaheadVfsFile::State : std::enable_shared_from_this<ReadaheadVfsFile::State> {
+    enum class BlockStatus {
+        Empty,   ///< The block holds no data
+        Pending, ///< The block is queued to be loaded
+        Loading, ///< The block is being loaded, its data must not be touched
+        Ready,   ///< The block holds valid data
+    };
+
+    struct Block {
+        std::size_t offset{};
+        std::size_t size{};
+        BlockStatus status{BlockStatus::Empty};
+        std::vector<u8> data;
+    };
+
+    explicit State(VirtualFile file_) : file{std::move(file_)}, file_size{file->GetSize()} {}
+
+    /// Returns the block holding the given offset, or nullptr when it is not cached
+    Block* FindBlock(std::size_t offset) {
+        const auto it = std::find_if(blocks.begin(), blocks.end(), [offset](const Block& block) {
+            return block.status != BlockStatus::Empty && block.offset <= offset &&
+                   offset < block.offset + BlockSize;
+        });
+        return it != blocks.end() ? &*it : nullptr;
+    }
+
+    /// Loads a pending block, the lock is released while reading from the file
+    void LoadBlock(std::unique_lock<std::mutex>& lock, Block& block) {
+        block.status = BlockStatus::Loading;
+        const std::size_t offset = block.offset;
+        lock.unlock();
+
+        if (block.data.empty()) {
+            block.data.resize(BlockSize);
+        }
+        const std::size_t size = file->Read(block.data.data(), BlockSize, offset);
+
+        lock.lock();
+        block.size = size;
+        block.status = BlockStatus::Ready;
+        block_loaded.notify_all();
+    }
+
+    /// Queues the blocks following the given position to be loaded in the background
+    void ReadAhead(Common::ThreadWorker& worker, std::size_t position) {
+        const std::size_t window_start = Common::AlignDown(position, BlockSize);
+        for (std::size_t index = 0; index < NumBlocks; ++index) {
+            const std::size_t block_offset = window_start + index * BlockSize;
+            if (block_offset >= file_size) {
+                break;
+            }
+            const bool is_cached = std::any_of(blocks.begin(), blocks.end(), [&](const Block& b) {
+                return b.status != BlockStatus::Empty && b.offset == block_offset;
+            });
+            if (is_cached) {
+                continue;
+            }
+
+            // Reuse empty blocks first, then blocks the guest has already read past
+            auto it = std::find_if(blocks.begin(), blocks.end(), [](const Block& b) {
+                return b.status == BlockStatus::Empty;
+            });
+            if (it == blocks.end()) {
+                it = std::find_if(blocks.begin(), blocks.end(), [position](const Block& b) {
+                    return b.status != BlockStatus::Loading && b.offset + BlockSize <= position;
+                });
+            }
+            if (it == blocks.end()) {
+                break;
+            }
+
+            it->offset = block_offset;
+            it->size = 0;
+            it->status = BlockStatus::Pending;
+
+            const std::size_t block_index = static_cast<std::size_t>(it - blocks.begin());
+            worker.QueueWork([self = shared_from_this(), block_index, block_offset] {
+                std::unique_lock lock{self->mutex};
+                Block& block = self->blocks[block_index];
+
+                // The guest may have claimed the block, or it may have been recycled
+                if (block.status != BlockStatus::Pending || block.offset != block_offset) {
+                    return;
+                }
+                self->LoadBlock(lock, block);
+            });
+        }
+    }
+
+    VirtualFile file;
+    const std::size_t file_size;
+
+    std::mutex mutex;
+    std::condition_variable block_loaded;
+    std::array<Block, NumBlocks> blocks;
+    std::size_t last_read_end{};
+    u32 sequential_reads{};
+};
+
+ReadaheadVfsFile::ReadaheadVfsFile(VirtualFile file_, std::shared_ptr<Common::ThreadWorker> worker_)
+    : file{std::move(file_)}, worker{std::move(worker_)}, state{std::make_shared<State>(file)} {}
+
+ReadaheadVfsFile::~ReadaheadVfsFile() = default;
+
+std::string ReadaheadVfsFile::GetName() const {
+    return file->GetName();
+}
+
+std::size_t ReadaheadVfsFile::GetSize() const {
+    return state->file_size;
+}
+
+bool ReadaheadVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+VirtualDir ReadaheadVfsFile::GetContainingDirectory() const {
+    return file->GetContainingDirectory();
+}
+
+bool ReadaheadVfsFile::IsWritable() const {
+    return false;
+}
+
+bool ReadaheadVfsFile::IsReadable() const {
+    return file->IsReadable();
+}
+
+std::size_t ReadaheadVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    if (offset >= state->file_size) {
+        return 0;
+    }
+    length = std::min(length, state->file_size - offset);
+
+    std::unique_lock lock{state->mutex};
+    state->sequential_reads = offset == state->last_read_end ? state->sequential_reads + 1 : 0;
+    state->last_read_end = offset + length;
+
+    // Copy out what is cached, waiting on blocks that are being loaded
+    std::size_t copied = 0;
+    while (copied < length) {
+        const std::size_t position = offset + copied;
+        State::Block* const block = state->FindBlock(position);
+        if (!block) {
+            break;
+        }
+        if (block->status == State::BlockStatus::Pending) {
+            // The background thread has not started loading it yet, load it here instead
+            state->LoadBlock(lock, *block);
+        }
+        state->block_loaded.wait(lock,
+                                 [block] { return block->status != State::BlockStatus::Loading; });
+        // The block may have been recycled while waiting, or may be short when the read failed
+        if (block->status != State::BlockStatus::Ready || position < block->offset ||
+            position >= block->offset + block->size) {
+            break;
+        }
+
+        const std::size_t block_offset = position - block->offset;
+        const std::size_t copy_size = std::min(block->size - block_offset, length - copied);
+        std::memcpy(data + copied, block->data.data() + block_offset, copy_size);
+        copied += copy_size;
+    }
+
+    if (state->sequential_reads >= SequentialThreshold) {
+        state->ReadAhead(*worker, offset + length);
+    }
+    lock.unlock();
+
+    if (copied < length) {
+        copied += file->Read(data + copied, length - copied, offset + copied);
+    }
+    return copied;
+}
+
+std::size_t ReadaheadVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+bool ReadaheadVfsFile::Rename(std::string_view new_name) {
+    return false;
+}
+
+} // namespace FileSys
@@ -0,0 +1,46 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <string_view>
+
+#include "core/file_sys/vfs.h"
+
+namespace Common {
+class ThreadWorker;
+}
+
+namespace FileSys {
+
+// An implementation of VfsFile that wraps around a read-only VfsFile and detects sequential reads.
+// Once a file is read sequentially, the blocks following the last read are read (and decrypted,
+// when the wrapped file is encrypted) on a background thread into a small cache, so the next reads
+// only have to copy the data out.
+// Cached blocks are never invalidated, the wrapped file must not be written while it is wrapped.
+class ReadaheadVfsFile : public VfsFile {
+public:
+    explicit ReadaheadVfsFile(VirtualFile file, std::shared_ptr<Common::ThreadWorker> worker);
+    ~ReadaheadVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    VirtualDir GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    bool Rename(std::string_view new_name) override;
+
+private:
+    struct State;
+
+    VirtualFile file;
+    std::shared_ptr<Common::ThreadWorker> worker;
+    std::shared_ptr<State> state;
+};
+
+} // namespace FileSys
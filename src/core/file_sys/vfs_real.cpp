@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <iterator>
+#include <mutex>
 #include <utility>
 #include "common/assert.h"
 #include "common/fs/file.h"
@@ -67,6 +68,7 @@ VfsEntryType RealVfsFilesystem::GetEntryType(std::string_view path_) const {
 VirtualFile RealVfsFilesystem::OpenFile(std::string_view path_, Mode perms) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
 
+    std::scoped_lock lock{cache_mutex};
     if (const auto weak_iter = cache.find(path); weak_iter != cache.cend()) {
         const auto& weak = weak_iter->second;
 
@@ -117,6 +119,8 @@ VirtualFile RealVfsFilesystem::CopyFile(std::string_view old_path_, std::string_
 VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_view new_path_) {
     const auto old_path = FS::SanitizePath(old_path_, FS::DirectorySeparator::PlatformDefault);
     const auto new_path = FS::SanitizePath(new_path_, FS::DirectorySeparator::PlatformDefault);
+
+    std::unique_lock lock{cache_mutex};
     const auto cached_file_iter = cache.find(old_path);
 
     if (cached_file_iter != cache.cend()) {
@@ -141,12 +145,15 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
         UNREACHABLE();
         return nullptr;
     }
+    lock.unlock();
 
     return OpenFile(new_path, Mode::ReadWrite);
 }
 
 bool RealVfsFilesystem::DeleteFile(std::string_view path_) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
+
+    std::scoped_lock lock{cache_mutex};
     const auto cached_iter = cache.find(path);
 
     if (cached_iter != cache.cend()) {
@@ -189,6 +196,7 @@ VirtualDir RealVfsFilesystem::MoveDirectory(std::string_view old_path_,
         return nullptr;
     }
 
+    std::unique_lock lock{cache_mutex};
     for (auto& kv : cache) {
         // If the path in the cache doesn't start with old_path, then bail on this file.
         if (kv.first.rfind(old_path, 0) != 0) {
@@ -214,6 +222,7 @@ VirtualDir RealVfsFilesystem::MoveDirectory(std::string_view old_path_,
             LOG_ERROR(Service_FS, "Failed to open path {} in order to re-cache it", file_new_path);
         }
     }
+    lock.unlock();
 
     return OpenDirectory(new_path, Mode::ReadWrite);
 }
@@ -221,6 +230,7 @@ VirtualDir RealVfsFilesystem::MoveDirectory(std::string_view old_path_,
 bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
 
+    std::unique_lock lock{cache_mutex};
     for (auto& kv : cache) {
         // If the path in the cache doesn't start with path, then bail on this file.
         if (kv.first.rfind(path, 0) != 0) {
@@ -234,6 +244,7 @@ bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
 
         cache.erase(kv.first);
     }
+    lock.unlock();
 
     return FS::RemoveDirRecursively(path);
 }
@@ -270,17 +281,13 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
-    if (!backing->Seek(static_cast<s64>(offset))) {
-        return 0;
-    }
-    return backing->ReadSpan(std::span{data, length});
+    // Host files are shared between every RealVfsFile opened on the same path, positional reads
+    // and writes do not depend on a shared file pointer
+    return backing->ReadAt(std::span{data, length}, offset);
 }
 
 std::size_t RealVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
-    if (!backing->Seek(static_cast<s64>(offset))) {
-        return 0;
-    }
-    return backing->WriteSpan(std::span{data, length});
+    return backing->WriteAt(std::span{data, length}, offset);
 }
 
 bool RealVfsFile::Rename(std::string_view name) {
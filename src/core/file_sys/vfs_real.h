@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <string_view>
 #include <boost/container/flat_map.hpp>
 #include "core/file_sys/mode.h"
@@ -36,7 +37,10 @@ public:
     bool DeleteDirectory(std::string_view path) override;
 
 private:
+    friend class RealVfsFile;
+
     boost::container::flat_map<std::string, std::weak_ptr<Common::FS::IOFile>> cache;
+    std::mutex cache_mutex;
 };
 
 // An implmentation of VfsFile that represents a file on the user's computer.
@@ -71,6 +71,10 @@ public:
         return true;
     }
 
+    u8 GetValue() const {
+        return value;
+    }
+
 private:
     u8 value;
     std::size_t size;
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -55,6 +56,11 @@ public:
                                [[maybe_unused]] f32 freq_high) const {
         return {};
     }
+    /// Returns whether the status can change without its backend calling NotifyStatusChanged, in
+    /// which case the device has to be read on every update.
+    virtual bool IsPolled() const {
+        return true;
+    }
     void SetCallback(InputCallback<StatusType> callback_) {
         callback = std::move(callback_);
     }
@@ -89,8 +95,39 @@ struct FactoryList {
 template <typename InputDeviceType>
 FactoryListType<InputDeviceType> FactoryList<InputDeviceType>::list;
 
+/// Device created for an unbound input, its status never changes.
+template <typename InputDeviceType>
+class NullDevice final : public InputDeviceType {
+public:
+    bool IsPolled() const override {
+        return false;
+    }
+};
+
+template <typename InputDeviceType>
+inline std::atomic<u64> status_change_count{};
+
 } // namespace Impl
 
+/**
+ * Posts a change of status of devices of a type that are not polled. Backends call it from their
+ * own thread once they have updated the status.
+ * @tparam InputDeviceType the type of the devices whose status changed
+ */
+template <typename InputDeviceType>
+void NotifyStatusChanged() {
+    Impl::status_change_count<InputDeviceType>.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * Returns the number of status changes posted so far for a type of devices. The devices of the
+ * type that are not polled keep the same status while it does not change.
+ */
+template <typename InputDeviceType>
+u64 GetStatusChangeCount() {
+    return Impl::status_change_count<InputDeviceType>.load(std::memory_order_acquire);
+}
+
 /**
  * Registers an input device factory.
  * @tparam InputDeviceType the type of input devices the factory can create
@@ -133,7 +170,7 @@ std::unique_ptr<InputDeviceType> CreateDevice(const std::string& params) {
         if (engine != "null") {
             LOG_ERROR(Input, "Unknown engine name: {}", engine);
         }
-        return std::make_unique<InputDeviceType>();
+        return std::make_unique<Impl::NullDevice<InputDeviceType>>();
     }
     return pair->second->Create(package);
 }
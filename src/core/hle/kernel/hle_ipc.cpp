@@ -296,6 +296,21 @@ std::size_t HLERequestContext::WriteBuffer(const void* buffer, std::size_t size,
     return size;
 }
 
+std::span<u8> HLERequestContext::GetWriteBufferSpan(std::size_t buffer_offset, std::size_t size,
+                                                    std::size_t buffer_index) const {
+    const bool is_buffer_b{BufferDescriptorB().size() > buffer_index &&
+                           BufferDescriptorB()[buffer_index].Size()};
+    const std::size_t buffer_size{GetWriteBufferSize(buffer_index)};
+    if (buffer_offset >= buffer_size) {
+        return {};
+    }
+    size = std::min(size, buffer_size - buffer_offset);
+
+    const VAddr buffer_address{is_buffer_b ? BufferDescriptorB()[buffer_index].Address()
+                                           : BufferDescriptorC()[buffer_index].Address()};
+    return memory.GetWritableSpan(buffer_address + buffer_offset, size);
+}
+
 std::size_t HLERequestContext::GetReadBufferSize(std::size_t buffer_index) const {
     const bool is_buffer_a{BufferDescriptorA().size() > buffer_index &&
                            BufferDescriptorA()[buffer_index].Size()};
@@ -5,9 +5,11 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -294,6 +296,20 @@ public:
         }
     }
 
+    /**
+     * Helper function to get the host memory backing part of the output buffer, so data can be
+     * produced in place instead of going through WriteBuffer.
+     *
+     * @param buffer_offset Offset within the output buffer the span starts at.
+     * @param size          Maximum size of the span.
+     * @param buffer_index  The output buffer to get the memory of.
+     *
+     * @returns A span shorter than size when the buffer is not contiguous in host memory, or
+     *          empty when the buffer is not mapped or buffer_offset is past its end.
+     */
+    std::span<u8> GetWriteBufferSpan(std::size_t buffer_offset, std::size_t size,
+                                     std::size_t buffer_index = 0) const;
+
     /// Helper function to get the size of the input buffer
     std::size_t GetReadBufferSize(std::size_t buffer_index = 0) const;
 
@@ -347,6 +363,7 @@ public:
 
 private:
     friend class IPC::ResponseBuilder;
+    friend class ServiceThread;
 
     void ParseCommandBuffer(const KHandleTable& handle_table, u32_le* src_cmdbuf, bool incoming);
 
@@ -381,6 +398,10 @@ private:
     std::shared_ptr<SessionRequestManager> manager;
     bool is_thread_waiting{};
 
+    /// Intrusive link used to queue this request on its ServiceThread
+    std::shared_ptr<HLERequestContext> next_request;
+    std::chrono::steady_clock::time_point queue_time;
+
     KernelCore& kernel;
     Core::Memory::Memory& memory;
 };
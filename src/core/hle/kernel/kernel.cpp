@@ -94,6 +94,7 @@ struct KernelCore::Impl {
 
         // Ensures all service threads gracefully shutdown
         service_threads.clear();
+        service_thread_pool.reset();
 
         next_object_id = 0;
         next_kernel_process_id = KProcess::InitialKIPIDMin;
@@ -674,6 +675,7 @@ struct KernelCore::Impl {
     Kernel::KSharedMemory* time_shared_mem{};
 
     // Threads used for services
+    std::unique_ptr<Kernel::ServiceThreadPool> service_thread_pool;
     std::unordered_set<std::shared_ptr<Kernel::ServiceThread>> service_threads;
 
     std::array<KThread*, Core::Hardware::NUM_CPU_CORES> suspend_threads;
@@ -977,7 +979,10 @@ void KernelCore::ExitSVCProfile() {
 }
 
 std::weak_ptr<Kernel::ServiceThread> KernelCore::CreateServiceThread(const std::string& name) {
-    auto service_thread = std::make_shared<Kernel::ServiceThread>(*this, 1, name);
+    if (!impl->service_thread_pool) {
+        impl->service_thread_pool = std::make_unique<Kernel::ServiceThreadPool>(*this);
+    }
+    auto service_thread = std::make_shared<Kernel::ServiceThread>(*impl->service_thread_pool, name);
     impl->service_threads.emplace(service_thread);
     return service_thread;
 }
@@ -2,114 +2,419 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <condition_variable>
-#include <functional>
+#include <map>
 #include <mutex>
 #include <thread>
-#include <vector>
-#include <queue>
+
+#include <fmt/format.h>
 
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "common/scope_exit.h"
 #include "common/thread.h"
-#include "core/core.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/k_server_session.h"
 #include "core/hle/kernel/k_session.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/service_thread.h"
-#include "core/hle/lock.h"
-#include "video_core/renderer_base.h"
 
 namespace Kernel {
 
-class ServiceThread::Impl final {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+/// Upper bound of host threads the pool spawns
+constexpr std::size_t MaxWorkers = 64;
+
+/// Number of requests a service completes before yielding its worker to other services
+constexpr std::size_t RequestBatchSize = 8;
+} // Anonymous namespace
+
+class ServiceThread::Impl final : public std::enable_shared_from_this<ServiceThread::Impl> {
 public:
-    explicit Impl(KernelCore& kernel, std::size_t num_threads, const std::string& name);
-    ~Impl();
+    explicit Impl(ServiceThreadPool::Impl& pool_, const std::string& name)
+        : pool{pool_}, service_name{name} {}
 
     void QueueSyncRequest(KSession& session, std::shared_ptr<HLERequestContext>&& context);
 
+    /// Completes pending requests, called from a pool worker
+    void Run();
+
+    /// Discards the pending requests, the service thread is not scheduled again after this
+    void Stop();
+
+    /// Drops the reference held while the service thread is queued on the pool
+    void Release();
+
+    Statistics GetStatistics() const {
+        std::scoped_lock lock{mutex};
+        return statistics;
+    }
+
+    /// Intrusive link used by the pool worker queues
+    Impl* next_ready{};
+
 private:
-    std::vector<std::thread> threads;
-    std::queue<std::function<void()>> requests;
-    std::mutex queue_mutex;
-    std::condition_variable condition;
+    ServiceThreadPool::Impl& pool;
     const std::string service_name;
+
+    mutable std::mutex mutex;
+    std::shared_ptr<HLERequestContext> requests_head;
+    HLERequestContext* requests_tail{};
+    std::shared_ptr<Impl> self; ///< Keeps the service thread alive while queued on the pool
+    Statistics statistics;
     bool stop{};
 };
 
-ServiceThread::Impl::Impl(KernelCore& kernel, std::size_t num_threads, const std::string& name)
-    : service_name{name} {
-    for (std::size_t i = 0; i < num_threads; ++i)
-        threads.emplace_back([this, &kernel] {
-            Common::SetCurrentThreadName(std::string{"yuzu:HleService:" + service_name}.c_str());
+class ServiceThreadPool::Impl final {
+public:
+    explicit Impl(KernelCore& kernel_) : kernel{kernel_} {}
+    ~Impl();
 
-            // Wait for first request before trying to acquire a render context
-            {
-                std::unique_lock lock{queue_mutex};
-                condition.wait(lock, [this] { return stop || !requests.empty(); });
-            }
+    /// Queues a service thread with pending requests on one of the workers
+    void Schedule(ServiceThread::Impl* service_thread);
 
-            kernel.RegisterHostThread();
+    /// Adds the statistics of a stopped service thread to the totals of its service
+    void RecordStatistics(const std::string& service_name,
+                          const ServiceThread::Statistics& statistics);
 
-            while (true) {
-                std::function<void()> task;
+private:
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        ServiceThread::Impl* head{};
+        ServiceThread::Impl* tail{};
+        std::atomic_bool idle{};
 
-                {
-                    std::unique_lock lock{queue_mutex};
-                    condition.wait(lock, [this] { return stop || !requests.empty(); });
-                    if (stop || requests.empty()) {
-                        return;
-                    }
-                    task = std::move(requests.front());
-                    requests.pop();
-                }
+        void Push(ServiceThread::Impl* service_thread) {
+            service_thread->next_ready = nullptr;
+            if (tail) {
+                tail->next_ready = service_thread;
+            } else {
+                head = service_thread;
+            }
+            tail = service_thread;
+        }
 
-                task();
+        ServiceThread::Impl* Pop() {
+            ServiceThread::Impl* const service_thread = head;
+            if (service_thread) {
+                head = service_thread->next_ready;
+                if (!head) {
+                    tail = nullptr;
+                }
+                service_thread->next_ready = nullptr;
             }
-        });
-}
+            return service_thread;
+        }
+    };
+
+    void WorkerLoop(std::size_t index);
+
+    /// Steals a queued service thread from another worker, returns nullptr when there is none
+    ServiceThread::Impl* Steal(std::size_t index);
+
+    /// Queues a service thread on a worker and wakes an idle worker to run it
+    void Push(Worker& worker, ServiceThread::Impl* service_thread);
+
+    KernelCore& kernel;
+    std::array<std::unique_ptr<Worker>, MaxWorkers> workers;
+    std::atomic<std::size_t> num_workers{};
+    std::atomic<std::size_t> next_worker{};
+    std::mutex spawn_mutex;
+    std::atomic_bool stop{};
+
+    /// Idle workers wait on a single condition variable, so any of them can pick queued work
+    std::mutex idle_mutex;
+    std::condition_variable idle_condition;
+    std::atomic<std::size_t> num_queued{};
+
+    /// Statistics of the stopped service threads by service name, logged when the pool is
+    /// destroyed. Sessions such as IFile create a service thread each, so they are not logged
+    /// one by one.
+    std::mutex statistics_mutex;
+    std::map<std::string, ServiceThread::Statistics> service_statistics;
+};
 
 void ServiceThread::Impl::QueueSyncRequest(KSession& session,
                                            std::shared_ptr<HLERequestContext>&& context) {
+    auto* server_session{&session.GetServerSession()};
+
+    // Open a reference to the session to ensure it is not closes while the service request
+    // completes asynchronously.
+    server_session->Open();
+
+    context->queue_time = Clock::now();
+
+    bool schedule{};
     {
-        std::unique_lock lock{queue_mutex};
+        std::scoped_lock lock{mutex};
+        if (stop) {
+            server_session->Close();
+            return;
+        }
+
+        HLERequestContext* const raw_context = context.get();
+        if (requests_tail) {
+            requests_tail->next_request = std::move(context);
+        } else {
+            requests_head = std::move(context);
+        }
+        requests_tail = raw_context;
+
+        // Only queue the service thread on the pool when it is not already queued or running
+        if (!self) {
+            self = shared_from_this();
+            schedule = true;
+        }
+    }
+    if (schedule) {
+        pool.Schedule(this);
+    }
+}
 
-        auto* server_session{&session.GetServerSession()};
+void ServiceThread::Impl::Run() {
+    for (std::size_t batch = 0; batch < RequestBatchSize; ++batch) {
+        std::shared_ptr<HLERequestContext> context;
+        {
+            std::scoped_lock lock{mutex};
+            if (stop || !requests_head) {
+                break;
+            }
+            context = std::move(requests_head);
+            requests_head = std::move(context->next_request);
+            if (!requests_head) {
+                requests_tail = nullptr;
+            }
+        }
 
-        // Open a reference to the session to ensure it is not closes while the service request
-        // completes asynchronously.
-        server_session->Open();
+        const auto start_time = Clock::now();
+        {
+            auto* server_session{context->Session()};
 
-        requests.emplace([server_session, context{std::move(context)}]() {
             // Close the reference.
             SCOPE_EXIT({ server_session->Close(); });
 
             // Complete the service request.
             server_session->CompleteSyncRequest(*context);
-        });
+        }
+        const auto end_time = Clock::now();
+
+        const auto queue_latency = start_time - context->queue_time;
+        const auto service_time = end_time - start_time;
+
+        std::scoped_lock lock{mutex};
+        ++statistics.num_requests;
+        statistics.total_queue_latency += queue_latency;
+        statistics.max_queue_latency = std::max<std::chrono::nanoseconds>(
+            statistics.max_queue_latency, queue_latency);
+        statistics.total_service_time += service_time;
+        statistics.max_service_time =
+            std::max<std::chrono::nanoseconds>(statistics.max_service_time, service_time);
+    }
+
+    std::shared_ptr<Impl> keep_alive;
+    {
+        std::scoped_lock lock{mutex};
+        if (!stop && requests_head) {
+            // There is still work left, requeue behind the other services
+            pool.Schedule(this);
+            return;
+        }
+        keep_alive = std::move(self);
     }
-    condition.notify_one();
 }
 
-ServiceThread::Impl::~Impl() {
+void ServiceThread::Impl::Stop() {
+    std::shared_ptr<HLERequestContext> discarded_requests;
+    Statistics final_statistics;
     {
-        std::unique_lock lock{queue_mutex};
+        std::scoped_lock lock{mutex};
         stop = true;
+        discarded_requests = std::move(requests_head);
+        requests_tail = nullptr;
+        final_statistics = statistics;
     }
-    condition.notify_all();
-    for (std::thread& thread : threads) {
-        thread.join();
+
+    // Unlink the discarded requests iteratively to avoid a deep recursion of destructors
+    while (discarded_requests) {
+        discarded_requests = std::move(discarded_requests->next_request);
+    }
+
+    if (final_statistics.num_requests > 0) {
+        pool.RecordStatistics(service_name, final_statistics);
     }
 }
 
-ServiceThread::ServiceThread(KernelCore& kernel, std::size_t num_threads, const std::string& name)
-    : impl{std::make_unique<Impl>(kernel, num_threads, name)} {}
+void ServiceThread::Impl::Release() {
+    std::shared_ptr<Impl> keep_alive;
+    {
+        std::scoped_lock lock{mutex};
+        keep_alive = std::move(self);
+    }
+}
+
+ServiceThreadPool::Impl::~Impl() {
+    stop = true;
+    {
+        std::scoped_lock lock{idle_mutex};
+    }
+    idle_condition.notify_all();
+
+    const std::size_t count = num_workers.load();
+    for (std::size_t index = 0; index < count; ++index) {
+        workers[index]->thread.join();
+    }
+
+    // Release the service threads that were still queued
+    for (std::size_t index = 0; index < count; ++index) {
+        while (ServiceThread::Impl* const service_thread = workers[index]->Pop()) {
+            service_thread->Release();
+        }
+    }
+
+    const auto to_us = [](std::chrono::nanoseconds ns) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(ns).count();
+    };
+    for (const auto& [service_name, statistics] : service_statistics) {
+        const auto num_requests = static_cast<s64>(statistics.num_requests);
+        LOG_INFO(Kernel,
+                 "{}: {} requests, queue latency avg={}us max={}us, service time avg={}us "
+                 "max={}us",
+                 service_name, num_requests, to_us(statistics.total_queue_latency) / num_requests,
+                 to_us(statistics.max_queue_latency),
+                 to_us(statistics.total_service_time) / num_requests,
+                 to_us(statistics.max_service_time));
+    }
+}
+
+void ServiceThreadPool::Impl::RecordStatistics(const std::string& service_name,
+                                               const ServiceThread::Statistics& statistics) {
+    std::scoped_lock lock{statistics_mutex};
+    ServiceThread::Statistics& total = service_statistics[service_name];
+    total.num_requests += statistics.num_requests;
+    total.total_queue_latency += statistics.total_queue_latency;
+    total.max_queue_latency = std::max(total.max_queue_latency, statistics.max_queue_latency);
+    total.total_service_time += statistics.total_service_time;
+    total.max_service_time = std::max(total.max_service_time, statistics.max_service_time);
+}
+
+void ServiceThreadPool::Impl::Schedule(ServiceThread::Impl* service_thread) {
+    const std::size_t count = num_workers.load(std::memory_order_acquire);
+    const std::size_t start = next_worker.fetch_add(1, std::memory_order_relaxed);
+
+    // Prefer handing the service thread to an idle worker
+    for (std::size_t offset = 0; offset < count; ++offset) {
+        Worker& worker = *workers[(start + offset) % count];
+        if (!worker.idle.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        Push(worker, service_thread);
+        return;
+    }
+
+    // Every worker is busy, spawn a new one when possible
+    if (count < MaxWorkers) {
+        std::scoped_lock spawn_lock{spawn_mutex};
+        const std::size_t index = num_workers.load(std::memory_order_relaxed);
+        if (index < MaxWorkers) {
+            auto worker = std::make_unique<Worker>();
+            worker->Push(service_thread);
+            num_queued.fetch_add(1, std::memory_order_release);
+            workers[index] = std::move(worker);
+            workers[index]->thread = std::thread([this, index] { WorkerLoop(index); });
+            num_workers.store(index + 1, std::memory_order_release);
+            return;
+        }
+    }
+
+    // Queue behind a busy worker, the first worker to become idle steals it
+    Push(*workers[start % num_workers.load(std::memory_order_acquire)], service_thread);
+}
 
-ServiceThread::~ServiceThread() = default;
+void ServiceThreadPool::Impl::Push(Worker& worker, ServiceThread::Impl* service_thread) {
+    {
+        std::scoped_lock lock{worker.mutex};
+        worker.Push(service_thread);
+        num_queued.fetch_add(1, std::memory_order_release);
+    }
+    {
+        std::scoped_lock lock{idle_mutex};
+    }
+    idle_condition.notify_one();
+}
+
+ServiceThread::Impl* ServiceThreadPool::Impl::Steal(std::size_t index) {
+    const std::size_t count = num_workers.load(std::memory_order_acquire);
+    for (std::size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers[(index + offset) % count];
+        std::unique_lock lock{victim.mutex, std::try_to_lock};
+        if (!lock) {
+            continue;
+        }
+        if (ServiceThread::Impl* const service_thread = victim.Pop()) {
+            num_queued.fetch_sub(1, std::memory_order_relaxed);
+            return service_thread;
+        }
+    }
+    return nullptr;
+}
+
+void ServiceThreadPool::Impl::WorkerLoop(std::size_t index) {
+    Common::SetCurrentThreadName(fmt::format("yuzu:HleService:{}", index).c_str());
+
+    kernel.RegisterHostThread();
+
+    Worker& worker = *workers[index];
+
+    while (!stop) {
+        ServiceThread::Impl* service_thread;
+        {
+            std::scoped_lock lock{worker.mutex};
+            service_thread = worker.Pop();
+            if (service_thread) {
+                num_queued.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        if (!service_thread) {
+            service_thread = Steal(index);
+        }
+        if (!service_thread) {
+            std::unique_lock lock{idle_mutex};
+            worker.idle = true;
+            idle_condition.wait(lock, [this] {
+                return stop || num_queued.load(std::memory_order_acquire) > 0;
+            });
+            worker.idle = false;
+            continue;
+        }
+        service_thread->Run();
+    }
+}
+
+ServiceThread::ServiceThread(ServiceThreadPool& pool, const std::string& name)
+    : impl{std::make_shared<Impl>(*pool.impl, name)} {}
+
+ServiceThread::~ServiceThread() {
+    impl->Stop();
+}
 
 void ServiceThread::QueueSyncRequest(KSession& session,
                                      std::shared_ptr<HLERequestContext>&& context) {
     impl->QueueSyncRequest(session, std::move(context));
 }
 
+ServiceThread::Statistics ServiceThread::GetStatistics() const {
+    return impl->GetStatistics();
+}
+
+ServiceThreadPool::ServiceThreadPool(KernelCore& kernel)
+    : impl{std::make_unique<Impl>(kernel)} {}
+
+ServiceThreadPool::~ServiceThreadPool() = default;
+
 } // namespace Kernel
@@ -4,23 +4,64 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 
+#include "common/common_types.h"
+
 namespace Kernel {
 
 class HLERequestContext;
 class KernelCore;
 class KSession;
+class ServiceThreadPool;
 
+/**
+ * Serializes the requests of a single HLE service. Requests queued on a service thread are
+ * completed one at a time and in FIFO order, but they are executed by the workers of a
+ * ServiceThreadPool shared by every service, so independent services run in parallel.
+ */
 class ServiceThread final {
 public:
-    explicit ServiceThread(KernelCore& kernel, std::size_t num_threads, const std::string& name);
+    /// Timing statistics accumulated over the lifetime of a service thread
+    struct Statistics {
+        u64 num_requests{};
+        std::chrono::nanoseconds total_queue_latency{};
+        std::chrono::nanoseconds max_queue_latency{};
+        std::chrono::nanoseconds total_service_time{};
+        std::chrono::nanoseconds max_service_time{};
+    };
+
+    explicit ServiceThread(ServiceThreadPool& pool, const std::string& name);
     ~ServiceThread();
 
     void QueueSyncRequest(KSession& session, std::shared_ptr<HLERequestContext>&& context);
 
+    [[nodiscard]] Statistics GetStatistics() const;
+
 private:
+    friend class ServiceThreadPool;
+
+    class Impl;
+    std::shared_ptr<Impl> impl;
+};
+
+/**
+ * Set of host threads executing the requests of every ServiceThread. Each worker owns a queue of
+ * service threads with pending requests, and idle workers steal from busy ones. Workers are
+ * spawned on demand when every existing worker is busy, so a service blocking on a long request
+ * does not hold back the others. The statistics of every service are logged when the pool is
+ * destroyed.
+ */
+class ServiceThreadPool final {
+public:
+    explicit ServiceThreadPool(KernelCore& kernel);
+    ~ServiceThreadPool();
+
+private:
+    friend class ServiceThread;
+
     class Impl;
     std::unique_ptr<Impl> impl;
 };
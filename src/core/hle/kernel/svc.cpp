@@ -13,6 +13,7 @@
 #include "common/common_funcs.h"
 #include "common/fiber.h"
 #include "common/logging/log.h"
+#include "common/logging/trace.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/string_util.h"
@@ -2683,6 +2684,7 @@ void Call(Core::System& system, u32 immediate) {
     const FunctionDef* info = system.CurrentProcess()->Is64BitProcess() ? GetSVCInfo64(immediate)
                                                                         : GetSVCInfo32(immediate);
     if (info) {
+        TRACE_SCOPE(Kernel_SVC, info->name, {"id", immediate});
         if (info->func) {
             info->func(system);
         } else {
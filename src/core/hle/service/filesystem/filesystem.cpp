@@ -7,6 +7,7 @@
 #include "common/assert.h"
 #include "common/fs/path_util.h"
 #include "common/settings.h"
+#include "common/thread_worker.h"
 #include "core/core.h"
 #include "core/file_sys/bis_factory.h"
 #include "core/file_sys/card_image.h"
@@ -255,6 +256,23 @@ FileSystemController::FileSystemController(Core::System& system_) : system{syste
 
 FileSystemController::~FileSystemController() = default;
 
+std::shared_ptr<Common::ThreadWorker> FileSystemController::GetReadaheadWorker() {
+    std::scoped_lock lock{readahead_mutex};
+    if (!readahead_worker) {
+        readahead_worker = std::make_shared<Common::ThreadWorker>(2, "yuzu:Readahead");
+    }
+    return readahead_worker;
+}
+
+void FileSystemController::ShutdownReadahead() {
+    std::shared_ptr<Common::ThreadWorker> worker;
+    {
+        std::scoped_lock lock{readahead_mutex};
+        worker = std::move(readahead_worker);
+    }
+    // The worker joins its threads here unless a storage still holds it
+}
+
 ResultCode FileSystemController::RegisterRomFS(std::unique_ptr<FileSys::RomFSFactory>&& factory) {
     romfs_factory = std::move(factory);
     LOG_DEBUG(Service_FS, "Registered RomFS");
@@ -5,11 +5,16 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include "common/common_types.h"
 #include "core/file_sys/directory.h"
 #include "core/file_sys/vfs.h"
 #include "core/hle/result.h"
 
+namespace Common {
+class ThreadWorker;
+}
+
 namespace Core {
 class System;
 }
@@ -123,6 +128,13 @@ public:
 
     void SetAutoSaveDataCreation(bool enable);
 
+    /// Returns the worker reading ahead of the guest on the storages it opens
+    std::shared_ptr<Common::ThreadWorker> GetReadaheadWorker();
+
+    /// Releases the readahead worker, its pending reads are drained once the storages using it
+    /// are closed. Called when emulation stops.
+    void ShutdownReadahead();
+
     // Creates the SaveData, SDMC, and BIS Factories. Should be called once and before any function
     // above is called.
     void CreateFactories(FileSys::VfsFilesystem& vfs, bool overwrite = true);
@@ -137,6 +149,9 @@ private:
     std::unique_ptr<FileSys::RegisteredCache> gamecard_registered;
     std::unique_ptr<FileSys::PlaceholderCache> gamecard_placeholder;
 
+    std::mutex readahead_mutex;
+    std::shared_ptr<Common::ThreadWorker> readahead_worker;
+
     Core::System& system;
 };
 
@@ -5,6 +5,7 @@
 #include <cinttypes>
 #include <cstring>
 #include <iterator>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "core/file_sys/savedata_factory.h"
 #include "core/file_sys/system_archive/system_archive.h"
 #include "core/file_sys/vfs.h"
+#include "core/file_sys/vfs_readahead.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/k_process.h"
 #include "core/hle/service/filesystem/filesystem.h"
@@ -56,10 +58,36 @@ enum class FileSystemType : u8 {
     ApplicationPackage = 7,
 };
 
+/**
+ * Reads from a file straight into the output buffer of a request, one host-contiguous span of
+ * the buffer at a time, avoiding the intermediate vector of ReadBytes and the copy of WriteBuffer.
+ * Returns the number of bytes read.
+ */
+static std::size_t ReadToWriteBuffer(Kernel::HLERequestContext& ctx, const FileSys::VfsFile& file,
+                                     std::size_t length, std::size_t offset) {
+    std::size_t total_read = 0;
+    while (total_read < length) {
+        const std::span<u8> dest = ctx.GetWriteBufferSpan(total_read, length - total_read);
+        if (dest.empty()) {
+            break;
+        }
+        const std::size_t read = file.Read(dest.data(), dest.size(), offset + total_read);
+        total_read += read;
+        if (read < dest.size()) {
+            break;
+        }
+    }
+    return total_read;
+}
+
 class IStorage final : public ServiceFramework<IStorage> {
 public:
+    // Storages are backed by RomFS and NCA data that can't be written while emulation runs, so
+    // their sequential reads can be served from readahead without invalidation
     explicit IStorage(Core::System& system_, FileSys::VirtualFile backend_)
-        : ServiceFramework{system_, "IStorage"}, backend(std::move(backend_)) {
+        : ServiceFramework{system_, "IStorage"},
+          backend(std::make_shared<FileSys::ReadaheadVfsFile>(
+              std::move(backend_), system_.GetFileSystemController().GetReadaheadWorker())) {
         static const FunctionInfo functions[] = {
             {0, &IStorage::Read, "Read"},
             {1, nullptr, "Write"},
@@ -95,10 +123,9 @@ private:
             return;
         }
 
-        // Read the data from the Storage backend
-        std::vector<u8> output = backend->ReadBytes(length, offset);
-        // Write the data to memory
-        ctx.WriteBuffer(output);
+        // Read the data from the Storage backend into memory
+        ReadToWriteBuffer(ctx, *backend, static_cast<std::size_t>(length),
+                          static_cast<std::size_t>(offset));
 
         IPC::ResponseBuilder rb{ctx, 2};
         rb.Push(ResultSuccess);
@@ -156,15 +183,13 @@ private:
             return;
         }
 
-        // Read the data from the Storage backend
-        std::vector<u8> output = backend->ReadBytes(length, offset);
-
-        // Write the data to memory
-        ctx.WriteBuffer(output);
+        // Read the data from the Storage backend into memory
+        const std::size_t read = ReadToWriteBuffer(ctx, *backend, static_cast<std::size_t>(length),
+                                                   static_cast<std::size_t>(offset));
 
         IPC::ResponseBuilder rb{ctx, 4};
         rb.Push(ResultSuccess);
-        rb.Push(static_cast<u64>(output.size()));
+        rb.Push(static_cast<u64>(read));
     }
 
     void Write(Kernel::HLERequestContext& ctx) {
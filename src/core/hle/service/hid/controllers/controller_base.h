@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <optional>
 #include "common/common_types.h"
 #include "common/swap.h"
+#include "core/frontend/input.h"
 
 namespace Core::Timing {
 class CoreTiming;
@@ -16,6 +18,33 @@ class System;
 }
 
 namespace Service::HID {
+/**
+ * Tells whether input devices that are not polled may have changed since an update last read them.
+ * These devices post their changes, while none is posted reading them can be skipped.
+ */
+class InputChangeTracker {
+public:
+    /// Forgets the last read, to be called when new devices are loaded.
+    void Reset() {
+        last_change_count.reset();
+    }
+
+    /// Returns whether devices of the given types have to be read, assuming they are read when it
+    /// returns true.
+    template <typename... InputDeviceTypes>
+    bool HasChanged() {
+        const u64 change_count = (u64{0} + ... + Input::GetStatusChangeCount<InputDeviceTypes>());
+        if (last_change_count == change_count) {
+            return false;
+        }
+        last_change_count = change_count;
+        return true;
+    }
+
+private:
+    std::optional<u64> last_change_count;
+};
+
 class ControllerBase {
 public:
     explicit ControllerBase(Core::System& system_);
@@ -261,6 +261,8 @@ void Controller_NPad::OnInit() {
         return;
     }
 
+    needs_full_update = true;
+
     OnLoadInputDevices();
 
     if (style.raw == 0) {
@@ -334,6 +336,16 @@ void Controller_NPad::OnLoadInputDevices() {
             InitializeVibrationDeviceAtIndex(i, device_idx);
         }
     }
+
+    const auto is_polled = [](const auto& device) { return device && device->IsPolled(); };
+    for (std::size_t i = 0; i < players.size(); ++i) {
+        has_polled_pad_devices[i] = std::any_of(buttons[i].begin(), buttons[i].end(), is_polled) ||
+                                    std::any_of(sticks[i].begin(), sticks[i].end(), is_polled);
+        has_polled_motion_devices[i] =
+            std::any_of(motions[i].begin(), motions[i].end(), is_polled);
+    }
+    pad_input_tracker.Reset();
+    motion_input_tracker.Reset();
 }
 
 void Controller_NPad::OnRelease() {
@@ -448,6 +460,8 @@ void Controller_NPad::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8*
     if (!IsControllerActivated()) {
         return;
     }
+    const bool devices_changed =
+        pad_input_tracker.HasChanged<Input::ButtonDevice, Input::AnalogDevice>();
     for (std::size_t i = 0; i < shared_memory_entries.size(); ++i) {
         auto& npad = shared_memory_entries[i];
         const std::array<NPadGeneric*, 7> controller_npads{
@@ -495,11 +509,16 @@ void Controller_NPad::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8*
         const auto& controller_type = connected_controllers[i].type;
 
         if (controller_type == NPadControllerType::None || !connected_controllers[i].is_connected) {
+            pad_state_types[i] = NPadControllerType::None;
             continue;
         }
         const u32 npad_index = static_cast<u32>(i);
 
-        RequestPadStateUpdate(npad_index);
+        // The sample is still appended when nothing changed, with the state read last
+        if (devices_changed || has_polled_pad_devices[i] || pad_state_types[i] != controller_type) {
+            RequestPadStateUpdate(npad_index);
+            pad_state_types[i] = controller_type;
+        }
         auto& pad_state = npad_pad_states[npad_index];
         auto& trigger_state = npad_trigger_states[npad_index];
 
@@ -613,8 +632,27 @@ void Controller_NPad::OnUpdate(const Core::Timing::CoreTiming& core_timing, u8*
 
         press_state |= static_cast<u32>(pad_state.pad_states.raw);
     }
-    std::memcpy(data + NPAD_OFFSET, shared_memory_entries.data(),
-                shared_memory_entries.size() * sizeof(NPadEntry));
+
+    if (needs_full_update) {
+        std::memcpy(data + NPAD_OFFSET, shared_memory_entries.data(),
+                    shared_memory_entries.size() * sizeof(NPadEntry));
+        needs_full_update = false;
+        return;
+    }
+    for (std::size_t i = 0; i < shared_memory_entries.size(); ++i) {
+        const auto& npad = shared_memory_entries[i];
+        u8* const entry_data = data + NPAD_OFFSET + i * sizeof(NPadEntry);
+
+        WriteEntryProperties(entry_data, npad);
+        WriteLatestSample(entry_data, npad, npad.fullkey_states);
+        WriteLatestSample(entry_data, npad, npad.handheld_states);
+        WriteLatestSample(entry_data, npad, npad.joy_dual_states);
+        WriteLatestSample(entry_data, npad, npad.joy_left_states);
+        WriteLatestSample(entry_data, npad, npad.joy_right_states);
+        WriteLatestSample(entry_data, npad, npad.palma_states);
+        WriteLatestSample(entry_data, npad, npad.system_ext_states);
+        WriteLatestSample(entry_data, npad, npad.gc_trigger_states);
+    }
 }
 
 void Controller_NPad::OnMotionUpdate(const Core::Timing::CoreTiming& core_timing, u8* data,
@@ -622,12 +660,14 @@ void Controller_NPad::OnMotionUpdate(const Core::Timing::CoreTiming& core_timing
     if (!IsControllerActivated()) {
         return;
     }
+    const bool devices_changed = motion_input_tracker.HasChanged<Input::MotionDevice>();
     for (std::size_t i = 0; i < shared_memory_entries.size(); ++i) {
         auto& npad = shared_memory_entries[i];
 
         const auto& controller_type = connected_controllers[i].type;
 
         if (controller_type == NPadControllerType::None || !connected_controllers[i].is_connected) {
+            motion_states_read[i] = false;
             continue;
         }
 
@@ -653,20 +693,29 @@ void Controller_NPad::OnMotionUpdate(const Core::Timing::CoreTiming& core_timing
             cur_entry.timestamp2 = cur_entry.timestamp;
         }
 
-        // Try to read sixaxis sensor states
+        // Try to read sixaxis sensor states, the ones read last are kept while nothing changed
         std::array<MotionDevice, 2> motion_devices;
 
         if (sixaxis_sensors_enabled && Settings::values.motion_enabled.GetValue()) {
+            auto& motion_state = motion_states[i];
+            const bool read_motion =
+                devices_changed || has_polled_motion_devices[i] || !motion_states_read[i];
             sixaxis_at_rest = true;
             for (std::size_t e = 0; e < motion_devices.size(); ++e) {
                 const auto& device = motions[i][e];
                 if (device) {
-                    std::tie(motion_devices[e].accel, motion_devices[e].gyro,
-                             motion_devices[e].rotation, motion_devices[e].orientation,
-                             motion_devices[e].quaternion) = device->GetStatus();
+                    if (read_motion) {
+                        std::tie(motion_state[e].accel, motion_state[e].gyro,
+                                 motion_state[e].rotation, motion_state[e].orientation,
+                                 motion_state[e].quaternion) = device->GetStatus();
+                    }
+                    motion_devices[e] = motion_state[e];
                     sixaxis_at_rest = sixaxis_at_rest && motion_devices[e].gyro.Length2() < 0.0001f;
                 }
             }
+            motion_states_read[i] = true;
+        } else {
+            motion_states_read[i] = false;
         }
 
         auto& full_sixaxis_entry =
@@ -751,8 +800,58 @@ void Controller_NPad::OnMotionUpdate(const Core::Timing::CoreTiming& core_timing
             break;
         }
     }
-    std::memcpy(data + NPAD_OFFSET, shared_memory_entries.data(),
-                shared_memory_entries.size() * sizeof(NPadEntry));
+
+    if (needs_full_update) {
+        std::memcpy(data + NPAD_OFFSET, shared_memory_entries.data(),
+                    shared_memory_entries.size() * sizeof(NPadEntry));
+        needs_full_update = false;
+        return;
+    }
+    for (std::size_t i = 0; i < shared_memory_entries.size(); ++i) {
+        const auto& npad = shared_memory_entries[i];
+        u8* const entry_data = data + NPAD_OFFSET + i * sizeof(NPadEntry);
+
+        WriteEntryProperties(entry_data, npad);
+        WriteLatestSample(entry_data, npad, npad.sixaxis_fullkey);
+        WriteLatestSample(entry_data, npad, npad.sixaxis_handheld);
+        WriteLatestSample(entry_data, npad, npad.sixaxis_dual_left);
+        WriteLatestSample(entry_data, npad, npad.sixaxis_dual_right);
+        WriteLatestSample(entry_data, npad, npad.sixaxis_left);
+        WriteLatestSample(entry_data, npad, npad.sixaxis_right);
+    }
+}
+
+void Controller_NPad::WriteEntryProperties(u8* entry_data, const NPadEntry& npad) const {
+    const auto* const base = reinterpret_cast<const u8*>(&npad);
+    const auto copy_range = [entry_data, base](const void* begin, const void* end) {
+        const auto* const begin_ptr = static_cast<const u8*>(begin);
+        std::memcpy(entry_data + (begin_ptr - base), begin_ptr,
+                    static_cast<const u8*>(end) - begin_ptr);
+    };
+    copy_range(&npad, &npad.fullkey_states);
+    copy_range(&npad.device_type, &npad.gc_trigger_states);
+}
+
+template <typename Ring>
+void Controller_NPad::WriteLatestSample(u8* entry_data, const NPadEntry& npad,
+                                        const Ring& ring) const {
+    const auto* const base = reinterpret_cast<const u8*>(&npad);
+    const auto copy_object = [entry_data, base](const auto& object) {
+        const auto* const object_ptr = reinterpret_cast<const u8*>(&object);
+        std::memcpy(entry_data + (object_ptr - base), object_ptr, sizeof(object));
+    };
+    if constexpr (std::is_same_v<Ring, TriggerGeneric>) {
+        // The trigger header is not a CommonHeader, copy everything preceding the samples
+        const auto* const ring_ptr = reinterpret_cast<const u8*>(&ring);
+        std::memcpy(entry_data + (ring_ptr - base), ring_ptr, offsetof(TriggerGeneric, trigger));
+        copy_object(ring.trigger[ring.last_entry_index]);
+    } else if constexpr (std::is_same_v<Ring, SixAxisGeneric>) {
+        copy_object(ring.common);
+        copy_object(ring.sixaxis[ring.common.last_entry_index]);
+    } else {
+        copy_object(ring.common);
+        copy_object(ring.npad[ring.common.last_entry_index]);
+    }
 }
 
 void Controller_NPad::SetSupportedStyleSet(NpadStyleSet style_set) {
@@ -549,10 +549,20 @@ private:
     bool IsControllerSupported(NPadControllerType controller) const;
     void RequestPadStateUpdate(u32 npad_id);
 
+    /// Copies the parts of an entry that are not sample rings to shared memory
+    void WriteEntryProperties(u8* entry_data, const NPadEntry& npad) const;
+
+    /// Copies the header and the latest sample of a sample ring to shared memory
+    template <typename Ring>
+    void WriteLatestSample(u8* entry_data, const NPadEntry& npad, const Ring& ring) const;
+
     std::atomic<u32> press_state{};
 
     NpadStyleSet style{};
     std::array<NPadEntry, 10> shared_memory_entries{};
+    // Samples are appended in place, so after shared memory has been written once in full only
+    // the latest sample of each ring and the entry properties have to be copied again.
+    bool needs_full_update{true};
     using ButtonArray = std::array<
         std::array<std::unique_ptr<Input::ButtonDevice>, Settings::NativeButton::NUM_BUTTONS_HID>,
         10>;
@@ -592,6 +602,15 @@ private:
     bool sixaxis_at_rest{true};
     std::array<ControllerPad, 10> npad_pad_states{};
     std::array<TriggerState, 10> npad_trigger_states{};
+    // Pad and motion states are read again only when a device changed or is polled, or for the
+    // pad state when the controller type it was read for changed.
+    InputChangeTracker pad_input_tracker;
+    InputChangeTracker motion_input_tracker;
+    std::array<bool, 10> has_polled_pad_devices{};
+    std::array<bool, 10> has_polled_motion_devices{};
+    std::array<NPadControllerType, 10> pad_state_types{};
+    std::array<std::array<MotionDevice, 2>, 10> motion_states{};
+    std::array<bool, 10> motion_states_read{};
     bool is_in_lr_assignment_mode{false};
 };
 } // namespace Service::HID
@@ -5,6 +5,7 @@
 #include <array>
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "common/settings.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -37,6 +38,9 @@
 #include "core/hle/service/hid/controllers/touchscreen.h"
 #include "core/hle/service/hid/controllers/xpad.h"
 
+MICROPROFILE_DEFINE(HID_UpdateControllers, "HID", "Update controllers", MP_RGB(128, 192, 255));
+MICROPROFILE_DEFINE(HID_UpdateMotion, "HID", "Update motion", MP_RGB(128, 160, 255));
+
 namespace Service::HID {
 
 // Updating period for each HID device.
@@ -120,6 +124,7 @@ void IAppletResource::GetSharedMemoryHandle(Kernel::HLERequestContext& ctx) {
 
 void IAppletResource::UpdateControllers(std::uintptr_t user_data,
                                         std::chrono::nanoseconds ns_late) {
+    MICROPROFILE_SCOPE(HID_UpdateControllers);
     auto& core_timing = system.CoreTiming();
 
     const bool should_reload = Settings::values.is_device_reload_pending.exchange(false);
@@ -140,6 +145,7 @@ void IAppletResource::UpdateControllers(std::uintptr_t user_data,
 }
 
 void IAppletResource::UpdateMotion(std::uintptr_t user_data, std::chrono::nanoseconds ns_late) {
+    MICROPROFILE_SCOPE(HID_UpdateMotion);
     auto& core_timing = system.CoreTiming();
 
     controllers[static_cast<size_t>(HidController::NPad)]->OnMotionUpdate(
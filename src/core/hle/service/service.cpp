@@ -6,6 +6,7 @@
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/logging/trace.h"
 #include "common/settings.h"
 #include "common/string_util.h"
 #include "core/core.h"
@@ -174,6 +175,7 @@ void ServiceFrameworkBase::InvokeRequest(Kernel::HLERequestContext& ctx) {
     }
 
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
+    TRACE_SCOPE(Service, info->name, {"service", service_name}, {"command", ctx.GetCommand()});
     handler_invoker(this, info->handler_callback, ctx);
 }
 
@@ -188,6 +190,7 @@ void ServiceFrameworkBase::InvokeRequestTipc(Kernel::HLERequestContext& ctx) {
     }
 
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
+    TRACE_SCOPE(Service, info->name, {"service", service_name}, {"command", ctx.GetCommand()});
     handler_invoker(this, info->handler_callback, ctx);
 }
 
@@ -525,7 +525,7 @@ std::pair<s32, Errno> BSD::PollImpl(std::vector<u8>& write_buffer, std::vector<u
         return result;
     });
 
-    const auto result = Network::Poll(host_pollfds, timeout);
+    const auto result = poll_set->Poll(host_pollfds, timeout);
 
     const size_t num = host_pollfds.size();
     for (size_t i = 0; i < num; ++i) {
@@ -787,6 +787,8 @@ Errno BSD::CloseImpl(s32 fd) {
         return Errno::BADF;
     }
 
+    poll_set->Remove(*file_descriptors[fd]->socket);
+
     const Errno bsd_errno = Translate(file_descriptors[fd]->socket->Close());
     if (bsd_errno != Errno::SUCCESS) {
         return bsd_errno;
@@ -827,7 +829,8 @@ void BSD::BuildErrnoResponse(Kernel::HLERequestContext& ctx, Errno bsd_errno) co
     rb.PushEnum(bsd_errno);
 }
 
-BSD::BSD(Core::System& system_, const char* name) : ServiceFramework{system_, name} {
+BSD::BSD(Core::System& system_, const char* name)
+    : ServiceFramework{system_, name}, poll_set{std::make_unique<Network::PollSet>()} {
     // clang-format off
     static const FunctionInfo functions[] = {
         {0, &BSD::RegisterClient, "RegisterClient"},
@@ -18,8 +18,9 @@ class System;
 }
 
 namespace Network {
+class PollSet;
 class Socket;
-}
+} // namespace Network
 
 namespace Service::Sockets {
 
@@ -167,6 +168,9 @@ private:
     void BuildErrnoResponse(Kernel::HLERequestContext& ctx, Errno bsd_errno) const noexcept;
 
     std::array<std::optional<FileDescriptor>, MAX_FD> file_descriptors;
+
+    /// Sockets polled by the guest, kept across calls to Poll
+    std::unique_ptr<Network::PollSet> poll_set;
 };
 
 class BSDCFG final : public ServiceFramework<BSDCFG> {
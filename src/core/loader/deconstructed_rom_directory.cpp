@@ -4,6 +4,8 @@
 
 #include <cinttypes>
 #include <cstring>
+#include <optional>
+#include <vector>
 #include "common/common_funcs.h"
 #include "common/logging/log.h"
 #include "core/core.h"
@@ -158,25 +160,36 @@ AppLoader_DeconstructedRomDirectory::LoadResult AppLoader_DeconstructedRomDirect
     modules.clear();
     const VAddr base_address{process.PageTable().GetCodeRegionStart()};
     VAddr next_load_addr{base_address};
-    const FileSys::PatchManager pm{metadata.GetTitleID(), system.GetFileSystemController(),
-                                   system.GetContentProvider()};
+    const std::optional<FileSys::PatchManager> pm{std::in_place, metadata.GetTitleID(),
+                                                  system.GetFileSystemController(),
+                                                  system.GetContentProvider()};
+
+    // Read every module at once so their segments are decompressed in parallel
+    std::vector<const char*> module_names;
+    std::vector<FileSys::VirtualFile> module_files;
+    std::vector<AppLoader_NSO::ModuleSource> module_sources;
     for (const auto& module : static_modules) {
-        const FileSys::VirtualFile module_file{dir->GetFile(module)};
+        FileSys::VirtualFile module_file{dir->GetFile(module)};
         if (!module_file) {
             continue;
         }
-
-        const VAddr load_addr{next_load_addr};
         const bool should_pass_arguments = std::strcmp(module, "rtld") == 0;
-        const auto tentative_next_load_addr = AppLoader_NSO::LoadModule(
-            process, system, *module_file, load_addr, should_pass_arguments, true, pm);
-        if (!tentative_next_load_addr) {
+        module_sources.push_back({module_file.get(), should_pass_arguments});
+        module_files.push_back(std::move(module_file));
+        module_names.push_back(module);
+    }
+    auto module_images = AppLoader_NSO::ReadModuleImages(module_sources);
+
+    for (std::size_t i = 0; i < module_images.size(); ++i) {
+        if (!module_images[i]) {
             return {ResultStatus::ErrorLoadingNSO, {}};
         }
 
-        next_load_addr = *tentative_next_load_addr;
-        modules.insert_or_assign(load_addr, module);
-        LOG_DEBUG(Loader, "loaded module {} @ 0x{:X}", module, load_addr);
+        const VAddr load_addr{next_load_addr};
+        next_load_addr = AppLoader_NSO::LoadModuleImage(
+            process, system, std::move(*module_images[i]), load_addr, pm);
+        modules.insert_or_assign(load_addr, module_names[i]);
+        LOG_DEBUG(Loader, "loaded module {} @ 0x{:X}", module_names[i], load_addr);
     }
 
     // Find the RomFS by searching for a ".romfs" file in this directory
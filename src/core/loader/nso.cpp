@@ -2,8 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstring>
+#include <limits>
+#include <thread>
 #include <vector>
 
 #include "common/common_funcs.h"
@@ -34,19 +38,84 @@ struct MODHeader {
 };
 static_assert(sizeof(MODHeader) == 0x1c, "MODHeader has incorrect size.");
 
-std::vector<u8> DecompressSegment(const std::vector<u8>& compressed_data,
-                                  const NSOSegmentHeader& header) {
-    std::vector<u8> uncompressed_data =
-        Common::Compression::DecompressDataLZ4(compressed_data, header.size);
+constexpr u32 PageAlignSize(u32 size) {
+    return static_cast<u32>((size + Core::Memory::PAGE_MASK) & ~Core::Memory::PAGE_MASK);
+}
+
+std::optional<NSOHeader> ReadHeader(const FileSys::VfsFile& nso_file) {
+    NSOHeader nso_header{};
+    if (nso_file.GetSize() < sizeof(NSOHeader) ||
+        sizeof(NSOHeader) != nso_file.ReadObject(&nso_header)) {
+        return std::nullopt;
+    }
+    if (nso_header.magic != Common::MakeMagic('N', 'S', 'O', '0')) {
+        return std::nullopt;
+    }
+    return nso_header;
+}
+
+struct ImageLayout {
+    u32 segments_end; ///< End of the segments read from the file, the arguments follow them.
+    u32 image_size;
+};
+
+/// Lays out the segments of an NSO in codeset, returns std::nullopt if the header is invalid.
+std::optional<ImageLayout> BuildCodeSet(const NSOHeader& nso_header, bool should_pass_arguments,
+                                        Kernel::CodeSet& codeset) {
+    // Segments are decompressed concurrently, they must not overlap
+    u64 segments_end = 0;
+    for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
+        const NSOSegmentHeader& segment = nso_header.segments[i];
+        if (segment.location < segments_end) {
+            LOG_ERROR(Loader, "Segment {} overlaps the previous segments", i);
+            return std::nullopt;
+        }
+        segments_end = u64{segment.location} + segment.size;
 
-    ASSERT_MSG(uncompressed_data.size() == header.size, "{} != {}", header.size,
-               uncompressed_data.size());
+        codeset.segments[i].addr = segment.location;
+        codeset.segments[i].offset = segment.location;
+        codeset.segments[i].size = segment.size;
+    }
+
+    u64 image_end = segments_end;
+    if (should_pass_arguments && !Settings::values.program_args.empty()) {
+        codeset.DataSegment().size += NSO_ARGUMENT_DATA_ALLOCATION_SIZE;
+        image_end += NSO_ARGUMENT_DATA_ALLOCATION_SIZE;
+    }
+    codeset.DataSegment().size += nso_header.segments[2].bss_size;
+    image_end += nso_header.segments[2].bss_size;
+
+    if (image_end > std::numeric_limits<u32>::max() - Core::Memory::PAGE_MASK) {
+        LOG_ERROR(Loader, "Program image is too large");
+        return std::nullopt;
+    }
 
-    return uncompressed_data;
+    for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
+        codeset.segments[i].size = PageAlignSize(codeset.segments[i].size);
+    }
+    return ImageLayout{
+        .segments_end = static_cast<u32>(segments_end),
+        .image_size = PageAlignSize(static_cast<u32>(image_end)),
+    };
 }
 
-constexpr u32 PageAlignSize(u32 size) {
-    return static_cast<u32>((size + Core::Memory::PAGE_MASK) & ~Core::Memory::PAGE_MASK);
+/// Reads a segment into its place in the program image, decompressing it if needed.
+bool ReadSegment(const FileSys::VfsFile& nso_file, const NSOHeader& nso_header,
+                 std::size_t segment_num, std::span<u8> image, std::vector<u8>& compressed) {
+    const NSOSegmentHeader& segment = nso_header.segments[segment_num];
+    const u32 compressed_size = nso_header.segments_compressed_size[segment_num];
+    const std::span<u8> destination = image.subspan(segment.location, segment.size);
+
+    if (!nso_header.IsSegmentCompressed(segment_num)) {
+        const std::size_t size = std::min<std::size_t>(compressed_size, destination.size());
+        return nso_file.Read(destination.data(), size, segment.offset) == size;
+    }
+
+    compressed.resize(compressed_size);
+    if (nso_file.Read(compressed.data(), compressed.size(), segment.offset) != compressed.size()) {
+        return false;
+    }
+    return Common::Compression::DecompressDataLZ4(compressed, destination);
 }
 } // Anonymous namespace
 
@@ -74,89 +143,132 @@ std::optional<VAddr> AppLoader_NSO::LoadModule(Kernel::KProcess& process, Core::
                                                const FileSys::VfsFile& nso_file, VAddr load_base,
                                                bool should_pass_arguments, bool load_into_process,
                                                std::optional<FileSys::PatchManager> pm) {
-    if (nso_file.GetSize() < sizeof(NSOHeader)) {
-        return std::nullopt;
-    }
-
-    NSOHeader nso_header{};
-    if (sizeof(NSOHeader) != nso_file.ReadObject(&nso_header)) {
-        return std::nullopt;
+    // Computing the process code layout only needs the header
+    if (!load_into_process) {
+        const auto nso_header = ReadHeader(nso_file);
+        if (!nso_header) {
+            return std::nullopt;
+        }
+        Kernel::CodeSet codeset;
+        const auto layout = BuildCodeSet(*nso_header, should_pass_arguments, codeset);
+        if (!layout) {
+            return std::nullopt;
+        }
+        return load_base + layout->image_size;
     }
 
-    if (nso_header.magic != Common::MakeMagic('N', 'S', 'O', '0')) {
+    const std::array sources{ModuleSource{&nso_file, should_pass_arguments}};
+    auto images = ReadModuleImages(sources);
+    if (!images[0]) {
         return std::nullopt;
     }
+    return LoadModuleImage(process, system, std::move(*images[0]), load_base, pm);
+}
 
-    // Build program image
-    Kernel::CodeSet codeset;
-    Kernel::PhysicalMemory program_image;
-    for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
-        std::vector<u8> data = nso_file.ReadBytes(nso_header.segments_compressed_size[i],
-                                                  nso_header.segments[i].offset);
-        if (nso_header.IsSegmentCompressed(i)) {
-            data = DecompressSegment(data, nso_header.segments[i]);
+std::vector<std::optional<NSOModuleImage>> AppLoader_NSO::ReadModuleImages(
+    std::span<const ModuleSource> sources) {
+    std::vector<std::optional<NSOModuleImage>> images(sources.size());
+
+    struct SegmentTask {
+        std::size_t module;
+        std::size_t segment;
+        u32 compressed_size;
+    };
+    std::vector<SegmentTask> tasks;
+
+    for (std::size_t module = 0; module < sources.size(); ++module) {
+        const auto nso_header = ReadHeader(*sources[module].file);
+        if (!nso_header) {
+            continue;
+        }
+        NSOModuleImage image;
+        image.name = sources[module].file->GetName();
+        image.header = *nso_header;
+        const bool should_pass_arguments = sources[module].should_pass_arguments;
+        const auto layout = BuildCodeSet(*nso_header, should_pass_arguments, image.codeset);
+        if (!layout) {
+            continue;
         }
-        program_image.resize(nso_header.segments[i].location + static_cast<u32>(data.size()));
-        std::memcpy(program_image.data() + nso_header.segments[i].location, data.data(),
-                    data.size());
-        codeset.segments[i].addr = nso_header.segments[i].location;
-        codeset.segments[i].offset = nso_header.segments[i].location;
-        codeset.segments[i].size = nso_header.segments[i].size;
-    }
 
-    if (should_pass_arguments && !Settings::values.program_args.empty()) {
-        const auto arg_data{Settings::values.program_args};
+        // Allocate the whole image up front, segments are decompressed into it
+        Kernel::PhysicalMemory& program_image = image.codeset.memory;
+        program_image.resize(layout->image_size);
+
+        if (should_pass_arguments && !Settings::values.program_args.empty()) {
+            const auto& arg_data = Settings::values.program_args;
+            const std::size_t arg_size = std::min<std::size_t>(
+                arg_data.size(), NSO_ARGUMENT_DATA_ALLOCATION_SIZE - sizeof(NSOArgumentHeader));
+            const NSOArgumentHeader args_header{
+                NSO_ARGUMENT_DATA_ALLOCATION_SIZE, static_cast<u32_le>(arg_size), {}};
+            u8* const args = program_image.data() + layout->segments_end;
+            std::memcpy(args, &args_header, sizeof(NSOArgumentHeader));
+            std::memcpy(args + sizeof(NSOArgumentHeader), arg_data.data(), arg_size);
+        }
 
-        codeset.DataSegment().size += NSO_ARGUMENT_DATA_ALLOCATION_SIZE;
-        NSOArgumentHeader args_header{
-            NSO_ARGUMENT_DATA_ALLOCATION_SIZE, static_cast<u32_le>(arg_data.size()), {}};
-        const auto end_offset = program_image.size();
-        program_image.resize(static_cast<u32>(program_image.size()) +
-                             NSO_ARGUMENT_DATA_ALLOCATION_SIZE);
-        std::memcpy(program_image.data() + end_offset, &args_header, sizeof(NSOArgumentHeader));
-        std::memcpy(program_image.data() + end_offset + sizeof(NSOArgumentHeader), arg_data.data(),
-                    arg_data.size());
+        for (std::size_t segment = 0; segment < nso_header->segments.size(); ++segment) {
+            tasks.push_back({module, segment, nso_header->segments_compressed_size[segment]});
+        }
+        images[module] = std::move(image);
     }
 
-    codeset.DataSegment().size += nso_header.segments[2].bss_size;
-    const u32 image_size{
-        PageAlignSize(static_cast<u32>(program_image.size()) + nso_header.segments[2].bss_size)};
-    program_image.resize(image_size);
+    // Start with the largest segments so the last ones to finish are short
+    std::sort(tasks.begin(), tasks.end(), [](const SegmentTask& lhs, const SegmentTask& rhs) {
+        return lhs.compressed_size > rhs.compressed_size;
+    });
+
+    std::vector<std::atomic_bool> failed(sources.size());
+    std::atomic_size_t next_task{0};
+    const auto worker = [&] {
+        std::vector<u8> compressed;
+        for (std::size_t index = next_task++; index < tasks.size(); index = next_task++) {
+            const SegmentTask& task = tasks[index];
+            NSOModuleImage& image = *images[task.module];
+            if (!ReadSegment(*sources[task.module].file, image.header, task.segment,
+                             image.codeset.memory, compressed)) {
+                failed[task.module] = true;
+            }
+        }
+    };
 
-    for (std::size_t i = 0; i < nso_header.segments.size(); ++i) {
-        codeset.segments[i].size = PageAlignSize(codeset.segments[i].size);
+    const std::size_t num_threads =
+        std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U), tasks.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < num_threads; ++i) {
+        threads.emplace_back(worker);
     }
-
-    // Apply patches if necessary
-    if (pm && (pm->HasNSOPatch(nso_header.build_id) || Settings::values.dump_nso)) {
-        std::vector<u8> pi_header;
-        pi_header.insert(pi_header.begin(), reinterpret_cast<u8*>(&nso_header),
-                         reinterpret_cast<u8*>(&nso_header) + sizeof(NSOHeader));
-        pi_header.insert(pi_header.begin() + sizeof(NSOHeader), program_image.data(),
-                         program_image.data() + program_image.size());
-
-        pi_header = pm->PatchNSO(pi_header, nso_file.GetName());
-
-        std::copy(pi_header.begin() + sizeof(NSOHeader), pi_header.end(), program_image.data());
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
     }
 
-    // If we aren't actually loading (i.e. just computing the process code layout), we are done
-    if (!load_into_process) {
-        return load_base + image_size;
+    for (std::size_t module = 0; module < sources.size(); ++module) {
+        if (failed[module]) {
+            LOG_ERROR(Loader, "Failed to read the segments of {}", images[module]->name);
+            images[module].reset();
+        }
     }
+    return images;
+}
+
+VAddr AppLoader_NSO::LoadModuleImage(Kernel::KProcess& process, Core::System& system,
+                                     NSOModuleImage image, VAddr load_base,
+                                     const std::optional<FileSys::PatchManager>& pm) {
+    const u32 image_size = static_cast<u32>(image.codeset.memory.size());
 
-    // Apply cheats if they exist and the program has a valid title ID
     if (pm) {
-        system.SetCurrentProcessBuildID(nso_header.build_id);
-        const auto cheats = pm->CreateCheatList(nso_header.build_id);
+        // Apply patches if necessary
+        pm->PatchNSOImage(image.codeset.memory, image.header, image.name);
+
+        // Apply cheats if they exist and the program has a valid title ID
+        system.SetCurrentProcessBuildID(image.header.build_id);
+        const auto cheats = pm->CreateCheatList(image.header.build_id);
         if (!cheats.empty()) {
-            system.RegisterCheatList(cheats, nso_header.build_id, load_base, image_size);
+            system.RegisterCheatList(cheats, image.header.build_id, load_base, image_size);
         }
     }
 
     // Load codeset for current process
-    codeset.memory = std::move(program_image);
-    process.LoadModule(std::move(codeset), load_base);
+    process.LoadModule(std::move(image.codeset), load_base);
 
     return load_base + image_size;
 }
@@ -6,10 +6,14 @@
 
 #include <array>
 #include <optional>
+#include <span>
+#include <string>
 #include <type_traits>
+#include <vector>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/file_sys/patch_manager.h"
+#include "core/hle/kernel/code_set.h"
 #include "core/loader/loader.h"
 
 namespace Core {
@@ -68,6 +72,13 @@ struct NSOArgumentHeader {
 };
 static_assert(sizeof(NSOArgumentHeader) == 0x20, "NSOArgumentHeader has incorrect size.");
 
+/// Program image of an NSO read by AppLoader_NSO::ReadModuleImages, not yet patched nor loaded.
+struct NSOModuleImage {
+    std::string name;
+    NSOHeader header{};
+    Kernel::CodeSet codeset;
+};
+
 /// Loads an NSO file
 class AppLoader_NSO final : public AppLoader {
 public:
@@ -91,6 +102,31 @@ public:
                                            bool should_pass_arguments, bool load_into_process,
                                            std::optional<FileSys::PatchManager> pm = {});
 
+    struct ModuleSource {
+        const FileSys::VfsFile* file;
+        bool should_pass_arguments;
+    };
+
+    /**
+     * Reads the program images of several NSOs, decompressing the segments of every module in
+     * parallel straight into their image.
+     *
+     * @param sources The modules to read.
+     *
+     * @return The image of each module, or std::nullopt for the modules that could not be read.
+     */
+    static std::vector<std::optional<NSOModuleImage>> ReadModuleImages(
+        std::span<const ModuleSource> sources);
+
+    /**
+     * Patches a program image read by ReadModuleImages and loads it into a process.
+     *
+     * @return The address following the loaded module.
+     */
+    static VAddr LoadModuleImage(Kernel::KProcess& process, Core::System& system,
+                                 NSOModuleImage image, VAddr load_base,
+                                 const std::optional<FileSys::PatchManager>& pm);
+
     LoadResult Load(Kernel::KProcess& process, Core::System& system) override;
 
     ResultStatus ReadNSOModules(Modules& out_modules) override;
@@ -330,6 +330,59 @@ struct Memory::Impl {
         }
     }
 
+    std::span<u8> GetWritableSpan(const VAddr vaddr, const std::size_t size) {
+        const auto& page_table = system.CurrentProcess()->PageTable().PageTableImpl();
+        std::size_t page_index = vaddr >> PAGE_BITS;
+
+        // Pages whose writes are tracked point at the write protected fastmem arena. Host system
+        // calls writing there fail instead of faulting, so these pages are handed out through
+        // their backing memory and the write is reported like for cached rasterizer memory.
+        const auto is_tracked = [&page_table](u8* pointer, Common::PageType type) {
+            return type == Common::PageType::Memory && pointer == page_table.fastmem_arena;
+        };
+
+        // Pages are contiguous on the host when they share the same base pointer (or backing
+        // address for cached rasterizer memory), as both are stored relative to the page address.
+        const auto [base_pointer, type] = page_table.pointers[page_index].PointerType();
+        const u64 base_backing = page_table.backing_addr[page_index];
+        const bool is_base_tracked = is_tracked(base_pointer, type);
+        const bool use_backing =
+            type == Common::PageType::RasterizerCachedMemory || is_base_tracked;
+        u8* host_ptr{};
+        switch (type) {
+        case Common::PageType::Memory:
+            DEBUG_ASSERT(base_pointer);
+            host_ptr = is_base_tracked ? GetPointerFromRasterizerCachedMemory(vaddr)
+                                       : base_pointer + vaddr;
+            break;
+        case Common::PageType::RasterizerCachedMemory:
+            host_ptr = GetPointerFromRasterizerCachedMemory(vaddr);
+            break;
+        default:
+            return {};
+        }
+
+        std::size_t span_size =
+            std::min(static_cast<std::size_t>(PAGE_SIZE - (vaddr & PAGE_MASK)), size);
+        while (span_size < size) {
+            ++page_index;
+            const auto [pointer, next_type] = page_table.pointers[page_index].PointerType();
+            if (next_type != type || is_tracked(pointer, next_type) != is_base_tracked) {
+                break;
+            }
+            if (use_backing ? page_table.backing_addr[page_index] != base_backing
+                            : pointer != base_pointer) {
+                break;
+            }
+            span_size += std::min(static_cast<std::size_t>(PAGE_SIZE), size - span_size);
+        }
+
+        if (use_backing) {
+            system.GPU().InvalidateRegion(vaddr, span_size);
+        }
+        return {host_ptr, span_size};
+    }
+
     void WriteBlockUnsafe(const Kernel::KProcess& process, const VAddr dest_addr,
                           const void* src_buffer, const std::size_t size) {
         const auto& page_table = process.PageTable().PageTableImpl();
@@ -543,6 +596,34 @@ struct Memory::Impl {
         }
     }
 
+    void RasterizerTrackRegionWrites(VAddr vaddr, u64 size, bool tracked) {
+        if (vaddr == 0) {
+            return;
+        }
+
+        auto& buffer = system.DeviceMemory().buffer;
+        if (tracked) {
+            buffer.TrackWrites(vaddr, size);
+        } else {
+            buffer.UntrackWrites(vaddr, size);
+        }
+
+        // Host accesses through the page table use the fastmem arena while the pages are tracked,
+        // so writes from HLE code are recorded as well.
+        const u64 num_pages = size >> PAGE_BITS;
+        for (u64 i = 0; i < num_pages; ++i, vaddr += PAGE_SIZE) {
+            auto& entry = current_page_table->pointers[vaddr >> PAGE_BITS];
+            if (entry.Type() != Common::PageType::Memory) {
+                continue;
+            }
+            if (tracked) {
+                entry.Store(current_page_table->fastmem_arena, Common::PageType::Memory);
+            } else if (u8* const pointer = GetPointerFromRasterizerCachedMemory(vaddr)) {
+                entry.Store(pointer - vaddr, Common::PageType::Memory);
+            }
+        }
+    }
+
     /**
      * Maps a region of pages as a specific type.
      *
@@ -888,6 +969,10 @@ void Memory::WriteBlock(const VAddr dest_addr, const void* src_buffer, const std
     impl->WriteBlock(dest_addr, src_buffer, size);
 }
 
+std::span<u8> Memory::GetWritableSpan(const VAddr vaddr, const std::size_t size) {
+    return impl->GetWritableSpan(vaddr, size);
+}
+
 void Memory::WriteBlockUnsafe(const Kernel::KProcess& process, VAddr dest_addr,
                               const void* src_buffer, std::size_t size) {
     impl->WriteBlockUnsafe(process, dest_addr, src_buffer, size);
@@ -919,6 +1004,24 @@ void Memory::RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached) {
     impl->RasterizerMarkRegionCached(vaddr, size, cached);
 }
 
+void Memory::RasterizerTrackRegionWrites(VAddr vaddr, u64 size, bool tracked) {
+    impl->RasterizerTrackRegionWrites(vaddr, size, tracked);
+}
+
+std::vector<std::pair<VAddr, u64>> Memory::RasterizerPopWrittenRegions() {
+    const auto ranges = system.DeviceMemory().buffer.PopWrittenRanges();
+    std::vector<std::pair<VAddr, u64>> regions;
+    regions.reserve(ranges.size());
+    for (const auto& [offset, size] : ranges) {
+        regions.emplace_back(static_cast<VAddr>(offset), static_cast<u64>(size));
+    }
+    return regions;
+}
+
+bool Memory::IsWriteTrackingSupported() const {
+    return system.DeviceMemory().buffer.IsWriteTrackingSupported();
+}
+
 bool IsKernelVirtualAddress(const VAddr vaddr) {
     return KERNEL_REGION_VADDR <= vaddr && vaddr < KERNEL_REGION_END;
 }
@@ -6,7 +6,10 @@
 
 #include <cstddef>
 #include <memory>
+#include <span>
 #include <string>
+#include <utility>
+#include <vector>
 #include "common/common_types.h"
 
 namespace Common {
@@ -449,6 +452,23 @@ public:
      */
     void WriteBlock(VAddr dest_addr, const void* src_buffer, std::size_t size);
 
+    /**
+     * Gets the host memory backing a range of the current process' address space, so data can
+     * be produced in place instead of being staged and copied with WriteBlock.
+     *
+     * @param vaddr The virtual address the span starts at.
+     * @param size  The maximum size of the span, in bytes.
+     *
+     * @returns The longest span starting at vaddr, up to size bytes, that is contiguous in host
+     *          memory. The span is shorter than size when the range crosses pages that are not
+     *          contiguous on the host, and empty when vaddr is not mapped.
+     *
+     * @post If the span covers cached rasterizer memory or pages whose writes are tracked, that
+     *       region is invalidated as if it had been written with WriteBlock. Tracked pages are
+     *       returned through their backing memory, so host system calls can write to the span.
+     */
+    std::span<u8> GetWritableSpan(VAddr vaddr, std::size_t size);
+
     /**
      * Writes a range of bytes into the current process' address space at the specified
      * virtual address.
@@ -528,6 +548,27 @@ public:
      */
     void RasterizerMarkRegionCached(VAddr vaddr, u64 size, bool cached);
 
+    /**
+     * Write protects or unprotects each page within the specified address range in the fastmem
+     * arena, recording the CPU writes to the protected pages. An alternative to
+     * RasterizerMarkRegionCached that leaves the pages on the fast path: reads are not
+     * intercepted and only the first write to a page after its writes are collected faults.
+     *
+     * @param vaddr   The virtual address indicating the start of the address range.
+     * @param size    The size of the address range in bytes, a multiple of the page size.
+     * @param tracked Whether writes to the pages within the address range should be tracked.
+     */
+    void RasterizerTrackRegionWrites(VAddr vaddr, u64 size, bool tracked);
+
+    /**
+     * Returns the regions written since the last call, as {address, size} pairs. Pages that are
+     * still tracked are write protected again.
+     */
+    std::vector<std::pair<VAddr, u64>> RasterizerPopWrittenRegions();
+
+    /// Returns whether RasterizerTrackRegionWrites can be used, which requires fastmem.
+    bool IsWriteTrackingSupported() const;
+
 private:
     Core::System& system;
 
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cstring>
 #include <limits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include "common/common_funcs.h"
@@ -20,6 +21,9 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 #else
 #error "Unimplemented platform"
 #endif
@@ -408,6 +412,138 @@ std::pair<s32, Errno> Poll(std::vector<PollFD>& pollfds, s32 timeout) {
     return {-1, GetAndLogLastError()};
 }
 
+#ifdef __linux__
+
+// Poll events are translated to poll(2) flags, make sure epoll understands them as they are
+static_assert(EPOLLIN == POLLIN && EPOLLPRI == POLLPRI && EPOLLOUT == POLLOUT &&
+              EPOLLERR == POLLERR && EPOLLHUP == POLLHUP);
+
+struct PollSet::Impl {
+    struct Registration {
+        u32 events{};
+        u32 revents{};
+        u64 generation{};
+    };
+
+    int epoll_fd = -1;
+    u64 generation = 0;
+    std::unordered_map<int, Registration> registered;
+    std::vector<epoll_event> ready_events;
+};
+
+PollSet::PollSet() : impl{std::make_unique<Impl>()} {
+    impl->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    ASSERT_MSG(impl->epoll_fd != -1, "epoll_create1 failed with errno={}", errno);
+}
+
+PollSet::~PollSet() {
+    (void)close(impl->epoll_fd);
+}
+
+std::pair<s32, Errno> PollSet::Poll(std::vector<PollFD>& pollfds, s32 timeout) {
+    const u64 generation = ++impl->generation;
+    auto& registered = impl->registered;
+
+    bool has_invalid = false;
+    for (PollFD& pollfd : pollfds) {
+        pollfd.revents = PollEvents{};
+
+        const int fd = pollfd.socket->fd;
+        u32 events = static_cast<u16>(TranslatePollEvents(pollfd.events));
+
+        const auto [it, inserted] = registered.try_emplace(fd);
+        Impl::Registration& registration = it->second;
+        if (!inserted && registration.generation == generation) {
+            // The same socket is listed more than once, listen for the union of the events
+            events |= registration.events;
+        }
+        if (inserted || registration.events != events) {
+            epoll_event event{};
+            event.events = events;
+            event.data.fd = fd;
+
+            int result = epoll_ctl(impl->epoll_fd, inserted ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd,
+                                   &event);
+            if (result == -1 && errno == ENOENT) {
+                // The descriptor was closed and reused without being removed from the set
+                result = epoll_ctl(impl->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+            }
+            if (result == -1) {
+                registered.erase(it);
+                pollfd.revents = PollEvents::Nval;
+                has_invalid = true;
+                continue;
+            }
+        }
+        registration.events = events;
+        registration.revents = 0;
+        registration.generation = generation;
+    }
+
+    // Sockets that are no longer polled have to leave the set, they would report errors otherwise
+    for (auto it = registered.begin(); it != registered.end();) {
+        if (it->second.generation == generation) {
+            ++it;
+            continue;
+        }
+        (void)epoll_ctl(impl->epoll_fd, EPOLL_CTL_DEL, it->first, nullptr);
+        it = registered.erase(it);
+    }
+
+    // Like poll, return immediately when there are invalid descriptors
+    impl->ready_events.resize(std::max<size_t>(registered.size(), 1));
+    const int result = epoll_wait(impl->epoll_fd, impl->ready_events.data(),
+                                  static_cast<int>(impl->ready_events.size()),
+                                  has_invalid ? 0 : timeout);
+    if (result == -1) {
+        return {-1, GetAndLogLastError()};
+    }
+
+    for (int i = 0; i < result; ++i) {
+        const epoll_event& event = impl->ready_events[i];
+        registered[event.data.fd].revents = event.events;
+    }
+
+    s32 num_ready = 0;
+    for (PollFD& pollfd : pollfds) {
+        if (pollfd.revents == PollEvents{}) {
+            const auto it = registered.find(pollfd.socket->fd);
+            if (it != registered.end()) {
+                pollfd.revents = TranslatePollRevents(static_cast<short>(it->second.revents));
+            }
+        }
+        if (pollfd.revents != PollEvents{}) {
+            ++num_ready;
+        }
+    }
+    return {num_ready, Errno::SUCCESS};
+}
+
+void PollSet::Remove(const Socket& socket) {
+    const auto it = impl->registered.find(socket.fd);
+    if (it == impl->registered.end()) {
+        return;
+    }
+    (void)epoll_ctl(impl->epoll_fd, EPOLL_CTL_DEL, socket.fd, nullptr);
+    impl->registered.erase(it);
+}
+
+#else
+
+struct PollSet::Impl {};
+
+PollSet::PollSet() = default;
+
+PollSet::~PollSet() = default;
+
+std::pair<s32, Errno> PollSet::Poll(std::vector<PollFD>& pollfds, s32 timeout) {
+    return Network::Poll(pollfds, timeout);
+}
+
+void PollSet::Remove(const Socket& socket) {}
+
+#endif
+
 Socket::~Socket() {
     if (fd == INVALID_SOCKET) {
         return;
@@ -570,7 +706,7 @@ std::pair<s32, Errno> Socket::SendTo(u32 flags, const std::vector<u8>& message,
     ASSERT(flags == 0);
 
     const sockaddr* to = nullptr;
-    const int tolen = addr ? 0 : sizeof(sockaddr);
+    const int tolen = addr ? sizeof(sockaddr) : 0;
     sockaddr host_addr_in;
 
     if (addr) {
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #if defined(_WIN32)
 #include <winsock.h>
@@ -91,4 +92,26 @@ public:
 
 std::pair<s32, Errno> Poll(std::vector<PollFD>& poll_fds, s32 timeout);
 
+/**
+ * Set of sockets that is polled repeatedly. The interest set persists across calls: on Linux it is
+ * kept in an epoll instance and only the sockets whose events changed since the previous call are
+ * updated, elsewhere it falls back to Poll. Sockets have to be removed before they are closed.
+ */
+class PollSet {
+public:
+    explicit PollSet();
+    ~PollSet();
+
+    PollSet(const PollSet&) = delete;
+    PollSet& operator=(const PollSet&) = delete;
+
+    std::pair<s32, Errno> Poll(std::vector<PollFD>& poll_fds, s32 timeout);
+
+    void Remove(const Socket& socket);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
 } // namespace Network
@@ -17,6 +17,7 @@
 #include "common/logging/log.h"
 #include "common/param_package.h"
 #include "common/settings_input.h"
+#include "core/frontend/input.h"
 #include "input_common/gcadapter/gc_adapter.h"
 
 namespace GCAdapter {
@@ -82,7 +83,9 @@ bool Adapter::IsPayloadCorrect(const AdapterPayload& adapter_payload, s32 payloa
 }
 
 void Adapter::UpdateControllers(const AdapterPayload& adapter_payload) {
+    bool changed = false;
     for (std::size_t port = 0; port < pads.size(); ++port) {
+        const GCController previous = pads[port];
         const std::size_t offset = 1 + (9 * port);
         const auto type = static_cast<ControllerTypes>(adapter_payload[offset] >> 4);
         UpdatePadType(port, type);
@@ -95,6 +98,14 @@ void Adapter::UpdateControllers(const AdapterPayload& adapter_payload) {
                 UpdateYuzuSettings(port);
             }
         }
+        changed = changed || pads[port].type != previous.type ||
+                  pads[port].buttons != previous.buttons ||
+                  pads[port].axis_values != previous.axis_values;
+    }
+    // The adapter is read continuously, only post the reads that changed a pad
+    if (changed) {
+        Input::NotifyStatusChanged<Input::ButtonDevice>();
+        Input::NotifyStatusChanged<Input::AnalogDevice>();
     }
 }
 
@@ -370,6 +381,8 @@ void Adapter::ResetDevices() {
     for (std::size_t i = 0; i < pads.size(); ++i) {
         ResetDevice(i);
     }
+    Input::NotifyStatusChanged<Input::ButtonDevice>();
+    Input::NotifyStatusChanged<Input::AnalogDevice>();
 }
 
 void Adapter::ResetDevice(std::size_t port) {
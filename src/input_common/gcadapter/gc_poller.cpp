@@ -27,6 +27,10 @@ public:
         return false;
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
 private:
     const u32 port;
     const s32 button;
@@ -54,6 +58,10 @@ public:
         return false;
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
 private:
     const u32 port;
     const u32 axis;
@@ -195,6 +203,10 @@ public:
         return {deadzone, range, 0.5f};
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
     bool GetAnalogDirectionStatus(Input::AnalogDirection direction) const override {
         const auto [x, y] = GetStatus();
         const float directional_deadzone = 0.5f;
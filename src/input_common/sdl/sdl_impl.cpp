@@ -21,6 +21,7 @@
 #include "common/logging/log.h"
 #include "common/math_util.h"
 #include "common/param_package.h"
+#include "common/scope_exit.h"
 #include "common/settings_input.h"
 #include "common/threadsafe_queue.h"
 #include "core/frontend/input.h"
@@ -78,13 +79,17 @@ public:
     }
 
     void SetButton(int button, bool value) {
-        std::lock_guard lock{mutex};
-        state.buttons.insert_or_assign(button, value);
+        {
+            std::lock_guard lock{mutex};
+            state.buttons.insert_or_assign(button, value);
+        }
+        Input::NotifyStatusChanged<Input::ButtonDevice>();
     }
 
     void SetMotion(SDL_ControllerSensorEvent event) {
         constexpr float gravity_constant = 9.80665f;
         std::lock_guard lock{mutex};
+        SCOPE_EXIT({ Input::NotifyStatusChanged<Input::MotionDevice>(); });
         u64 time_difference = event.timestamp - last_motion_update;
         last_motion_update = event.timestamp;
         switch (event.sensor) {
@@ -116,8 +121,13 @@ public:
     }
 
     void SetAxis(int axis, Sint16 value) {
-        std::lock_guard lock{mutex};
-        state.axes.insert_or_assign(axis, value);
+        {
+            std::lock_guard lock{mutex};
+            state.axes.insert_or_assign(axis, value);
+        }
+        // Axes can be bound to buttons as well as sticks
+        Input::NotifyStatusChanged<Input::ButtonDevice>();
+        Input::NotifyStatusChanged<Input::AnalogDevice>();
     }
 
     float GetAxis(int axis, float range) const {
@@ -169,8 +179,11 @@ public:
     }
 
     void SetHat(int hat, Uint8 direction) {
-        std::lock_guard lock{mutex};
-        state.hats.insert_or_assign(hat, direction);
+        {
+            std::lock_guard lock{mutex};
+            state.hats.insert_or_assign(hat, direction);
+        }
+        Input::NotifyStatusChanged<Input::ButtonDevice>();
     }
 
     bool GetHatDirection(int hat, Uint8 direction) const {
@@ -409,6 +422,10 @@ public:
         return joystick->GetButton(button);
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int button;
@@ -423,6 +440,10 @@ public:
         return joystick->GetHatDirection(hat, direction);
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int hat;
@@ -444,6 +465,10 @@ public:
         return axis_value < threshold;
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int axis;
@@ -485,6 +510,10 @@ public:
         return {deadzone, range, 0.5f};
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
     bool GetAnalogDirectionStatus(Input::AnalogDirection direction) const override {
         const auto [x, y] = GetStatus();
         const float directional_deadzone = 0.5f;
@@ -545,6 +574,10 @@ public:
         return joystick->GetMotion().GetMotion();
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
 };
@@ -10,6 +10,7 @@
 #include <boost/asio.hpp>
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "core/frontend/input.h"
 #include "input_common/udp/client.h"
 #include "input_common/udp/protocol.h"
 
@@ -300,6 +301,8 @@ void Client::OnPadData(Response::PadData data, std::size_t client) {
             UpdateYuzuSettings(client, data.info.id, accelerometer, gyroscope);
         }
     }
+    Input::NotifyStatusChanged<Input::MotionDevice>();
+    Input::NotifyStatusChanged<Input::TouchDevice>();
 }
 
 void Client::StartCommunication(std::size_t client, const std::string& host, u16 port) {
@@ -20,6 +20,10 @@ public:
         return client->GetPadState(ip, port, pad).motion_status;
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
 private:
     const std::string ip;
     const u16 port;
@@ -82,6 +86,10 @@ public:
         return client->GetTouchState();
     }
 
+    bool IsPolled() const override {
+        return false;
+    }
+
 private:
     const std::string ip;
     [[maybe_unused]] const u16 port;
@@ -0,0 +1,95 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <unordered_map>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "common/flat_hash_map.h"
+
+namespace Common {
+
+TEST_CASE("FlatHashMap: Insert and find", "[common]") {
+    FlatHashMap<u64, int> map;
+    REQUIRE(map.empty());
+    REQUIRE(map.find(0) == map.end());
+
+    const auto [it, is_new] = map.try_emplace(0x1000, 1);
+    REQUIRE(is_new);
+    REQUIRE(it->first == 0x1000);
+    REQUIRE(it->second == 1);
+
+    const auto [other_it, other_is_new] = map.try_emplace(0x1000, 2);
+    REQUIRE(!other_is_new);
+    REQUIRE(other_it == it);
+    REQUIRE(other_it->second == 1);
+
+    map[0x2000] = 3;
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.find(0x2000)->second == 3);
+    REQUIRE(map.contains(0x1000));
+    REQUIRE(!map.contains(0x3000));
+}
+
+TEST_CASE("FlatHashMap: Aligned keys", "[common]") {
+    // Keys that only differ in their high bits must not end up in the same probe sequence
+    FlatHashMap<u64, u64> map;
+    for (u64 i = 0; i < 0x1000; ++i) {
+        map[i << 20] = i;
+    }
+    REQUIRE(map.size() == 0x1000);
+    for (u64 i = 0; i < 0x1000; ++i) {
+        const auto it = map.find(i << 20);
+        REQUIRE(it != map.end());
+        REQUIRE(it->second == i);
+    }
+}
+
+TEST_CASE("FlatHashMap: Erase while iterating", "[common]") {
+    FlatHashMap<u32, u32> map;
+    for (u32 i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    auto it = map.begin();
+    while (it != map.end()) {
+        if (it->second % 3 == 0) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    REQUIRE(map.size() == 666);
+    for (u32 i = 0; i < 1000; ++i) {
+        REQUIRE(map.contains(i) == (i % 3 != 0));
+    }
+}
+
+TEST_CASE("FlatHashMap: Matches unordered_map", "[common]") {
+    FlatHashMap<u32, u32> map;
+    std::unordered_map<u32, u32> reference;
+    std::mt19937 rng{1234};
+    for (int i = 0; i < 100000; ++i) {
+        // Small key range to exercise collisions and erasure inside probe sequences
+        const u32 key = static_cast<u32>(rng() % 512);
+        if (rng() % 3 == 0) {
+            REQUIRE(map.erase(key) == reference.erase(key));
+        } else {
+            map[key] = static_cast<u32>(i);
+            reference[key] = static_cast<u32>(i);
+        }
+    }
+    REQUIRE(map.size() == reference.size());
+    for (const auto& [key, value] : reference) {
+        const auto it = map.find(key);
+        REQUIRE(it != map.end());
+        REQUIRE(it->second == value);
+    }
+    size_t count = 0;
+    for ([[maybe_unused]] const auto& element : map) {
+        ++count;
+    }
+    REQUIRE(count == reference.size());
+}
+
+} // namespace Common
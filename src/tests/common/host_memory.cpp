@@ -2,10 +2,19 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#ifndef _WIN32
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#endif
+
 #include <catch2/catch.hpp>
 
 #include "common/host_memory.h"
 #include "common/literals.h"
+#include "common/scope_exit.h"
 
 using Common::HostMemory;
 using namespace Common::Literals;
@@ -183,3 +192,137 @@ TEST_CASE("HostMemory: Partial sparse middle unmap and check bindings", "[common
     REQUIRE(ptr[0x0000] == 19);
     REQUIRE(ptr[0x3fff] == 12);
 }
+
+TEST_CASE("HostMemory: Track writes", "[common]") {
+    HostMemory mem(BACKING_SIZE, VIRTUAL_SIZE);
+    if (!mem.IsWriteTrackingSupported()) {
+        return;
+    }
+    mem.Map(0x4000, 0x10000, 0x4000);
+
+    volatile u8* const ptr = mem.VirtualBasePointer() + 0x4000;
+    ptr[0x1000] = 1;
+
+    mem.TrackWrites(0x5000, 0x2000);
+    REQUIRE(mem.PopWrittenRanges().empty());
+
+    // Reads and writes outside of the range are not recorded
+    REQUIRE(ptr[0x1000] == 1);
+    ptr[0x0000] = 2;
+    ptr[0x3000] = 3;
+    REQUIRE(mem.PopWrittenRanges().empty());
+
+    ptr[0x1010] = 4;
+    ptr[0x1020] = 5;
+    REQUIRE(ptr[0x1010] == 4);
+    REQUIRE(ptr[0x1020] == 5);
+
+    const auto ranges = mem.PopWrittenRanges();
+    REQUIRE(ranges.size() == 1);
+    REQUIRE(ranges[0].first == 0x5000);
+    REQUIRE(ranges[0].second == 0x1000);
+    REQUIRE(mem.PopWrittenRanges().empty());
+}
+
+TEST_CASE("HostMemory: Track writes again after popping them", "[common]") {
+    HostMemory mem(BACKING_SIZE, VIRTUAL_SIZE);
+    if (!mem.IsWriteTrackingSupported()) {
+        return;
+    }
+    mem.Map(0x4000, 0x10000, 0x4000);
+    mem.TrackWrites(0x4000, 0x4000);
+
+    volatile u8* const ptr = mem.VirtualBasePointer() + 0x4000;
+    ptr[0x0000] = 1;
+    ptr[0x1000] = 2;
+    ptr[0x3000] = 3;
+
+    auto ranges = mem.PopWrittenRanges();
+    REQUIRE(ranges.size() == 2);
+    REQUIRE(ranges[0] == std::pair<size_t, size_t>{0x4000, 0x2000});
+    REQUIRE(ranges[1] == std::pair<size_t, size_t>{0x7000, 0x1000});
+
+    ptr[0x3004] = 4;
+    ranges = mem.PopWrittenRanges();
+    REQUIRE(ranges.size() == 1);
+    REQUIRE(ranges[0] == std::pair<size_t, size_t>{0x7000, 0x1000});
+    REQUIRE(ptr[0x3000] == 3);
+    REQUIRE(ptr[0x3004] == 4);
+}
+
+TEST_CASE("HostMemory: Untrack writes", "[common]") {
+    HostMemory mem(BACKING_SIZE, VIRTUAL_SIZE);
+    if (!mem.IsWriteTrackingSupported()) {
+        return;
+    }
+    mem.Map(0x4000, 0x10000, 0x4000);
+    mem.TrackWrites(0x4000, 0x4000);
+    mem.UntrackWrites(0x5000, 0x1000);
+
+    volatile u8* const ptr = mem.VirtualBasePointer() + 0x4000;
+    ptr[0x1000] = 1;
+    REQUIRE(mem.PopWrittenRanges().empty());
+
+    // A written page that is no longer tracked is reported once and left writable
+    ptr[0x2000] = 2;
+    mem.UntrackWrites(0x6000, 0x1000);
+    REQUIRE(mem.PopWrittenRanges().size() == 1);
+    ptr[0x2000] = 3;
+    REQUIRE(mem.PopWrittenRanges().empty());
+    REQUIRE(ptr[0x2000] == 3);
+}
+
+TEST_CASE("HostMemory: Track writes to mirrors", "[common]") {
+    HostMemory mem(BACKING_SIZE, VIRTUAL_SIZE);
+    if (!mem.IsWriteTrackingSupported()) {
+        return;
+    }
+    mem.Map(0x5000, 0x3000, 0x1000);
+    mem.Map(0x8000, 0x3000, 0x1000);
+    mem.TrackWrites(0x5000, 0x1000);
+
+    volatile u8* const mirror_a = mem.VirtualBasePointer() + 0x5000;
+    volatile u8* const mirror_b = mem.VirtualBasePointer() + 0x8000;
+
+    // Tracking is per virtual page, writes through an untracked mirror are not recorded
+    mirror_b[0] = 76;
+    REQUIRE(mem.PopWrittenRanges().empty());
+    REQUIRE(mirror_a[0] == 76);
+
+    mirror_a[1] = 77;
+    const auto ranges = mem.PopWrittenRanges();
+    REQUIRE(ranges.size() == 1);
+    REQUIRE(ranges[0].first == 0x5000);
+    REQUIRE(mirror_b[1] == 77);
+}
+
+#ifndef _WIN32
+TEST_CASE("HostMemory: Read from a file into a tracked page", "[common]") {
+    HostMemory mem(BACKING_SIZE, VIRTUAL_SIZE);
+    if (!mem.IsWriteTrackingSupported()) {
+        return;
+    }
+    mem.Map(0x4000, 0x10000, 0x1000);
+    mem.TrackWrites(0x4000, 0x1000);
+
+    std::FILE* const file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    SCOPE_EXIT({ std::fclose(file); });
+    const int fd = fileno(file);
+    const std::array<u8, 4> data{1, 2, 3, 4};
+    REQUIRE(pwrite(fd, data.data(), data.size(), 0) == static_cast<ssize_t>(data.size()));
+
+    // The host kernel does not fault on a write protected page, the read fails instead
+    u8* const view = mem.VirtualBasePointer() + 0x4000;
+    errno = 0;
+    REQUIRE(pread(fd, view, data.size(), 0) == -1);
+    REQUIRE(errno == EFAULT);
+    REQUIRE(view[0] == 0);
+
+    // Reading into the backing memory works, it is seen through the view and is not recorded
+    u8* const backing = mem.BackingBasePointer() + 0x10000;
+    REQUIRE(pread(fd, backing, data.size(), 0) == static_cast<ssize_t>(data.size()));
+    REQUIRE(std::memcmp(view, data.data(), data.size()) == 0);
+    REQUIRE(mem.PopWrittenRanges().empty());
+}
+#endif
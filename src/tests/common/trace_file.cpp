@@ -0,0 +1,66 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <filesystem>
+#include <string>
+#include <variant>
+#include <catch2/catch.hpp>
+#include "common/logging/trace_file.h"
+
+namespace Common::Log::Trace {
+
+TEST_CASE("TraceFile: Events are read back with their arguments", "[common]") {
+    const auto path = std::filesystem::temp_directory_path() / "yuzu_test_trace.ylog";
+    {
+        TraceWriter writer{path, TraceWriter::CHUNK_SIZE * 2};
+        REQUIRE(writer.IsOpen());
+        writer.Write(Entry{
+            .timestamp = std::chrono::nanoseconds{100},
+            .thread_id = 1,
+            .log_class = Class::Service,
+            .log_level = Level::Info,
+            .filename = "service.cpp",
+            .line_num = 42,
+            .function = "InvokeRequest",
+            .message = "message",
+        });
+        writer.WriteEvent(Event{
+            .timestamp = std::chrono::nanoseconds{200},
+            .duration = std::chrono::nanoseconds{50},
+            .thread_id = 2,
+            .type = EventType::Complete,
+            .category = Class::Kernel_SVC,
+            .name = "SendSyncRequest",
+            .args = {{"id", u64{0x21}}, {"delta", s64{-3}}, {"ratio", 0.5}, {"port", "fsp-srv"}},
+        });
+    }
+
+    const auto trace = ReadTraceFile(path);
+    std::filesystem::remove(path);
+    REQUIRE(trace);
+    REQUIRE(trace->entries.size() == 2);
+
+    const TraceEntry& entry = trace->entries[0];
+    REQUIRE(entry.type == RecordType::Message);
+    REQUIRE(entry.filename == "service.cpp");
+    REQUIRE(entry.function == "InvokeRequest");
+    REQUIRE(entry.message == "message");
+
+    const TraceEntry& event = trace->entries[1];
+    REQUIRE(event.type == RecordType::CompleteEvent);
+    REQUIRE(event.timestamp.count() == 200);
+    REQUIRE(event.duration.count() == 50);
+    REQUIRE(event.thread_id == 2);
+    REQUIRE(event.log_class == Class::Kernel_SVC);
+    REQUIRE(event.function == "SendSyncRequest");
+    REQUIRE(event.args.size() == 4);
+    REQUIRE(event.args[0].name == "id");
+    REQUIRE(std::get<u64>(event.args[0].value) == 0x21);
+    REQUIRE(std::get<s64>(event.args[1].value) == -3);
+    REQUIRE(std::get<double>(event.args[2].value) == 0.5);
+    REQUIRE(event.args[3].name == "port");
+    REQUIRE(std::get<std::string>(event.args[3].value) == "fsp-srv");
+}
+
+} // namespace Common::Log::Trace
@@ -0,0 +1,95 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <map>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "core/file_sys/vfs_concat.h"
+#include "core/file_sys/vfs_offset.h"
+#include "core/file_sys/vfs_vector.h"
+
+using namespace FileSys;
+
+namespace {
+// Counts the reads forwarded to the file
+class CountingVfsFile final : public VectorVfsFile {
+public:
+    using VectorVfsFile::VectorVfsFile;
+
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override {
+        ++num_reads;
+        return VectorVfsFile::Read(data, length, offset);
+    }
+
+    mutable std::size_t num_reads = 0;
+};
+
+std::shared_ptr<CountingVfsFile> MakeBaseFile(std::size_t size) {
+    // Nonzero everywhere, so fills read over from the base file would show up
+    std::vector<u8> data(size);
+    std::iota(data.begin(), data.end(), u8{1});
+    for (u8& value : data) {
+        value |= 0x80;
+    }
+    return std::make_shared<CountingVfsFile>(std::move(data));
+}
+
+VirtualFile Window(const VirtualFile& base, std::size_t size, std::size_t offset) {
+    return std::make_shared<OffsetVfsFile>(base, size, offset);
+}
+} // Anonymous namespace
+
+TEST_CASE("ConcatenatedVfsFile: Windows separated by fills are read at once", "[core]") {
+    const auto base = MakeBaseFile(0x40);
+
+    // Files aligned to 0x10 like in a RomFS image, the padding between them is filled with zeroes
+    std::multimap<u64, VirtualFile> files;
+    files.emplace(0x00, Window(base, 5, 0x00));
+    files.emplace(0x10, Window(base, 7, 0x10));
+    files.emplace(0x20, Window(base, 3, 0x20));
+    const auto concat = ConcatenatedVfsFile::MakeConcatenatedFile(0, std::move(files), "concat");
+    REQUIRE(concat->GetSize() == 0x23);
+
+    std::vector<u8> expected(0x23, 0);
+    base->Read(expected.data() + 0x00, 5, 0x00);
+    base->Read(expected.data() + 0x10, 7, 0x10);
+    base->Read(expected.data() + 0x20, 3, 0x20);
+
+    base->num_reads = 0;
+    std::vector<u8> data(0x23);
+    REQUIRE(concat->Read(data.data(), data.size(), 0) == data.size());
+    REQUIRE(data == expected);
+    REQUIRE(base->num_reads == 1);
+
+    // Reads starting and ending inside fills
+    base->num_reads = 0;
+    std::vector<u8> middle(0x14);
+    REQUIRE(concat->Read(middle.data(), middle.size(), 0x08) == middle.size());
+    REQUIRE(std::equal(middle.begin(), middle.end(), expected.begin() + 0x08));
+    REQUIRE(base->num_reads == 1);
+}
+
+TEST_CASE("ConcatenatedVfsFile: Windows not contiguous in the base file are read apart", "[core]") {
+    const auto base = MakeBaseFile(0x40);
+
+    // The second window does not start where the fill after the first one ends in the base file
+    std::multimap<u64, VirtualFile> files;
+    files.emplace(0x00, Window(base, 5, 0x00));
+    files.emplace(0x10, Window(base, 7, 0x18));
+    const auto concat = ConcatenatedVfsFile::MakeConcatenatedFile(0, std::move(files), "concat");
+
+    std::vector<u8> expected(0x17, 0);
+    base->Read(expected.data() + 0x00, 5, 0x00);
+    base->Read(expected.data() + 0x10, 7, 0x18);
+
+    base->num_reads = 0;
+    std::vector<u8> data(0x17);
+    REQUIRE(concat->Read(data.data(), data.size(), 0) == data.size());
+    REQUIRE(data == expected);
+    REQUIRE(base->num_reads == 2);
+}
@@ -0,0 +1,135 @@
+// Copyright 2021 yuzu Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <mbedtls/sha256.h>
+
+#include "core/file_sys/vfs_hash_tree.h"
+#include "core/file_sys/vfs_vector.h"
+
+using namespace FileSys;
+
+namespace {
+constexpr u64 DATA_SIZE = 100000;
+constexpr u64 DATA_BLOCK_SIZE = 0x1000;
+constexpr u64 HASH_BLOCK_SIZE = 0x100;
+constexpr u64 TOP_BLOCK_SIZE = 0x1000;
+
+constexpr u64 TOP_OFFSET = 0;
+constexpr u64 HASH_OFFSET = 0x1000;
+constexpr u64 DATA_OFFSET = 0x2000;
+
+Core::Crypto::SHA256Hash HashBlock(const std::vector<u8>& data, u64 offset, u64 size,
+                                   u64 block_size) {
+    std::vector<u8> block(block_size);
+    std::memcpy(block.data(), data.data() + offset, size);
+    Core::Crypto::SHA256Hash hash;
+    mbedtls_sha256_ret(block.data(), block.size(), hash.data(), 0);
+    return hash;
+}
+
+// Hashes every block of data, padding the last one with zeroes.
+std::vector<u8> HashLevel(const std::vector<u8>& data, u64 block_size) {
+    std::vector<u8> hashes;
+    for (u64 offset = 0; offset < data.size(); offset += block_size) {
+        const auto hash = HashBlock(data, offset, std::min(block_size, data.size() - offset),
+                                    block_size);
+        hashes.insert(hashes.end(), hash.begin(), hash.end());
+    }
+    return hashes;
+}
+
+struct TestTree {
+    std::vector<u8> data;
+    std::vector<u8> image;
+    HashTreeLayout layout;
+};
+
+// Builds a three level tree: the top hashes, the hashes of the data blocks and the data itself.
+TestTree MakeTree() {
+    TestTree tree;
+    std::mt19937 rng{1234};
+    tree.data.resize(DATA_SIZE);
+    for (u8& value : tree.data) {
+        value = static_cast<u8>(rng());
+    }
+
+    const std::vector<u8> data_hashes = HashLevel(tree.data, DATA_BLOCK_SIZE);
+    const std::vector<u8> top_hashes = HashLevel(data_hashes, HASH_BLOCK_SIZE);
+
+    tree.image.resize(DATA_OFFSET + DATA_SIZE);
+    std::memcpy(tree.image.data() + TOP_OFFSET, top_hashes.data(), top_hashes.size());
+    std::memcpy(tree.image.data() + HASH_OFFSET, data_hashes.data(), data_hashes.size());
+    std::memcpy(tree.image.data() + DATA_OFFSET, tree.data.data(), tree.data.size());
+
+    tree.layout = HashTreeLayout{
+        .master_hashes = {HashBlock(top_hashes, 0, top_hashes.size(), TOP_BLOCK_SIZE)},
+        .levels =
+            {
+                {TOP_OFFSET, top_hashes.size(), TOP_BLOCK_SIZE},
+                {HASH_OFFSET, data_hashes.size(), HASH_BLOCK_SIZE},
+                {DATA_OFFSET, DATA_SIZE, DATA_BLOCK_SIZE},
+            },
+        .pad_blocks = true,
+    };
+    return tree;
+}
+
+std::shared_ptr<HashTreeVfsFile> MakeFile(const TestTree& tree) {
+    return std::make_shared<HashTreeVfsFile>(std::make_shared<VectorVfsFile>(tree.image),
+                                             tree.layout, "test");
+}
+} // Anonymous namespace
+
+TEST_CASE("HashTreeVfsFile: Valid tree", "[core]") {
+    const TestTree tree = MakeTree();
+    const auto file = MakeFile(tree);
+    REQUIRE(file->GetSize() == DATA_SIZE);
+
+    // Unaligned reads crossing blocks, read twice to go through verified blocks
+    for (int pass = 0; pass < 2; ++pass) {
+        for (u64 offset = 0; offset < DATA_SIZE; offset += 0x1234) {
+            std::vector<u8> buffer(0x2345);
+            const std::size_t read = file->Read(buffer.data(), buffer.size(), offset);
+            REQUIRE(read == std::min<u64>(buffer.size(), DATA_SIZE - offset));
+            REQUIRE(std::memcmp(buffer.data(), tree.data.data() + offset, read) == 0);
+        }
+    }
+
+    REQUIRE(MakeFile(tree)->VerifyAll(4));
+    REQUIRE(MakeFile(tree)->ReadAllBytes() == tree.data);
+}
+
+TEST_CASE("HashTreeVfsFile: Corrupt data", "[core]") {
+    TestTree tree = MakeTree();
+    constexpr u64 corrupt_block = 5;
+    tree.image[DATA_OFFSET + corrupt_block * DATA_BLOCK_SIZE + 17] ^= 1;
+
+    const auto file = MakeFile(tree);
+    std::vector<u8> buffer(DATA_SIZE);
+    REQUIRE(file->Read(buffer.data(), buffer.size(), 0) == corrupt_block * DATA_BLOCK_SIZE);
+    REQUIRE(file->Read(buffer.data(), 0x10, corrupt_block * DATA_BLOCK_SIZE + 0x20) == 0);
+    REQUIRE(file->Read(buffer.data(), 0x10, (corrupt_block + 1) * DATA_BLOCK_SIZE) == 0x10);
+
+    REQUIRE(!MakeFile(tree)->VerifyAll(4));
+}
+
+TEST_CASE("HashTreeVfsFile: Corrupt hashes", "[core]") {
+    TestTree tree = MakeTree();
+    // Damages the hashes of the first eight data blocks
+    tree.image[HASH_OFFSET + 3] ^= 1;
+
+    const auto file = MakeFile(tree);
+    std::vector<u8> buffer(0x10);
+    REQUIRE(file->Read(buffer.data(), buffer.size(), 0) == 0);
+    REQUIRE(file->Read(buffer.data(), buffer.size(), 7 * DATA_BLOCK_SIZE) == 0);
+    REQUIRE(file->Read(buffer.data(), buffer.size(), 8 * DATA_BLOCK_SIZE) == buffer.size());
+
+    REQUIRE(!MakeFile(tree)->VerifyAll(1));
+}
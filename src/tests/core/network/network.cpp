@@ -26,3 +26,50 @@ TEST_CASE("Network::Errors", "[core]") {
     std::vector<u8> message{1, 2, 3, 4};
     REQUIRE(socks[1].Recv(0, message).second == Network::Errno::NOTCONN);
 }
+
+TEST_CASE("Network::PollSet", "[core]") {
+    Network::NetworkInstance network_instance; // initialize network
+
+    Network::Socket receiver;
+    Network::Socket sender;
+    for (Network::Socket* sock : {&receiver, &sender}) {
+        REQUIRE(sock->Initialize(Network::Domain::INET, Network::Type::DGRAM,
+                                 Network::Protocol::UDP) == Network::Errno::SUCCESS);
+    }
+
+    const Network::SockAddrIn any_port{Network::Domain::INET, {127, 0, 0, 1}, 0};
+    REQUIRE(receiver.Bind(any_port) == Network::Errno::SUCCESS);
+    const auto [receiver_addr, sockname_errno] = receiver.GetSockName();
+    REQUIRE(sockname_errno == Network::Errno::SUCCESS);
+
+    Network::PollSet poll_set;
+    std::vector<Network::PollFD> pollfds{
+        {&receiver, Network::PollEvents::In, Network::PollEvents{}},
+    };
+
+    // Nothing has been sent yet
+    REQUIRE(poll_set.Poll(pollfds, 0) == std::make_pair(0, Network::Errno::SUCCESS));
+    REQUIRE(pollfds[0].revents == Network::PollEvents{});
+
+    const std::vector<u8> message{1, 2, 3, 4};
+    REQUIRE(sender.SendTo(0, message, &receiver_addr).first == 4);
+
+    // The registration from the previous call is reused
+    REQUIRE(poll_set.Poll(pollfds, 1000) == std::make_pair(1, Network::Errno::SUCCESS));
+    REQUIRE(True(pollfds[0].revents & Network::PollEvents::In));
+
+    // Changing the interest set takes effect on the next call
+    pollfds.push_back({&sender, Network::PollEvents::Out, Network::PollEvents{}});
+    REQUIRE(poll_set.Poll(pollfds, 1000) == std::make_pair(2, Network::Errno::SUCCESS));
+    REQUIRE(True(pollfds[1].revents & Network::PollEvents::Out));
+
+    std::vector<u8> received(message.size());
+    REQUIRE(receiver.Recv(0, received).first == 4);
+    REQUIRE(received == message);
+
+    pollfds.pop_back();
+    REQUIRE(poll_set.Poll(pollfds, 0) == std::make_pair(0, Network::Errno::SUCCESS));
+
+    poll_set.Remove(receiver);
+    poll_set.Remove(sender);
+}
@@ -2,8 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <random>
 #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
 #include <catch2/catch.hpp>
 
@@ -547,3 +551,186 @@ TEST_CASE("BufferBase: Cached write downloads") {
     buffer.MarkRegionAsCpuModified(c, WORD);
     REQUIRE(rasterizer.Count() == 0);
 }
+
+namespace {
+/// Page granular model of the state tracked by BufferBase
+struct PageModel {
+    explicit PageModel(u64 num_pages)
+        : cpu(num_pages, true), gpu(num_pages), cached(num_pages), untracked(num_pages, true) {}
+
+    void Mark(std::vector<bool>& state, u64 begin, u64 end, bool value, bool track) {
+        for (u64 page = begin; page < end; ++page) {
+            state[page] = value;
+            if (track) {
+                untracked[page] = value;
+            }
+        }
+    }
+
+    void FlushCachedWrites() {
+        for (size_t page = 0; page < cached.size(); ++page) {
+            if (cached[page]) {
+                cpu[page] = true;
+                untracked[page] = true;
+                cached[page] = false;
+            }
+        }
+    }
+
+    std::vector<Range> ForEachModifiedRange(bool is_gpu, u64 begin, u64 end) {
+        // Only the pages between the first and the last modified pages of the words overlapping
+        // the range are unmarked
+        const std::vector<bool>& state = is_gpu ? gpu : cpu;
+        const u64 first_page = begin - begin % 64;
+        const u64 last_page = std::min<u64>((end + 63) / 64 * 64, state.size());
+        const auto first = std::find(state.begin() + first_page, state.begin() + last_page, true);
+        const auto last = std::find(state.rbegin() + (state.size() - last_page),
+                                    state.rbegin() + (state.size() - first_page), true);
+        begin = std::max<u64>(begin, first - state.begin());
+        end = std::min<u64>(end, state.rend() - last);
+        std::vector<Range> ranges;
+        for (u64 page = begin; page < end; ++page) {
+            const bool is_modified = is_gpu ? gpu[page] && !untracked[page] : cpu[page];
+            if (is_gpu) {
+                gpu[page] = false;
+            } else {
+                cpu[page] = false;
+                untracked[page] = false;
+            }
+            if (!is_modified) {
+                continue;
+            }
+            if (!ranges.empty() && ranges.back().first + ranges.back().second == page * PAGE) {
+                ranges.back().second += PAGE;
+            } else {
+                ranges.emplace_back(page * PAGE, PAGE);
+            }
+        }
+        return ranges;
+    }
+
+    std::vector<bool> cpu;
+    std::vector<bool> gpu;
+    std::vector<bool> cached;
+    std::vector<bool> untracked;
+};
+
+void RunModelOperations(u64 size_bytes, unsigned seed) {
+    RasterizerInterface rasterizer;
+    BufferBase buffer(rasterizer, c, size_bytes);
+    const u64 num_pages = size_bytes / PAGE;
+    PageModel model(num_pages);
+
+    std::mt19937 rng{seed};
+    const auto random_range = [&] {
+        // Mix single pages, ranges within a word and ranges spanning many words
+        const u64 max_pages = std::array<u64, 3>{1, 64, num_pages}[rng() % 3];
+        const u64 begin = rng() % num_pages;
+        const u64 end = std::min(begin + 1 + rng() % max_pages, num_pages);
+        return Range{begin, end};
+    };
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        const auto [begin, end] = random_range();
+        const VAddr addr = c + begin * PAGE;
+        const u64 size = (end - begin) * PAGE;
+        switch (rng() % 8) {
+        case 0:
+            buffer.MarkRegionAsCpuModified(addr, size);
+            model.Mark(model.cpu, begin, end, true, true);
+            break;
+        case 1:
+            buffer.UnmarkRegionAsCpuModified(addr, size);
+            model.Mark(model.cpu, begin, end, false, true);
+            break;
+        case 2:
+            buffer.MarkRegionAsGpuModified(addr, size);
+            model.Mark(model.gpu, begin, end, true, false);
+            break;
+        case 3:
+            buffer.UnmarkRegionAsGpuModified(addr, size);
+            model.Mark(model.gpu, begin, end, false, false);
+            break;
+        case 4:
+            buffer.CachedCpuWrite(addr, size);
+            model.Mark(model.cached, begin, end, true, true);
+            break;
+        case 5:
+            buffer.FlushCachedWrites();
+            model.FlushCachedWrites();
+            break;
+        case 6:
+        case 7: {
+            const bool is_gpu = rng() % 2 == 0;
+            std::vector<Range> ranges;
+            const auto func = [&](u64 offset, u64 range_size) {
+                ranges.emplace_back(offset, range_size);
+            };
+            if (is_gpu) {
+                buffer.ForEachDownloadRange(addr, size, func);
+            } else {
+                buffer.ForEachUploadRange(addr, size, func);
+            }
+            REQUIRE(ranges == model.ForEachModifiedRange(is_gpu, begin, end));
+            break;
+        }
+        }
+        // Compare the whole buffer from time to time, otherwise the pages around the range
+        const bool full_check = iteration % 64 == 0;
+        const u64 check_begin = full_check ? 0 : (begin > 0 ? begin - 1 : 0);
+        const u64 check_end = full_check ? num_pages : std::min(end + 1, num_pages);
+        for (u64 page = check_begin; page < check_end; ++page) {
+            const VAddr page_addr = c + page * PAGE;
+            INFO("Iteration " << iteration << " page " << page);
+            REQUIRE(buffer.IsRegionCpuModified(page_addr, 1) == model.cpu[page]);
+            REQUIRE(buffer.IsRegionGpuModified(page_addr, 1) ==
+                    (model.gpu[page] && !model.untracked[page]));
+            REQUIRE(rasterizer.Count(page_addr) == (model.untracked[page] ? 0 : 1));
+        }
+        const bool any_cpu = std::find(model.cpu.begin(), model.cpu.end(), true) != model.cpu.end();
+        REQUIRE(buffer.IsRegionCpuModified(c, size_bytes) == any_cpu);
+    }
+    buffer.MarkRegionAsCpuModified(c, size_bytes);
+    REQUIRE(rasterizer.Count() == 0);
+}
+} // Anonymous namespace
+
+TEST_CASE("BufferBase: Random operations match a page model in a small buffer") {
+    RunModelOperations(WORD, 1);
+}
+
+TEST_CASE("BufferBase: Random operations match a page model in a large buffer") {
+    RunModelOperations(WORD * 3 + PAGE * 5, 2);
+}
+
+TEST_CASE("BufferBase: Random operations match a page model across summary words") {
+    RunModelOperations(WORD * 130, 3);
+}
+
+TEST_CASE("BufferBase: Modified ranges after clean words") {
+    RasterizerInterface rasterizer;
+    BufferBase buffer(rasterizer, c, WORD * 4);
+    buffer.UnmarkRegionAsCpuModified(c, WORD * 4);
+    buffer.MarkRegionAsCpuModified(c + PAGE, PAGE);
+    buffer.MarkRegionAsCpuModified(c + WORD * 3 + PAGE * 2, PAGE);
+    std::vector<Range> ranges;
+    buffer.ForEachUploadRange(c, WORD * 4, [&](u64 offset, u64 size) {
+        ranges.emplace_back(offset, size);
+    });
+    REQUIRE(ranges == std::vector<Range>{{PAGE, PAGE}, {WORD * 3 + PAGE * 2, PAGE}});
+    REQUIRE(!buffer.IsRegionCpuModified(c, WORD * 4));
+    REQUIRE(rasterizer.Count() == WORD * 4 / PAGE);
+}
+
+TEST_CASE("BufferBase: Flushed cached writes are not flushed again") {
+    RasterizerInterface rasterizer;
+    BufferBase buffer(rasterizer, c, WORD);
+    buffer.UnmarkRegionAsCpuModified(c, WORD);
+    buffer.CachedCpuWrite(c + PAGE, PAGE);
+    buffer.FlushCachedWrites();
+    int num = 0;
+    buffer.ForEachUploadRange(c, WORD, [&](u64 offset, u64 size) { ++num; });
+    REQUIRE(num == 1);
+    buffer.FlushCachedWrites();
+    REQUIRE(!buffer.IsRegionCpuModified(c + PAGE, PAGE));
+    REQUIRE(rasterizer.Count() == 64);
+}
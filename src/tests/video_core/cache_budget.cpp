@@ -0,0 +1,102 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "common/common_types.h"
+#include "video_core/cache_budget.h"
+
+namespace {
+using VideoCommon::CacheBudget;
+using VideoCommon::SlotId;
+
+std::vector<u32> SweepAll(CacheBudget& budget) {
+    std::vector<u32> visited;
+    budget.Sweep(1000, true, [&](SlotId id) {
+        visited.push_back(id.index);
+        return true;
+    });
+    return visited;
+}
+} // Anonymous namespace
+
+TEST_CASE("CacheBudget: Accounting", "[video_core]") {
+    CacheBudget budget(1000);
+    budget.Insert(SlotId{0}, 0x1000, 400, 0);
+    budget.Insert(SlotId{3}, 0x2000, 500, 0);
+    REQUIRE(budget.ResidentBytes() == 900);
+    budget.Remove(SlotId{0});
+    REQUIRE(budget.ResidentBytes() == 500);
+
+    budget.Tick();
+    const auto stats = budget.GetStats();
+    REQUIRE(stats.resident_bytes == 500);
+    REQUIRE(stats.budget_bytes == 1000);
+    REQUIRE(stats.num_resident == 1);
+}
+
+TEST_CASE("CacheBudget: Least recently used order", "[video_core]") {
+    CacheBudget budget;
+    for (u32 index = 0; index < 4; ++index) {
+        budget.Insert(SlotId{index}, index * 0x1000, 100, 0);
+    }
+    REQUIRE(SweepAll(budget) == std::vector<u32>{0, 1, 2, 3});
+
+    budget.Touch(SlotId{1}, 1);
+    budget.Touch(SlotId{0}, 2);
+    REQUIRE(SweepAll(budget) == std::vector<u32>{2, 3, 1, 0});
+
+    // Touching twice in the same tick keeps the order
+    budget.Touch(SlotId{1}, 2);
+    budget.Touch(SlotId{1}, 2);
+    REQUIRE(SweepAll(budget) == std::vector<u32>{2, 3, 0, 1});
+
+    // Resources that are not accounted are ignored
+    budget.Touch(SlotId{10}, 3);
+    REQUIRE(SweepAll(budget) == std::vector<u32>{2, 3, 0, 1});
+}
+
+TEST_CASE("CacheBudget: Evict while sweeping", "[video_core]") {
+    CacheBudget budget(250);
+    for (u32 index = 0; index < 5; ++index) {
+        budget.Insert(SlotId{index}, index * 0x1000, 100, 0);
+    }
+    budget.Sweep(10, true, [&](SlotId id) {
+        budget.RecordEviction(id);
+        budget.Remove(id);
+        return budget.ResidentBytes() > 250;
+    });
+    REQUIRE(budget.ResidentBytes() == 200);
+    REQUIRE(SweepAll(budget) == std::vector<u32>{3, 4});
+
+    // Creating again an evicted resource counts as a re-upload
+    budget.Insert(SlotId{0}, 0x1000, 100, 1);
+    budget.Insert(SlotId{5}, 0x8000, 100, 1);
+    budget.Tick();
+    const auto stats = budget.GetStats();
+    REQUIRE(stats.evictions == 3);
+    REQUIRE(stats.evicted_bytes == 300);
+    REQUIRE(stats.reupload_bytes == 100);
+}
+
+TEST_CASE("CacheBudget: Continue sweep", "[video_core]") {
+    CacheBudget budget;
+    for (u32 index = 0; index < 6; ++index) {
+        budget.Insert(SlotId{index}, index * 0x1000, 100, 0);
+    }
+    std::vector<u32> visited;
+    const auto visit = [&](SlotId id) {
+        visited.push_back(id.index);
+        return true;
+    };
+    budget.Sweep(2, false, visit);
+    budget.Sweep(2, false, visit);
+    // Removing the resource the sweep stopped at continues from the next one
+    budget.Remove(SlotId{4});
+    budget.Sweep(2, false, visit);
+    budget.Sweep(1, false, visit);
+    REQUIRE(visited == std::vector<u32>{0, 1, 2, 3, 5, 0});
+}
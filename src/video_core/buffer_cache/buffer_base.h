@@ -40,6 +40,35 @@ class BufferBase {
     static constexpr u64 BYTES_PER_PAGE = Core::Memory::PAGE_SIZE;
     static constexpr u64 BYTES_PER_WORD = PAGES_PER_WORD * BYTES_PER_PAGE;
 
+    /// Returns a mask with the bits [begin, end) set, where begin < end <= 64
+    [[nodiscard]] static constexpr u64 RangeMask(u64 begin, u64 end) noexcept {
+        return (~u64{0} >> (PAGES_PER_WORD - (end - begin))) << begin;
+    }
+
+    /**
+     * Calls func with the index and the mask of each word overlapping the bits [begin, end).
+     * Words fully inside the range get a full mask, so loops over them can be vectorized.
+     */
+    template <typename Func>
+    static void ForEachWordMask(u64 begin, u64 end, Func&& func) {
+        if (begin >= end) {
+            return;
+        }
+        const u64 word_begin = begin / PAGES_PER_WORD;
+        const u64 word_last = (end - 1) / PAGES_PER_WORD;
+        const u64 local_begin = begin % PAGES_PER_WORD;
+        const u64 local_end = (end - 1) % PAGES_PER_WORD + 1;
+        if (word_begin == word_last) {
+            func(word_begin, RangeMask(local_begin, local_end));
+            return;
+        }
+        func(word_begin, RangeMask(local_begin, PAGES_PER_WORD));
+        for (u64 word_index = word_begin + 1; word_index < word_last; ++word_index) {
+            func(word_index, ~u64{0});
+        }
+        func(word_last, RangeMask(0, local_end));
+    }
+
     /// Vector tracking modified pages tightly packed with small vector optimization
     union WordsArray {
         /// Returns the pointer to the words state
@@ -59,23 +88,35 @@ class BufferBase {
     struct Words {
         explicit Words() = default;
         explicit Words(u64 size_bytes_) : size_bytes{size_bytes_} {
+            const size_t num_words = NumWords();
             if (IsShort()) {
                 cpu.stack = ~u64{0};
                 gpu.stack = 0;
                 cached_cpu.stack = 0;
                 untracked.stack = ~u64{0};
+                cpu_summary.stack = 1;
+                gpu_summary.stack = 0;
+                cached_cpu_summary.stack = 0;
             } else {
                 // Share allocation between CPU and GPU pages and set their default values
-                const size_t num_words = NumWords();
-                u64* const alloc = new u64[num_words * 4];
+                const size_t num_summary_words = NumSummaryWords();
+                u64* const alloc = new u64[num_words * 4 + num_summary_words * 3];
                 cpu.heap = alloc;
                 gpu.heap = alloc + num_words;
                 cached_cpu.heap = alloc + num_words * 2;
                 untracked.heap = alloc + num_words * 3;
+                cpu_summary.heap = alloc + num_words * 4;
+                gpu_summary.heap = cpu_summary.heap + num_summary_words;
+                cached_cpu_summary.heap = gpu_summary.heap + num_summary_words;
                 std::fill_n(cpu.heap, num_words, ~u64{0});
                 std::fill_n(gpu.heap, num_words, 0);
                 std::fill_n(cached_cpu.heap, num_words, 0);
                 std::fill_n(untracked.heap, num_words, ~u64{0});
+                std::fill_n(cpu_summary.heap, num_summary_words, 0);
+                std::fill_n(gpu_summary.heap, num_summary_words, 0);
+                std::fill_n(cached_cpu_summary.heap, num_summary_words, 0);
+                ForEachWordMask(0, num_words,
+                                [this](u64 index, u64 mask) { cpu_summary.heap[index] |= mask; });
             }
             // Clean up tailing bits
             const u64 last_word_size = size_bytes % BYTES_PER_WORD;
@@ -97,13 +138,18 @@ class BufferBase {
             gpu = rhs.gpu;
             cached_cpu = rhs.cached_cpu;
             untracked = rhs.untracked;
+            cpu_summary = rhs.cpu_summary;
+            gpu_summary = rhs.gpu_summary;
+            cached_cpu_summary = rhs.cached_cpu_summary;
             rhs.cpu.heap = nullptr;
             return *this;
         }
 
         Words(Words&& rhs) noexcept
             : size_bytes{rhs.size_bytes}, cpu{rhs.cpu}, gpu{rhs.gpu},
-              cached_cpu{rhs.cached_cpu}, untracked{rhs.untracked} {
+              cached_cpu{rhs.cached_cpu}, untracked{rhs.untracked},
+              cpu_summary{rhs.cpu_summary}, gpu_summary{rhs.gpu_summary},
+              cached_cpu_summary{rhs.cached_cpu_summary} {
             rhs.cpu.heap = nullptr;
         }
 
@@ -120,6 +166,11 @@ class BufferBase {
             return Common::DivCeil(size_bytes, BYTES_PER_WORD);
         }
 
+        /// Returns the number of words of each summary, one bit per word of the buffer
+        [[nodiscard]] size_t NumSummaryWords() const noexcept {
+            return Common::DivCeil(NumWords(), PAGES_PER_WORD);
+        }
+
         /// Release buffer resources
         void Release() {
             if (!IsShort()) {
@@ -133,6 +184,10 @@ class BufferBase {
         WordsArray gpu;
         WordsArray cached_cpu;
         WordsArray untracked;
+        /// Summaries of the words, a bit is set when its word has any page set
+        WordsArray cpu_summary;
+        WordsArray gpu_summary;
+        WordsArray cached_cpu_summary;
     };
 
     enum class Type {
@@ -212,14 +267,25 @@ public:
     void FlushCachedWrites() noexcept {
         flags &= ~BufferFlagBits::CachedWrites;
         const u64 num_words = NumWords();
-        const u64* const cached_words = Array<Type::CachedCPU>();
+        u64* const cached_words = Array<Type::CachedCPU>();
         u64* const untracked_words = Array<Type::Untracked>();
         u64* const cpu_words = Array<Type::CPU>();
-        for (u64 word_index = 0; word_index < num_words; ++word_index) {
+        RasterizerNotifier<false> notifier{*this};
+        for (u64 word_index = FindSetWord<Type::CachedCPU>(0, num_words); word_index < num_words;
+             word_index = FindSetWord<Type::CachedCPU>(word_index + 1, num_words)) {
             const u64 cached_bits = cached_words[word_index];
-            NotifyRasterizer<false>(word_index, untracked_words[word_index], cached_bits);
+            notifier.Add(word_index, ~untracked_words[word_index] & cached_bits);
             untracked_words[word_index] |= cached_bits;
             cpu_words[word_index] |= cached_bits;
+            cached_words[word_index] = 0;
+        }
+        notifier.Flush();
+
+        u64* const cached_summary = Summary<Type::CachedCPU>();
+        u64* const cpu_summary = Summary<Type::CPU>();
+        for (u64 index = 0; index < words.NumSummaryWords(); ++index) {
+            cpu_summary[index] |= cached_summary[index];
+            cached_summary[index] = 0;
         }
     }
 
@@ -329,6 +395,121 @@ private:
         }
     }
 
+    template <Type type>
+    u64* Summary() noexcept {
+        static_assert(type != Type::Untracked);
+        if constexpr (type == Type::CPU) {
+            return words.cpu_summary.Pointer(IsShort());
+        } else if constexpr (type == Type::GPU) {
+            return words.gpu_summary.Pointer(IsShort());
+        } else if constexpr (type == Type::CachedCPU) {
+            return words.cached_cpu_summary.Pointer(IsShort());
+        }
+    }
+
+    template <Type type>
+    const u64* Summary() const noexcept {
+        static_assert(type != Type::Untracked);
+        if constexpr (type == Type::CPU) {
+            return words.cpu_summary.Pointer(IsShort());
+        } else if constexpr (type == Type::GPU) {
+            return words.gpu_summary.Pointer(IsShort());
+        } else if constexpr (type == Type::CachedCPU) {
+            return words.cached_cpu_summary.Pointer(IsShort());
+        }
+    }
+
+    /// Refreshes the summary bit of a word after it changed
+    template <Type type>
+    void UpdateSummary(u64 word_index) noexcept {
+        u64& summary_word = Summary<type>()[word_index / PAGES_PER_WORD];
+        const u64 bit = u64{1} << (word_index % PAGES_PER_WORD);
+        if (Array<type>()[word_index] != 0) {
+            summary_word |= bit;
+        } else {
+            summary_word &= ~bit;
+        }
+    }
+
+    /// Returns the first word in [word_begin, word_end) with any page set, or word_end
+    template <Type type>
+    [[nodiscard]] u64 FindSetWord(u64 word_begin, u64 word_end) const noexcept {
+        const u64* const summary = Summary<type>();
+        u64 word_index = word_begin;
+        while (word_index < word_end) {
+            const u64 bits = summary[word_index / PAGES_PER_WORD] >> (word_index % PAGES_PER_WORD);
+            if (bits != 0) {
+                return std::min(word_index + std::countr_zero(bits), word_end);
+            }
+            word_index = Common::AlignDown(word_index, PAGES_PER_WORD) + PAGES_PER_WORD;
+        }
+        return word_end;
+    }
+
+    /// Returns one past the last word in [word_begin, word_end) with any page set, or word_begin
+    template <Type type>
+    [[nodiscard]] u64 FindSetWordEnd(u64 word_begin, u64 word_end) const noexcept {
+        const u64* const summary = Summary<type>();
+        u64 word_index = word_end;
+        while (word_index > word_begin) {
+            const u64 last = word_index - 1;
+            const u64 bits = summary[last / PAGES_PER_WORD]
+                             << (PAGES_PER_WORD - 1 - last % PAGES_PER_WORD);
+            if (bits != 0) {
+                return std::max(last - std::countl_zero(bits) + 1, word_begin);
+            }
+            word_index = Common::AlignDown(last, PAGES_PER_WORD);
+        }
+        return word_begin;
+    }
+
+    /**
+     * Accumulates pages changing their CPU tracking state, merging pages contiguous across words
+     * into a single notification to the rasterizer
+     *
+     * @tparam add_to_rasterizer True when the rasterizer should start tracking the pages
+     */
+    template <bool add_to_rasterizer>
+    class RasterizerNotifier {
+    public:
+        explicit RasterizerNotifier(const BufferBase& buffer_) : buffer{buffer_} {}
+
+        /// Adds the pages of a word whose bits are set
+        void Add(u64 word_index, u64 bits) {
+            u64 page = word_index * PAGES_PER_WORD;
+            while (bits != 0) {
+                const int empty_bits = std::countr_zero(bits);
+                page += empty_bits;
+                bits >>= empty_bits;
+
+                const u64 continuous_bits = std::countr_one(bits);
+                if (num_pages == 0 || first_page + num_pages != page) {
+                    Flush();
+                    first_page = page;
+                }
+                num_pages += continuous_bits;
+                page += continuous_bits;
+                bits = continuous_bits < PAGES_PER_WORD ? (bits >> continuous_bits) : 0;
+            }
+        }
+
+        /// Notifies the rasterizer about the pending pages
+        void Flush() {
+            if (num_pages == 0) {
+                return;
+            }
+            buffer.rasterizer->UpdatePagesCachedCount(buffer.cpu_addr + first_page * BYTES_PER_PAGE,
+                                                      num_pages * BYTES_PER_PAGE,
+                                                      add_to_rasterizer ? 1 : -1);
+            num_pages = 0;
+        }
+
+    private:
+        const BufferBase& buffer;
+        u64 first_page = 0;
+        u64 num_pages = 0;
+    };
+
     /**
      * Change the state of a range of pages
      *
@@ -346,23 +527,20 @@ private:
         u64* const untracked_words = Array<Type::Untracked>();
         u64* const state_words = Array<type>();
         const u64 offset_end = std::min(offset + size, SizeBytes());
-        const u64 begin_page_index = offset / BYTES_PER_PAGE;
-        const u64 begin_word_index = begin_page_index / PAGES_PER_WORD;
-        const u64 end_page_index = Common::DivCeil(offset_end, BYTES_PER_PAGE);
-        const u64 end_word_index = Common::DivCeil(end_page_index, PAGES_PER_WORD);
-        u64 page_index = begin_page_index % PAGES_PER_WORD;
-        u64 word_index = begin_word_index;
-        while (word_index < end_word_index) {
-            const u64 next_word_first_page = (word_index + 1) * PAGES_PER_WORD;
-            const u64 left_offset =
-                std::min(next_word_first_page - end_page_index, PAGES_PER_WORD) % PAGES_PER_WORD;
-            const u64 right_offset = page_index;
-            u64 bits = ~u64{0};
-            bits = (bits >> right_offset) << right_offset;
-            bits = (bits << left_offset) >> left_offset;
-            if constexpr (type == Type::CPU || type == Type::CachedCPU) {
-                NotifyRasterizer<!enable>(word_index, untracked_words[word_index], bits);
-            }
+        const u64 page_begin = offset / BYTES_PER_PAGE;
+        const u64 page_end = Common::DivCeil(offset_end, BYTES_PER_PAGE);
+        if (page_begin >= page_end) {
+            return;
+        }
+        if constexpr (type == Type::CPU || type == Type::CachedCPU) {
+            RasterizerNotifier<!enable> notifier{*this};
+            ForEachWordMask(page_begin, page_end, [&](u64 word_index, u64 bits) {
+                const u64 untracked_bits = untracked_words[word_index];
+                notifier.Add(word_index, (enable ? ~untracked_bits : untracked_bits) & bits);
+            });
+            notifier.Flush();
+        }
+        ForEachWordMask(page_begin, page_end, [&](u64 word_index, u64 bits) {
             if constexpr (enable) {
                 state_words[word_index] |= bits;
                 if constexpr (type == Type::CPU || type == Type::CachedCPU) {
@@ -374,35 +552,18 @@ private:
                     untracked_words[word_index] &= ~bits;
                 }
             }
-            page_index = 0;
-            ++word_index;
-        }
-    }
-
-    /**
-     * Notify rasterizer about changes in the CPU tracking state of a word in the buffer
-     *
-     * @param word_index   Index to the word to notify to the rasterizer
-     * @param current_bits Current state of the word
-     * @param new_bits     New state of the word
-     *
-     * @tparam add_to_rasterizer True when the rasterizer should start tracking the new pages
-     */
-    template <bool add_to_rasterizer>
-    void NotifyRasterizer(u64 word_index, u64 current_bits, u64 new_bits) const {
-        u64 changed_bits = (add_to_rasterizer ? current_bits : ~current_bits) & new_bits;
-        VAddr addr = cpu_addr + word_index * BYTES_PER_WORD;
-        while (changed_bits != 0) {
-            const int empty_bits = std::countr_zero(changed_bits);
-            addr += empty_bits * BYTES_PER_PAGE;
-            changed_bits >>= empty_bits;
-
-            const u32 continuous_bits = std::countr_one(changed_bits);
-            const u64 size = continuous_bits * BYTES_PER_PAGE;
-            const VAddr begin_addr = addr;
-            addr += size;
-            changed_bits = continuous_bits < PAGES_PER_WORD ? (changed_bits >> continuous_bits) : 0;
-            rasterizer->UpdatePagesCachedCount(begin_addr, size, add_to_rasterizer ? 1 : -1);
+        });
+        const u64 word_begin = page_begin / PAGES_PER_WORD;
+        const u64 word_end = Common::DivCeil(page_end, PAGES_PER_WORD);
+        if constexpr (enable) {
+            ForEachWordMask(word_begin, word_end,
+                            [&](u64 index, u64 mask) { Summary<type>()[index] |= mask; });
+        } else {
+            // Only the words on the edges of the range can keep pages set
+            ForEachWordMask(word_begin, word_end,
+                            [&](u64 index, u64 mask) { Summary<type>()[index] &= ~mask; });
+            UpdateSummary<type>(word_begin);
+            UpdateSummary<type>(word_end - 1);
         }
     }
 
@@ -426,83 +587,70 @@ private:
         }
         u64* const untracked_words = Array<Type::Untracked>();
         u64* const state_words = Array<type>();
-        const u64 query_end = query_begin + std::min(static_cast<u64>(size), SizeBytes());
-        u64* const words_begin = state_words + query_begin / BYTES_PER_WORD;
-        u64* const words_end = state_words + Common::DivCeil(query_end, BYTES_PER_WORD);
+        const u64 query_end = std::min(query_begin + static_cast<u64>(size), SizeBytes());
+        const u64 query_page_begin = query_begin / BYTES_PER_PAGE;
+        const u64 query_page_end = Common::DivCeil(query_end, BYTES_PER_PAGE);
+        const u64 query_word_begin = query_page_begin / PAGES_PER_WORD;
+        const u64 query_word_end = Common::DivCeil(query_page_end, PAGES_PER_WORD);
 
-        const auto modified = [](u64 word) { return word != 0; };
-        const auto first_modified_word = std::find_if(words_begin, words_end, modified);
-        if (first_modified_word == words_end) {
+        const u64 word_index_begin = FindSetWord<type>(query_word_begin, query_word_end);
+        if (word_index_begin == query_word_end) {
             // Exit early when the buffer is not modified
             return;
         }
-        const auto last_modified_word = std::find_if_not(first_modified_word, words_end, modified);
-
-        const u64 word_index_begin = std::distance(state_words, first_modified_word);
-        const u64 word_index_end = std::distance(state_words, last_modified_word);
-
-        const unsigned local_page_begin = std::countr_zero(*first_modified_word);
-        const unsigned local_page_end =
-            static_cast<unsigned>(PAGES_PER_WORD) - std::countl_zero(last_modified_word[-1]);
-        const u64 word_page_begin = word_index_begin * PAGES_PER_WORD;
-        const u64 word_page_end = (word_index_end - 1) * PAGES_PER_WORD;
-        const u64 query_page_begin = query_begin / BYTES_PER_PAGE;
-        const u64 query_page_end = Common::DivCeil(query_end, BYTES_PER_PAGE);
-        const u64 page_index_begin = std::max(word_page_begin + local_page_begin, query_page_begin);
-        const u64 page_index_end = std::min(word_page_end + local_page_end, query_page_end);
-        const u64 first_word_page_begin = page_index_begin % PAGES_PER_WORD;
-        const u64 last_word_page_end = (page_index_end - 1) % PAGES_PER_WORD + 1;
-
-        u64 page_begin = first_word_page_begin;
+        const u64 word_index_end = FindSetWordEnd<type>(word_index_begin, query_word_end);
+        const u64 local_page_begin = std::countr_zero(state_words[word_index_begin]);
+        const u64 local_page_end =
+            PAGES_PER_WORD - std::countl_zero(state_words[word_index_end - 1]);
+        const u64 page_index_begin =
+            std::max(word_index_begin * PAGES_PER_WORD + local_page_begin, query_page_begin);
+        const u64 page_index_end =
+            std::min((word_index_end - 1) * PAGES_PER_WORD + local_page_end, query_page_end);
+
+        RasterizerNotifier<true> notifier{*this};
         u64 current_base = 0;
         u64 current_size = 0;
-        bool on_going = false;
-        for (u64 word_index = word_index_begin; word_index < word_index_end; ++word_index) {
-            const bool is_last_word = word_index + 1 == word_index_end;
-            const u64 page_end = is_last_word ? last_word_page_end : PAGES_PER_WORD;
-            const u64 right_offset = page_begin;
-            const u64 left_offset = PAGES_PER_WORD - page_end;
-            u64 bits = ~u64{0};
-            bits = (bits >> right_offset) << right_offset;
-            bits = (bits << left_offset) >> left_offset;
-
+        ForEachWordMask(page_index_begin, page_index_end, [&](u64 word_index, u64 bits) {
             const u64 current_word = state_words[word_index] & bits;
             state_words[word_index] &= ~bits;
 
             if constexpr (type == Type::CPU) {
-                const u64 current_bits = untracked_words[word_index] & bits;
+                notifier.Add(word_index, untracked_words[word_index] & bits);
                 untracked_words[word_index] &= ~bits;
-                NotifyRasterizer<true>(word_index, current_bits, ~u64{0});
             }
             // Exclude CPU modified pages when visiting GPU pages
-            const u64 word = current_word & ~(type == Type::GPU ? untracked_words[word_index] : 0);
-            u64 page = page_begin;
-            page_begin = 0;
-
-            while (page < page_end) {
-                const int empty_bits = std::countr_zero(word >> page);
-                if (on_going && empty_bits != 0) {
-                    InvokeModifiedRange(func, current_size, current_base);
-                    current_size = 0;
-                    on_going = false;
-                }
-                if (empty_bits == PAGES_PER_WORD) {
-                    break;
-                }
+            u64 word = current_word & ~(type == Type::GPU ? untracked_words[word_index] : 0);
+            u64 page = word_index * PAGES_PER_WORD;
+            while (word != 0) {
+                const int empty_bits = std::countr_zero(word);
                 page += empty_bits;
-
-                const int continuous_bits = std::countr_one(word >> page);
-                if (!on_going && continuous_bits != 0) {
-                    current_base = word_index * PAGES_PER_WORD + page;
-                    on_going = true;
+                word >>= empty_bits;
+
+                const u64 continuous_bits = std::countr_one(word);
+                if (current_size == 0 || current_base + current_size != page) {
+                    if (current_size != 0) {
+                        InvokeModifiedRange(func, current_size, current_base);
+                    }
+                    current_base = page;
+                    current_size = 0;
                 }
                 current_size += continuous_bits;
                 page += continuous_bits;
+                word = continuous_bits < PAGES_PER_WORD ? (word >> continuous_bits) : 0;
             }
-        }
-        if (on_going && current_size > 0) {
+        });
+        if (current_size != 0) {
             InvokeModifiedRange(func, current_size, current_base);
         }
+        notifier.Flush();
+        if (page_index_begin < page_index_end) {
+            const u64 word_begin = page_index_begin / PAGES_PER_WORD;
+            const u64 word_end = Common::DivCeil(page_index_end, PAGES_PER_WORD);
+            ForEachWordMask(word_begin, word_end,
+                            [&](u64 index, u64 mask) { Summary<type>()[index] &= ~mask; });
+            UpdateSummary<type>(word_begin);
+            UpdateSummary<type>(word_end - 1);
+        }
     }
 
     template <typename Func>
@@ -514,13 +662,14 @@ private:
     }
 
     /**
-     * Returns true when a region has been modified
+     * Calls func with the index and the modified pages of each word of a region query that has
+     * modified pages, skipping clean words through the summary. Stops when func returns true.
      *
      * @param offset Offset in bytes from the start of the buffer
      * @param size   Size in bytes of the region to query for modifications
      */
-    template <Type type>
-    [[nodiscard]] bool IsRegionModified(u64 offset, u64 size) const noexcept {
+    template <Type type, typename Func>
+    void ForEachModifiedWord(u64 offset, u64 size, Func&& func) const {
         static_assert(type != Type::Untracked);
 
         const u64* const untracked_words = Array<Type::Untracked>();
@@ -528,22 +677,37 @@ private:
         const u64 num_query_words = size / BYTES_PER_WORD + 1;
         const u64 word_begin = offset / BYTES_PER_WORD;
         const u64 word_end = std::min(word_begin + num_query_words, NumWords());
-        const u64 page_limit = Common::DivCeil(offset + size, BYTES_PER_PAGE);
-        u64 page_index = (offset / BYTES_PER_PAGE) % PAGES_PER_WORD;
-        for (u64 word_index = word_begin; word_index < word_end; ++word_index, page_index = 0) {
+        for (u64 word_index = FindSetWord<type>(word_begin, word_end); word_index < word_end;
+             word_index = FindSetWord<type>(word_index + 1, word_end)) {
             const u64 off_word = type == Type::GPU ? untracked_words[word_index] : 0;
             const u64 word = state_words[word_index] & ~off_word;
-            if (word == 0) {
-                continue;
+            if (word != 0 && func(word_index, word)) {
+                return;
             }
+        }
+    }
+
+    /**
+     * Returns true when a region has been modified
+     *
+     * @param offset Offset in bytes from the start of the buffer
+     * @param size   Size in bytes of the region to query for modifications
+     */
+    template <Type type>
+    [[nodiscard]] bool IsRegionModified(u64 offset, u64 size) const noexcept {
+        const u64 word_begin = offset / BYTES_PER_WORD;
+        const u64 page_limit = Common::DivCeil(offset + size, BYTES_PER_PAGE);
+        bool is_modified = false;
+        ForEachModifiedWord<type>(offset, size, [&](u64 word_index, u64 word) {
+            const u64 page_index =
+                word_index == word_begin ? (offset / BYTES_PER_PAGE) % PAGES_PER_WORD : 0;
             const u64 page_end = std::min((word_index + 1) * PAGES_PER_WORD, page_limit);
             const u64 local_page_end = page_end % PAGES_PER_WORD;
             const u64 page_end_shift = (PAGES_PER_WORD - local_page_end) % PAGES_PER_WORD;
-            if (((word >> page_index) << page_index) << page_end_shift != 0) {
-                return true;
-            }
-        }
-        return false;
+            is_modified = ((word >> page_index) << page_index) << page_end_shift != 0;
+            return is_modified;
+        });
+        return is_modified;
     }
 
     /**
@@ -554,23 +718,11 @@ private:
      */
     template <Type type>
     [[nodiscard]] std::pair<u64, u64> ModifiedRegion(u64 offset, u64 size) const noexcept {
-        static_assert(type != Type::Untracked);
-
-        const u64* const untracked_words = Array<Type::Untracked>();
-        const u64* const state_words = Array<type>();
-        const u64 num_query_words = size / BYTES_PER_WORD + 1;
-        const u64 word_begin = offset / BYTES_PER_WORD;
-        const u64 word_end = std::min(word_begin + num_query_words, NumWords());
         const u64 page_base = offset / BYTES_PER_PAGE;
         const u64 page_limit = Common::DivCeil(offset + size, BYTES_PER_PAGE);
         u64 begin = std::numeric_limits<u64>::max();
         u64 end = 0;
-        for (u64 word_index = word_begin; word_index < word_end; ++word_index) {
-            const u64 off_word = type == Type::GPU ? untracked_words[word_index] : 0;
-            const u64 word = state_words[word_index] & ~off_word;
-            if (word == 0) {
-                continue;
-            }
+        ForEachModifiedWord<type>(offset, size, [&](u64 word_index, u64 word) {
             const u64 local_page_begin = std::countr_zero(word);
             const u64 local_page_end = PAGES_PER_WORD - std::countl_zero(word);
             const u64 page_index = word_index * PAGES_PER_WORD;
@@ -578,7 +730,8 @@ private:
             const u64 page_end = std::min(page_index + local_page_end, page_limit);
             begin = std::min(begin, page_begin);
             end = std::max(end, page_end);
-        }
+            return false;
+        });
         static constexpr std::pair<u64, u64> EMPTY{0, 0};
         return begin < end ? std::make_pair(begin * BYTES_PER_PAGE, end * BYTES_PER_PAGE) : EMPTY;
     }
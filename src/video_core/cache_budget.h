@@ -0,0 +1,210 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "common/flat_hash_map.h"
+#include "video_core/texture_cache/slot_vector.h"
+
+namespace VideoCommon {
+
+/// Memory statistics of a cache, safe to read from any thread
+struct CacheMemoryStats {
+    u64 resident_bytes = 0;
+    u64 budget_bytes = 0;
+    u64 num_resident = 0;
+    /// Total evicted resources and their size
+    u64 evictions = 0;
+    u64 evicted_bytes = 0;
+    /// Total size of the resources created again where one had been evicted
+    u64 reupload_bytes = 0;
+    double evictions_per_second = 0.0;
+};
+
+/**
+ * Accounts the memory of the resources of a cache against a byte budget and keeps them in least
+ * recently used order, so garbage collection evicts the oldest resources first.
+ *
+ * Resources are identified by their slot and linked through an array indexed by it, touching or
+ * removing a resource is constant time.
+ */
+class CacheBudget {
+public:
+    explicit CacheBudget(u64 budget_bytes_ = 0) : budget_bytes{budget_bytes_} {}
+
+    /// Starts accounting a resource, as the most recently used one
+    void Insert(SlotId id, VAddr cpu_addr, u64 size_bytes, u64 tick) {
+        if (id.index >= nodes.size()) {
+            nodes.resize(id.index + 1);
+        }
+        Node& node = nodes[id.index];
+        ASSERT_MSG(!node.is_resident, "Resource {} is already accounted", id.index);
+        node.cpu_addr = cpu_addr;
+        node.size_bytes = size_bytes;
+        node.last_use = tick;
+        node.is_resident = true;
+        Link(id.index);
+
+        resident_bytes += size_bytes;
+        ++num_resident;
+        if (evicted_addresses.erase(cpu_addr) != 0) {
+            reupload_bytes += size_bytes;
+        }
+    }
+
+    /// Stops accounting a resource
+    void Remove(SlotId id) {
+        ASSERT(id.index < nodes.size());
+        Node& node = nodes[id.index];
+        ASSERT_MSG(node.is_resident, "Resource {} is not accounted", id.index);
+        Unlink(id.index);
+        node.is_resident = false;
+
+        resident_bytes -= node.size_bytes;
+        --num_resident;
+    }
+
+    /// Marks a resource as used in the given tick
+    void Touch(SlotId id, u64 tick) {
+        if (id.index >= nodes.size()) {
+            return;
+        }
+        Node& node = nodes[id.index];
+        if (!node.is_resident || node.last_use == tick) {
+            return;
+        }
+        node.last_use = tick;
+        Unlink(id.index);
+        Link(id.index);
+    }
+
+    /// Records that a resource is being removed to stay within the budget
+    void RecordEviction(SlotId id) {
+        ASSERT(id.index < nodes.size());
+        const Node& node = nodes[id.index];
+        ++evictions;
+        evicted_bytes += node.size_bytes;
+        if (evicted_addresses.size() >= MAX_EVICTED_ADDRESSES) {
+            evicted_addresses.clear();
+        }
+        evicted_addresses.try_emplace(node.cpu_addr, node.size_bytes);
+    }
+
+    /**
+     * Visits up to max_visits resources in least recently used order, resources may be removed
+     * while they are visited. The sweep starts from the oldest resource when from_oldest is true,
+     * otherwise it continues where the previous one stopped.
+     * @param func Called with the id of each resource, returns false to stop the sweep
+     */
+    template <typename Func>
+    void Sweep(size_t max_visits, bool from_oldest, Func&& func) {
+        if (from_oldest || cursor == INVALID) {
+            cursor = head;
+        }
+        for (; max_visits > 0 && cursor != INVALID; --max_visits) {
+            const u32 index = cursor;
+            cursor = nodes[index].next;
+            if (!func(SlotId{index})) {
+                break;
+            }
+        }
+    }
+
+    /// Updates the rate counters and publishes the statistics, called once per frame
+    void Tick() {
+        const auto now = std::chrono::steady_clock::now();
+        const std::chrono::duration<double> elapsed = now - rate_start;
+        if (elapsed >= std::chrono::seconds{1}) {
+            evictions_per_second =
+                static_cast<double>(evictions - rate_start_evictions) / elapsed.count();
+            rate_start = now;
+            rate_start_evictions = evictions;
+        }
+
+        std::scoped_lock lock{stats_mutex};
+        published_stats = CacheMemoryStats{
+            .resident_bytes = resident_bytes,
+            .budget_bytes = budget_bytes,
+            .num_resident = num_resident,
+            .evictions = evictions,
+            .evicted_bytes = evicted_bytes,
+            .reupload_bytes = reupload_bytes,
+            .evictions_per_second = evictions_per_second,
+        };
+    }
+
+    void SetBudget(u64 budget_bytes_) noexcept {
+        budget_bytes = budget_bytes_;
+    }
+
+    [[nodiscard]] u64 ResidentBytes() const noexcept {
+        return resident_bytes;
+    }
+
+    /// Returns the statistics published in the last tick
+    [[nodiscard]] CacheMemoryStats GetStats() const {
+        std::scoped_lock lock{stats_mutex};
+        return published_stats;
+    }
+
+private:
+    static constexpr u32 INVALID = SlotId::INVALID_INDEX;
+
+    /// Evicted addresses kept to detect resources created again
+    static constexpr size_t MAX_EVICTED_ADDRESSES = 0x10000;
+
+    struct Node {
+        u32 prev = INVALID;
+        u32 next = INVALID;
+        VAddr cpu_addr = 0;
+        u64 size_bytes = 0;
+        u64 last_use = 0;
+        bool is_resident = false;
+    };
+
+    void Link(u32 index) {
+        Node& node = nodes[index];
+        node.prev = tail;
+        node.next = INVALID;
+        (tail == INVALID ? head : nodes[tail].next) = index;
+        tail = index;
+    }
+
+    void Unlink(u32 index) {
+        Node& node = nodes[index];
+        if (cursor == index) {
+            cursor = node.next;
+        }
+        (node.prev == INVALID ? head : nodes[node.prev].next) = node.next;
+        (node.next == INVALID ? tail : nodes[node.next].prev) = node.prev;
+    }
+
+    std::vector<Node> nodes;
+    u32 head = INVALID;
+    u32 tail = INVALID;
+    u32 cursor = INVALID;
+
+    u64 budget_bytes;
+    u64 resident_bytes = 0;
+    u64 num_resident = 0;
+    u64 evictions = 0;
+    u64 evicted_bytes = 0;
+    u64 reupload_bytes = 0;
+    Common::FlatHashMap<VAddr, u64> evicted_addresses;
+
+    std::chrono::steady_clock::time_point rate_start = std::chrono::steady_clock::now();
+    u64 rate_start_evictions = 0;
+    double evictions_per_second = 0.0;
+
+    mutable std::mutex stats_mutex;
+    CacheMemoryStats published_stats;
+};
+
+} // namespace VideoCommon
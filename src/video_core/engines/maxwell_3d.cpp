@@ -5,6 +5,7 @@
 #include <cstring>
 #include <optional>
 #include "common/assert.h"
+#include "common/logging/trace.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "video_core/engines/maxwell_3d.h"
@@ -256,6 +257,9 @@ void Maxwell3D::CallMethod(u32 method, u32 method_argument, bool is_last_call) {
         FinishCBData();
     }
 
+    // Words streamed to a constant buffer are left out, uploads can be thousands of them
+    TRACE_SCOPE(HW_GPU, "Maxwell3D::CallMethod", {"method", method}, {"argument", method_argument});
+
     // It is an error to write to a register other than the current macro's ARG register before it
     // has finished execution.
     if (executing_macro != 0) {
@@ -207,6 +207,7 @@ void GPU::FlushCommands() {
 }
 
 void GPU::SyncGuestHost() {
+    rasterizer->SyncCPUWrites();
     rasterizer->SyncGuestHost();
 }
 
@@ -46,6 +46,8 @@ static void RunThread(Core::System& system, VideoCore::RendererBase& renderer,
             dma_pusher.Push(std::move(submit_list->entries));
             dma_pusher.DispatchCalls();
         } else if (const auto* data = std::get_if<SwapBuffersCommand>(&next.data)) {
+            // The framebuffer may have been written by the CPU
+            rasterizer->SyncCPUWrites();
             renderer.SwapBuffers(data->framebuffer ? &*data->framebuffer : nullptr);
         } else if (std::holds_alternative<OnCommandListEndCommand>(next.data)) {
             rasterizer->ReleaseFences();
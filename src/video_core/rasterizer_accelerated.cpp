@@ -2,11 +2,15 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
+#include <memory>
+#include <mutex>
 
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/div_ceil.h"
+#include "common/settings.h"
 #include "core/memory.h"
 #include "video_core/rasterizer_accelerated.h"
 
@@ -14,58 +18,212 @@ namespace VideoCore {
 
 using namespace Core::Memory;
 
-RasterizerAccelerated::RasterizerAccelerated(Memory& cpu_memory_) : cpu_memory{cpu_memory_} {}
+namespace {
+/// Lowest bit of every 16-bit lane of a table word
+constexpr u64 LANE_ONES = 0x0001'0001'0001'0001ULL;
+constexpr u64 LANE_LOW_BITS = 0x7fff'7fff'7fff'7fffULL;
 
-RasterizerAccelerated::~RasterizerAccelerated() = default;
+/// Returns the highest bit of every lane in [lane_begin, lane_end) set
+constexpr u64 LaneMask(u64 lane_begin, u64 lane_end) {
+    const u64 end_mask = lane_end == 4 ? ~0ULL : (1ULL << (lane_end * 16)) - 1;
+    const u64 begin_mask = (1ULL << (lane_begin * 16)) - 1;
+    return ~LANE_LOW_BITS & end_mask & ~begin_mask;
+}
+
+/// Returns the highest bit set in every lane of value that is zero
+constexpr u64 ZeroLanes(u64 value) {
+    return ~(((value & LANE_LOW_BITS) + LANE_LOW_BITS) | value) & ~LANE_LOW_BITS;
+}
+
+/// Calls func(run_begin, run_end, value) for each run of pages in [page_begin, page_end) where
+/// pred(page) returns the same value
+template <typename Pred, typename Func>
+void ForEachPageRun(u64 page_begin, u64 page_end, Pred&& pred, Func&& func) {
+    u64 run_begin = page_begin;
+    bool run_value = false;
+    for (u64 page = page_begin; page < page_end; ++page) {
+        const bool value = pred(page);
+        if (page != run_begin && value != run_value) {
+            func(run_begin, page, run_value);
+            run_begin = page;
+        }
+        run_value = value;
+    }
+    if (run_begin != page_end) {
+        func(run_begin, page_end, run_value);
+    }
+}
+} // Anonymous namespace
+
+RasterizerAccelerated::RasterizerAccelerated(Memory& cpu_memory_)
+    : cpu_memory{cpu_memory_}, use_write_tracking{Settings::IsWriteTrackingEnabled() &&
+                                                  cpu_memory.IsWriteTrackingSupported()} {}
+
+RasterizerAccelerated::~RasterizerAccelerated() {
+    for (std::atomic<Leaf*>& leaf : cached_pages) {
+        delete leaf.load(std::memory_order_relaxed);
+    }
+}
 
 void RasterizerAccelerated::UpdatePagesCachedCount(VAddr addr, u64 size, int delta) {
-    u64 uncache_begin = 0;
-    u64 cache_begin = 0;
-    u64 uncache_bytes = 0;
-    u64 cache_bytes = 0;
+    ASSERT_MSG(delta == 1 || delta == -1, "Delta must be 1 or -1!");
+
+    // Pages whose count went from zero to one or from one to zero are marked in runs
+    u64 run_begin = 0;
+    u64 run_pages = 0;
+    const auto flush_run = [&] {
+        if (run_pages > 0) {
+            MarkRegionCached(run_begin << PAGE_BITS, run_pages << PAGE_BITS, delta > 0);
+            run_pages = 0;
+        }
+    };
 
-    std::atomic_thread_fence(std::memory_order_acquire);
     const u64 page_end = Common::DivCeil(addr + size, PAGE_SIZE);
-    for (u64 page = addr >> PAGE_BITS; page != page_end; ++page) {
-        std::atomic_uint16_t& count = cached_pages.at(page >> 2).Count(page);
+    ASSERT_MSG(page_end <= NUM_PAGES, "Address 0x{:x} is out of range!", addr + size);
+    u64 page = addr >> PAGE_BITS;
+    while (page < page_end) {
+        // Updates every page of the range that lives in this word with a single operation
+        const u64 word_index = page / PAGES_PER_WORD;
+        const u64 lane_begin = page % PAGES_PER_WORD;
+        const u64 lane_end = std::min(PAGES_PER_WORD, lane_begin + page_end - page);
+        const u64 range_mask = LaneMask(lane_begin, lane_end);
+        const u64 lanes = range_mask >> 15;
 
+        Leaf& leaf = GetLeaf(word_index / WORDS_PER_LEAF);
+        std::atomic<u64>& word = leaf.counts[word_index % WORDS_PER_LEAF];
+        u64 transitions;
         if (delta > 0) {
-            ASSERT_MSG(count.load(std::memory_order::relaxed) < UINT16_MAX, "Count may overflow!");
-        } else if (delta < 0) {
-            ASSERT_MSG(count.load(std::memory_order::relaxed) > 0, "Count may underflow!");
+            ASSERT_MSG((ZeroLanes(~word.load(std::memory_order_relaxed)) & range_mask) == 0,
+                       "Count may overflow!");
+            const u64 old_counts = word.fetch_add(lanes, std::memory_order_acq_rel);
+            transitions = ZeroLanes(old_counts) & range_mask;
         } else {
-            ASSERT_MSG(false, "Delta must be non-zero!");
+            ASSERT_MSG((ZeroLanes(word.load(std::memory_order_relaxed)) & range_mask) == 0,
+                       "Count may underflow!");
+            const u64 old_counts = word.fetch_sub(lanes, std::memory_order_acq_rel);
+            transitions = ZeroLanes(old_counts ^ LANE_ONES) & range_mask;
         }
 
-        // Adds or subtracts 1, as count is a unsigned 8-bit value
-        count.fetch_add(static_cast<u16>(delta), std::memory_order_release);
-
-        // Assume delta is either -1 or 1
-        if (count.load(std::memory_order::relaxed) == 0) {
-            if (uncache_bytes == 0) {
-                uncache_begin = page;
+        if (transitions == range_mask) {
+            if (run_pages == 0) {
+                run_begin = page;
+            }
+            run_pages += lane_end - lane_begin;
+        } else if (transitions == 0) {
+            flush_run();
+        } else {
+            for (u64 lane = lane_begin; lane < lane_end; ++lane) {
+                if ((transitions & LaneMask(lane, lane + 1)) == 0) {
+                    flush_run();
+                    continue;
+                }
+                if (run_pages == 0) {
+                    run_begin = word_index * PAGES_PER_WORD + lane;
+                }
+                ++run_pages;
             }
-            uncache_bytes += PAGE_SIZE;
-        } else if (uncache_bytes > 0) {
-            cpu_memory.RasterizerMarkRegionCached(uncache_begin << PAGE_BITS, uncache_bytes, false);
-            uncache_bytes = 0;
         }
-        if (count.load(std::memory_order::relaxed) == 1 && delta > 0) {
-            if (cache_bytes == 0) {
-                cache_begin = page;
+        page += lane_end - lane_begin;
+    }
+    flush_run();
+}
+
+void RasterizerAccelerated::SyncCPUWrites() {
+    if (!use_write_tracking) {
+        return;
+    }
+    // Written pages that are still cached are protected again before the caches are notified, so
+    // writes after this point are found on the next sync
+    for (const auto& [addr, size] : cpu_memory.RasterizerPopWrittenRegions()) {
+        OnCPUWrite(addr, size);
+    }
+}
+
+void RasterizerAccelerated::MarkRegionGpuModified(VAddr addr, u64 size) {
+    if (!use_write_tracking) {
+        return;
+    }
+    // CPU reads of GPU modified data have to reach the caches to be flushed, so these pages stop
+    // being tracked and are marked through the page types instead until they are uncached
+    const u64 page_begin = addr >> PAGE_BITS;
+    const u64 page_end = Common::DivCeil(addr + size, PAGE_SIZE);
+    ASSERT_MSG(page_end <= NUM_PAGES, "Address 0x{:x} is out of range!", addr + size);
+    std::scoped_lock lock{gpu_modified_mutex};
+    ForEachPageRun(
+        page_begin, page_end,
+        [this](u64 page) { return !IsGpuModified(page) && CachedCount(page) != 0; },
+        [this](u64 run_begin, u64 run_end, bool is_switched) {
+            if (!is_switched) {
+                return;
+            }
+            const VAddr run_addr = run_begin << PAGE_BITS;
+            const u64 run_size = (run_end - run_begin) << PAGE_BITS;
+            SetGpuModified(run_begin, run_end, true);
+            cpu_memory.RasterizerTrackRegionWrites(run_addr, run_size, false);
+            cpu_memory.RasterizerMarkRegionCached(run_addr, run_size, true);
+        });
+}
+
+void RasterizerAccelerated::MarkRegionCached(VAddr addr, u64 size, bool cached) {
+    if (!use_write_tracking) {
+        cpu_memory.RasterizerMarkRegionCached(addr, size, cached);
+        return;
+    }
+    std::scoped_lock lock{gpu_modified_mutex};
+    ForEachPageRun(
+        addr >> PAGE_BITS, (addr + size) >> PAGE_BITS,
+        [this](u64 page) { return IsGpuModified(page); },
+        [this, cached](u64 run_begin, u64 run_end, bool is_gpu_modified) {
+            const VAddr run_addr = run_begin << PAGE_BITS;
+            const u64 run_size = (run_end - run_begin) << PAGE_BITS;
+            if (!is_gpu_modified) {
+                cpu_memory.RasterizerTrackRegionWrites(run_addr, run_size, cached);
+            } else if (!cached) {
+                SetGpuModified(run_begin, run_end, false);
+                cpu_memory.RasterizerMarkRegionCached(run_addr, run_size, false);
             }
-            cache_bytes += PAGE_SIZE;
-        } else if (cache_bytes > 0) {
-            cpu_memory.RasterizerMarkRegionCached(cache_begin << PAGE_BITS, cache_bytes, true);
-            cache_bytes = 0;
+            // A page the GPU modified between its count being raised and this call is already
+            // marked as cached through its page type
+        });
+}
+
+u64 RasterizerAccelerated::CachedCount(u64 page) {
+    const Leaf& leaf = GetLeaf(page / PAGES_PER_LEAF);
+    const u64 word = leaf.counts[page % PAGES_PER_LEAF / PAGES_PER_WORD].load(
+        std::memory_order_acquire);
+    return (word >> (page % PAGES_PER_WORD * 16)) & 0x7fff;
+}
+
+bool RasterizerAccelerated::IsGpuModified(u64 page) {
+    const Leaf& leaf = GetLeaf(page / PAGES_PER_LEAF);
+    const u64 bit = page % PAGES_PER_LEAF;
+    return ((leaf.gpu_modified[bit / 64] >> (bit % 64)) & 1) != 0;
+}
+
+void RasterizerAccelerated::SetGpuModified(u64 page_begin, u64 page_end, bool modified) {
+    for (u64 page = page_begin; page < page_end; ++page) {
+        Leaf& leaf = GetLeaf(page / PAGES_PER_LEAF);
+        const u64 bit = page % PAGES_PER_LEAF;
+        if (modified) {
+            leaf.gpu_modified[bit / 64] |= 1ULL << (bit % 64);
+        } else {
+            leaf.gpu_modified[bit / 64] &= ~(1ULL << (bit % 64));
         }
     }
-    if (uncache_bytes > 0) {
-        cpu_memory.RasterizerMarkRegionCached(uncache_begin << PAGE_BITS, uncache_bytes, false);
+}
+
+RasterizerAccelerated::Leaf& RasterizerAccelerated::GetLeaf(u64 index) {
+    std::atomic<Leaf*>& slot = cached_pages[index];
+    Leaf* leaf = slot.load(std::memory_order_acquire);
+    if (leaf != nullptr) {
+        return *leaf;
     }
-    if (cache_bytes > 0) {
-        cpu_memory.RasterizerMarkRegionCached(cache_begin << PAGE_BITS, cache_bytes, true);
+    // Another thread may be allocating the same leaf, the first one to publish it wins
+    auto new_leaf = std::make_unique<Leaf>();
+    if (slot.compare_exchange_strong(leaf, new_leaf.get(), std::memory_order_acq_rel)) {
+        return *new_leaf.release();
     }
+    return *leaf;
 }
 
 } // namespace VideoCore
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <atomic>
+#include <mutex>
 
 #include "common/common_types.h"
 #include "video_core/rasterizer_interface.h"
@@ -24,26 +25,51 @@ public:
 
     void UpdatePagesCachedCount(VAddr addr, u64 size, int delta) override;
 
+    void SyncCPUWrites() override;
+
+    void MarkRegionGpuModified(VAddr addr, u64 size) override;
+
 private:
-    class CacheEntry final {
-    public:
-        CacheEntry() = default;
+    /// Marks a region as cached or uncached, either through the page types or by tracking writes
+    void MarkRegionCached(VAddr addr, u64 size, bool cached);
+
+    /// Returns the number of objects cached in the given page
+    u64 CachedCount(u64 page);
+
+    /// Returns whether the GPU has written to the given page since it was cached
+    bool IsGpuModified(u64 page);
 
-        std::atomic_uint16_t& Count(std::size_t page) {
-            return values[page & 3];
-        }
+    /// Sets or clears the GPU modified bit of each page in [page_begin, page_end)
+    void SetGpuModified(u64 page_begin, u64 page_end, bool modified);
 
-        const std::atomic_uint16_t& Count(std::size_t page) const {
-            return values[page & 3];
-        }
+    /// Each word of the table packs the cached counts of this many consecutive pages
+    static constexpr u64 PAGES_PER_WORD = 4;
+    static constexpr u64 WORDS_PER_LEAF = 0x1000;
+    static constexpr u64 PAGES_PER_LEAF = WORDS_PER_LEAF * PAGES_PER_WORD;
+    /// The table covers 38-bit guest addresses
+    static constexpr u64 NUM_PAGES = 1ULL << 26;
+    static constexpr u64 NUM_LEAVES = NUM_PAGES / PAGES_PER_LEAF;
 
-    private:
-        std::array<std::atomic_uint16_t, 4> values{};
+    struct Leaf {
+        /// 16-bit cached counts, packed PAGES_PER_WORD to a word
+        std::array<std::atomic<u64>, WORDS_PER_LEAF> counts{};
+        /// Cached pages the GPU has written to, guarded by gpu_modified_mutex
+        std::array<u64, PAGES_PER_LEAF / 64> gpu_modified{};
     };
-    static_assert(sizeof(CacheEntry) == 8, "CacheEntry should be 8 bytes!");
 
-    std::array<CacheEntry, 0x1000000> cached_pages;
+    /// Returns the leaf with the given index, allocating it if it has never been touched
+    Leaf& GetLeaf(u64 index);
+
+    /// Two level table of 16-bit cached counts, leaves are only allocated for touched regions
+    std::array<std::atomic<Leaf*>, NUM_LEAVES> cached_pages{};
+
+    /// Serializes switching pages between tracked writes and intercepted accesses
+    std::mutex gpu_modified_mutex;
+
     Core::Memory::Memory& cpu_memory;
+    /// Whether CPU writes to cached pages are found with page protection instead of page types,
+    /// pages with GPU modified data are always marked through the page types
+    const bool use_write_tracking;
 };
 
 } // namespace VideoCore
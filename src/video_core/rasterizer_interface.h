@@ -9,6 +9,7 @@
 #include <span>
 #include <stop_token>
 #include "common/common_types.h"
+#include "video_core/cache_budget.h"
 #include "video_core/engines/fermi_2d.h"
 #include "video_core/gpu.h"
 #include "video_core/guest_driver.h"
@@ -24,6 +25,12 @@ enum class QueryType {
 };
 constexpr std::size_t NumQueryTypes = 1;
 
+/// Memory statistics of the texture and buffer caches
+struct CacheMemoryStats {
+    VideoCommon::CacheMemoryStats textures;
+    VideoCommon::CacheMemoryStats buffers;
+};
+
 enum class LoadCallbackStage {
     Prepare,
     Build,
@@ -122,6 +129,17 @@ public:
     /// Increase/decrease the number of object in pages touching the specified region
     virtual void UpdatePagesCachedCount(VAddr addr, u64 size, int delta) {}
 
+    /// Notify the caches of the CPU writes to cached pages recorded since the last call
+    virtual void SyncCPUWrites() {}
+
+    /// Notify that the GPU has written to the specified region of cached pages
+    virtual void MarkRegionGpuModified(VAddr addr, u64 size) {}
+
+    /// Return the memory statistics of the caches, safe to call from any thread
+    [[nodiscard]] virtual CacheMemoryStats GetCacheMemoryStats() const {
+        return {};
+    }
+
     /// Initialize disk cached resources for the game being emulated
     virtual void LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                                    const DiskResourceLoadCallback& callback) {}
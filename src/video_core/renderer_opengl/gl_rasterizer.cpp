@@ -677,6 +677,13 @@ void RasterizerOpenGL::TickFrame() {
     }
 }
 
+VideoCore::CacheMemoryStats RasterizerOpenGL::GetCacheMemoryStats() const {
+    return {
+        .textures = texture_cache.GetMemoryStats(),
+        .buffers = buffer_cache.GetMemoryStats(),
+    };
+}
+
 bool RasterizerOpenGL::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Surface& src,
                                              const Tegra::Engines::Fermi2D::Surface& dst,
                                              const Tegra::Engines::Fermi2D::Config& copy_config) {
@@ -39,11 +39,35 @@ constexpr std::array POLYGON_OFFSET_ENABLE_LUT = {
     POLYGON, // Patches
 };
 
+using HashBlock = FixedPipelineState::HashBlock;
+
+template <typename T>
+u64 HashBytes(const T& value) noexcept {
+    return Common::CityHash64(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+size_t CombineBlockHashes(const FixedPipelineState& state,
+                          const std::array<u64, FixedPipelineState::NUM_HASH_BLOCKS>& hashes) {
+    size_t hash = 0;
+    for (size_t block = 0; block < hashes.size(); ++block) {
+        // Dynamic state is not part of the key when the device supports it
+        if (block == static_cast<size_t>(HashBlock::DynamicState) &&
+            state.no_extended_dynamic_state == 0) {
+            continue;
+        }
+        boost::hash_combine(hash, hashes[block]);
+    }
+    return hash;
+}
+
 } // Anonymous namespace
 
-void FixedPipelineState::Refresh(Tegra::Engines::Maxwell3D& maxwell3d,
-                                 bool has_extended_dynamic_state) {
+u32 FixedPipelineState::Refresh(Tegra::Engines::Maxwell3D& maxwell3d,
+                                bool has_extended_dynamic_state) {
     const Maxwell& regs = maxwell3d.regs;
+    const std::array old_common{raw1, raw2, alpha_test_ref, point_size};
+    u32 refreshed_blocks = 0;
+
     const std::array enabled_lut{
         regs.polygon_offset_point_enable,
         regs.polygon_offset_line_enable,
@@ -78,6 +102,7 @@ void FixedPipelineState::Refresh(Tegra::Engines::Maxwell3D& maxwell3d,
 
     if (maxwell3d.dirty.flags[Dirty::InstanceDivisors]) {
         maxwell3d.dirty.flags[Dirty::InstanceDivisors] = false;
+        refreshed_blocks |= HashBlockBit(HashBlock::BindingDivisors);
         for (size_t index = 0; index < Maxwell::NumVertexArrays; ++index) {
             const bool is_enabled = regs.instanced_arrays.IsInstancingEnabled(index);
             binding_divisors[index] = is_enabled ? regs.vertex_array[index].divisor : 0;
@@ -85,6 +110,7 @@ void FixedPipelineState::Refresh(Tegra::Engines::Maxwell3D& maxwell3d,
     }
     if (maxwell3d.dirty.flags[Dirty::VertexAttributes]) {
         maxwell3d.dirty.flags[Dirty::VertexAttributes] = false;
+        refreshed_blocks |= HashBlockBit(HashBlock::Attributes);
         for (size_t index = 0; index < Maxwell::NumVertexAttributes; ++index) {
             const auto& input = regs.vertex_attrib_format[index];
             auto& attribute = attributes[index];
@@ -98,12 +124,14 @@ void FixedPipelineState::Refresh(Tegra::Engines::Maxwell3D& maxwell3d,
     }
     if (maxwell3d.dirty.flags[Dirty::Blending]) {
         maxwell3d.dirty.flags[Dirty::Blending] = false;
+        refreshed_blocks |= HashBlockBit(HashBlock::Attachments);
         for (size_t index = 0; index < attachments.size(); ++index) {
             attachments[index].Refresh(regs, index);
         }
     }
     if (maxwell3d.dirty.flags[Dirty::ViewportSwizzles]) {
         maxwell3d.dirty.flags[Dirty::ViewportSwizzles] = false;
+        refreshed_blocks |= HashBlockBit(HashBlock::ViewportSwizzles);
         const auto& transform = regs.viewport_transform;
         std::ranges::transform(transform, viewport_swizzles.begin(), [](const auto& viewport) {
             return static_cast<u16>(viewport.swizzle.raw);
@@ -111,8 +139,17 @@ void FixedPipelineState::Refresh(Tegra::Engines::Maxwell3D& maxwell3d,
     }
     if (!has_extended_dynamic_state) {
         no_extended_dynamic_state.Assign(1);
+        const DynamicState old_dynamic_state = dynamic_state;
         dynamic_state.Refresh(regs);
+        if (std::memcmp(&old_dynamic_state, &dynamic_state, sizeof(DynamicState)) != 0) {
+            refreshed_blocks |= HashBlockBit(HashBlock::DynamicState);
+        }
+    }
+    // The common block is repacked on every draw, only hash it again when it changes
+    if (old_common != std::array{raw1, raw2, alpha_test_ref, point_size}) {
+        refreshed_blocks |= HashBlockBit(HashBlock::Common);
     }
+    return refreshed_blocks;
 }
 
 void FixedPipelineState::BlendingAttachment::Refresh(const Maxwell& regs, size_t index) {
@@ -191,9 +228,45 @@ void FixedPipelineState::DynamicState::Refresh(const Maxwell& regs) {
     });
 }
 
+u64 FixedPipelineState::HashBlockData(HashBlock block) const noexcept {
+    switch (block) {
+    case HashBlock::Common: {
+        const char* const data = reinterpret_cast<const char*>(this);
+        const char* const end = reinterpret_cast<const char*>(&binding_divisors);
+        return Common::CityHash64(data, static_cast<size_t>(end - data));
+    }
+    case HashBlock::BindingDivisors:
+        return HashBytes(binding_divisors);
+    case HashBlock::Attributes:
+        return HashBytes(attributes);
+    case HashBlock::Attachments:
+        return HashBytes(attachments);
+    case HashBlock::ViewportSwizzles:
+        return HashBytes(viewport_swizzles);
+    case HashBlock::DynamicState:
+        return HashBytes(dynamic_state);
+    }
+    return 0;
+}
+
 size_t FixedPipelineState::Hash() const noexcept {
-    const u64 hash = Common::CityHash64(reinterpret_cast<const char*>(this), Size());
-    return static_cast<size_t>(hash);
+    std::array<u64, NUM_HASH_BLOCKS> hashes;
+    for (size_t block = 0; block < NUM_HASH_BLOCKS; ++block) {
+        hashes[block] = HashBlockData(static_cast<HashBlock>(block));
+    }
+    return CombineBlockHashes(*this, hashes);
+}
+
+size_t FixedPipelineStateHasher::Update(const FixedPipelineState& state,
+                                        u32 refreshed_blocks) noexcept {
+    const u32 blocks = refreshed_blocks | stale_blocks;
+    stale_blocks = 0;
+    for (size_t block = 0; block < block_hashes.size(); ++block) {
+        if ((blocks & (1U << block)) != 0) {
+            block_hashes[block] = state.HashBlockData(static_cast<HashBlock>(block));
+        }
+    }
+    return CombineBlockHashes(state, block_hashes);
 }
 
 bool FixedPipelineState::operator==(const FixedPipelineState& rhs) const noexcept {
@@ -18,6 +18,22 @@ namespace Vulkan {
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
 struct FixedPipelineState {
+    /// Blocks of the state hashed separately, so only the refreshed ones have to be hashed again
+    enum class HashBlock : u32 {
+        Common,
+        BindingDivisors,
+        Attributes,
+        Attachments,
+        ViewportSwizzles,
+        DynamicState,
+    };
+    static constexpr size_t NUM_HASH_BLOCKS = 6;
+    static constexpr u32 ALL_HASH_BLOCKS = (1U << NUM_HASH_BLOCKS) - 1;
+
+    static constexpr u32 HashBlockBit(HashBlock block) noexcept {
+        return 1U << static_cast<u32>(block);
+    }
+
     static u32 PackComparisonOp(Maxwell::ComparisonOp op) noexcept;
     static Maxwell::ComparisonOp UnpackComparisonOp(u32 packed) noexcept;
 
@@ -197,7 +213,13 @@ struct FixedPipelineState {
     std::array<u16, Maxwell::NumViewports> viewport_swizzles;
     DynamicState dynamic_state;
 
-    void Refresh(Tegra::Engines::Maxwell3D& maxwell3d, bool has_extended_dynamic_state);
+    /// Repacks the state from the registers, blocks tracked by dirty flags are only repacked when
+    /// their registers have changed
+    /// @returns Mask of the hash blocks that may have changed
+    u32 Refresh(Tegra::Engines::Maxwell3D& maxwell3d, bool has_extended_dynamic_state);
+
+    /// Returns the hash of a single block of the state
+    u64 HashBlockData(HashBlock block) const noexcept;
 
     size_t Hash() const noexcept;
 
@@ -216,6 +238,18 @@ static_assert(std::has_unique_object_representations_v<FixedPipelineState>);
 static_assert(std::is_trivially_copyable_v<FixedPipelineState>);
 static_assert(std::is_trivially_constructible_v<FixedPipelineState>);
 
+/// Keeps the hash of a fixed pipeline state up to date, hashing again only its refreshed blocks
+class FixedPipelineStateHasher {
+public:
+    /// Hashes again the given blocks of the state
+    /// @returns Hash of the whole state, equal to FixedPipelineState::Hash
+    size_t Update(const FixedPipelineState& state, u32 refreshed_blocks) noexcept;
+
+private:
+    std::array<u64, FixedPipelineState::NUM_HASH_BLOCKS> block_hashes{};
+    u32 stale_blocks = FixedPipelineState::ALL_HASH_BLOCKS;
+};
+
 } // namespace Vulkan
 
 namespace std {
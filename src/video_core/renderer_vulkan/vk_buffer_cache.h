@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <span>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
 #include "video_core/buffer_cache/buffer_cache.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_vulkan/vk_compute_pass.h"
@@ -57,9 +62,17 @@ public:
 
     [[nodiscard]] StagingBufferRef DownloadStagingBuffer(size_t size);
 
-    void CopyBuffer(VkBuffer src_buffer, VkBuffer dst_buffer,
+    void CopyBuffer(VkBuffer dst_buffer, VkBuffer src_buffer,
                     std::span<const VideoCommon::BufferCopy> copies);
 
+    /// Queues copies from a staging buffer, they are recorded on the next call to FlushUploads
+    void UploadBuffer(VkBuffer dst_buffer, VkBuffer src_buffer,
+                      std::span<const VideoCommon::BufferCopy> copies);
+
+    /// Records the queued uploads between a single pair of barriers, copies with the same source
+    /// and destination buffers are merged into one command
+    void FlushUploads();
+
     void BindIndexBuffer(PrimitiveTopology topology, IndexFormat index_format, u32 num_indices,
                          u32 base_vertex, VkBuffer buffer, u32 offset, u32 size);
 
@@ -86,6 +99,12 @@ public:
     }
 
 private:
+    struct UploadBatch {
+        VkBuffer dst_buffer;
+        VkBuffer src_buffer;
+        boost::container::small_vector<VkBufferCopy, 4> copies;
+    };
+
     void BindBuffer(VkBuffer buffer, u32 offset, u32 size) {
         update_descriptor_queue.AddBuffer(buffer, offset, size);
     }
@@ -100,6 +119,8 @@ private:
     StagingBufferPool& staging_pool;
     VKUpdateDescriptorQueue& update_descriptor_queue;
 
+    std::vector<UploadBatch> upload_batches;
+
     vk::Buffer quad_array_lut;
     MemoryCommit quad_array_lut_commit;
     VkIndexType quad_array_lut_index_type{};
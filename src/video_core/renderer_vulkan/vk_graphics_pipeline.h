@@ -24,7 +24,12 @@ struct GraphicsPipelineCacheKey {
     std::array<GPUVAddr, Maxwell::MaxShaderProgram> shaders;
     FixedPipelineState fixed_state;
 
-    std::size_t Hash() const noexcept;
+    /// Returns the hash of the key given the hash of its fixed state
+    std::size_t Hash(std::size_t fixed_state_hash) const noexcept;
+
+    std::size_t Hash() const noexcept {
+        return Hash(fixed_state.Hash());
+    }
 
     bool operator==(const GraphicsPipelineCacheKey& rhs) const noexcept;
 
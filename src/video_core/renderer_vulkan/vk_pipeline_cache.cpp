@@ -120,9 +120,13 @@ u32 FillDescriptorLayout(const ShaderEntries& entries,
 
 } // Anonymous namespace
 
-std::size_t GraphicsPipelineCacheKey::Hash() const noexcept {
-    const u64 hash = Common::CityHash64(reinterpret_cast<const char*>(this), Size());
-    return static_cast<std::size_t>(hash);
+std::size_t GraphicsPipelineCacheKey::Hash(std::size_t fixed_state_hash) const noexcept {
+    // The fixed state is hashed in blocks, hash the rest of the key and combine them
+    constexpr std::size_t head_size = sizeof(renderpass) + sizeof(shaders);
+    std::size_t hash = static_cast<std::size_t>(
+        Common::CityHash64(reinterpret_cast<const char*>(this), head_size));
+    boost::hash_combine(hash, fixed_state_hash);
+    return hash;
 }
 
 bool GraphicsPipelineCacheKey::operator==(const GraphicsPipelineCacheKey& rhs) const noexcept {
@@ -200,42 +204,55 @@ std::array<Shader*, Maxwell::MaxShaderProgram> VKPipelineCache::GetShaders() {
 }
 
 VKGraphicsPipeline* VKPipelineCache::GetGraphicsPipeline(
-    const GraphicsPipelineCacheKey& key, u32 num_color_buffers,
+    const GraphicsPipelineCacheKey& key, std::size_t key_hash, u32 num_color_buffers,
     VideoCommon::Shader::AsyncShaders& async_shaders) {
     MICROPROFILE_SCOPE(Vulkan_PipelineCache);
 
-    if (last_graphics_pipeline && last_graphics_key == key) {
+    if (last_graphics_pipeline && last_graphics_hash == key_hash && last_graphics_key == key) {
         return last_graphics_pipeline;
     }
     last_graphics_key = key;
+    last_graphics_hash = key_hash;
 
     if (device.UseAsynchronousShaders() && async_shaders.IsShaderAsync(gpu)) {
         std::unique_lock lock{pipeline_cache};
-        const auto [pair, is_cache_miss] = graphics_cache.try_emplace(key);
+        const auto [entry, is_cache_miss] = TryEmplaceGraphicsPipeline(key, key_hash);
         if (is_cache_miss) {
             gpu.ShaderNotify().MarkSharderBuilding();
-            LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
+            LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key_hash);
             const auto [program, bindings] = DecompileShaders(key.fixed_state);
             async_shaders.QueueVulkanShader(this, device, scheduler, descriptor_pool,
                                             update_descriptor_queue, bindings, program, key,
                                             num_color_buffers);
         }
-        last_graphics_pipeline = pair->second.get();
+        last_graphics_pipeline = entry->get();
         return last_graphics_pipeline;
     }
 
-    const auto [pair, is_cache_miss] = graphics_cache.try_emplace(key);
-    auto& entry = pair->second;
-    if (is_cache_miss) {
-        gpu.ShaderNotify().MarkSharderBuilding();
-        LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key.Hash());
-        const auto [program, bindings] = DecompileShaders(key.fixed_state);
-        entry = std::make_unique<VKGraphicsPipeline>(device, scheduler, descriptor_pool,
-                                                     update_descriptor_queue, key, bindings,
-                                                     program, num_color_buffers);
-        gpu.ShaderNotify().MarkShaderComplete();
+    // Asynchronous shader workers emplace their pipelines in the cache concurrently, the lock is
+    // released while the pipeline is built
+    std::unique_lock lock{pipeline_cache};
+    const auto [entry, is_cache_miss] = TryEmplaceGraphicsPipeline(key, key_hash);
+    if (!is_cache_miss) {
+        last_graphics_pipeline = entry->get();
+        return last_graphics_pipeline;
     }
-    last_graphics_pipeline = entry.get();
+    lock.unlock();
+
+    gpu.ShaderNotify().MarkSharderBuilding();
+    LOG_INFO(Render_Vulkan, "Compile 0x{:016X}", key_hash);
+    const auto [program, bindings] = DecompileShaders(key.fixed_state);
+    auto pipeline = std::make_unique<VKGraphicsPipeline>(device, scheduler, descriptor_pool,
+                                                         update_descriptor_queue, key, bindings,
+                                                         program, num_color_buffers);
+    gpu.ShaderNotify().MarkShaderComplete();
+
+    // Entries can be moved by insertions, look it up again instead of using the old pointer
+    lock.lock();
+    const auto it = graphics_cache.find(GraphicsKeyRef{key_hash, &key});
+    ASSERT_MSG(it != graphics_cache.end(), "Pipeline 0x{:016X} is not in the cache", key_hash);
+    it->second = std::move(pipeline);
+    last_graphics_pipeline = it->second.get();
     return last_graphics_pipeline;
 }
 
@@ -292,8 +309,14 @@ VKComputePipeline& VKPipelineCache::GetComputePipeline(const ComputePipelineCach
 
 void VKPipelineCache::EmplacePipeline(std::unique_ptr<VKGraphicsPipeline> pipeline) {
     gpu.ShaderNotify().MarkShaderComplete();
+    const GraphicsPipelineCacheKey key = pipeline->GetCacheKey();
     std::unique_lock lock{pipeline_cache};
-    graphics_cache.at(pipeline->GetCacheKey()) = std::move(pipeline);
+    const auto it = graphics_cache.find(GraphicsKeyRef{key.Hash(), &key});
+    if (it == graphics_cache.end()) {
+        // The shaders of the pipeline were removed while it was being built
+        return;
+    }
+    it->second = std::move(pipeline);
 }
 
 void VKPipelineCache::OnShaderRemoval(Shader* shader) {
@@ -309,16 +332,22 @@ void VKPipelineCache::OnShaderRemoval(Shader* shader) {
     };
 
     const GPUVAddr invalidated_addr = shader->GetGpuAddr();
+    std::unique_lock lock{pipeline_cache};
     for (auto it = graphics_cache.begin(); it != graphics_cache.end();) {
-        auto& entry = it->first;
-        if (std::find(entry.shaders.begin(), entry.shaders.end(), invalidated_addr) ==
-            entry.shaders.end()) {
+        const GraphicsPipelineCacheKey* const entry = it->first.key;
+        if (std::find(entry->shaders.begin(), entry->shaders.end(), invalidated_addr) ==
+            entry->shaders.end()) {
             ++it;
             continue;
         }
         Finish();
+        if (it->second.get() == last_graphics_pipeline) {
+            last_graphics_pipeline = nullptr;
+        }
+        free_graphics_keys.push_back(entry);
         it = graphics_cache.erase(it);
     }
+    lock.unlock();
     for (auto it = compute_cache.begin(); it != compute_cache.end();) {
         auto& entry = it->first;
         if (entry.shader != invalidated_addr) {
@@ -330,6 +359,35 @@ void VKPipelineCache::OnShaderRemoval(Shader* shader) {
     }
 }
 
+std::pair<std::unique_ptr<VKGraphicsPipeline>*, bool> VKPipelineCache::TryEmplaceGraphicsPipeline(
+    const GraphicsPipelineCacheKey& key, std::size_t key_hash) {
+    if (const auto it = graphics_cache.find(GraphicsKeyRef{key_hash, &key});
+        it != graphics_cache.end()) {
+        return {&it->second, false};
+    }
+    const GraphicsKeyRef stored_ref{key_hash, AllocateGraphicsKey(key)};
+    const auto [it, is_inserted] = graphics_cache.try_emplace(stored_ref);
+    return {&it->second, true};
+}
+
+const GraphicsPipelineCacheKey* VKPipelineCache::AllocateGraphicsKey(
+    const GraphicsPipelineCacheKey& key) {
+    GraphicsPipelineCacheKey* stored_key;
+    if (!free_graphics_keys.empty()) {
+        // Keys in the arena are only referenced as const from the map
+        stored_key = const_cast<GraphicsPipelineCacheKey*>(free_graphics_keys.back());
+        free_graphics_keys.pop_back();
+    } else {
+        if (graphics_key_chunk_usage == std::tuple_size_v<GraphicsKeyChunk>) {
+            graphics_key_chunks.push_back(std::make_unique<GraphicsKeyChunk>());
+            graphics_key_chunk_usage = 0;
+        }
+        stored_key = &(*graphics_key_chunks.back())[graphics_key_chunk_usage++];
+    }
+    *stored_key = key;
+    return stored_key;
+}
+
 std::pair<SPIRVProgram, std::vector<VkDescriptorSetLayoutBinding>>
 VKPipelineCache::DecompileShaders(const FixedPipelineState& fixed_state) {
     Specialization specialization;
@@ -15,6 +15,7 @@
 #include <boost/functional/hash.hpp>
 
 #include "common/common_types.h"
+#include "common/flat_hash_map.h"
 #include "video_core/engines/const_buffer_engine_interface.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/renderer_vulkan/fixed_pipeline_state.h"
@@ -128,8 +129,9 @@ public:
 
     std::array<Shader*, Maxwell::MaxShaderProgram> GetShaders();
 
+    /// Returns the graphics pipeline of key, key_hash must be equal to key.Hash()
     VKGraphicsPipeline* GetGraphicsPipeline(const GraphicsPipelineCacheKey& key,
-                                            u32 num_color_buffers,
+                                            std::size_t key_hash, u32 num_color_buffers,
                                             VideoCommon::Shader::AsyncShaders& async_shaders);
 
     VKComputePipeline& GetComputePipeline(const ComputePipelineCacheKey& key);
@@ -140,9 +142,37 @@ protected:
     void OnShaderRemoval(Shader* shader) final;
 
 private:
+    /// Key of a graphics pipeline stored in the key arena, with its precomputed hash
+    struct GraphicsKeyRef {
+        std::size_t hash;
+        const GraphicsPipelineCacheKey* key;
+    };
+
+    struct GraphicsKeyRefHash {
+        std::size_t operator()(const GraphicsKeyRef& ref) const noexcept {
+            return ref.hash;
+        }
+    };
+
+    struct GraphicsKeyRefEqual {
+        bool operator()(const GraphicsKeyRef& lhs, const GraphicsKeyRef& rhs) const noexcept {
+            return lhs.hash == rhs.hash && *lhs.key == *rhs.key;
+        }
+    };
+
+    using GraphicsKeyChunk = std::array<GraphicsPipelineCacheKey, 64>;
+
     std::pair<SPIRVProgram, std::vector<VkDescriptorSetLayoutBinding>> DecompileShaders(
         const FixedPipelineState& fixed_state);
 
+    /// Returns the entry of key, inserting an empty one when it's not in the cache
+    /// @returns Pointer to the entry and true if it was inserted
+    std::pair<std::unique_ptr<VKGraphicsPipeline>*, bool> TryEmplaceGraphicsPipeline(
+        const GraphicsPipelineCacheKey& key, std::size_t key_hash);
+
+    /// Copies a key into the key arena
+    const GraphicsPipelineCacheKey* AllocateGraphicsKey(const GraphicsPipelineCacheKey& key);
+
     Tegra::GPU& gpu;
     Tegra::Engines::Maxwell3D& maxwell3d;
     Tegra::Engines::KeplerCompute& kepler_compute;
@@ -159,11 +189,17 @@ private:
     std::array<Shader*, Maxwell::MaxShaderProgram> last_shaders{};
 
     GraphicsPipelineCacheKey last_graphics_key;
+    std::size_t last_graphics_hash = 0;
     VKGraphicsPipeline* last_graphics_pipeline = nullptr;
 
     std::mutex pipeline_cache;
-    std::unordered_map<GraphicsPipelineCacheKey, std::unique_ptr<VKGraphicsPipeline>>
+    Common::FlatHashMap<GraphicsKeyRef, std::unique_ptr<VKGraphicsPipeline>, GraphicsKeyRefHash,
+                        GraphicsKeyRefEqual>
         graphics_cache;
+    /// Graphics keys are stored out of the map, so its slots stay small to probe
+    std::vector<std::unique_ptr<GraphicsKeyChunk>> graphics_key_chunks;
+    std::size_t graphics_key_chunk_usage = std::tuple_size_v<GraphicsKeyChunk>;
+    std::vector<const GraphicsPipelineCacheKey*> free_graphics_keys;
     std::unordered_map<ComputePipelineCacheKey, std::unique_ptr<VKComputePipeline>> compute_cache;
 };
 
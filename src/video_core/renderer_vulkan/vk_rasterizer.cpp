@@ -270,7 +270,10 @@ void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
 
     query_cache.UpdateCounters();
 
-    graphics_key.fixed_state.Refresh(maxwell3d, device.IsExtExtendedDynamicStateSupported());
+    const u32 refreshed_blocks =
+        graphics_key.fixed_state.Refresh(maxwell3d, device.IsExtExtendedDynamicStateSupported());
+    const size_t fixed_state_hash =
+        fixed_state_hasher.Update(graphics_key.fixed_state, refreshed_blocks);
 
     std::scoped_lock lock{buffer_cache.mutex, texture_cache.mutex};
 
@@ -285,8 +288,9 @@ void RasterizerVulkan::Draw(bool is_indexed, bool is_instanced) {
     const Framebuffer* const framebuffer = texture_cache.GetFramebuffer();
     graphics_key.renderpass = framebuffer->RenderPass();
 
-    VKGraphicsPipeline* const pipeline = pipeline_cache.GetGraphicsPipeline(
-        graphics_key, framebuffer->NumColorBuffers(), async_shaders);
+    VKGraphicsPipeline* const pipeline =
+        pipeline_cache.GetGraphicsPipeline(graphics_key, graphics_key.Hash(fixed_state_hash),
+                                           framebuffer->NumColorBuffers(), async_shaders);
     if (pipeline == nullptr || pipeline->GetHandle() == VK_NULL_HANDLE) {
         // Async graphics pipeline was not ready.
         return;
@@ -637,6 +641,13 @@ void RasterizerVulkan::TickFrame() {
     }
 }
 
+VideoCore::CacheMemoryStats RasterizerVulkan::GetCacheMemoryStats() const {
+    return {
+        .textures = texture_cache.GetMemoryStats(),
+        .buffers = buffer_cache.GetMemoryStats(),
+    };
+}
+
 bool RasterizerVulkan::AccelerateSurfaceCopy(const Tegra::Engines::Fermi2D::Surface& src,
                                              const Tegra::Engines::Fermi2D::Surface& dst,
                                              const Tegra::Engines::Fermi2D::Config& copy_config) {
@@ -86,6 +86,7 @@ public:
                                const Tegra::Engines::Fermi2D::Config& copy_config) override;
     bool AccelerateDisplay(const Tegra::FramebufferConfig& config, VAddr framebuffer_addr,
                            u32 pixel_stride) override;
+    VideoCore::CacheMemoryStats GetCacheMemoryStats() const override;
 
     VideoCommon::Shader::AsyncShaders& GetAsyncShaders() {
         return async_shaders;
@@ -177,6 +178,7 @@ private:
     ASTCDecoderPass astc_decoder_pass;
 
     GraphicsPipelineCacheKey graphics_key;
+    FixedPipelineStateHasher fixed_state_hasher;
 
     TextureCacheRuntime texture_cache_runtime;
     TextureCache texture_cache;
@@ -2,13 +2,17 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <thread>
 #include <utility>
 
+#include "common/logging/log.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
 #include "common/thread.h"
 #include "video_core/renderer_vulkan/vk_command_pool.h"
 #include "video_core/renderer_vulkan/vk_master_semaphore.h"
@@ -23,6 +27,18 @@ namespace Vulkan {
 
 MICROPROFILE_DECLARE(Vulkan_WaitForWorker);
 
+namespace {
+/// Number of dispatches recorded in a command buffer before a new one is started
+constexpr size_t DISPATCHES_PER_SEGMENT = 8;
+
+size_t NumRecorderThreads() {
+    if (!Settings::values.use_multithreaded_recording.GetValue()) {
+        return 0;
+    }
+    return std::clamp<size_t>(std::thread::hardware_concurrency() / 4, 2, 4);
+}
+} // Anonymous namespace
+
 void VKScheduler::CommandChunk::ExecuteAll(vk::CommandBuffer cmdbuf) {
     auto command = first;
     while (command != nullptr) {
@@ -41,15 +57,35 @@ VKScheduler::VKScheduler(const Device& device_, StateTracker& state_tracker_)
     : device{device_}, state_tracker{state_tracker_},
       master_semaphore{std::make_unique<MasterSemaphore>(device)},
       command_pool{std::make_unique<CommandPool>(*master_semaphore, device)} {
+    const size_t num_recorders = NumRecorderThreads();
+    for (size_t i = 0; i < num_recorders; ++i) {
+        auto& recorder = recorders.emplace_back(std::make_unique<Recorder>());
+        recorder->command_pool = std::make_unique<CommandPool>(*master_semaphore, device);
+    }
     AcquireNewChunk();
     AllocateNewContext();
-    worker_thread = std::thread(&VKScheduler::WorkerThread, this);
+    if (recorders.empty()) {
+        worker_thread = std::thread(&VKScheduler::WorkerThread, this);
+    }
+    for (const auto& recorder : recorders) {
+        recorder->thread = std::thread(&VKScheduler::RecorderThread, this, std::ref(*recorder));
+    }
+    if (!recorders.empty()) {
+        LOG_INFO(Render_Vulkan, "Recording command buffers in {} threads", recorders.size());
+    }
 }
 
 VKScheduler::~VKScheduler() {
-    quit = true;
-    cv.notify_all();
-    worker_thread.join();
+    if (worker_thread.joinable()) {
+        quit = true;
+        cv.notify_all();
+        worker_thread.join();
+    }
+    for (const auto& recorder : recorders) {
+        // An empty task stops the recorder
+        recorder->queue.Push(RecordTask{});
+        recorder->thread.join();
+    }
 }
 
 void VKScheduler::Flush(VkSemaphore semaphore) {
@@ -66,8 +102,13 @@ void VKScheduler::Finish(VkSemaphore semaphore) {
 
 void VKScheduler::WaitWorker() {
     MICROPROFILE_SCOPE(Vulkan_WaitForWorker);
-    DispatchWork();
+    DispatchChunk();
 
+    if (!recorders.empty()) {
+        std::unique_lock lock{recorded_mutex};
+        recorded_cv.wait(lock, [this] { return num_recorded_chunks == num_dispatched_chunks; });
+        return;
+    }
     bool finished = false;
     do {
         cv.notify_all();
@@ -77,12 +118,11 @@ void VKScheduler::WaitWorker() {
 }
 
 void VKScheduler::DispatchWork() {
-    if (chunk->Empty()) {
+    if (!recorders.empty() && ++segment_dispatches >= DISPATCHES_PER_SEGMENT) {
+        EndSegment();
         return;
     }
-    chunk_queue.Push(std::move(chunk));
-    cv.notify_all();
-    AcquireNewChunk();
+    DispatchChunk();
 }
 
 void VKScheduler::RequestRenderpass(const Framebuffer* framebuffer) {
@@ -149,14 +189,102 @@ void VKScheduler::WorkerThread() {
     } while (!quit);
 }
 
+void VKScheduler::RecorderThread(Recorder& recorder) {
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+    vk::CommandBuffer cmdbuf;
+    while (true) {
+        RecordTask task = recorder.queue.PopWait();
+        if (!task.chunk) {
+            break;
+        }
+        if (!task.segment->cmdbuf) {
+            // Segments assigned to a recorder are closed before the next one is opened
+            cmdbuf = vk::CommandBuffer(recorder.command_pool->Commit(), device.GetDispatchLoader());
+            cmdbuf.Begin({
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                .pNext = nullptr,
+                .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                .pInheritanceInfo = nullptr,
+            });
+            task.segment->cmdbuf = *cmdbuf.address();
+        }
+        task.chunk->ExecuteAll(cmdbuf);
+        if (task.ends_segment) {
+            cmdbuf.End();
+        }
+        chunk_reserve.Push(std::move(task.chunk));
+        {
+            std::scoped_lock lock{recorded_mutex};
+            ++num_recorded_chunks;
+        }
+        recorded_cv.notify_all();
+    }
+}
+
+void VKScheduler::DispatchChunk() {
+    if (chunk->Empty()) {
+        return;
+    }
+    if (!recorders.empty()) {
+        PushRecordTask(false);
+        return;
+    }
+    chunk_queue.Push(std::move(chunk));
+    cv.notify_all();
+    AcquireNewChunk();
+}
+
+void VKScheduler::EndSegment() {
+    // Command buffers can't share render passes nor dynamic state, leave a clean state behind
+    query_cache->DisableStreams();
+    EndRenderPass();
+    InvalidateState();
+    segment_dispatches = 0;
+    if (!open_segment && chunk->Empty()) {
+        return;
+    }
+    PushRecordTask(true);
+}
+
+void VKScheduler::PushRecordTask(bool ends_segment) {
+    if (!open_segment) {
+        open_segment = &segments.emplace_back();
+        open_recorder = recorders[next_recorder].get();
+        next_recorder = (next_recorder + 1) % recorders.size();
+    }
+    open_recorder->queue.Push(RecordTask{
+        .segment = open_segment,
+        .chunk = std::move(chunk),
+        .ends_segment = ends_segment,
+    });
+    ++num_dispatched_chunks;
+    if (ends_segment) {
+        open_segment = nullptr;
+        open_recorder = nullptr;
+    }
+    AcquireNewChunk();
+}
+
 void VKScheduler::SubmitExecution(VkSemaphore semaphore) {
     EndPendingOperations();
     InvalidateState();
+    if (!recorders.empty()) {
+        EndSegment();
+    }
     WaitWorker();
 
     std::unique_lock lock{mutex};
 
-    current_cmdbuf.End();
+    submit_cmdbufs.clear();
+    if (recorders.empty()) {
+        current_cmdbuf.End();
+        submit_cmdbufs.push_back(*current_cmdbuf.address());
+    } else {
+        for (const Segment& segment : segments) {
+            submit_cmdbufs.push_back(segment.cmdbuf);
+        }
+        segments.clear();
+    }
 
     const VkSemaphore timeline_semaphore = master_semaphore->Handle();
     const u32 num_signal_semaphores = semaphore ? 2U : 1U;
@@ -184,8 +312,8 @@ void VKScheduler::SubmitExecution(VkSemaphore semaphore) {
         .waitSemaphoreCount = 1,
         .pWaitSemaphores = &timeline_semaphore,
         .pWaitDstStageMask = &wait_stage_mask,
-        .commandBufferCount = 1,
-        .pCommandBuffers = current_cmdbuf.address(),
+        .commandBufferCount = static_cast<u32>(submit_cmdbufs.size()),
+        .pCommandBuffers = submit_cmdbufs.data(),
         .signalSemaphoreCount = num_signal_semaphores,
         .pSignalSemaphores = signal_semaphores.data(),
     };
@@ -201,15 +329,18 @@ void VKScheduler::SubmitExecution(VkSemaphore semaphore) {
 }
 
 void VKScheduler::AllocateNewContext() {
-    std::unique_lock lock{mutex};
+    // Recorder threads allocate their own command buffers
+    if (recorders.empty()) {
+        std::unique_lock lock{mutex};
 
-    current_cmdbuf = vk::CommandBuffer(command_pool->Commit(), device.GetDispatchLoader());
-    current_cmdbuf.Begin({
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .pNext = nullptr,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        .pInheritanceInfo = nullptr,
-    });
+        current_cmdbuf = vk::CommandBuffer(command_pool->Commit(), device.GetDispatchLoader());
+        current_cmdbuf.Begin({
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .pNext = nullptr,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            .pInheritanceInfo = nullptr,
+        });
+    }
 
     // Enable counters once again. These are disabled when a command buffer is finished.
     if (query_cache) {
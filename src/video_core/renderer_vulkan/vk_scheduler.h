@@ -7,10 +7,13 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <stack>
 #include <thread>
 #include <utility>
+#include <vector>
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "common/threadsafe_queue.h"
@@ -27,6 +30,10 @@ class VKQueryCache;
 
 /// The scheduler abstracts command buffer and fence management with an interface that's able to do
 /// OpenGL-like operations on Vulkan command buffers.
+///
+/// When multithreaded recording is enabled, the recorded work is split in segments that are
+/// recorded in parallel into their own command buffers by a set of recorder threads. The command
+/// buffers are submitted in the order their segments were recorded.
 class VKScheduler {
 public:
     explicit VKScheduler(const Device& device, StateTracker& state_tracker);
@@ -43,6 +50,7 @@ public:
     void WaitWorker();
 
     /// Sends currently recorded work to the worker thread.
+    /// It must be called in between draws, as it may start a new command buffer.
     void DispatchWork();
 
     /// Requests to begin a renderpass.
@@ -69,7 +77,7 @@ public:
         if (chunk->Record(command)) {
             return;
         }
-        DispatchWork();
+        DispatchChunk();
         (void)chunk->Record(command);
     }
 
@@ -166,6 +174,23 @@ private:
         alignas(std::max_align_t) std::array<u8, 0x8000> data{};
     };
 
+    /// Work recorded into a single command buffer by one of the recorder threads
+    struct Segment {
+        VkCommandBuffer cmdbuf = nullptr;
+    };
+
+    struct RecordTask {
+        Segment* segment = nullptr;
+        std::unique_ptr<CommandChunk> chunk;
+        bool ends_segment = false;
+    };
+
+    struct Recorder {
+        std::unique_ptr<CommandPool> command_pool;
+        Common::SPSCQueue<RecordTask> queue;
+        std::thread thread;
+    };
+
     struct State {
         VkRenderPass renderpass = nullptr;
         VkFramebuffer framebuffer = nullptr;
@@ -175,6 +200,16 @@ private:
 
     void WorkerThread();
 
+    void RecorderThread(Recorder& recorder);
+
+    /// Sends the current chunk to be recorded, keeping the current command buffer
+    void DispatchChunk();
+
+    /// Sends the current chunk to be recorded and closes the current segment
+    void EndSegment();
+
+    void PushRecordTask(bool ends_segment);
+
     void SubmitExecution(VkSemaphore semaphore);
 
     void AllocateNewContext();
@@ -205,10 +240,23 @@ private:
     std::array<VkImageSubresourceRange, 9> renderpass_image_ranges{};
 
     Common::SPSCQueue<std::unique_ptr<CommandChunk>> chunk_queue;
-    Common::SPSCQueue<std::unique_ptr<CommandChunk>> chunk_reserve;
+    Common::MPSCQueue<std::unique_ptr<CommandChunk>> chunk_reserve;
     std::mutex mutex;
     std::condition_variable cv;
     bool quit = false;
+
+    std::vector<std::unique_ptr<Recorder>> recorders;
+    std::deque<Segment> segments;
+    Segment* open_segment = nullptr;
+    Recorder* open_recorder = nullptr;
+    size_t next_recorder = 0;
+    size_t segment_dispatches = 0;
+    std::vector<VkCommandBuffer> submit_cmdbufs;
+
+    u64 num_dispatched_chunks = 0;
+    u64 num_recorded_chunks = 0;
+    std::mutex recorded_mutex;
+    std::condition_variable recorded_cv;
 };
 
 } // namespace Vulkan
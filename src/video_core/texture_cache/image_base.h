@@ -31,6 +31,8 @@ enum class ImageFlagBits : u32 {
                          ///< garbage collection priority
     Alias = 1 << 9,      ///< This image has aliases and has priority on garbage
                          ///< collection
+
+    PendingDecode = 1 << 10, ///< Contents are being decoded by a worker thread
 };
 DECLARE_ENUM_FLAG_OPERATORS(ImageFlagBits)
 
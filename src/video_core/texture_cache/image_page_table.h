@@ -0,0 +1,65 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <boost/container/small_vector.hpp>
+
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "video_core/texture_cache/types.h"
+
+namespace VideoCommon {
+
+/// Two level page directory from CPU pages to the images overlapping them.
+/// Leaves are allocated the first time an image is registered in their range, most pages only
+/// hold a few images so they are stored inline.
+class ImagePageTable {
+public:
+    /// Address shift of the pages
+    static constexpr u64 PAGE_BITS = 20;
+
+    using ImageIds = boost::container::small_vector<ImageId, 4>;
+
+    /// Returns the images registered in page, or null when there is none
+    [[nodiscard]] ImageIds* Find(u64 page) noexcept {
+        const u64 leaf_index = page >> LEAF_BITS;
+        if (leaf_index >= NUM_LEAVES || !leaves[leaf_index]) {
+            return nullptr;
+        }
+        return &(*leaves[leaf_index])[page & LEAF_MASK];
+    }
+
+    /// Returns the images registered in page, or null when there is none
+    [[nodiscard]] const ImageIds* Find(u64 page) const noexcept {
+        return const_cast<ImagePageTable*>(this)->Find(page);
+    }
+
+    /// Returns the images registered in page, allocating its leaf if needed
+    [[nodiscard]] ImageIds& operator[](u64 page) {
+        const u64 leaf_index = page >> LEAF_BITS;
+        ASSERT_MSG(leaf_index < NUM_LEAVES, "Page 0x{:x} is out of range", page << PAGE_BITS);
+        std::unique_ptr<Leaf>& leaf = leaves[leaf_index];
+        if (!leaf) {
+            leaf = std::make_unique<Leaf>();
+        }
+        return (*leaf)[page & LEAF_MASK];
+    }
+
+private:
+    /// Each leaf covers 1 GiB of CPU addresses
+    static constexpr u64 LEAF_BITS = 10;
+    static constexpr u64 LEAF_MASK = (1ULL << LEAF_BITS) - 1;
+    /// The directory covers 39-bit CPU addresses
+    static constexpr u64 NUM_LEAVES = 1ULL << (39 - PAGE_BITS - LEAF_BITS);
+
+    using Leaf = std::array<ImageIds, 1ULL << LEAF_BITS>;
+
+    std::array<std::unique_ptr<Leaf>, NUM_LEAVES> leaves;
+};
+
+} // namespace VideoCommon
@@ -7,12 +7,13 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
+#include <thread>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -20,9 +21,14 @@
 
 #include "common/alignment.h"
 #include "common/common_types.h"
+#include "common/flat_hash_map.h"
+#include "common/fs/path_util.h"
 #include "common/literals.h"
 #include "common/logging/log.h"
 #include "common/settings.h"
+#include "common/thread.h"
+#include "common/thread_worker.h"
+#include "video_core/cache_budget.h"
 #include "video_core/compatible_formats.h"
 #include "video_core/delayed_destruction_ring.h"
 #include "video_core/dirty_flags.h"
@@ -36,12 +42,14 @@
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/texture_cache/formatter.h"
 #include "video_core/texture_cache/image_base.h"
+#include "video_core/texture_cache/image_page_table.h"
 #include "video_core/texture_cache/image_info.h"
 #include "video_core/texture_cache/image_view_base.h"
 #include "video_core/texture_cache/image_view_info.h"
 #include "video_core/texture_cache/render_targets.h"
 #include "video_core/texture_cache/samples_helper.h"
 #include "video_core/texture_cache/slot_vector.h"
+#include "video_core/texture_cache/texture_disk_cache.h"
 #include "video_core/texture_cache/types.h"
 #include "video_core/texture_cache/util.h"
 #include "video_core/textures/texture.h"
@@ -62,8 +70,8 @@ using namespace Common::Literals;
 
 template <class P>
 class TextureCache {
-    /// Address shift for caching images into a hash table
-    static constexpr u64 PAGE_BITS = 20;
+    /// Address shift for caching images into the page table
+    static constexpr u64 PAGE_BITS = ImagePageTable::PAGE_BITS;
 
     /// Enables debugging features to the texture cache
     static constexpr bool ENABLE_VALIDATION = P::ENABLE_VALIDATION;
@@ -96,13 +104,6 @@ class TextureCache {
         PixelFormat src_format;
     };
 
-    template <typename T>
-    struct IdentityHash {
-        [[nodiscard]] size_t operator()(T value) const noexcept {
-            return static_cast<size_t>(value);
-        }
-    };
-
 public:
     explicit TextureCache(Runtime&, VideoCore::RasterizerInterface&, Tegra::Engines::Maxwell3D&,
                           Tegra::Engines::KeplerCompute&, Tegra::MemoryManager&);
@@ -110,6 +111,11 @@ public:
     /// Notify the cache that a new frame has been queued
     void TickFrame();
 
+    /// Return the memory statistics of the cache, safe to call from any thread
+    [[nodiscard]] CacheMemoryStats GetMemoryStats() const {
+        return memory_budget.GetStats();
+    }
+
     /// Return a constant reference to the given image view id
     [[nodiscard]] const ImageView& GetImageView(ImageViewId id) const noexcept;
 
@@ -212,6 +218,10 @@ private:
                         std::span<ImageViewId> cached_image_view_ids, std::span<const u32> indices,
                         std::span<ImageViewId> image_view_ids);
 
+    /// Find or create the image view in the guest descriptor table and refresh its image contents
+    void PrefetchImageView(DescriptorTable<TICEntry>& table,
+                           std::span<ImageViewId> cached_image_view_ids, u32 index);
+
     /// Find or create an image view in the guest descriptor table
     ImageViewId VisitImageView(DescriptorTable<TICEntry>& table,
                                std::span<ImageViewId> cached_image_view_ids, u32 index);
@@ -220,7 +230,21 @@ private:
     FramebufferId GetFramebufferId(const RenderTargets& key);
 
     /// Refresh the contents (pixel data) of an image
-    void RefreshContents(Image& image);
+    void RefreshContents(Image& image, ImageId image_id);
+
+    /// Queue the decoding of an image converted on the CPU to the decode workers
+    void QueueAsyncDecode(Image& image, ImageId image_id);
+
+    /// Wait for the pending decode of an image, if there is one, and upload its result
+    void WaitAsyncDecode(ImageId image_id);
+
+    /// Convert the guest data of an image on the CPU, loading it from the disk cache when possible
+    /// @returns Copies to upload output to the image
+    static std::vector<BufferImageCopy> DecodeConvertedImage(TextureDiskCache* disk_cache,
+                                                             std::span<const u8> input,
+                                                             const ImageInfo& info,
+                                                             u32 unswizzled_size_bytes,
+                                                             std::span<u8> output);
 
     /// Upload data from guest to an image
     template <typename StagingBuffer>
@@ -336,14 +360,17 @@ private:
 
     RenderTargets render_targets;
 
-    std::unordered_map<TICEntry, ImageViewId> image_views;
-    std::unordered_map<TSCEntry, SamplerId> samplers;
-    std::unordered_map<RenderTargets, FramebufferId> framebuffers;
+    Common::FlatHashMap<TICEntry, ImageViewId> image_views;
+    Common::FlatHashMap<TSCEntry, SamplerId> samplers;
+    Common::FlatHashMap<RenderTargets, FramebufferId> framebuffers;
 
-    std::unordered_map<u64, std::vector<ImageId>, IdentityHash<u64>> page_table;
+    ImagePageTable page_table;
 
     bool has_deleted_images = false;
-    u64 total_used_memory = 0;
+    CacheBudget memory_budget;
+    /// False when the last garbage collection evicted nothing, so the next one resumes its sweep
+    /// instead of visiting the same images it had to skip again
+    bool gc_sweep_from_oldest = true;
     u64 minimum_memory;
     u64 expected_memory;
     u64 critical_memory;
@@ -363,11 +390,28 @@ private:
     DelayedDestructionRing<ImageView, TICKS_TO_DESTROY> sentenced_image_view;
     DelayedDestructionRing<Framebuffer, TICKS_TO_DESTROY> sentenced_framebuffers;
 
-    std::unordered_map<GPUVAddr, ImageAllocId> image_allocs_table;
+    Common::FlatHashMap<GPUVAddr, ImageAllocId> image_allocs_table;
 
     u64 modification_tick = 0;
     u64 frame_tick = 0;
-    typename SlotVector<Image>::Iterator deletion_iterator;
+
+    /// Image being decoded on a worker thread from a snapshot of its guest memory
+    struct AsyncDecode {
+        ImageId image_id;
+        ImageInfo info;
+        u32 unswizzled_size_bytes;
+        std::vector<u8> input;
+        std::vector<u8> output;
+        std::vector<BufferImageCopy> copies;
+        Common::Event finished;
+    };
+
+    /// True while images converted on the CPU can be decoded asynchronously
+    bool is_decode_batch = false;
+    std::vector<std::shared_ptr<AsyncDecode>> async_decodes;
+    std::unique_ptr<TextureDiskCache> disk_cache;
+    Common::ThreadWorker decode_workers{std::clamp(std::thread::hardware_concurrency() / 2, 1U, 4U),
+                                        "yuzu:TextureDecoder"};
 };
 
 template <class P>
@@ -389,8 +433,6 @@ TextureCache<P>::TextureCache(Runtime& runtime_, VideoCore::RasterizerInterface&
     void(slot_image_views.insert(runtime, NullImageParams{}));
     void(slot_samplers.insert(runtime, sampler_descriptor));
 
-    deletion_iterator = slot_images.begin();
-
     if constexpr (HAS_DEVICE_MEMORY_INFO) {
         const auto device_memory = runtime.GetDeviceLocalMemory();
         const u64 possible_expected_memory = (device_memory * 3) / 10;
@@ -404,23 +446,36 @@ TextureCache<P>::TextureCache(Runtime& runtime_, VideoCore::RasterizerInterface&
         critical_memory = DEFAULT_CRITICAL_MEMORY + 1_GiB;
         minimum_memory = expected_memory;
     }
+    if (const u64 budget_mib = Settings::values.texture_cache_budget.GetValue(); budget_mib != 0) {
+        expected_memory = budget_mib * 1_MiB;
+        critical_memory = expected_memory * 2;
+        minimum_memory = std::min(minimum_memory, expected_memory);
+    }
+    memory_budget.SetBudget(expected_memory);
+
+    if (Settings::values.use_disk_texture_cache.GetValue()) {
+        disk_cache = std::make_unique<TextureDiskCache>(
+            Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) / "texture" / "decoded.bin",
+            u64{Settings::values.disk_texture_cache_size.GetValue()} * 1_MiB);
+    }
 }
 
 template <class P>
 void TextureCache<P>::RunGarbageCollector() {
-    const bool high_priority_mode = total_used_memory >= expected_memory;
-    const bool aggressive_mode = total_used_memory >= critical_memory;
-    const u64 ticks_to_destroy = high_priority_mode ? 60 : 100;
-    int num_iterations = aggressive_mode ? 256 : (high_priority_mode ? 128 : 64);
-    for (; num_iterations > 0; --num_iterations) {
-        if (deletion_iterator == slot_images.end()) {
-            deletion_iterator = slot_images.begin();
-            if (deletion_iterator == slot_images.end()) {
-                break;
-            }
-        }
-        auto [image_id, image_tmp] = *deletion_iterator;
-        Image* image = image_tmp; // fix clang error.
+    // Over budget, evict starting from the least recently used image. Otherwise continue the
+    // previous sweep, to clean up aliases and bad overlaps across the whole cache over time.
+    // Images that can't be evicted yet stay at the front of the list, so a sweep that evicted
+    // nothing is continued as well instead of starting over from them.
+    const bool is_over_budget = memory_budget.ResidentBytes() >= expected_memory;
+    const bool is_over_critical = memory_budget.ResidentBytes() >= critical_memory;
+    const size_t num_iterations = is_over_critical ? 256 : (is_over_budget ? 128 : 64);
+    const bool from_oldest = is_over_budget && gc_sweep_from_oldest;
+    size_t num_evicted = 0;
+    memory_budget.Sweep(num_iterations, from_oldest, [this, &num_evicted](ImageId image_id) {
+        const bool high_priority_mode = memory_budget.ResidentBytes() >= expected_memory;
+        const bool aggressive_mode = memory_budget.ResidentBytes() >= critical_memory;
+        const u64 ticks_to_destroy = high_priority_mode ? 60 : 100;
+        Image* const image = &slot_images[image_id];
         const bool is_alias = True(image->flags & ImageFlagBits::Alias);
         const bool is_bad_overlap = True(image->flags & ImageFlagBits::BadOverlap);
         const bool must_download = image->IsSafeDownload();
@@ -430,52 +485,54 @@ void TextureCache<P>::RunGarbageCollector() {
                 ? ticks_to_destroy >> 4
                 : ((should_care && aggressive_mode) ? ticks_to_destroy >> 1 : ticks_to_destroy);
         should_care |= aggressive_mode;
-        if (should_care && image->frame_tick + ticks_needed < frame_tick) {
-            if (is_bad_overlap) {
-                const bool overlap_check = std::ranges::all_of(
-                    image->overlapping_images, [&, image](const ImageId& overlap_id) {
-                        auto& overlap = slot_images[overlap_id];
-                        return overlap.frame_tick >= image->frame_tick;
-                    });
-                if (!overlap_check) {
-                    ++deletion_iterator;
-                    continue;
-                }
-            }
-            if (!is_bad_overlap && must_download) {
-                const bool alias_check = std::ranges::none_of(
-                    image->aliased_images, [&, image](const AliasedImage& alias) {
-                        auto& alias_image = slot_images[alias.id];
-                        return (alias_image.frame_tick < image->frame_tick) ||
-                               (alias_image.modification_tick < image->modification_tick);
-                    });
-
-                if (alias_check) {
-                    auto map = runtime.DownloadStagingBuffer(image->unswizzled_size_bytes);
-                    const auto copies = FullDownloadCopies(image->info);
-                    image->DownloadMemory(map, copies);
-                    runtime.Finish();
-                    SwizzleImage(gpu_memory, image->gpu_addr, image->info, copies, map.mapped_span);
-                }
-            }
-            if (True(image->flags & ImageFlagBits::Tracked)) {
-                UntrackImage(*image);
+        if (!should_care || image->frame_tick + ticks_needed >= frame_tick) {
+            return true;
+        }
+        if (is_bad_overlap) {
+            const bool overlap_check = std::ranges::all_of(
+                image->overlapping_images, [&, image](const ImageId& overlap_id) {
+                    auto& overlap = slot_images[overlap_id];
+                    return overlap.frame_tick >= image->frame_tick;
+                });
+            if (!overlap_check) {
+                return true;
             }
-            UnregisterImage(image_id);
-            DeleteImage(image_id);
-            if (is_bad_overlap) {
-                ++num_iterations;
+        }
+        if (!is_bad_overlap && must_download) {
+            const bool alias_check = std::ranges::none_of(
+                image->aliased_images, [&, image](const AliasedImage& alias) {
+                    auto& alias_image = slot_images[alias.id];
+                    return (alias_image.frame_tick < image->frame_tick) ||
+                           (alias_image.modification_tick < image->modification_tick);
+                });
+
+            if (alias_check) {
+                auto map = runtime.DownloadStagingBuffer(image->unswizzled_size_bytes);
+                const auto copies = FullDownloadCopies(image->info);
+                image->DownloadMemory(map, copies);
+                runtime.Finish();
+                SwizzleImage(gpu_memory, image->gpu_addr, image->info, copies, map.mapped_span);
             }
         }
-        ++deletion_iterator;
-    }
+        if (True(image->flags & ImageFlagBits::Tracked)) {
+            UntrackImage(*image);
+        }
+        memory_budget.RecordEviction(image_id);
+        UnregisterImage(image_id);
+        DeleteImage(image_id);
+        ++num_evicted;
+        return true;
+    });
+    gc_sweep_from_oldest = num_evicted != 0;
 }
 
 template <class P>
 void TextureCache<P>::TickFrame() {
-    if (Settings::values.use_caches_gc.GetValue() && total_used_memory > minimum_memory) {
+    if (Settings::values.use_caches_gc.GetValue() &&
+        memory_budget.ResidentBytes() > minimum_memory) {
         RunGarbageCollector();
     }
+    memory_budget.Tick();
     sentenced_images.Tick();
     sentenced_framebuffers.Tick();
     sentenced_image_view.Tick();
@@ -608,12 +665,42 @@ void TextureCache<P>::FillImageViews(DescriptorTable<TICEntry>& table,
                                      std::span<const u32> indices,
                                      std::span<ImageViewId> image_view_ids) {
     ASSERT(indices.size() <= image_view_ids.size());
+    // Images converted on the CPU are decoded by worker threads while the remaining views are
+    // found, preparing each view only waits for the decode of its own image
+    is_decode_batch = true;
     do {
         has_deleted_images = false;
+        for (const u32 index : indices) {
+            PrefetchImageView(table, cached_image_view_ids, index);
+        }
         std::ranges::transform(indices, image_view_ids.begin(), [&](u32 index) {
             return VisitImageView(table, cached_image_view_ids, index);
         });
     } while (has_deleted_images);
+    is_decode_batch = false;
+
+    // Every decode should have been waited for, make sure none outlives the batch
+    while (!async_decodes.empty()) {
+        WaitAsyncDecode(async_decodes.front()->image_id);
+    }
+}
+
+template <class P>
+void TextureCache<P>::PrefetchImageView(DescriptorTable<TICEntry>& table,
+                                        std::span<ImageViewId> cached_image_view_ids, u32 index) {
+    if (index > table.Limit()) {
+        return;
+    }
+    const auto [descriptor, is_new] = table.Read(index);
+    ImageViewId& image_view_id = cached_image_view_ids[index];
+    if (is_new) {
+        image_view_id = FindImageView(descriptor);
+    }
+    if (image_view_id == NULL_IMAGE_VIEW_ID) {
+        return;
+    }
+    const ImageId image_id = slot_image_views[image_view_id].image_id;
+    RefreshContents(slot_images[image_id], image_id);
 }
 
 template <class P>
@@ -829,12 +916,11 @@ void TextureCache<P>::InvalidateDepthBuffer() {
 template <class P>
 typename P::ImageView* TextureCache<P>::TryFindFramebufferImageView(VAddr cpu_addr) {
     // TODO: Properly implement this
-    const auto it = page_table.find(cpu_addr >> PAGE_BITS);
-    if (it == page_table.end()) {
+    const auto* const image_ids = page_table.Find(cpu_addr >> PAGE_BITS);
+    if (!image_ids) {
         return nullptr;
     }
-    const auto& image_ids = it->second;
-    for (const ImageId image_id : image_ids) {
+    for (const ImageId image_id : *image_ids) {
         const ImageBase& image = slot_images[image_id];
         if (image.cpu_addr != cpu_addr) {
             continue;
@@ -915,7 +1001,7 @@ bool TextureCache<P>::IsRegionGpuModified(VAddr addr, size_t size) {
 }
 
 template <class P>
-void TextureCache<P>::RefreshContents(Image& image) {
+void TextureCache<P>::RefreshContents(Image& image, ImageId image_id) {
     if (False(image.flags & ImageFlagBits::CpuModified)) {
         // Only upload modified images
         return;
@@ -927,11 +1013,82 @@ void TextureCache<P>::RefreshContents(Image& image) {
         LOG_WARNING(HW_GPU, "MSAA image uploads are not implemented");
         return;
     }
+    if (is_decode_batch && True(image.flags & ImageFlagBits::Converted) &&
+        False(image.flags & ImageFlagBits::AcceleratedUpload)) {
+        QueueAsyncDecode(image, image_id);
+        return;
+    }
     auto staging = runtime.UploadStagingBuffer(MapSizeBytes(image));
     UploadImageContents(image, staging);
     runtime.InsertUploadMemoryBarrier();
 }
 
+template <class P>
+void TextureCache<P>::QueueAsyncDecode(Image& image, ImageId image_id) {
+    // A previous decode of the image is uploaded first, so uploads happen in order
+    WaitAsyncDecode(image_id);
+
+    auto decode = std::make_shared<AsyncDecode>();
+    decode->image_id = image_id;
+    decode->info = image.info;
+    decode->unswizzled_size_bytes = image.unswizzled_size_bytes;
+    decode->input.resize(CalculateGuestSizeInBytes(image.info));
+    gpu_memory.ReadBlockUnsafe(image.gpu_addr, decode->input.data(), decode->input.size());
+    decode->output.resize(MapSizeBytes(image));
+
+    image.flags |= ImageFlagBits::PendingDecode;
+    async_decodes.push_back(decode);
+    decode_workers.QueueWork([decode, disk_cache = disk_cache.get()] {
+        decode->copies = DecodeConvertedImage(disk_cache, decode->input, decode->info,
+                                              decode->unswizzled_size_bytes, decode->output);
+        decode->finished.Set();
+    });
+}
+
+template <class P>
+void TextureCache<P>::WaitAsyncDecode(ImageId image_id) {
+    Image& image = slot_images[image_id];
+    if (False(image.flags & ImageFlagBits::PendingDecode)) {
+        return;
+    }
+    image.flags &= ~ImageFlagBits::PendingDecode;
+    const auto it = std::ranges::find_if(async_decodes, [image_id](const auto& decode) {
+        return decode->image_id == image_id;
+    });
+    ASSERT(it != async_decodes.end());
+    const std::shared_ptr<AsyncDecode> decode = std::move(*it);
+    async_decodes.erase(it);
+
+    decode->finished.Wait();
+    auto staging = runtime.UploadStagingBuffer(decode->output.size());
+    std::memcpy(staging.mapped_span.data(), decode->output.data(), decode->output.size());
+    image.UploadMemory(staging, decode->copies);
+    runtime.InsertUploadMemoryBarrier();
+}
+
+template <class P>
+std::vector<BufferImageCopy> TextureCache<P>::DecodeConvertedImage(TextureDiskCache* disk_cache,
+                                                                   std::span<const u8> input,
+                                                                   const ImageInfo& info,
+                                                                   u32 unswizzled_size_bytes,
+                                                                   std::span<u8> output) {
+    std::vector<BufferImageCopy> copies;
+    u64 key = 0;
+    if (disk_cache) {
+        key = TextureDiskCache::MakeKey(input, info);
+        if (disk_cache->Load(key, output, copies)) {
+            return copies;
+        }
+    }
+    std::vector<u8> unswizzled_data(unswizzled_size_bytes);
+    copies = UnswizzleImage(input, info, unswizzled_data);
+    ConvertImage(unswizzled_data, info, output, copies);
+    if (disk_cache) {
+        disk_cache->Store(key, output, copies);
+    }
+    return copies;
+}
+
 template <class P>
 template <typename StagingBuffer>
 void TextureCache<P>::UploadImageContents(Image& image, StagingBuffer& staging) {
@@ -943,9 +1100,11 @@ void TextureCache<P>::UploadImageContents(Image& image, StagingBuffer& staging)
         const auto uploads = FullUploadSwizzles(image.info);
         runtime.AccelerateImageUpload(image, staging, uploads);
     } else if (True(image.flags & ImageFlagBits::Converted)) {
-        std::vector<u8> unswizzled_data(image.unswizzled_size_bytes);
-        auto copies = UnswizzleImage(gpu_memory, gpu_addr, image.info, unswizzled_data);
-        ConvertImage(unswizzled_data, image.info, mapped_span, copies);
+        std::vector<u8> input(CalculateGuestSizeInBytes(image.info));
+        gpu_memory.ReadBlockUnsafe(gpu_addr, input.data(), input.size());
+        const auto copies =
+            DecodeConvertedImage(disk_cache.get(), input, image.info, image.unswizzled_size_bytes,
+                                 mapped_span.first(MapSizeBytes(image)));
         image.UploadMemory(staging, copies);
     } else if (image.info.type == ImageType::Buffer) {
         const std::array copies{UploadBufferCopy(gpu_memory, gpu_addr, image, mapped_span)};
@@ -1095,9 +1254,12 @@ ImageId TextureCache<P>::JoinImages(const ImageInfo& info, GPUVAddr gpu_addr, VA
     Image& new_image = slot_images[new_image_id];
 
     // TODO: Only upload what we need
-    RefreshContents(new_image);
+    RefreshContents(new_image, new_image_id);
 
     for (const ImageId overlap_id : overlap_ids) {
+        // Overlaps are copied over the refreshed contents, so these have to be uploaded first
+        WaitAsyncDecode(new_image_id);
+        WaitAsyncDecode(overlap_id);
         Image& overlap = slot_images[overlap_id];
         if (overlap.info.num_samples != new_image.info.num_samples) {
             LOG_WARNING(HW_GPU, "Copying between images with different samples is not implemented");
@@ -1243,15 +1405,15 @@ void TextureCache<P>::ForEachImageInRegion(VAddr cpu_addr, size_t size, Func&& f
     static constexpr bool BOOL_BREAK = std::is_same_v<FuncReturn, bool>;
     boost::container::small_vector<ImageId, 32> images;
     ForEachPage(cpu_addr, size, [this, &images, cpu_addr, size, func](u64 page) {
-        const auto it = page_table.find(page);
-        if (it == page_table.end()) {
+        const auto* const image_ids = page_table.Find(page);
+        if (!image_ids) {
             if constexpr (BOOL_BREAK) {
                 return false;
             } else {
                 return;
             }
         }
-        for (const ImageId image_id : it->second) {
+        for (const ImageId image_id : *image_ids) {
             Image& image = slot_images[image_id];
             if (True(image.flags & ImageFlagBits::Picked)) {
                 continue;
@@ -1303,7 +1465,8 @@ void TextureCache<P>::RegisterImage(ImageId image_id) {
         True(image.flags & ImageFlagBits::Converted)) {
         tentative_size = EstimatedDecompressedSize(tentative_size, image.info.format);
     }
-    total_used_memory += Common::AlignUp(tentative_size, 1024);
+    memory_budget.Insert(image_id, image.cpu_addr, Common::AlignUp(tentative_size, 1024),
+                         frame_tick);
 }
 
 template <class P>
@@ -1313,26 +1476,19 @@ void TextureCache<P>::UnregisterImage(ImageId image_id) {
                "Trying to unregister an already registered image");
     image.flags &= ~ImageFlagBits::Registered;
     image.flags &= ~ImageFlagBits::BadOverlap;
-    u64 tentative_size = std::max(image.guest_size_bytes, image.unswizzled_size_bytes);
-    if ((IsPixelFormatASTC(image.info.format) &&
-         True(image.flags & ImageFlagBits::AcceleratedUpload)) ||
-        True(image.flags & ImageFlagBits::Converted)) {
-        tentative_size = EstimatedDecompressedSize(tentative_size, image.info.format);
-    }
-    total_used_memory -= Common::AlignUp(tentative_size, 1024);
+    memory_budget.Remove(image_id);
     ForEachPage(image.cpu_addr, image.guest_size_bytes, [this, image_id](u64 page) {
-        const auto page_it = page_table.find(page);
-        if (page_it == page_table.end()) {
+        auto* const image_ids = page_table.Find(page);
+        if (!image_ids) {
             UNREACHABLE_MSG("Unregistering unregistered page=0x{:x}", page << PAGE_BITS);
             return;
         }
-        std::vector<ImageId>& image_ids = page_it->second;
-        const auto vector_it = std::ranges::find(image_ids, image_id);
-        if (vector_it == image_ids.end()) {
+        const auto vector_it = std::ranges::find(*image_ids, image_id);
+        if (vector_it == image_ids->end()) {
             UNREACHABLE_MSG("Unregistering unregistered image in page=0x{:x}", page << PAGE_BITS);
             return;
         }
-        image_ids.erase(vector_it);
+        image_ids->erase(vector_it);
     });
 }
 
@@ -1353,6 +1509,11 @@ void TextureCache<P>::UntrackImage(ImageBase& image) {
 template <class P>
 void TextureCache<P>::DeleteImage(ImageId image_id) {
     ImageBase& image = slot_images[image_id];
+    if (True(image.flags & ImageFlagBits::PendingDecode)) {
+        // The worker keeps its own reference to the decode, the result is discarded
+        std::erase_if(async_decodes,
+                      [image_id](const auto& decode) { return decode->image_id == image_id; });
+    }
     const GPUVAddr gpu_addr = image.gpu_addr;
     const auto alloc_it = image_allocs_table.find(gpu_addr);
     if (alloc_it == image_allocs_table.end()) {
@@ -1453,6 +1614,9 @@ void TextureCache<P>::RemoveFramebuffers(std::span<const ImageViewId> removed_vi
 
 template <class P>
 void TextureCache<P>::MarkModification(ImageBase& image) noexcept {
+    if (False(image.flags & ImageFlagBits::GpuModified)) {
+        rasterizer.MarkRegionGpuModified(image.cpu_addr, image.guest_size_bytes);
+    }
     image.flags |= ImageFlagBits::GpuModified;
     image.modification_tick = ++modification_tick;
 }
@@ -1491,14 +1655,18 @@ void TextureCache<P>::PrepareImage(ImageId image_id, bool is_modification, bool
         if (False(image.flags & ImageFlagBits::Tracked)) {
             TrackImage(image);
         }
+        // Pending contents would be uploaded over what the image is used for
+        WaitAsyncDecode(image_id);
     } else {
-        RefreshContents(image);
+        RefreshContents(image, image_id);
+        WaitAsyncDecode(image_id);
         SynchronizeAliases(image_id);
     }
     if (is_modification) {
         MarkModification(image);
     }
     image.frame_tick = frame_tick;
+    memory_budget.Touch(image_id, frame_tick);
 }
 
 template <class P>
@@ -1513,6 +1681,8 @@ void TextureCache<P>::PrepareImageView(ImageViewId image_view_id, bool is_modifi
 
 template <class P>
 void TextureCache<P>::CopyImage(ImageId dst_id, ImageId src_id, std::span<const ImageCopy> copies) {
+    WaitAsyncDecode(dst_id);
+    WaitAsyncDecode(src_id);
     Image& dst = slot_images[dst_id];
     Image& src = slot_images[src_id];
     const auto dst_format_type = GetFormatType(dst.info.format);
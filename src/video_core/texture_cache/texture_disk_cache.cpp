@@ -0,0 +1,361 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "common/cityhash.h"
+#include "common/common_funcs.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "common/zstd_compression.h"
+#include "video_core/texture_cache/image_info.h"
+#include "video_core/texture_cache/texture_disk_cache.h"
+
+namespace VideoCommon {
+namespace {
+constexpr u32 CACHE_MAGIC = Common::MakeMagic('Y', 'T', 'X', 'C');
+/// Has to be bumped when the output of the CPU decoders changes
+constexpr u32 CACHE_VERSION = 1;
+
+struct FileHeader {
+    u32_le magic;
+    u32_le version;
+};
+static_assert(sizeof(FileHeader) == 0x8, "FileHeader has incorrect size.");
+
+struct RecordHeader {
+    u64_le key;
+    u64_le last_use;
+    u32_le output_size;
+    u32_le compressed_size;
+    u32_le num_copies;
+    u32_le padding;
+};
+static_assert(sizeof(RecordHeader) == 0x20, "RecordHeader has incorrect size.");
+
+struct CopyRecord {
+    u64_le buffer_offset;
+    u64_le buffer_size;
+    u32_le buffer_row_length;
+    u32_le buffer_image_height;
+    s32_le base_level;
+    s32_le base_layer;
+    s32_le num_layers;
+    s32_le offset_x;
+    s32_le offset_y;
+    s32_le offset_z;
+    u32_le width;
+    u32_le height;
+    u32_le depth;
+    u32_le padding;
+};
+static_assert(sizeof(CopyRecord) == 0x40, "CopyRecord has incorrect size.");
+
+u64 RecordSize(const RecordHeader& record) {
+    return sizeof(RecordHeader) + u64{record.num_copies} * sizeof(CopyRecord) +
+           record.compressed_size;
+}
+
+CopyRecord MakeCopyRecord(const BufferImageCopy& copy) {
+    return CopyRecord{
+        .buffer_offset = copy.buffer_offset,
+        .buffer_size = copy.buffer_size,
+        .buffer_row_length = copy.buffer_row_length,
+        .buffer_image_height = copy.buffer_image_height,
+        .base_level = copy.image_subresource.base_level,
+        .base_layer = copy.image_subresource.base_layer,
+        .num_layers = copy.image_subresource.num_layers,
+        .offset_x = copy.image_offset.x,
+        .offset_y = copy.image_offset.y,
+        .offset_z = copy.image_offset.z,
+        .width = copy.image_extent.width,
+        .height = copy.image_extent.height,
+        .depth = copy.image_extent.depth,
+        .padding = 0,
+    };
+}
+
+BufferImageCopy MakeBufferImageCopy(const CopyRecord& record) {
+    return BufferImageCopy{
+        .buffer_offset = static_cast<size_t>(record.buffer_offset),
+        .buffer_size = static_cast<size_t>(record.buffer_size),
+        .buffer_row_length = record.buffer_row_length,
+        .buffer_image_height = record.buffer_image_height,
+        .image_subresource =
+            {
+                .base_level = record.base_level,
+                .base_layer = record.base_layer,
+                .num_layers = record.num_layers,
+            },
+        .image_offset = {record.offset_x, record.offset_y, record.offset_z},
+        .image_extent = {record.width, record.height, record.depth},
+    };
+}
+} // Anonymous namespace
+
+TextureDiskCache::TextureDiskCache(std::filesystem::path path_, u64 budget_bytes_)
+    : path{std::move(path_)}, budget_bytes{budget_bytes_} {
+    std::scoped_lock lock{mutex};
+    Open();
+    if (file_size > budget_bytes) {
+        Compact(budget_bytes);
+    }
+}
+
+TextureDiskCache::~TextureDiskCache() {
+    const Stats current = GetStats();
+    const u64 lookups = current.hits + current.misses;
+    if (lookups == 0) {
+        return;
+    }
+    LOG_INFO(HW_GPU,
+             "Texture disk cache: {} hits, {} misses ({:.1f}% hit rate), {} stores, {} evictions, "
+             "{} MiB used",
+             current.hits, current.misses, 100.0 * static_cast<double>(current.hits) / lookups,
+             current.stores, current.evictions, current.size_bytes >> 20);
+}
+
+u64 TextureDiskCache::MakeKey(std::span<const u8> input, const ImageInfo& info) {
+    const bool is_linear = info.type == ImageType::Linear;
+    const std::array<u32, 15> params{
+        CACHE_VERSION,
+        static_cast<u32>(info.format),
+        static_cast<u32>(info.type),
+        static_cast<u32>(info.resources.levels),
+        static_cast<u32>(info.resources.layers),
+        info.size.width,
+        info.size.height,
+        info.size.depth,
+        is_linear ? info.pitch : info.block.width,
+        is_linear ? 0 : info.block.height,
+        is_linear ? 0 : info.block.depth,
+        info.layer_stride,
+        info.maybe_unaligned_layer_stride,
+        info.num_samples,
+        info.tile_width_spacing,
+    };
+    const u64 seed = Common::CityHash64(reinterpret_cast<const char*>(params.data()),
+                                        sizeof(params));
+    return Common::CityHash64WithSeed(reinterpret_cast<const char*>(input.data()), input.size(),
+                                      seed);
+}
+
+bool TextureDiskCache::Load(u64 key, std::span<u8> output, std::vector<BufferImageCopy>& copies) {
+    std::vector<CopyRecord> copy_records;
+    std::vector<u8> compressed;
+    {
+        std::scoped_lock lock{mutex};
+        const auto it = entries.find(key);
+        if (it == entries.end()) {
+            ++stats.misses;
+            return false;
+        }
+        Entry& entry = it->second;
+        RecordHeader record{};
+        bool is_read = file.Seek(static_cast<s64>(entry.offset)) && file.ReadObject(record) &&
+                       record.key == key && record.output_size == output.size();
+        if (is_read) {
+            copy_records.resize(record.num_copies);
+            compressed.resize(record.compressed_size);
+            is_read = file.ReadSpan<CopyRecord>(copy_records) == copy_records.size() &&
+                      file.ReadSpan<u8>(compressed) == compressed.size();
+        }
+        if (!is_read) {
+            ++stats.misses;
+            return false;
+        }
+        // The use is stored in the pack, so eviction takes previous boots into account
+        entry.last_use = ++use_counter;
+        const u64_le last_use = entry.last_use;
+        if (!file.Seek(static_cast<s64>(entry.offset + offsetof(RecordHeader, last_use))) ||
+            !file.WriteObject(last_use)) {
+            LOG_WARNING(HW_GPU, "Failed to update the texture disk cache");
+        }
+    }
+
+    const std::vector<u8> data = Common::Compression::DecompressDataZSTD(compressed);
+    std::scoped_lock lock{mutex};
+    if (data.size() != output.size()) {
+        ++stats.misses;
+        return false;
+    }
+    std::ranges::copy(data, output.begin());
+    copies.resize(copy_records.size());
+    std::ranges::transform(copy_records, copies.begin(), MakeBufferImageCopy);
+    ++stats.hits;
+    return true;
+}
+
+void TextureDiskCache::Store(u64 key, std::span<const u8> output,
+                             std::span<const BufferImageCopy> copies) {
+    {
+        std::scoped_lock lock{mutex};
+        if (!file.IsOpen() || entries.contains(key)) {
+            return;
+        }
+    }
+    const std::vector<u8> compressed =
+        Common::Compression::CompressDataZSTDDefault(output.data(), output.size());
+    std::vector<CopyRecord> copy_records(copies.size());
+    std::ranges::transform(copies, copy_records.begin(), MakeCopyRecord);
+
+    RecordHeader record{
+        .key = key,
+        .last_use = 0,
+        .output_size = static_cast<u32>(output.size()),
+        .compressed_size = static_cast<u32>(compressed.size()),
+        .num_copies = static_cast<u32>(copy_records.size()),
+        .padding = 0,
+    };
+    const u64 record_size = RecordSize(record);
+    if (sizeof(FileHeader) + record_size > budget_bytes) {
+        return;
+    }
+
+    std::scoped_lock lock{mutex};
+    if (!file.IsOpen() || entries.contains(key)) {
+        return;
+    }
+    if (file_size + record_size > budget_bytes) {
+        // Leave some room, so the pack is not rewritten on every store
+        Compact(std::min(budget_bytes / 4 * 3, budget_bytes - record_size));
+        if (!file.IsOpen()) {
+            return;
+        }
+    }
+    record.last_use = ++use_counter;
+    if (!file.Seek(static_cast<s64>(file_size)) || !file.WriteObject(record) ||
+        file.WriteSpan<CopyRecord>(copy_records) != copy_records.size() ||
+        file.WriteSpan<u8>(compressed) != compressed.size()) {
+        LOG_WARNING(HW_GPU, "Failed to write to the texture disk cache");
+        // Drop what was written of the record
+        void(file.SetSize(file_size));
+        return;
+    }
+    entries.try_emplace(key, Entry{
+                                 .offset = file_size,
+                                 .size = record_size,
+                                 .last_use = record.last_use,
+                             });
+    file_size += record_size;
+    ++stats.stores;
+}
+
+TextureDiskCache::Stats TextureDiskCache::GetStats() const {
+    std::scoped_lock lock{mutex};
+    Stats result = stats;
+    result.size_bytes = file_size;
+    return result;
+}
+
+void TextureDiskCache::Open() {
+    file.Close();
+    entries.clear();
+    file_size = 0;
+
+    if (!Common::FS::CreateParentDirs(path)) {
+        LOG_WARNING(HW_GPU, "Failed to create the texture disk cache directory");
+        return;
+    }
+    file.Open(path, Common::FS::FileAccessMode::ReadWrite, Common::FS::FileType::BinaryFile);
+    FileHeader header{};
+    if (!file.IsOpen() || !file.ReadObject(header) || header.magic != CACHE_MAGIC ||
+        header.version != CACHE_VERSION) {
+        // Missing, invalid or outdated, start a new pack
+        file.Open(path, Common::FS::FileAccessMode::Write, Common::FS::FileType::BinaryFile);
+        const bool is_created = file.WriteObject(FileHeader{
+            .magic = CACHE_MAGIC,
+            .version = CACHE_VERSION,
+        });
+        file.Open(path, Common::FS::FileAccessMode::ReadWrite, Common::FS::FileType::BinaryFile);
+        if (!is_created || !file.IsOpen()) {
+            LOG_WARNING(HW_GPU, "Failed to create the texture disk cache at {}",
+                        Common::FS::PathToUTF8String(path));
+            file.Close();
+            return;
+        }
+    }
+
+    const u64 size = file.GetSize();
+    u64 offset = sizeof(FileHeader);
+    while (size - offset >= sizeof(RecordHeader)) {
+        RecordHeader record{};
+        if (!file.Seek(static_cast<s64>(offset)) || !file.ReadObject(record)) {
+            break;
+        }
+        const u64 record_size = RecordSize(record);
+        if (record_size > size - offset) {
+            break;
+        }
+        entries[record.key] = Entry{
+            .offset = offset,
+            .size = record_size,
+            .last_use = record.last_use,
+        };
+        use_counter = std::max<u64>(use_counter, record.last_use);
+        offset += record_size;
+    }
+    if (offset != size) {
+        // A record was left incomplete, most likely by a crash while it was written
+        LOG_WARNING(HW_GPU, "Discarding {} bytes at the end of the texture disk cache",
+                    size - offset);
+        void(file.SetSize(offset));
+    }
+    file_size = offset;
+}
+
+void TextureDiskCache::Compact(u64 target_bytes) {
+    std::vector<std::pair<u64, Entry>> kept(entries.begin(), entries.end());
+    std::ranges::sort(kept, std::greater{}, [](const auto& pair) { return pair.second.last_use; });
+    u64 kept_size = sizeof(FileHeader);
+    size_t num_kept = 0;
+    while (num_kept < kept.size() && kept_size + kept[num_kept].second.size <= target_bytes) {
+        kept_size += kept[num_kept].second.size;
+        ++num_kept;
+    }
+    const size_t num_evicted = kept.size() - num_kept;
+    kept.resize(num_kept);
+    std::ranges::sort(kept, std::less{}, [](const auto& pair) { return pair.second.offset; });
+
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+    bool is_written;
+    {
+        const Common::FS::IOFile temp{temp_path, Common::FS::FileAccessMode::Write,
+                                      Common::FS::FileType::BinaryFile};
+        is_written = temp.IsOpen() && temp.WriteObject(FileHeader{
+                                          .magic = CACHE_MAGIC,
+                                          .version = CACHE_VERSION,
+                                      });
+        std::vector<u8> buffer;
+        for (const auto& [key, entry] : kept) {
+            if (!is_written) {
+                break;
+            }
+            buffer.resize(entry.size);
+            is_written = file.Seek(static_cast<s64>(entry.offset)) &&
+                         file.ReadSpan<u8>(buffer) == buffer.size() &&
+                         temp.WriteSpan<u8>(buffer) == buffer.size();
+        }
+    }
+    if (!is_written) {
+        LOG_WARNING(HW_GPU, "Failed to compact the texture disk cache");
+        void(Common::FS::RemoveFile(temp_path));
+        return;
+    }
+    file.Close();
+    if (!Common::FS::RemoveFile(path) || !Common::FS::RenameFile(temp_path, path)) {
+        LOG_WARNING(HW_GPU, "Failed to replace the texture disk cache");
+    }
+    stats.evictions += num_evicted;
+    Open();
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,81 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/flat_hash_map.h"
+#include "common/fs/file.h"
+#include "video_core/texture_cache/types.h"
+
+namespace VideoCommon {
+
+struct ImageInfo;
+
+/**
+ * Persists the images converted on the CPU across boots, keyed by a hash of their guest data and
+ * of their parameters, so identical textures are not decoded again.
+ *
+ * Entries are compressed and appended to a single pack file indexed in memory. When the pack grows
+ * over its size budget the least recently used entries are evicted. It is safe to use from
+ * multiple threads.
+ */
+class TextureDiskCache {
+public:
+    struct Stats {
+        u64 hits;
+        u64 misses;
+        u64 stores;
+        u64 evictions;
+        u64 size_bytes;
+    };
+
+    explicit TextureDiskCache(std::filesystem::path path_, u64 budget_bytes_);
+    ~TextureDiskCache();
+
+    TextureDiskCache(const TextureDiskCache&) = delete;
+    TextureDiskCache& operator=(const TextureDiskCache&) = delete;
+
+    /// Returns the key of the converted image of the given guest data
+    [[nodiscard]] static u64 MakeKey(std::span<const u8> input, const ImageInfo& info);
+
+    /// Loads a converted image into output and its copies
+    /// @returns False when the image is not in the cache, output is left undefined
+    [[nodiscard]] bool Load(u64 key, std::span<u8> output, std::vector<BufferImageCopy>& copies);
+
+    /// Stores a converted image and its copies
+    void Store(u64 key, std::span<const u8> output, std::span<const BufferImageCopy> copies);
+
+    [[nodiscard]] Stats GetStats() const;
+
+private:
+    struct Entry {
+        u64 offset;
+        u64 size;
+        u64 last_use;
+    };
+
+    /// Opens the pack file and indexes its entries, creating it when it is missing or invalid
+    void Open();
+
+    /// Rewrites the pack keeping the most recently used entries that fit in target_bytes
+    void Compact(u64 target_bytes);
+
+    std::filesystem::path path;
+    u64 budget_bytes;
+
+    mutable std::mutex mutex;
+    Common::FS::IOFile file;
+    Common::FlatHashMap<u64, Entry> entries;
+    u64 file_size = 0;
+    u64 use_counter = 0;
+    Stats stats{};
+};
+
+} // namespace VideoCommon
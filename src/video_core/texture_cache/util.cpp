@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <numeric>
 #include <optional>
 #include <span>
@@ -594,6 +595,25 @@ void SwizzleBlockLinearImage(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr
     ASSERT(host_offset - copy.buffer_offset == copy.buffer_size);
 }
 
+[[nodiscard]] BufferImageCopy LinearImageCopy(const ImageInfo& info) {
+    const u32 bpp_log2 = BytesPerBlockLog2(info.format);
+    ASSERT((info.pitch >> bpp_log2) << bpp_log2 == info.pitch);
+    return BufferImageCopy{
+        .buffer_offset = 0,
+        .buffer_size = CalculateGuestSizeInBytes(info),
+        .buffer_row_length = info.pitch >> bpp_log2,
+        .buffer_image_height = info.size.height,
+        .image_subresource =
+            {
+                .base_level = 0,
+                .base_layer = 0,
+                .num_layers = 1,
+            },
+        .image_offset = {0, 0, 0},
+        .image_extent = info.size,
+    };
+}
+
 } // Anonymous namespace
 
 u32 CalculateGuestSizeInBytes(const ImageInfo& info) noexcept {
@@ -789,31 +809,23 @@ bool IsValidAddress(const Tegra::MemoryManager& gpu_memory, const TICEntry& conf
 std::vector<BufferImageCopy> UnswizzleImage(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr,
                                             const ImageInfo& info, std::span<u8> output) {
     const size_t guest_size_bytes = CalculateGuestSizeInBytes(info);
-    const u32 bpp_log2 = BytesPerBlockLog2(info.format);
-    const Extent3D size = info.size;
-
     if (info.type == ImageType::Linear) {
         gpu_memory.ReadBlockUnsafe(gpu_addr, output.data(), guest_size_bytes);
-
-        ASSERT((info.pitch >> bpp_log2) << bpp_log2 == info.pitch);
-        return {{
-            .buffer_offset = 0,
-            .buffer_size = guest_size_bytes,
-            .buffer_row_length = info.pitch >> bpp_log2,
-            .buffer_image_height = size.height,
-            .image_subresource =
-                {
-                    .base_level = 0,
-                    .base_layer = 0,
-                    .num_layers = 1,
-                },
-            .image_offset = {0, 0, 0},
-            .image_extent = size,
-        }};
+        return {LinearImageCopy(info)};
     }
     const auto input_data = std::make_unique<u8[]>(guest_size_bytes);
     gpu_memory.ReadBlockUnsafe(gpu_addr, input_data.get(), guest_size_bytes);
-    const std::span<const u8> input(input_data.get(), guest_size_bytes);
+    return UnswizzleImage(std::span<const u8>(input_data.get(), guest_size_bytes), info, output);
+}
+
+std::vector<BufferImageCopy> UnswizzleImage(std::span<const u8> input, const ImageInfo& info,
+                                            std::span<u8> output) {
+    if (info.type == ImageType::Linear) {
+        std::memcpy(output.data(), input.data(), CalculateGuestSizeInBytes(info));
+        return {LinearImageCopy(info)};
+    }
+    const u32 bpp_log2 = BytesPerBlockLog2(info.format);
+    const Extent3D size = info.size;
 
     const LevelInfo level_info = MakeLevelInfo(info);
     const s32 num_layers = info.resources.layers;
@@ -61,6 +61,11 @@ struct OverlapResult {
                                                           GPUVAddr gpu_addr, const ImageInfo& info,
                                                           std::span<u8> output);
 
+/// Unswizzles an image from a snapshot of its guest memory, it does not access guest memory
+[[nodiscard]] std::vector<BufferImageCopy> UnswizzleImage(std::span<const u8> input,
+                                                          const ImageInfo& info,
+                                                          std::span<u8> output);
+
 [[nodiscard]] BufferCopy UploadBufferCopy(Tegra::MemoryManager& gpu_memory, GPUVAddr gpu_addr,
                                           const ImageBase& image, std::span<u8> output);
 
@@ -634,6 +634,8 @@ void Config::ReadDataStorageValues() {
         ReadSetting(QStringLiteral("gamecard_current_game"), false).toBool();
     Settings::values.gamecard_path =
         ReadSetting(QStringLiteral("gamecard_path"), QString{}).toString().toStdString();
+    Settings::values.verify_nca_integrity =
+        ReadSetting(QStringLiteral("verify_nca_integrity"), false).toBool();
 
     qt_config->endGroup();
 }
@@ -657,6 +659,7 @@ void Config::ReadDebuggingValues() {
         ReadSetting(QStringLiteral("disable_macro_jit"), false).toBool();
     Settings::values.extended_logging =
         ReadSetting(QStringLiteral("extended_logging"), false).toBool();
+    Settings::values.trace_logging = ReadSetting(QStringLiteral("trace_logging"), false).toBool();
     Settings::values.use_debug_asserts =
         ReadSetting(QStringLiteral("use_debug_asserts"), false).toBool();
     Settings::values.use_auto_stub = ReadSetting(QStringLiteral("use_auto_stub"), false).toBool();
@@ -823,6 +826,18 @@ void Config::ReadRendererValues() {
     ReadSettingGlobal(Settings::values.use_fast_gpu_time, QStringLiteral("use_fast_gpu_time"),
                       true);
     ReadSettingGlobal(Settings::values.use_caches_gc, QStringLiteral("use_caches_gc"), false);
+    ReadSettingGlobal(Settings::values.use_write_tracking, QStringLiteral("use_write_tracking"),
+                      false);
+    ReadSettingGlobal(Settings::values.use_disk_texture_cache,
+                      QStringLiteral("use_disk_texture_cache"), false);
+    ReadSettingGlobal(Settings::values.disk_texture_cache_size,
+                      QStringLiteral("disk_texture_cache_size"), 1024);
+    ReadSettingGlobal(Settings::values.use_multithreaded_recording,
+                      QStringLiteral("use_multithreaded_recording"), false);
+    ReadSettingGlobal(Settings::values.texture_cache_budget,
+                      QStringLiteral("texture_cache_budget"), 0);
+    ReadSettingGlobal(Settings::values.buffer_cache_budget, QStringLiteral("buffer_cache_budget"),
+                      0);
     ReadSettingGlobal(Settings::values.bg_red, QStringLiteral("bg_red"), 0.0);
     ReadSettingGlobal(Settings::values.bg_green, QStringLiteral("bg_green"), 0.0);
     ReadSettingGlobal(Settings::values.bg_blue, QStringLiteral("bg_blue"), 0.0);
@@ -1254,6 +1269,8 @@ void Config::SaveDataStorageValues() {
                  false);
     WriteSetting(QStringLiteral("gamecard_path"),
                  QString::fromStdString(Settings::values.gamecard_path), QString{});
+    WriteSetting(QStringLiteral("verify_nca_integrity"), Settings::values.verify_nca_integrity,
+                 false);
 
     qt_config->endGroup();
 }
@@ -1272,6 +1289,7 @@ void Config::SaveDebuggingValues() {
     WriteSetting(QStringLiteral("quest_flag"), Settings::values.quest_flag, false);
     WriteSetting(QStringLiteral("use_debug_asserts"), Settings::values.use_debug_asserts, false);
     WriteSetting(QStringLiteral("disable_macro_jit"), Settings::values.disable_macro_jit, false);
+    WriteSetting(QStringLiteral("trace_logging"), Settings::values.trace_logging, false);
 
     qt_config->endGroup();
 }
@@ -1412,6 +1430,18 @@ void Config::SaveRendererValues() {
     WriteSettingGlobal(QStringLiteral("use_fast_gpu_time"), Settings::values.use_fast_gpu_time,
                        true);
     WriteSettingGlobal(QStringLiteral("use_caches_gc"), Settings::values.use_caches_gc, false);
+    WriteSettingGlobal(QStringLiteral("use_write_tracking"), Settings::values.use_write_tracking,
+                       false);
+    WriteSettingGlobal(QStringLiteral("use_disk_texture_cache"),
+                       Settings::values.use_disk_texture_cache, false);
+    WriteSettingGlobal(QStringLiteral("disk_texture_cache_size"),
+                       Settings::values.disk_texture_cache_size, 1024);
+    WriteSettingGlobal(QStringLiteral("use_multithreaded_recording"),
+                       Settings::values.use_multithreaded_recording, false);
+    WriteSettingGlobal(QStringLiteral("texture_cache_budget"),
+                       Settings::values.texture_cache_budget, 0);
+    WriteSettingGlobal(QStringLiteral("buffer_cache_budget"), Settings::values.buffer_cache_budget,
+                       0);
     // Cast to double because Qt's written float values are not human-readable
     WriteSettingGlobal(QStringLiteral("bg_red"), Settings::values.bg_red, 0.0);
     WriteSettingGlobal(QStringLiteral("bg_green"), Settings::values.bg_green, 0.0);
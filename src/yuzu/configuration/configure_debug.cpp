@@ -45,6 +45,7 @@ void ConfigureDebug::SetConfiguration() {
     ui->disable_macro_jit->setEnabled(runtime_lock);
     ui->disable_macro_jit->setChecked(Settings::values.disable_macro_jit);
     ui->extended_logging->setChecked(Settings::values.extended_logging);
+    ui->trace_logging->setChecked(Settings::values.trace_logging);
 }
 
 void ConfigureDebug::ApplyConfiguration() {
@@ -59,6 +60,7 @@ void ConfigureDebug::ApplyConfiguration() {
     Settings::values.renderer_debug = ui->enable_graphics_debugging->isChecked();
     Settings::values.disable_macro_jit = ui->disable_macro_jit->isChecked();
     Settings::values.extended_logging = ui->extended_logging->isChecked();
+    Settings::values.trace_logging = ui->trace_logging->isChecked();
     Debugger::ToggleConsole();
     Common::Log::Filter filter;
     filter.ParseFilterString(Settings::values.log_filter);
@@ -25,6 +25,9 @@ void ConfigureGraphicsAdvanced::SetConfiguration() {
     ui->use_vsync->setEnabled(runtime_lock);
     ui->use_assembly_shaders->setEnabled(runtime_lock);
     ui->use_asynchronous_shaders->setEnabled(runtime_lock);
+    ui->use_write_tracking->setEnabled(runtime_lock);
+    ui->use_disk_texture_cache->setEnabled(runtime_lock);
+    ui->use_multithreaded_recording->setEnabled(runtime_lock);
     ui->anisotropic_filtering_combobox->setEnabled(runtime_lock);
 
     ui->use_vsync->setChecked(Settings::values.use_vsync.GetValue());
@@ -33,6 +36,10 @@ void ConfigureGraphicsAdvanced::SetConfiguration() {
     ui->use_asynchronous_shaders->setChecked(Settings::values.use_asynchronous_shaders.GetValue());
     ui->use_caches_gc->setChecked(Settings::values.use_caches_gc.GetValue());
     ui->use_fast_gpu_time->setChecked(Settings::values.use_fast_gpu_time.GetValue());
+    ui->use_write_tracking->setChecked(Settings::values.use_write_tracking.GetValue());
+    ui->use_disk_texture_cache->setChecked(Settings::values.use_disk_texture_cache.GetValue());
+    ui->use_multithreaded_recording->setChecked(
+        Settings::values.use_multithreaded_recording.GetValue());
 
     if (Settings::IsConfiguringGlobal()) {
         ui->gpu_accuracy->setCurrentIndex(
@@ -70,6 +77,13 @@ void ConfigureGraphicsAdvanced::ApplyConfiguration() {
                                              use_caches_gc);
     ConfigurationShared::ApplyPerGameSetting(&Settings::values.use_fast_gpu_time,
                                              ui->use_fast_gpu_time, use_fast_gpu_time);
+    ConfigurationShared::ApplyPerGameSetting(&Settings::values.use_write_tracking,
+                                             ui->use_write_tracking, use_write_tracking);
+    ConfigurationShared::ApplyPerGameSetting(&Settings::values.use_disk_texture_cache,
+                                             ui->use_disk_texture_cache, use_disk_texture_cache);
+    ConfigurationShared::ApplyPerGameSetting(&Settings::values.use_multithreaded_recording,
+                                             ui->use_multithreaded_recording,
+                                             use_multithreaded_recording);
 
     if (Settings::IsConfiguringGlobal()) {
         // Must guard in case of a during-game configuration when set to be game-specific.
@@ -109,6 +123,11 @@ void ConfigureGraphicsAdvanced::SetupPerGameUI() {
             Settings::values.use_asynchronous_shaders.UsingGlobal());
         ui->use_fast_gpu_time->setEnabled(Settings::values.use_fast_gpu_time.UsingGlobal());
         ui->use_caches_gc->setEnabled(Settings::values.use_caches_gc.UsingGlobal());
+        ui->use_write_tracking->setEnabled(Settings::values.use_write_tracking.UsingGlobal());
+        ui->use_disk_texture_cache->setEnabled(
+            Settings::values.use_disk_texture_cache.UsingGlobal());
+        ui->use_multithreaded_recording->setEnabled(
+            Settings::values.use_multithreaded_recording.UsingGlobal());
         ui->anisotropic_filtering_combobox->setEnabled(
             Settings::values.max_anisotropy.UsingGlobal());
 
@@ -127,6 +146,15 @@ void ConfigureGraphicsAdvanced::SetupPerGameUI() {
                                             Settings::values.use_fast_gpu_time, use_fast_gpu_time);
     ConfigurationShared::SetColoredTristate(ui->use_caches_gc, Settings::values.use_caches_gc,
                                             use_caches_gc);
+    ConfigurationShared::SetColoredTristate(ui->use_write_tracking,
+                                            Settings::values.use_write_tracking,
+                                            use_write_tracking);
+    ConfigurationShared::SetColoredTristate(ui->use_disk_texture_cache,
+                                            Settings::values.use_disk_texture_cache,
+                                            use_disk_texture_cache);
+    ConfigurationShared::SetColoredTristate(ui->use_multithreaded_recording,
+                                            Settings::values.use_multithreaded_recording,
+                                            use_multithreaded_recording);
     ConfigurationShared::SetColoredComboBox(
         ui->gpu_accuracy, ui->label_gpu_accuracy,
         static_cast<int>(Settings::values.gpu_accuracy.GetValue(true)));
@@ -40,4 +40,7 @@ private:
     ConfigurationShared::CheckState use_asynchronous_shaders;
     ConfigurationShared::CheckState use_fast_gpu_time;
     ConfigurationShared::CheckState use_caches_gc;
+    ConfigurationShared::CheckState use_write_tracking;
+    ConfigurationShared::CheckState use_disk_texture_cache;
+    ConfigurationShared::CheckState use_multithreaded_recording;
 };
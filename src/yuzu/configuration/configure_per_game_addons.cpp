@@ -122,7 +122,7 @@ void ConfigurePerGameAddons::LoadConfiguration() {
 
     const auto& disabled = Settings::values.disabled_addons[title_id];
 
-    for (const auto& patch : pm.GetPatchVersionNames(update_raw)) {
+    for (const auto& patch : pm.GetPatchVersionNames(update_raw != nullptr)) {
         const auto name =
             QString::fromStdString(patch.first).replace(QStringLiteral("[D] "), QString{});
 
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -23,6 +24,8 @@
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/submission_package.h"
+#include "core/file_sys/title_metadata_index.h"
+#include "core/file_sys/vfs_offset.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/loader/loader.h"
 #include "yuzu/compatibility_list.h"
@@ -161,12 +164,10 @@ QString FormatGameName(const std::string& physical_name) {
     return physical_name_as_qstring;
 }
 
-QString FormatPatchNameVersions(const FileSys::PatchManager& patch_manager,
-                                Loader::AppLoader& loader, bool updatable = true) {
+QString FormatPatchNameVersions(const FileSys::PatchManager::PatchVersionNames& patch_versions,
+                                Loader::FileType file_type, bool updatable = true) {
     QString out;
-    FileSys::VirtualFile update_raw;
-    loader.ReadUpdateRaw(update_raw);
-    for (const auto& kv : patch_manager.GetPatchVersionNames(update_raw)) {
+    for (const auto& kv : patch_versions) {
         const bool is_update = kv.first == "Update" || kv.first == "[D] Update";
         if (!updatable && is_update) {
             continue;
@@ -181,7 +182,7 @@ QString FormatPatchNameVersions(const FileSys::PatchManager& patch_manager,
 
             // Display container name for packed updates
             if (is_update && ver == "PACKED") {
-                ver = Loader::GetFileTypeString(loader.GetFileType());
+                ver = Loader::GetFileTypeString(file_type);
             }
 
             out.append(QStringLiteral("%1 (%2)\n").arg(type, QString::fromStdString(ver)));
@@ -193,9 +194,9 @@ QString FormatPatchNameVersions(const FileSys::PatchManager& patch_manager,
 }
 
 QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::string& name,
-                                        const std::vector<u8>& icon, Loader::AppLoader& loader,
-                                        u64 program_id, const CompatibilityList& compatibility_list,
-                                        const FileSys::PatchManager& patch) {
+                                        const std::vector<u8>& icon, Loader::FileType file_type,
+                                        u64 program_id, u64 size, const QString& patch_versions,
+                                        const CompatibilityList& compatibility_list) {
     const auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
 
     // The game list uses this as compatibility number for untested games
@@ -204,7 +205,6 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
         compatibility = it->second.first;
     }
 
-    const auto file_type = loader.GetFileType();
     const auto file_type_string = QString::fromStdString(Loader::GetFileTypeString(file_type));
 
     QList<QStandardItem*> list{
@@ -212,13 +212,8 @@ QList<QStandardItem*> MakeGameListEntry(const std::string& path, const std::stri
                              file_type_string, program_id),
         new GameListItemCompat(compatibility),
         new GameListItem(file_type_string),
-        new GameListItemSize(Common::FS::GetSize(path)),
+        new GameListItemSize(size),
     };
-
-    const auto patch_versions = GetGameListCachedObject(
-        fmt::format("{:016X}", patch.GetTitleID()), "pv.txt", [&patch, &loader] {
-            return FormatPatchNameVersions(patch, loader, loader.IsRomFSUpdatable());
-        });
     list.insert(2, new GameListItem(patch_versions));
 
     return list;
@@ -230,7 +225,9 @@ GameListWorker::GameListWorker(FileSys::VirtualFilesystem vfs,
                                QVector<UISettings::GameDir>& game_dirs,
                                const CompatibilityList& compatibility_list)
     : vfs(std::move(vfs)), provider(provider), game_dirs(game_dirs),
-      compatibility_list(compatibility_list) {}
+      compatibility_list(compatibility_list),
+      index(std::make_unique<FileSys::TitleMetadataIndex>(
+          Common::FS::GetYuzuPath(Common::FS::YuzuPath::CacheDir) / "game_list" / "index.bin")) {}
 
 GameListWorker::~GameListWorker() = default;
 
@@ -277,18 +274,26 @@ void GameListWorker::AddTitlesToGameList(GameListDir* parent_dir) {
             GetMetadataFromControlNCA(patch, *control, icon, name);
         }
 
-        emit EntryReady(MakeGameListEntry(file->GetFullPath(), name, icon, *loader, program_id,
-                                          compatibility_list, patch),
+        const auto patch_versions = GetGameListCachedObject(
+            fmt::format("{:016X}", patch.GetTitleID()), "pv.txt", [&patch, &loader] {
+                FileSys::VirtualFile update_raw;
+                loader->ReadUpdateRaw(update_raw);
+                return FormatPatchNameVersions(patch.GetPatchVersionNames(update_raw != nullptr),
+                                               loader->GetFileType(), loader->IsRomFSUpdatable());
+            });
+
+        const auto path = file->GetFullPath();
+        emit EntryReady(MakeGameListEntry(path, name, icon, loader->GetFileType(), program_id,
+                                          Common::FS::GetSize(path), patch_versions,
+                                          compatibility_list),
                         parent_dir);
     }
 }
 
-void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_path, bool deep_scan,
-                                    GameListDir* parent_dir) {
-    auto& system = Core::System::GetInstance();
-
-    const auto callback = [this, target, parent_dir,
-                           &system](const std::filesystem::path& path) -> bool {
+std::vector<std::string> GameListWorker::CollectFiles(const std::string& dir_path,
+                                                     bool deep_scan) {
+    std::vector<std::string> files;
+    const auto callback = [this, &files](const std::filesystem::path& path) -> bool {
         if (stop_processing) {
             // Breaks the callback loop.
             return false;
@@ -299,56 +304,7 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
 
         if (!is_dir &&
             (HasSupportedFileExtension(physical_name) || IsExtractedNCAMain(physical_name))) {
-            const auto file = vfs->OpenFile(physical_name, FileSys::Mode::Read);
-            if (!file) {
-                return true;
-            }
-
-            auto loader = Loader::GetLoader(system, file);
-            if (!loader) {
-                return true;
-            }
-
-            const auto file_type = loader->GetFileType();
-            if (file_type == Loader::FileType::Unknown || file_type == Loader::FileType::Error) {
-                return true;
-            }
-
-            u64 program_id = 0;
-            const auto res2 = loader->ReadProgramId(program_id);
-
-            if (target == ScanTarget::FillManualContentProvider) {
-                if (res2 == Loader::ResultStatus::Success && file_type == Loader::FileType::NCA) {
-                    provider->AddEntry(FileSys::TitleType::Application,
-                                       FileSys::GetCRTypeFromNCAType(FileSys::NCA{file}.GetType()),
-                                       program_id, file);
-                } else if (res2 == Loader::ResultStatus::Success &&
-                           (file_type == Loader::FileType::XCI ||
-                            file_type == Loader::FileType::NSP)) {
-                    const auto nsp = file_type == Loader::FileType::NSP
-                                         ? std::make_shared<FileSys::NSP>(file)
-                                         : FileSys::XCI{file}.GetSecurePartitionNSP();
-                    for (const auto& title : nsp->GetNCAs()) {
-                        for (const auto& entry : title.second) {
-                            provider->AddEntry(entry.first.first, entry.first.second, title.first,
-                                               entry.second->GetBaseFile());
-                        }
-                    }
-                }
-            } else {
-                std::vector<u8> icon;
-                [[maybe_unused]] const auto res1 = loader->ReadIcon(icon);
-
-                std::string name = " ";
-                [[maybe_unused]] const auto res3 = loader->ReadTitle(name);
-
-                const FileSys::PatchManager patch{program_id, system.GetFileSystemController(),
-                                                  system.GetContentProvider()};
-
-                emit EntryReady(MakeGameListEntry(physical_name, name, icon, *loader, program_id,
-                                                  compatibility_list, patch),
-                                parent_dir);
-            }
+            files.push_back(physical_name);
         } else if (is_dir) {
             watch_list.append(QString::fromStdString(physical_name));
         }
@@ -362,13 +318,108 @@ void GameListWorker::ScanFileSystem(ScanTarget target, const std::string& dir_pa
     } else {
         Common::FS::IterateDirEntries(dir_path, callback, Common::FS::DirEntryFilter::File);
     }
+    return files;
+}
+
+void GameListWorker::AddContentsToProvider(const std::string& physical_name,
+                                           const FileSys::TitleMetadata& metadata) {
+    if (!metadata.program_id) {
+        return;
+    }
+    if (metadata.contents_indexed && metadata.contents.empty()) {
+        return;
+    }
+
+    const auto file = vfs->OpenFile(physical_name, FileSys::Mode::Read);
+    if (!file) {
+        return;
+    }
+
+    if (!metadata.contents_indexed) {
+        // The contents could not be located in the container, parse it again
+        const auto nsp = metadata.file_type == Loader::FileType::NSP
+                             ? std::make_shared<FileSys::NSP>(file)
+                             : FileSys::XCI{file}.GetSecurePartitionNSP();
+        for (const auto& title : nsp->GetNCAs()) {
+            for (const auto& entry : title.second) {
+                provider->AddEntry(entry.first.first, entry.first.second, title.first,
+                                   entry.second->GetBaseFile());
+            }
+        }
+        return;
+    }
+
+    for (const auto& content : metadata.contents) {
+        auto content_file = file;
+        if (content.offset != 0 || content.size != file->GetSize()) {
+            content_file = std::make_shared<FileSys::OffsetVfsFile>(file, content.size,
+                                                                    content.offset, content.name);
+        }
+        provider->AddEntry(content.title_type, content.record_type, content.title_id,
+                           std::move(content_file));
+    }
+}
+
+void GameListWorker::ScanFileSystem(ScanTarget target, const std::vector<std::string>& files,
+                                    GameListDir* parent_dir) {
+    auto& system = Core::System::GetInstance();
+
+    for (const auto& physical_name : files) {
+        if (stop_processing) {
+            return;
+        }
+
+        const auto* const metadata = index->Find(physical_name);
+        if (metadata == nullptr || metadata->file_type == Loader::FileType::Unknown) {
+            continue;
+        }
+
+        if (target == ScanTarget::FillManualContentProvider) {
+            AddContentsToProvider(physical_name, *metadata);
+        } else {
+            const u64 program_id = metadata->program_id.value_or(0);
+            const FileSys::PatchManager patch{program_id, system.GetFileSystemController(),
+                                              system.GetContentProvider()};
+            const auto patch_versions =
+                FormatPatchNameVersions(index->GetAddOns(physical_name, patch),
+                                        metadata->file_type, metadata->romfs_updatable);
+
+            emit EntryReady(MakeGameListEntry(physical_name, metadata->name, metadata->icon,
+                                              metadata->file_type, program_id, metadata->size,
+                                              patch_versions, compatibility_list),
+                            parent_dir);
+        }
+    }
 }
 
 void GameListWorker::run() {
     stop_processing = false;
     provider->ClearAllEntries();
 
-    for (UISettings::GameDir& game_dir : game_dirs) {
+    if (UISettings::values.cache_game_list) {
+        index->Load();
+    }
+
+    // Bring the index up to date with every game directory at once, so only new and changed files
+    // are parsed and they are parsed in parallel.
+    std::vector<std::vector<std::string>> dir_files(game_dirs.size());
+    std::vector<std::string> all_files;
+    for (int i = 0; i < game_dirs.size(); ++i) {
+        const UISettings::GameDir& game_dir = game_dirs[i];
+        if (game_dir.path == QStringLiteral("SDMC") ||
+            game_dir.path == QStringLiteral("UserNAND") ||
+            game_dir.path == QStringLiteral("SysNAND")) {
+            continue;
+        }
+        watch_list.append(game_dir.path);
+        dir_files[i] = CollectFiles(game_dir.path.toStdString(), game_dir.deep_scan);
+        all_files.insert(all_files.end(), dir_files[i].begin(), dir_files[i].end());
+    }
+    index->Refresh(Core::System::GetInstance(), vfs, all_files,
+                   std::thread::hardware_concurrency(), stop_processing);
+
+    for (int i = 0; i < game_dirs.size(); ++i) {
+        UISettings::GameDir& game_dir = game_dirs[i];
         if (game_dir.path == QStringLiteral("SDMC")) {
             auto* const game_list_dir = new GameListDir(game_dir, GameListItemType::SdmcDir);
             emit DirEntryReady(game_list_dir);
@@ -382,16 +433,18 @@ void GameListWorker::run() {
             emit DirEntryReady(game_list_dir);
             AddTitlesToGameList(game_list_dir);
         } else {
-            watch_list.append(game_dir.path);
             auto* const game_list_dir = new GameListDir(game_dir);
             emit DirEntryReady(game_list_dir);
-            ScanFileSystem(ScanTarget::FillManualContentProvider, game_dir.path.toStdString(),
-                           game_dir.deep_scan, game_list_dir);
-            ScanFileSystem(ScanTarget::PopulateGameList, game_dir.path.toStdString(),
-                           game_dir.deep_scan, game_list_dir);
+            ScanFileSystem(ScanTarget::FillManualContentProvider, dir_files[i], game_list_dir);
+            ScanFileSystem(ScanTarget::PopulateGameList, dir_files[i], game_list_dir);
         }
     }
 
+    // Also keeps what was parsed when the scan was cancelled
+    if (UISettings::values.cache_game_list) {
+        index->Save();
+    }
+
     emit Finished(watch_list);
 }
 
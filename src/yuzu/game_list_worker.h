@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <QList>
 #include <QObject>
@@ -23,6 +24,8 @@ class QStandardItem;
 
 namespace FileSys {
 class NCA;
+struct TitleMetadata;
+class TitleMetadataIndex;
 class VfsFilesystem;
 } // namespace FileSys
 
@@ -70,13 +73,20 @@ private:
         PopulateGameList,
     };
 
-    void ScanFileSystem(ScanTarget target, const std::string& dir_path, bool deep_scan,
+    /// Lists the files of a game directory that may be games, adding its subdirectories to the
+    /// watch list.
+    std::vector<std::string> CollectFiles(const std::string& dir_path, bool deep_scan);
+
+    void ScanFileSystem(ScanTarget target, const std::vector<std::string>& files,
                         GameListDir* parent_dir);
+    void AddContentsToProvider(const std::string& physical_name,
+                               const FileSys::TitleMetadata& metadata);
 
     std::shared_ptr<FileSys::VfsFilesystem> vfs;
     FileSys::ManualContentProvider* provider;
     QVector<UISettings::GameDir>& game_dirs;
     const CompatibilityList& compatibility_list;
+    std::unique_ptr<FileSys::TitleMetadataIndex> index;
 
     QStringList watch_list;
     std::atomic_bool stop_processing;
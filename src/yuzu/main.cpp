@@ -183,6 +183,9 @@ static void InitializeLogging() {
     const auto log_dir = FS::GetYuzuPath(FS::YuzuPath::LogDir);
     void(FS::CreateDir(log_dir));
     Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir / LOG_FILE));
+    if (Settings::values.trace_logging) {
+        Log::AddBackend(std::make_unique<Log::TraceBackend>(log_dir / TRACE_FILE));
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
@@ -2106,8 +2109,13 @@ void GMainWindow::OnMenuLoadFolder() {
     }
 }
 
-void GMainWindow::IncrementInstallProgress() {
-    install_progress->setValue(install_progress->value() + 1);
+void GMainWindow::IncrementInstallProgress(qint64 bytes, qint64 bytes_per_second) {
+    install_progress_bytes += bytes;
+    install_progress->setValue(static_cast<int>(install_progress_bytes / 0x1000));
+    install_progress->setLabelText(
+        tr("%1\n%2 MB/s")
+            .arg(install_progress_label)
+            .arg(static_cast<double>(bytes_per_second) / 0x100000, 0, 'f', 1));
 }
 
 void GMainWindow::OnMenuInstallToNAND() {
@@ -2150,6 +2158,7 @@ void GMainWindow::OnMenuInstallToNAND() {
     QStringList overwritten_files{}; // Files that overwrote those existing in the NAND
     QStringList failed_files{};      // Files that failed to install due to errors
     bool detected_base_install{};    // Whether a base game was attempted to be installed
+    QStringList unverified_files{};  // Files whose NCAs failed hash verification
 
     ui.action_Install_File_NAND->setEnabled(false);
 
@@ -2159,11 +2168,12 @@ void GMainWindow::OnMenuInstallToNAND() {
     install_progress->setAttribute(Qt::WA_DeleteOnClose, true);
     install_progress->setFixedWidth(installDialog.GetMinimumWidth() + 40);
     install_progress->show();
+    install_progress_bytes = 0;
 
     for (const QString& file : files) {
         install_progress->setWindowTitle(tr("%n file(s) remaining", "", remaining));
-        install_progress->setLabelText(
-            tr("Installing file \"%1\"...").arg(QFileInfo(file).fileName()));
+        install_progress_label = tr("Installing file \"%1\"...").arg(QFileInfo(file).fileName());
+        install_progress->setLabelText(install_progress_label);
 
         QFuture<InstallResult> future;
         InstallResult result;
@@ -2200,6 +2210,10 @@ void GMainWindow::OnMenuInstallToNAND() {
             failed_files.append(QFileInfo(file).fileName());
             detected_base_install = true;
             break;
+        case InstallResult::VerificationFailed:
+            failed_files.append(QFileInfo(file).fileName());
+            unverified_files.append(QFileInfo(file).fileName());
+            break;
         }
 
         --remaining;
@@ -2214,6 +2228,14 @@ void GMainWindow::OnMenuInstallToNAND() {
                "NAND.\nPlease, only use this feature to install updates and DLC."));
     }
 
+    if (!unverified_files.isEmpty()) {
+        QMessageBox::warning(
+            this, tr("Install Results"),
+            tr("The NCAs of the following files failed hash verification, the files may be "
+               "corrupted or incorrectly dumped:\n%1")
+                .arg(unverified_files.join(QLatin1Char{'\n'})));
+    }
+
     const QString install_results =
         (new_files.isEmpty() ? QString{}
                              : tr("%n file(s) were newly installed\n", "", new_files.size())) +
@@ -2231,28 +2253,12 @@ void GMainWindow::OnMenuInstallToNAND() {
 }
 
 InstallResult GMainWindow::InstallNSPXCI(const QString& filename) {
-    const auto qt_raw_copy = [this](const FileSys::VirtualFile& src,
-                                    const FileSys::VirtualFile& dest, std::size_t block_size) {
-        if (src == nullptr || dest == nullptr) {
+    const auto qt_progress = [this](const FileSys::CopyProgress& progress) {
+        if (install_progress->wasCanceled()) {
             return false;
         }
-        if (!dest->Resize(src->GetSize())) {
-            return false;
-        }
-
-        std::array<u8, 0x1000> buffer{};
-
-        for (std::size_t i = 0; i < src->GetSize(); i += buffer.size()) {
-            if (install_progress->wasCanceled()) {
-                dest->Resize(0);
-                return false;
-            }
-
-            emit UpdateInstallProgress();
-
-            const auto read = src->Read(buffer.data(), buffer.size(), i);
-            dest->Write(buffer.data(), read, i);
-        }
+        emit UpdateInstallProgress(static_cast<qint64>(progress.delta_bytes),
+                                   static_cast<qint64>(progress.bytes_per_second));
         return true;
     };
 
@@ -2274,7 +2280,7 @@ InstallResult GMainWindow::InstallNSPXCI(const QString& filename) {
     }
     const auto res =
         Core::System::GetInstance().GetFileSystemController().GetUserNANDContents()->InstallEntry(
-            *nsp, true, qt_raw_copy);
+            *nsp, true, qt_progress);
     switch (res) {
     case FileSys::InstallResult::Success:
         return InstallResult::Success;
@@ -2282,34 +2288,20 @@ InstallResult GMainWindow::InstallNSPXCI(const QString& filename) {
         return InstallResult::Overwrite;
     case FileSys::InstallResult::ErrorBaseInstall:
         return InstallResult::BaseInstallAttempted;
+    case FileSys::InstallResult::ErrorVerificationFailed:
+        return InstallResult::VerificationFailed;
     default:
         return InstallResult::Failure;
     }
 }
 
 InstallResult GMainWindow::InstallNCA(const QString& filename) {
-    const auto qt_raw_copy = [this](const FileSys::VirtualFile& src,
-                                    const FileSys::VirtualFile& dest, std::size_t block_size) {
-        if (src == nullptr || dest == nullptr) {
+    const auto qt_progress = [this](const FileSys::CopyProgress& progress) {
+        if (install_progress->wasCanceled()) {
             return false;
         }
-        if (!dest->Resize(src->GetSize())) {
-            return false;
-        }
-
-        std::array<u8, 0x1000> buffer{};
-
-        for (std::size_t i = 0; i < src->GetSize(); i += buffer.size()) {
-            if (install_progress->wasCanceled()) {
-                dest->Resize(0);
-                return false;
-            }
-
-            emit UpdateInstallProgress();
-
-            const auto read = src->Read(buffer.data(), buffer.size(), i);
-            dest->Write(buffer.data(), read, i);
-        }
+        emit UpdateInstallProgress(static_cast<qint64>(progress.delta_bytes),
+                                   static_cast<qint64>(progress.bytes_per_second));
         return true;
     };
 
@@ -2357,18 +2349,20 @@ InstallResult GMainWindow::InstallNCA(const QString& filename) {
         res = Core::System::GetInstance()
                   .GetFileSystemController()
                   .GetUserNANDContents()
-                  ->InstallEntry(*nca, static_cast<FileSys::TitleType>(index), true, qt_raw_copy);
+                  ->InstallEntry(*nca, static_cast<FileSys::TitleType>(index), true, qt_progress);
     } else {
         res = Core::System::GetInstance()
                   .GetFileSystemController()
                   .GetSystemNANDContents()
-                  ->InstallEntry(*nca, static_cast<FileSys::TitleType>(index), true, qt_raw_copy);
+                  ->InstallEntry(*nca, static_cast<FileSys::TitleType>(index), true, qt_progress);
     }
 
     if (res == FileSys::InstallResult::Success) {
         return InstallResult::Success;
     } else if (res == FileSys::InstallResult::OverwriteExisting) {
         return InstallResult::Overwrite;
+    } else if (res == FileSys::InstallResult::ErrorVerificationFailed) {
+        return InstallResult::VerificationFailed;
     } else {
         return InstallResult::Failure;
     }
@@ -83,6 +83,7 @@ enum class InstallResult {
     Overwrite,
     Failure,
     BaseInstallAttempted,
+    VerificationFailed,
 };
 
 enum class ReinitializeKeyBehavior {
@@ -134,7 +135,7 @@ signals:
     // Signal that tells widgets to update icons to use the current theme
     void UpdateThemedIcons();
 
-    void UpdateInstallProgress();
+    void UpdateInstallProgress(qint64 bytes, qint64 bytes_per_second);
 
     void ControllerSelectorReconfigureFinished();
 
@@ -255,7 +256,7 @@ private slots:
     void OnGameListOpenPerGameProperties(const std::string& file);
     void OnMenuLoadFile();
     void OnMenuLoadFolder();
-    void IncrementInstallProgress();
+    void IncrementInstallProgress(qint64 bytes, qint64 bytes_per_second);
     void OnMenuInstallToNAND();
     void OnMenuRecentFile();
     void OnConfigure();
@@ -354,6 +355,8 @@ private:
 
     // Install progress dialog
     QProgressDialog* install_progress;
+    qint64 install_progress_bytes{};
+    QString install_progress_label;
 
     // Last game booted, used for multi-process apps
     QString last_filename_booted;
@@ -386,6 +386,8 @@ void Config::ReadValues() {
     Settings::values.gamecard_current_game =
         sdl2_config->GetBoolean("Data Storage", "gamecard_current_game", false);
     Settings::values.gamecard_path = sdl2_config->Get("Data Storage", "gamecard_path", "");
+    Settings::values.verify_nca_integrity =
+        sdl2_config->GetBoolean("Data Storage", "verify_nca_integrity", false);
 
     // System
     Settings::values.use_docked_mode.SetValue(
@@ -455,6 +457,18 @@ void Config::ReadValues() {
         sdl2_config->GetBoolean("Renderer", "accelerate_astc", true));
     Settings::values.use_fast_gpu_time.SetValue(
         sdl2_config->GetBoolean("Renderer", "use_fast_gpu_time", true));
+    Settings::values.use_write_tracking.SetValue(
+        sdl2_config->GetBoolean("Renderer", "use_write_tracking", false));
+    Settings::values.use_disk_texture_cache.SetValue(
+        sdl2_config->GetBoolean("Renderer", "use_disk_texture_cache", false));
+    Settings::values.disk_texture_cache_size.SetValue(static_cast<u32>(
+        sdl2_config->GetInteger("Renderer", "disk_texture_cache_size", 1024)));
+    Settings::values.use_multithreaded_recording.SetValue(
+        sdl2_config->GetBoolean("Renderer", "use_multithreaded_recording", false));
+    Settings::values.texture_cache_budget.SetValue(
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "texture_cache_budget", 0)));
+    Settings::values.buffer_cache_budget.SetValue(
+        static_cast<u32>(sdl2_config->GetInteger("Renderer", "buffer_cache_budget", 0)));
 
     Settings::values.bg_red.SetValue(
         static_cast<float>(sdl2_config->GetReal("Renderer", "bg_red", 0.0)));
@@ -492,6 +506,7 @@ void Config::ReadValues() {
 
     Settings::values.disable_macro_jit =
         sdl2_config->GetBoolean("Debugging", "disable_macro_jit", false);
+    Settings::values.trace_logging = sdl2_config->GetBoolean("Debugging", "trace_logging", false);
 
     const auto title_list = sdl2_config->Get("AddOns", "title_ids", "");
     std::stringstream ss(title_list);
@@ -231,6 +231,31 @@ use_vsync =
 # 0 (default): Off, 1: On
 use_caches_gc =
 
+# Memory budgets in MiB of the texture and buffer caches. With garbage collection enabled, the least
+# recently used resources are evicted past them.
+# 0 (default): Automatic, based on the available video memory
+texture_cache_budget =
+buffer_cache_budget =
+
+# Whether to track CPU writes to memory cached by the GPU by write protecting it, instead of
+# intercepting every access to it. Memory the GPU has written to is still intercepted.
+# Requires fastmem, has no effect with extreme GPU accuracy.
+# 0 (default): Off, 1: On
+use_write_tracking =
+
+# Whether to store the textures decoded on the CPU to disk, so they are not decoded again on later
+# boots.
+# 0 (default): Off, 1: On
+use_disk_texture_cache =
+
+# Maximum size of the texture disk cache in MiB, least recently used textures are evicted past it.
+# Defaults to 1024
+disk_texture_cache_size =
+
+# Whether to record Vulkan command buffers in multiple threads
+# 0 (default): Off, 1: On
+use_multithreaded_recording =
+
 # The clear color for the renderer. What shows up on the sides of the bottom screen.
 # Must be in range of 0.0-1.0. Defaults to 1.0 for all.
 bg_red =
@@ -303,6 +328,10 @@ gamecard_current_game =
 # If 'gamecard_current_game' is 1 this setting is irrelevant
 gamecard_path =
 
+# Whether to check game data against its hash trees as it is read
+# 1: Yes, 0 (default): No
+verify_nca_integrity =
+
 [System]
 # Whether the system is docked
 # 1 (default): Yes, 0: No
@@ -366,6 +395,9 @@ use_debug_asserts =
 use_auto_stub =
 # Enables/Disables the macro JIT compiler
 disable_macro_jit=false
+# Records log messages to a binary trace in the log directory, keeping the most recent ones.
+# Convert it with yuzu-trace-converter. false: Disabled (default), true: Enabled
+trace_logging=false
 # Presents guest frames as they become available. Experimental.
 # false: Disabled (default), true: Enabled
 disable_fps_limit=false
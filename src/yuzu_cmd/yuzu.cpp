@@ -26,7 +26,11 @@
 #include "common/telemetry.h"
 #include "core/core.h"
 #include "core/crypto/key_manager.h"
+#include "core/file_sys/card_image.h"
+#include "core/file_sys/content_archive.h"
+#include "core/file_sys/nca_metadata.h"
 #include "core/file_sys/registered_cache.h"
+#include "core/file_sys/submission_package.h"
 #include "core/file_sys/vfs_real.h"
 #include "core/hle/kernel/k_process.h"
 #include "core/hle/service/filesystem/filesystem.h"
@@ -67,13 +71,59 @@ static void PrintHelp(const char* argv0) {
                  "-f, --fullscreen      Start in fullscreen mode\n"
                  "-h, --help            Display this help and exit\n"
                  "-v, --version         Output version information and exit\n"
-                 "-p, --program         Pass following string as arguments to executable\n";
+                 "-p, --program         Pass following string as arguments to executable\n"
+                 "-i, --integrity       Check game data against its hashes as it is read\n"
+                 "-c, --verify          Check every hash of the given NCA, NSP or XCI and exit\n";
 }
 
 static void PrintVersion() {
     std::cout << "yuzu " << Common::g_scm_branch << " " << Common::g_scm_desc << std::endl;
 }
 
+/// Checks every NCA of a title against its hashes, returns the process exit code
+static int VerifyTitle(const std::string& filepath) {
+    const auto vfs = std::make_shared<FileSys::RealVfsFilesystem>();
+    const auto file = vfs->OpenFile(filepath, FileSys::Mode::Read);
+    if (file == nullptr) {
+        LOG_CRITICAL(Frontend, "Failed to open {}", filepath);
+        return -1;
+    }
+
+    std::vector<std::shared_ptr<FileSys::NCA>> ncas;
+    switch (Loader::IdentifyFile(file)) {
+    case Loader::FileType::NCA:
+        ncas.push_back(std::make_shared<FileSys::NCA>(file));
+        break;
+    case Loader::FileType::NSP:
+        ncas = FileSys::NSP{file}.GetNCAsCollapsed();
+        break;
+    case Loader::FileType::XCI:
+        ncas = FileSys::XCI{file}.GetNCAs();
+        break;
+    default:
+        LOG_CRITICAL(Frontend, "{} is not a NCA, NSP or XCI file", filepath);
+        return -1;
+    }
+
+    const std::size_t num_threads = std::max(1U, std::thread::hardware_concurrency());
+    bool success = true;
+    for (const auto& nca : ncas) {
+        if (nca->GetStatus() == Loader::ResultStatus::ErrorMissingBKTRBaseRomFS) {
+            LOG_WARNING(Frontend, "Skipping {}, it needs the RomFS of the base game", nca->GetName());
+            continue;
+        }
+        if (nca->GetStatus() != Loader::ResultStatus::Success) {
+            LOG_ERROR(Frontend, "Failed to open {}: {}", nca->GetName(), nca->GetStatus());
+            success = false;
+            continue;
+        }
+        const bool valid = nca->VerifyIntegrity(num_threads);
+        LOG_INFO(Frontend, "{}: {}", nca->GetName(), valid ? "OK" : "CORRUPT");
+        success &= valid;
+    }
+    return success ? 0 : 1;
+}
+
 static void InitializeLogging() {
     using namespace Common;
 
@@ -86,6 +136,9 @@ static void InitializeLogging() {
     const auto& log_dir = FS::GetYuzuPath(FS::YuzuPath::LogDir);
     void(FS::CreateDir(log_dir));
     Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir / LOG_FILE));
+    if (Settings::values.trace_logging) {
+        Log::AddBackend(std::make_unique<Log::TraceBackend>(log_dir / TRACE_FILE));
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
@@ -111,17 +164,20 @@ int main(int argc, char** argv) {
     std::string filepath;
 
     bool fullscreen = false;
+    bool verify_title = false;
 
     static struct option long_options[] = {
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {"program", optional_argument, 0, 'p'},
+        {"integrity", no_argument, 0, 'i'},
+        {"verify", no_argument, 0, 'c'},
         {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:fhvp::", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:fhvp::ic", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'f':
@@ -138,6 +194,12 @@ int main(int argc, char** argv) {
                 Settings::values.program_args = argv[optind];
                 ++optind;
                 break;
+            case 'i':
+                Settings::values.verify_nca_integrity = true;
+                break;
+            case 'c':
+                verify_title = true;
+                break;
             }
         } else {
 #ifdef _WIN32
@@ -163,6 +225,10 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    if (verify_title) {
+        return VerifyTitle(filepath);
+    }
+
     auto& system{Core::System::GetInstance()};
     InputCommon::InputSubsystem input_subsystem;
 
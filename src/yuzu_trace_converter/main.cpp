@@ -0,0 +1,228 @@
+// Copyright 2021 yuzu emulator team
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// Converts a trace recorded by the trace logging backend to the Chrome trace event JSON format,
+// which can be opened in chrome://tracing or in the Perfetto UI. Log entries become instant events,
+// trace events keep their duration and arguments.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#ifdef _WIN32
+// windows.h needs to be included before shellapi.h
+#include <windows.h>
+
+#include <shellapi.h>
+#endif
+
+#include <fmt/format.h>
+
+#include "common/fs/file.h"
+#include "common/fs/fs_util.h"
+#include "common/logging/filter.h"
+#include "common/logging/trace_file.h"
+
+namespace {
+/// Events are buffered and written in batches of about this size.
+constexpr std::size_t WRITE_BATCH_SIZE = 1 << 20;
+
+void PrintHelp(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s <trace file> [output file]\n"
+                 "Converts a yuzu log trace to Chrome trace event JSON, to be opened in "
+                 "chrome://tracing or ui.perfetto.dev.\n"
+                 "The output file defaults to the trace file with a .json extension.\n",
+                 argv0);
+}
+
+void AppendEscaped(std::string& out, std::string_view string) {
+    for (const char c : string) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += fmt::format("\\u{:04x}", static_cast<unsigned char>(c));
+            } else {
+                out += c;
+            }
+            break;
+        }
+    }
+}
+
+/// Appends a duration in nanoseconds as microseconds.
+void AppendMicroseconds(std::string& out, std::chrono::nanoseconds duration) {
+    const auto count = duration.count();
+    out += fmt::format("{}.{:03}", count / 1000, count % 1000);
+}
+
+/// Appends a trace event, complete ones span their duration.
+void AppendTraceEvent(std::string& out, const Common::Log::Trace::TraceEntry& entry) {
+    using Common::Log::Trace::RecordType;
+    out += "{\"name\":\"";
+    AppendEscaped(out, entry.function);
+    out += "\",\"cat\":\"";
+    out += Common::Log::GetLogClassName(entry.log_class);
+    if (entry.type == RecordType::CompleteEvent) {
+        out += "\",\"ph\":\"X\",\"dur\":";
+        AppendMicroseconds(out, entry.duration);
+    } else {
+        out += "\",\"ph\":\"i\",\"s\":\"t\"";
+    }
+    out += ",\"ts\":";
+    AppendMicroseconds(out, entry.timestamp);
+    out += fmt::format(",\"pid\":1,\"tid\":{},\"args\":{{", entry.thread_id);
+    bool first = true;
+    for (const auto& arg : entry.args) {
+        out += first ? "\"" : ",\"";
+        first = false;
+        AppendEscaped(out, arg.name);
+        out += "\":";
+        std::visit(
+            [&out](const auto& value) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(value)>, std::string>) {
+                    out += '"';
+                    AppendEscaped(out, value);
+                    out += '"';
+                } else if constexpr (std::is_same_v<std::decay_t<decltype(value)>, double>) {
+                    // JSON has no representation of infinities and NaNs
+                    out += std::isfinite(value) ? fmt::format("{}", value) : "null";
+                } else {
+                    out += fmt::format("{}", value);
+                }
+            },
+            arg.value);
+    }
+    out += "}}";
+}
+
+/// Appends an instant event for a log entry, timestamps are in microseconds.
+void AppendEvent(std::string& out, const Common::Log::Trace::TraceEntry& entry) {
+    if (entry.type != Common::Log::Trace::RecordType::Message) {
+        return AppendTraceEvent(out, entry);
+    }
+    const auto count = entry.timestamp.count();
+    out += "{\"name\":\"";
+    AppendEscaped(out, entry.function);
+    out += "\",\"cat\":\"";
+    out += Common::Log::GetLogClassName(entry.log_class);
+    out += fmt::format("\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{}.{:03},\"pid\":1,\"tid\":{},",
+                       count / 1000, count % 1000, entry.thread_id);
+    out += "\"args\":{\"level\":\"";
+    out += Common::Log::GetLevelName(entry.log_level);
+    out += "\",\"location\":\"";
+    AppendEscaped(out, entry.filename);
+    out += fmt::format(":{}\",\"message\":\"", entry.line_num);
+    AppendEscaped(out, entry.message);
+    out += "\"}}";
+}
+} // Anonymous namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::filesystem::path> args;
+#ifdef _WIN32
+    int argc_w;
+    const auto argv_w = CommandLineToArgvW(GetCommandLineW(), &argc_w);
+    if (argv_w == nullptr) {
+        std::fprintf(stderr, "Failed to get command line arguments\n");
+        return 1;
+    }
+    for (int i = 1; i < argc_w; ++i) {
+        args.emplace_back(argv_w[i]);
+    }
+    LocalFree(argv_w);
+#else
+    for (int i = 1; i < argc; ++i) {
+        args.emplace_back(argv[i]);
+    }
+#endif
+    if (args.empty() || args.size() > 2) {
+        PrintHelp(argv[0]);
+        return 1;
+    }
+
+    const std::filesystem::path& input = args[0];
+    std::filesystem::path output = input;
+    if (args.size() == 2) {
+        output = args[1];
+    } else {
+        output.replace_extension(".json");
+    }
+
+    const auto trace = Common::Log::Trace::ReadTraceFile(input);
+    if (!trace) {
+        std::fprintf(stderr, "%s is not a valid trace\n",
+                     Common::FS::PathToUTF8String(input).c_str());
+        return 1;
+    }
+
+    Common::FS::IOFile file{output, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::TextFile};
+    if (!file.IsOpen()) {
+        std::fprintf(stderr, "Failed to open %s\n", Common::FS::PathToUTF8String(output).c_str());
+        return 1;
+    }
+
+    std::string out = fmt::format("{{\"displayTimeUnit\":\"ns\",\"otherData\":{{\"start_time_ns\":"
+                                  "\"{}\"}},\"traceEvents\":[",
+                                  trace->start_time);
+
+    // Names the threads, they are only known by the order in which they started logging
+    std::set<u32> thread_ids;
+    for (const auto& entry : trace->entries) {
+        thread_ids.insert(entry.thread_id);
+    }
+    bool first = true;
+    for (const u32 thread_id : thread_ids) {
+        out += fmt::format("{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                           "\"args\":{{\"name\":\"Thread {}\"}}}}",
+                           first ? "\n" : ",\n", thread_id, thread_id);
+        first = false;
+    }
+
+    for (const auto& entry : trace->entries) {
+        out += first ? "\n" : ",\n";
+        first = false;
+        AppendEvent(out, entry);
+        if (out.size() >= WRITE_BATCH_SIZE) {
+            if (file.WriteString(out) != out.size()) {
+                std::fprintf(stderr, "Failed to write %s\n",
+                             Common::FS::PathToUTF8String(output).c_str());
+                return 1;
+            }
+            out.clear();
+        }
+    }
+    out += "\n]}\n";
+    if (file.WriteString(out) != out.size()) {
+        std::fprintf(stderr, "Failed to write %s\n", Common::FS::PathToUTF8String(output).c_str());
+        return 1;
+    }
+
+    std::printf("Converted %zu entries and events to %s\n", trace->entries.size(),
+                Common::FS::PathToUTF8String(output).c_str());
+    return 0;
+}